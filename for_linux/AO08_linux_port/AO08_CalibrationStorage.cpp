@@ -1,4 +1,5 @@
 #include "AO08_CalibrationStorage.h"
+#include "LogModules.h"
 using namespace ArduinoHAL;
 
 // Preferences 键名定义
@@ -12,31 +13,35 @@ AO08_CalibrationStorage::AO08_CalibrationStorage(const char* namespaceName)
 
 bool AO08_CalibrationStorage::begin() {
     if (!_prefs.begin(_namespace, false)) {
-        Serial.print("[存储错误] 无法打开命名空间: ");
-        Serial.println(_namespace);
+        LOG_E(AO08) {
+            Serial.print("[存储错误] 无法打开命名空间: ");
+            Serial.println(_namespace);
+        }
         return false;
     }
     
-    Serial.print("[存储] 初始化成功，命名空间: ");
-    Serial.println(_namespace);
+    LOG_I(AO08) {
+        Serial.print("[存储] 初始化成功，命名空间: ");
+        Serial.println(_namespace);
+    }
     return true;
 }
 
 bool AO08_CalibrationStorage::validateParams(const CalibrationParams& params) {
     // 验证参数合理性
     if (params.voltageAir <= params.voltageZero) {
-        Serial.println("[存储错误] 空气电压必须大于零点电压");
+        LOG_E(AO08) Serial.println("[存储错误] 空气电压必须大于零点电压");
         return false;
     }
     
     // 检查电压范围是否合理（AO-08 在空气中约为 60-65mV）
     if (params.voltageAir < 10.0f || params.voltageAir > 200.0f) {
-        Serial.println("[存储警告] 空气电压超出正常范围 (10-200mV)");
+        LOG_W(AO08) Serial.println("[存储警告] 空气电压超出正常范围 (10-200mV)");
         // 不返回 false，只警告
     }
     
     if (abs(params.voltageZero) > 50.0f) {
-        Serial.println("[存储警告] 零点电压超出正常范围 (-50 到 50mV)");
+        LOG_W(AO08) Serial.println("[存储警告] 零点电压超出正常范围 (-50 到 50mV)");
     }
     
     return true;
@@ -48,7 +53,7 @@ bool AO08_CalibrationStorage::saveCalibration(const CalibrationParams& params) {
     }
     
     if (!_prefs.begin(_namespace, false)) {
-        Serial.println("[存储错误] 无法打开命名空间进行写入");
+        LOG_E(AO08) Serial.println("[存储错误] 无法打开命名空间进行写入");
         return false;
     }
     
@@ -59,27 +64,29 @@ bool AO08_CalibrationStorage::saveCalibration(const CalibrationParams& params) {
     
     _prefs.end();
     
-    Serial.println("[存储] 校准参数已保存:");
-    Serial.print("  零点电压: ");
-    Serial.print(params.voltageZero, 4);
-    Serial.println(" mV");
-    Serial.print("  空气电压: ");
-    Serial.print(params.voltageAir, 4);
-    Serial.println(" mV");
+    LOG_I(AO08) {
+        Serial.println("[存储] 校准参数已保存:");
+        Serial.print("  零点电压: ");
+        Serial.print(params.voltageZero, 4);
+        Serial.println(" mV");
+        Serial.print("  空气电压: ");
+        Serial.print(params.voltageAir, 4);
+        Serial.println(" mV");
+    }
     
     return true;
 }
 
 bool AO08_CalibrationStorage::loadCalibration(CalibrationParams& params) {
     if (!_prefs.begin(_namespace, true)) { // 只读模式
-        Serial.println("[存储错误] 无法打开命名空间进行读取");
+        LOG_E(AO08) Serial.println("[存储错误] 无法打开命名空间进行读取");
         return false;
     }
     
     // 检查是否存在有效校准
     if (!_prefs.getBool(KEY_IS_VALID, false)) {
         _prefs.end();
-        Serial.println("[存储] 未找到有效的校准参数");
+        LOG_I(AO08) Serial.println("[存储] 未找到有效的校准参数");
         return false;
     }
     
@@ -96,13 +103,15 @@ bool AO08_CalibrationStorage::loadCalibration(CalibrationParams& params) {
         return false;
     }
     
-    Serial.println("[存储] 校准参数已加载:");
-    Serial.print("  零点电压: ");
-    Serial.print(params.voltageZero, 4);
-    Serial.println(" mV");
-    Serial.print("  空气电压: ");
-    Serial.print(params.voltageAir, 4);
-    Serial.println(" mV");
+    LOG_I(AO08) {
+        Serial.println("[存储] 校准参数已加载:");
+        Serial.print("  零点电压: ");
+        Serial.print(params.voltageZero, 4);
+        Serial.println(" mV");
+        Serial.print("  空气电压: ");
+        Serial.print(params.voltageAir, 4);
+        Serial.println(" mV");
+    }
     
     return true;
 }
@@ -129,7 +138,7 @@ bool AO08_CalibrationStorage::clearCalibration() {
     
     _prefs.end();
     
-    Serial.println("[存储] 校准参数已清除");
+    LOG_I(AO08) Serial.println("[存储] 校准参数已清除");
     return true;
 }
 
@@ -1,10 +1,14 @@
 #include "AO08_Sensor.h"
+#include "LogModules.h"
 using namespace ArduinoHAL;
 
 AO08_Sensor::AO08_Sensor(I2CMux* mux_ptr, uint8_t muxChannel, uint8_t adsAddress)
     : _mux(mux_ptr), _muxChannel(muxChannel), _adsAddress(adsAddress),
       _lastError(OK), _voltageZero(0.0f), _voltageAir(0.0f),
-      _isCalibratedZero(false), _isCalibratedAir(false) {
+      _isCalibratedZero(false), _isCalibratedAir(false),
+      _autoRangeEnabled(true), _lastPga(5),
+      _calPoint(CAL_ZERO), _calSave(true),
+      _acqRunning(false), _acqRdy(nullptr), _filteredVoltage(0.0f), _hasFiltered(false) {
     
     // 计算配置字
     // Bit 15: OS (1) = 启动单次转换
@@ -15,11 +19,14 @@ AO08_Sensor::AO08_Sensor(I2CMux* mux_ptr, uint8_t muxChannel, uint8_t adsAddress
     // Bit 1-0: COMP_QUE (11) = 禁用比较器
     _configWord = 0x8B83;
     
-    // 计算 LSB 代表的毫伏数
-    // 量程 = 0.256V = 256mV
-    // 16位 ADC (15位 + 符号位), 范围 -32768 到 32767
-    // mV/LSB = 256.0 (mV) / 32768.0 (steps)
-    _mvPerLsb = 256.0f / 32768.0f;
+    // 自动量程从 ±0.256V 开始：AO-08 正常只有 9–13 mV，只有接线或放大电路不同时才会换大量程
+    _autoRange.setPga(5);
+    
+    _acqStats = AcquisitionStats();
+}
+
+AO08_Sensor::~AO08_Sensor() {
+    stopAcquisition();
 }
 
 void AO08_Sensor::selectMuxChannel() {
@@ -31,29 +38,33 @@ void AO08_Sensor::selectMuxChannel() {
 bool AO08_Sensor::begin() {
     // 初始化参数存储
     if (!_storage.begin()) {
-        Serial.println("[AO08] 警告: 参数存储初始化失败，将无法保存校准参数");
+        LOG_W(AO08) Serial.println("[AO08] 警告: 参数存储初始化失败，将无法保存校准参数");
     }
     
     selectMuxChannel();
     Wire.beginTransmission(_adsAddress);
     // 检查 I2C 设备是否存在
     if (Wire.endTransmission() == 0) {
-        Serial.print("[AO08] ADS1115 (通道 ");
-        Serial.print(_muxChannel);
-        Serial.println(") 初始化成功");
+        LOG_I(AO08) {
+            Serial.print("[AO08] ADS1115 (通道 ");
+            Serial.print(_muxChannel);
+            Serial.println(") 初始化成功");
+        }
         
         // 尝试从存储加载校准参数
         if (loadCalibrationFromStorage()) {
-            Serial.println("[AO08] 已从存储加载校准参数");
+            LOG_I(AO08) Serial.println("[AO08] 已从存储加载校准参数");
         } else {
-            Serial.println("[AO08] 未找到已保存的校准参数，需要重新校准");
+            LOG_I(AO08) Serial.println("[AO08] 未找到已保存的校准参数，需要重新校准");
         }
         
         return true;
     } else {
-        Serial.print("[AO08] 错误: ADS1115 (通道 ");
-        Serial.print(_muxChannel);
-        Serial.println(") 未响应");
+        LOG_E(AO08) {
+            Serial.print("[AO08] 错误: ADS1115 (通道 ");
+            Serial.print(_muxChannel);
+            Serial.println(") 未响应");
+        }
         _lastError = ERROR_I2C;
         return false;
     }
@@ -111,8 +122,10 @@ uint16_t AO08_Sensor::readRegister(uint8_t reg) {
 // 核心函数：启动一次转换并读取结果
 int16_t AO08_Sensor::readConversionResult() {
     _lastError = OK;
-    // 1. 写入配置，启动一次转换
-    if (!writeRegister(ADS1115_REG_POINTER_CONFIG, _configWord)) {
+    // 1. 写入配置（PGA 取自动量程选定的档位），启动一次转换
+    _lastPga = _autoRange.getPga();
+    uint16_t config = (_configWord & ~0x0E00) | _autoRange.getConfigBits();
+    if (!writeRegister(ADS1115_REG_POINTER_CONFIG, config)) {
         return 0;
     }
 
@@ -133,7 +146,7 @@ int16_t AO08_Sensor::readConversionResult() {
     }
 
     if (!conversionDone) {
-        Serial.println("[AO08] 错误: ADC 转换超时");
+        LOG_W(AO08) Serial.println("[AO08] 错误: ADC 转换超时");
         _lastError = ERROR_TIMEOUT;
         return 0;
     }
@@ -143,130 +156,238 @@ int16_t AO08_Sensor::readConversionResult() {
 }
 
 // 将 ADC 原始值转换为毫伏
-float AO08_Sensor::adsValToMillivolts(int16_t ads_val) {
-    return (float)ads_val * _mvPerLsb;
+// 16位 ADC (15位 + 符号位), 范围 -32768 到 32767, mV/LSB = 量程(mV) / 32768
+float AO08_Sensor::adsValToMillivolts(int16_t ads_val, uint8_t pga) {
+    return (float)ads_val * PgaAutoRange::fullScaleVolts(pga) * 1000.0f / 32768.0f;
+}
+
+void AO08_Sensor::setAutoRange(bool enable) {
+    std::lock_guard<std::mutex> lock(_acqMutex);
+    _autoRangeEnabled = enable;
+    if (!enable && !_acqRunning.load()) {
+        // 关闭后回到构造时的固定量程
+        _autoRange.setPga((_configWord >> 9) & 0x0007);
+    }
+}
+
+bool AO08_Sensor::isAutoRange() const {
+    return _autoRangeEnabled;
+}
+
+uint8_t AO08_Sensor::getPga() const {
+    std::lock_guard<std::mutex> lock(_acqMutex);
+    return _autoRange.getPga();
+}
+
+uint32_t AO08_Sensor::getRangeSwitchCount() const {
+    std::lock_guard<std::mutex> lock(_acqMutex);
+    return _autoRange.getSwitchCount();
 }
 
 // 读取电压 (mV)
 bool AO08_Sensor::readVoltage(float &voltage_mV) {
+    if (_acqRunning.load()) {
+        std::lock_guard<std::mutex> lock(_acqMutex);
+        if (!_hasFiltered) {
+            _lastError = ERROR_TIMEOUT;
+            return false;
+        }
+        voltage_mV = _filteredVoltage;
+        _lastError = OK;
+        return true;
+    }
+    
     int16_t raw_adc = readConversionResult();
     if (_lastError != OK) {
         return false;
     }
     
-    voltage_mV = adsValToMillivolts(raw_adc);
+    voltage_mV = adsValToMillivolts(raw_adc, _lastPga);
+    
+    // 新档位随下一次转换的配置写入生效
+    if (_autoRangeEnabled) {
+        _autoRange.update(raw_adc, _lastPga);
+    }
     return true;
 }
 
-// 校准零点
-bool AO08_Sensor::calibrateZero(bool saveToStorage) {
-    Serial.println("\n=== AO08 零点校准 ===");
-    Serial.println("请确保传感器引脚已短接，或置于纯氮气中");
-    Serial.println("等待 2 秒后开始测量...");
-    delay(2000);
-
-    // 读取多次并取平均值
-    const int samples = 10;
-    float sum = 0.0f;
-    int validSamples = 0;
-    
-    for (int i = 0; i < samples; i++) {
-        float voltage;
-        if (readVoltage(voltage)) {
-            sum += voltage;
-            validSamples++;
+// 零点：短接后信号几乎立即稳定，窗口标准差 0.02mV（约 2.5 LSB）
+static const CalibrationConfig ZERO_CALIBRATION_CONFIG = {
+    500,        // settleMs
+    15000,      // timeoutMs
+    20,         // window（约 2 秒）
+    0.02f,      // maxStdDev (mV)
+    5           // maxReadFailures
+};
+
+// 空气点：电化学传感器需要更长的稳定时间，窗口标准差 0.05mV（空气中输出的约 0.5%）
+static const CalibrationConfig AIR_CALIBRATION_CONFIG = {
+    2000,       // settleMs
+    60000,      // timeoutMs
+    20,         // window
+    0.05f,      // maxStdDev (mV)
+    5           // maxReadFailures
+};
+
+bool AO08_Sensor::startCalibration(CalibrationPoint point, bool saveToStorage) {
+    if (_calSampler.isRunning()) {
+        return false;
+    }
+    _calPoint = point;
+    _calSave = saveToStorage;
+    _calSampler.start(point == CAL_ZERO ? ZERO_CALIBRATION_CONFIG : AIR_CALIBRATION_CONFIG);
+    return true;
+}
+
+CalibrationSampler::Status AO08_Sensor::stepCalibration() {
+    if (!_calSampler.isRunning()) {
+        return _calSampler.getStatus();
+    }
+
+    float voltage;
+    CalibrationSampler::Status status = readVoltage(voltage)
+        ? _calSampler.addSample(voltage)
+        : _calSampler.addFailure();
+
+    if (status == CalibrationSampler::STABLE) {
+        bool applied = (_calPoint == CAL_ZERO)
+            ? applyZeroCalibration(_calSampler.getMean(), _calSave)
+            : applyAirCalibration(_calSampler.getMean(), _calSave);
+        if (!applied) {
+            _calSampler.reject();
+            return _calSampler.getStatus();
+        }
+    } else if (!_calSampler.isRunning()) {
+        LOG_W(AO08) {
+            Serial.print("[AO08] 校准未完成: ");
+            Serial.print(CalibrationSampler::statusName(status));
+            Serial.print(", 标准差 ");
+            Serial.print(_calSampler.getStdDev(), 4);
+            Serial.println(" mV");
         }
+        _lastError = ERROR_CALIBRATION_FAILED;
+    }
+    return status;
+}
+
+void AO08_Sensor::cancelCalibration() {
+    _calSampler.cancel();
+}
+
+bool AO08_Sensor::isCalibrating() const {
+    return _calSampler.isRunning();
+}
+
+const CalibrationSampler& AO08_Sensor::getCalibrationSampler() const {
+    return _calSampler;
+}
+
+AO08_Sensor::CalibrationPoint AO08_Sensor::getCalibrationPoint() const {
+    return _calPoint;
+}
+
+bool AO08_Sensor::runCalibration(CalibrationPoint point, bool saveToStorage) {
+    if (!startCalibration(point, saveToStorage)) {
+        return false;
+    }
+    CalibrationSampler::Status status;
+    while (true) {
+        status = stepCalibration();
+        if (!_calSampler.isRunning()) break;
         delay(100);
     }
-    
-    if (validSamples == 0) {
-        Serial.println("[AO08] 错误: 零点校准失败 (无法读取ADC)");
+    return status == CalibrationSampler::STABLE;
+}
+
+void AO08_Sensor::saveCalibrationParams() {
+    AO08_CalibrationStorage::CalibrationParams params;
+    params.voltageZero = _voltageZero;
+    params.voltageAir = _voltageAir;
+    params.isValid = true;
+    _storage.saveCalibration(params);
+}
+
+// 校准零点
+bool AO08_Sensor::calibrateZero(bool saveToStorage) {
+    LOG_I(AO08) {
+        Serial.println("\n=== AO08 零点校准 ===");
+        Serial.println("请确保传感器引脚已短接，或置于纯氮气中");
+        Serial.println("等待信号稳定...");
+    }
+
+    if (!runCalibration(CAL_ZERO, saveToStorage)) {
+        LOG_E(AO08) Serial.println("[AO08] 错误: 零点校准失败");
         _lastError = ERROR_CALIBRATION_FAILED;
         return false;
     }
-    
-    _voltageZero = sum / validSamples;
+
+    LOG_I(AO08) Serial.println("=== 零点校准完成 ===\n");
+    return true;
+}
+
+bool AO08_Sensor::applyZeroCalibration(float voltage_mV, bool saveToStorage) {
+    _voltageZero = voltage_mV;
     _isCalibratedZero = true;
     
-    Serial.print("[AO08] 零点电压 (V_zero) 设置为: ");
-    Serial.print(_voltageZero, 4);
-    Serial.println(" mV");
+    LOG_I(AO08) {
+        Serial.print("[AO08] 零点电压 (V_zero) 设置为: ");
+        Serial.print(_voltageZero, 4);
+        Serial.print(" mV (标准差 ");
+        Serial.print(_calSampler.getStdDev(), 4);
+        Serial.println(" mV)");
+    }
     
     // 保存到存储
     if (saveToStorage && _isCalibratedAir) {
         // 如果空气点也已校准，保存完整参数
-        AO08_CalibrationStorage::CalibrationParams params;
-        params.voltageZero = _voltageZero;
-        params.voltageAir = _voltageAir;
-        params.isValid = true;
-        _storage.saveCalibration(params);
+        saveCalibrationParams();
     }
-    
-    Serial.println("=== 零点校准完成 ===\n");
     return true;
 }
 
 // 校准空气点
 bool AO08_Sensor::calibrateAir(bool saveToStorage) {
-    Serial.println("\n=== AO08 空气点校准 ===");
-    Serial.println("请确保传感器已充分暴露于新鲜空气中");
-    Serial.println("等待 30 秒让传感器稳定...");
-    
-    // 显示倒计时
-    for (int i = 30; i > 0; i--) {
-        Serial.print("等待中: ");
-        Serial.print(i);
-        Serial.println(" 秒");
-        delay(1000);
-    }
-    
-    // 读取多次并取平均值
-    const int samples = 10;
-    float sum = 0.0f;
-    int validSamples = 0;
-    
-    for (int i = 0; i < samples; i++) {
-        float voltage;
-        if (readVoltage(voltage)) {
-            sum += voltage;
-            validSamples++;
-        }
-        delay(100);
+    LOG_I(AO08) {
+        Serial.println("\n=== AO08 空气点校准 ===");
+        Serial.println("请确保传感器已充分暴露于新鲜空气中");
+        Serial.println("等待信号稳定（最长 60 秒）...");
     }
     
-    if (validSamples == 0) {
-        Serial.println("[AO08] 错误: 空气点校准失败 (无法读取ADC)");
+    if (!runCalibration(CAL_AIR, saveToStorage)) {
+        LOG_E(AO08) Serial.println("[AO08] 错误: 空气点校准失败");
         _lastError = ERROR_CALIBRATION_FAILED;
         return false;
     }
     
-    _voltageAir = sum / validSamples;
-    _isCalibratedAir = true;
-    
-    Serial.print("[AO08] 空气点电压 (V_air) 设置为: ");
-    Serial.print(_voltageAir, 4);
-    Serial.println(" mV");
+    LOG_I(AO08) Serial.println("=== 空气点校准完成 ===\n");
+    return true;
+}
 
+bool AO08_Sensor::applyAirCalibration(float voltage_mV, bool saveToStorage) {
     // 检查校准是否合理
-    if (_isCalibratedZero && (_voltageAir <= _voltageZero)) {
-        Serial.println("[AO08] 错误: 空气电压必须大于零点电压！");
+    if (_isCalibratedZero && (voltage_mV <= _voltageZero)) {
+        LOG_E(AO08) Serial.println("[AO08] 错误: 空气电压必须大于零点电压！");
         _lastError = ERROR_CALIBRATION_FAILED;
-        _isCalibratedAir = false;
         return false;
     }
     
+    _voltageAir = voltage_mV;
+    _isCalibratedAir = true;
+    
+    LOG_I(AO08) {
+        Serial.print("[AO08] 空气点电压 (V_air) 设置为: ");
+        Serial.print(_voltageAir, 4);
+        Serial.print(" mV (标准差 ");
+        Serial.print(_calSampler.getStdDev(), 4);
+        Serial.println(" mV)");
+    }
+    
     // 保存到存储
     if (saveToStorage && _isCalibratedZero) {
         // 如果零点也已校准，保存完整参数
-        AO08_CalibrationStorage::CalibrationParams params;
-        params.voltageZero = _voltageZero;
-        params.voltageAir = _voltageAir;
-        params.isValid = true;
-        _storage.saveCalibration(params);
-        Serial.println("[AO08] 校准参数已保存到非易失性存储");
+        saveCalibrationParams();
+        LOG_I(AO08) Serial.println("[AO08] 校准参数已保存到非易失性存储");
     }
-    
-    Serial.println("=== 空气点校准完成 ===\n");
     return true;
 }
 
@@ -320,3 +441,208 @@ bool AO08_Sensor::readOxygenPercentage(float &oxygen_percent) {
 }
 
 
+
+// ============================================================================
+// 高速采集
+// ============================================================================
+
+// ADS1115 数据速率档位 (SPS)，下标即 DR 位
+static const uint16_t ADS1115_DATA_RATES[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+
+bool AO08_Sensor::startAcquisition(const DecimationConfig& config, int rdyPin) {
+    if (_acqRunning.load()) {
+        return true;
+    }
+    if (_calSampler.isRunning()) {
+        LOG_W(AO08) Serial.println("[AO08] 校准进行中，不能切换采集模式");
+        return false;
+    }
+    
+    // 选择不低于请求速率的最接近档位
+    uint8_t dr = 7;
+    for (uint8_t i = 0; i < 8; i++) {
+        if (ADS1115_DATA_RATES[i] >= config.inputRate) {
+            dr = i;
+            break;
+        }
+    }
+    DecimationConfig filterConfig = config;
+    filterConfig.inputRate = ADS1115_DATA_RATES[dr];
+    
+    // 连续模式：保留 MUX 与 PGA，清除 OS/MODE，设置数据速率
+    uint16_t comparator = 0x0003;  // 禁用比较器
+    if (rdyPin >= 0) {
+        // ALERT/RDY 作为转换完成信号：Hi_thresh 最高位 1、Lo_thresh 最高位 0，每次转换触发
+        if (!writeRegister(ADS1115_REG_POINTER_HI_THRESH, 0x8000) ||
+            !writeRegister(ADS1115_REG_POINTER_LO_THRESH, 0x0000)) {
+            LOG_E(AO08) Serial.println("[AO08] 错误: 写阈值寄存器失败");
+            return false;
+        }
+        comparator = 0x0000;
+    }
+    uint16_t continuousConfig = (_configWord & 0x7000) | _autoRange.getConfigBits() |
+                                ((uint16_t)dr << 5) | comparator;
+    if (!writeRegister(ADS1115_REG_POINTER_CONFIG, continuousConfig)) {
+        LOG_E(AO08) Serial.println("[AO08] 错误: 启动连续转换失败");
+        return false;
+    }
+    
+    // 指针停在转换寄存器，之后每个样本只是一次 2 字节读取
+    Wire.beginTransmission(_adsAddress);
+    Wire.write(ADS1115_REG_POINTER_CONVERT);
+    if (Wire.endTransmission() != 0) {
+        _lastError = ERROR_I2C;
+        return false;
+    }
+    
+    if (rdyPin >= 0) {
+        _acqRdy = new GPIO(rdyPin);
+        _acqRdy->pinMode(INPUT);
+        _acqRdy->setEdge("falling");
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(_acqMutex);
+        _filter.configure(filterConfig);
+        _hasFiltered = false;
+        _acqStats = AcquisitionStats();
+        _acqStats.outputRate = _filter.getOutputRate();
+        _acqStats.latencyMs = _filter.getLatencyMs();
+    }
+    
+    _acqRunning = true;
+    _acqThread = std::thread(&AO08_Sensor::acquisitionLoop, this, continuousConfig,
+                             1000000UL / ADS1115_DATA_RATES[dr]);
+    
+    LOG_I(AO08) {
+        Serial.print("[AO08] 高速采集已启动: ");
+        Serial.print(ADS1115_DATA_RATES[dr]);
+        Serial.print(" SPS -> ");
+        Serial.print(_acqStats.outputRate, 1);
+        Serial.print(" Hz, 延迟 ");
+        Serial.print(_acqStats.latencyMs, 1);
+        Serial.println(" ms");
+    }
+    
+    // 等待滤波器输出第一个样本（CIC 需要 N+1 个抽取周期填满）
+    unsigned long timeoutMs = (unsigned long)((filterConfig.stages + 2) * 1000.0f / _acqStats.outputRate) + 100;
+    unsigned long startMs = millis();
+    while (millis() - startMs < timeoutMs) {
+        {
+            std::lock_guard<std::mutex> lock(_acqMutex);
+            if (_hasFiltered) {
+                return true;
+            }
+        }
+        delay(10);
+    }
+    LOG_W(AO08) Serial.println("[AO08] 警告: 高速采集尚无输出");
+    return true;
+}
+
+void AO08_Sensor::stopAcquisition() {
+    if (!_acqRunning.load()) {
+        return;
+    }
+    _acqRunning = false;
+    if (_acqThread.joinable()) {
+        _acqThread.join();
+    }
+    delete _acqRdy;
+    _acqRdy = nullptr;
+    
+    // 回到单次转换模式（不置 OS，芯片保持掉电），恢复默认阈值
+    writeRegister(ADS1115_REG_POINTER_CONFIG, _configWord & ~0x8000);
+    writeRegister(ADS1115_REG_POINTER_HI_THRESH, 0x7FFF);
+    writeRegister(ADS1115_REG_POINTER_LO_THRESH, 0x8000);
+    LOG_I(AO08) Serial.println("[AO08] 高速采集已停止");
+}
+
+bool AO08_Sensor::isAcquiring() const {
+    return _acqRunning.load();
+}
+
+AO08_Sensor::AcquisitionStats AO08_Sensor::getAcquisitionStats() const {
+    std::lock_guard<std::mutex> lock(_acqMutex);
+    return _acqStats;
+}
+
+void AO08_Sensor::acquisitionLoop(uint16_t config, unsigned long periodUs) {
+    // 滤波器输入统一换算为 ±0.256V 档的 LSB，切换量程不会在输出上造成台阶
+    const float finestVolts = PgaAutoRange::fullScaleVolts(PGA_RANGE_COUNT - 1);
+    const float mvPerUnit = finestVolts * 1000.0f / 32768.0f;
+    uint8_t pga = (config >> 9) & 0x0007;
+    
+    unsigned long nextUs = micros();
+    unsigned long rateStartUs = nextUs;
+    uint32_t rateCount = 0;
+    
+    while (_acqRunning.load()) {
+        // 等待下一个转换结果
+        if (_acqRdy && _acqRdy->waitForEdge(10) == 0) {
+            continue;
+        }
+        if (!_acqRdy) {
+            nextUs += periodUs;
+            long waitUs = (long)(nextUs - micros());
+            if (waitUs > 0) {
+                delayMicroseconds(waitUs);
+            } else if (waitUs < -(long)(10 * periodUs)) {
+                // 落后太多（线程被长时间挂起），重新对齐而不是追赶
+                nextUs = micros();
+            }
+        }
+        
+        selectMuxChannel();
+        bool ok = Wire.requestFrom(_adsAddress, (uint8_t)2) == 2;
+        int16_t raw = 0;
+        if (ok) {
+            raw = (int16_t)((Wire.read() << 8) | Wire.read());
+        }
+        
+        std::unique_lock<std::mutex> lock(_acqMutex);
+        if (!ok) {
+            _acqStats.readErrors++;
+            continue;
+        }
+        
+        double out;
+        _acqStats.samples++;
+        double scaled = raw * (PgaAutoRange::fullScaleVolts(pga) / finestVolts);
+        if (_filter.push(scaled, out)) {
+            _filteredVoltage = (float)(out * mvPerUnit);
+            _hasFiltered = true;
+            _acqStats.outputs++;
+            _acqStats.inputNoise_mV = _filter.getInputNoise() * mvPerUnit;
+            _acqStats.outputNoise_mV = _filter.getOutputNoise() * mvPerUnit;
+            _acqStats.noiseValid = _filter.isNoiseValid();
+        }
+        
+        rateCount++;
+        unsigned long nowUs = micros();
+        if (nowUs - rateStartUs >= 1000000UL) {
+            _acqStats.inputRate = rateCount * 1e6f / (nowUs - rateStartUs);
+            rateCount = 0;
+            rateStartUs = nowUs;
+        }
+        
+        if (!_autoRangeEnabled || !_autoRange.update(raw, pga)) {
+            continue;
+        }
+        pga = _autoRange.getPga();
+        _acqStats.rangeSwitches = _autoRange.getSwitchCount();
+        lock.unlock();
+        
+        // 写入新 PGA（芯片从头开始转换）。转换寄存器里此时仍是旧档位的结果，
+        // 所以清掉残留的 RDY 边沿，并从写入时刻起至少等一个完整周期再读
+        config = (config & ~0x0E00) | ((uint16_t)pga << 9);
+        writeRegister(ADS1115_REG_POINTER_CONFIG, config);
+        Wire.beginTransmission(_adsAddress);
+        Wire.write(ADS1115_REG_POINTER_CONVERT);
+        Wire.endTransmission();
+        if (_acqRdy) {
+            _acqRdy->waitForEdge(0);
+        }
+        nextUs = micros() + periodUs / 10 + 50;
+    }
+}
@@ -4,6 +4,12 @@
 #include "LuckfoxArduino.h"
 #include "I2CMux.h"
 #include "AO08_CalibrationStorage.h"
+#include "CalibrationSampler.h"
+#include "DecimationFilter.h"
+#include "PgaAutoRange.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 /**
  * @class AO08_Sensor
@@ -22,6 +28,27 @@ public:
         ERROR_CALIBRATION_FAILED // 校准失败
     };
 
+    enum CalibrationPoint {
+        CAL_ZERO = 0,           // 零点（Vsensor+/- 短接或纯氮气）
+        CAL_AIR                 // 空气点（20.9% O2）
+    };
+
+    /**
+     * @brief 高速采集统计
+     */
+    struct AcquisitionStats {
+        float inputRate;        ///< 实测输入样本率 (SPS)
+        float outputRate;       ///< 输出率 (Hz)
+        float latencyMs;        ///< 滤波群延迟 (ms)
+        float inputNoise_mV;    ///< 原始样本噪声（窗口标准差, mV）
+        float outputNoise_mV;   ///< 抽取后噪声（窗口标准差, mV）
+        bool noiseValid;        ///< 统计窗口已填满
+        uint32_t samples;       ///< 累计输入样本数
+        uint32_t outputs;       ///< 累计输出样本数
+        uint32_t readErrors;    ///< I2C 读取失败次数
+        uint32_t rangeSwitches; ///< PGA 自动量程切换次数
+    };
+
     /**
      * @brief 构造函数
      * @param mux_ptr 指向 I2CMux 多路复用器的指针（可为 nullptr）
@@ -29,6 +56,9 @@ public:
      * @param adsAddress ADS1115 的 I2C 地址 (默认为 0x48)
      */
     AO08_Sensor(I2CMux* mux_ptr, uint8_t muxChannel, uint8_t adsAddress = 0x48);
+    ~AO08_Sensor();
+    AO08_Sensor(const AO08_Sensor&) = delete;
+    AO08_Sensor& operator=(const AO08_Sensor&) = delete;
 
     /**
      * @brief 初始化 ADS1115 (检查 I2C 连接)
@@ -38,13 +68,40 @@ public:
 
     /**
      * @brief 读取传感器原始的差分电压 (单位: mV)
+     * @note 高速采集运行时返回最新的抽取滤波输出，不访问 I2C
      * @param voltage_mV 输出读取到的电压值 (毫伏)
      * @return true 读取成功, false 失败
      */
     bool readVoltage(float &voltage_mV);
 
     /**
-     * @brief 执行零点校准并保存参数
+     * @brief 启动高速采集：ADS1115 以连续模式运行在 ±0.256V 量程，后台线程读取每个样本
+     *        并送入 CIC 抽取滤波（可选工频陷波），得到低噪声、延迟已知的电压流
+     * @note 数据速率取不低于 config.inputRate 的最接近档位（默认 860 SPS）；
+     *       采集期间 ADS1115 及其 Mux 通道由采集线程独占。返回前等待第一个输出样本。
+     * @param config 抽取滤波配置
+     * @param rdyPin ALERT/RDY 所接 GPIO 编号，-1 表示按转换周期计时读取
+     * @return true 启动成功
+     */
+    bool startAcquisition(const DecimationConfig& config = DEFAULT_DECIMATION_CONFIG, int rdyPin = -1);
+
+    /**
+     * @brief 停止高速采集，ADS1115 回到单次转换（掉电）模式
+     */
+    void stopAcquisition();
+
+    /**
+     * @brief 高速采集是否在运行
+     */
+    bool isAcquiring() const;
+
+    /**
+     * @brief 高速采集统计（样本率、延迟、输入/输出噪声底）
+     */
+    AcquisitionStats getAcquisitionStats() const;
+
+    /**
+     * @brief 执行零点校准并保存参数（阻塞，信号稳定后立即返回）
      * @note 执行此操作前，必须将 Vsensor+ 和 Vsensor- 短接
      * @param saveToStorage 是否保存到非易失性存储（默认: true）
      * @return true 校准成功
@@ -52,13 +109,70 @@ public:
     bool calibrateZero(bool saveToStorage = true);
 
     /**
-     * @brief 执行空气点校准 (20.9% O2) 并保存参数
+     * @brief 执行空气点校准 (20.9% O2) 并保存参数（阻塞，信号稳定后立即返回）
      * @note 执行此操作前，必须将传感器暴露在新鲜空气中
      * @param saveToStorage 是否保存到非易失性存储（默认: true）
      * @return true 校准成功
      */
     bool calibrateAir(bool saveToStorage = true);
 
+    /**
+     * @brief 开始非阻塞校准
+     * @note 之后由调用方周期性调用 stepCalibration()（建议间隔约 100ms），直到其返回的状态不再是进行中
+     * @param point 校准点
+     * @param saveToStorage 完成后是否保存到非易失性存储
+     * @return false 已有校准在进行中
+     */
+    bool startCalibration(CalibrationPoint point, bool saveToStorage = true);
+
+    /**
+     * @brief 读取一次 ADC 并推进校准
+     * @return 采样器状态；STABLE 表示校准参数已更新，其余完成状态表示失败
+     */
+    CalibrationSampler::Status stepCalibration();
+
+    /**
+     * @brief 取消进行中的校准，已有校准参数保持不变
+     */
+    void cancelCalibration();
+
+    /**
+     * @brief 是否有校准正在进行
+     */
+    bool isCalibrating() const;
+
+    /**
+     * @brief 当前校准的采样统计（进度、均值、标准差、稳定度）
+     */
+    const CalibrationSampler& getCalibrationSampler() const;
+
+    /**
+     * @brief 当前（或最近一次）校准的校准点
+     */
+    CalibrationPoint getCalibrationPoint() const;
+
+    /**
+     * @brief 启用/关闭 PGA 自动量程（默认启用，从 ±0.256V 开始）
+     * @note 只根据已完成的转换结果为下一次转换选档，带回差，不会为选档额外转换；
+     *       电压换算始终使用产生该结果的档位，对调用方透明
+     */
+    void setAutoRange(bool enable);
+
+    /**
+     * @brief 是否启用了自动量程
+     */
+    bool isAutoRange() const;
+
+    /**
+     * @brief 当前 PGA 档位（0 = ±6.144V ... 5 = ±0.256V）
+     */
+    uint8_t getPga() const;
+
+    /**
+     * @brief 自动量程累计切换次数
+     */
+    uint32_t getRangeSwitchCount() const;
+
     /**
      * @brief 从存储中加载校准参数
      * @return true 加载成功, false 加载失败或参数无效
@@ -104,8 +218,19 @@ private:
     // 获取 ADC 原始读数
     int16_t readConversionResult();
     
-    // 将 ADC 原始值根据当前增益转换为毫伏
-    float adsValToMillivolts(int16_t ads_val);
+    // 将 ADC 原始值按产生它的 PGA 档位转换为毫伏
+    float adsValToMillivolts(int16_t ads_val, uint8_t pga);
+
+    // 应用校准结果（检查合理性并按需保存）
+    bool applyZeroCalibration(float voltage_mV, bool saveToStorage);
+    bool applyAirCalibration(float voltage_mV, bool saveToStorage);
+    void saveCalibrationParams();
+
+    // 阻塞式校准的公共循环
+    bool runCalibration(CalibrationPoint point, bool saveToStorage);
+
+    // 高速采集线程
+    void acquisitionLoop(uint16_t config, unsigned long periodUs);
 
     I2CMux* _mux;
     uint8_t _muxChannel;
@@ -119,15 +244,36 @@ private:
     bool _isCalibratedAir;
 
     // ADS1115 配置
-    uint16_t _configWord; // 存储我们的标准配置
-    float _mvPerLsb;      // 根据增益计算 LSB 代表的毫伏数
+    uint16_t _configWord; // 存储我们的标准配置（PGA 位由自动量程决定）
+    
+    // PGA 自动量程（采集期间由 _acqMutex 保护）
+    PgaAutoRange _autoRange;
+    bool _autoRangeEnabled;
+    uint8_t _lastPga;     // 最近一个结果所用的档位
     
     // 参数存储
     AO08_CalibrationStorage _storage;
+
+    // 非阻塞校准状态
+    CalibrationSampler _calSampler;
+    CalibrationPoint _calPoint;
+    bool _calSave;
+
+    // 高速采集状态（_acqMutex 保护滤波器与统计）
+    std::thread _acqThread;
+    std::atomic<bool> _acqRunning;
+    mutable std::mutex _acqMutex;
+    DecimationFilter _filter;
+    GPIO* _acqRdy;
+    float _filteredVoltage;
+    bool _hasFiltered;
+    AcquisitionStats _acqStats;
     
     // ADS1115 寄存器地址
     static const uint8_t ADS1115_REG_POINTER_CONVERT = 0x00;
     static const uint8_t ADS1115_REG_POINTER_CONFIG = 0x01;
+    static const uint8_t ADS1115_REG_POINTER_LO_THRESH = 0x02;
+    static const uint8_t ADS1115_REG_POINTER_HI_THRESH = 0x03;
 };
 
 #endif // AO08_SENSOR_H
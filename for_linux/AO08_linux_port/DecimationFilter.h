@@ -0,0 +1,231 @@
+#ifndef DecimationFilter_h
+#define DecimationFilter_h
+
+#include "LuckfoxArduino.h"
+#include <cmath>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+/**
+ * @brief 抽取滤波配置
+ */
+struct DecimationConfig {
+    float inputRate;        ///< 输入采样率 (Hz)，即 ADS1115 数据速率
+    uint16_t decimation;    ///< 抽取倍数 R，输出率 = inputRate / R
+    uint8_t stages;         ///< CIC 级数 N（1..DECIMATION_MAX_STAGES）
+    float notchHz;          ///< 工频陷波频率（50/60），0 表示不启用
+    float notchQ;           ///< 陷波品质因数
+    uint8_t noiseWindow;    ///< 噪声统计窗口（样本数，<= NOISE_MAX_WINDOW）
+};
+
+constexpr uint8_t DECIMATION_MAX_STAGES = 4;
+constexpr uint8_t NOISE_MAX_WINDOW = 128;
+
+/**
+ * @brief 默认配置：860 SPS 输入，R = 86 得到 10 Hz 输出
+ *
+ * CIC 的零点位于输出率的整数倍（10、20 ... Hz），50 Hz 与 60 Hz 工频都正好落在零点上，
+ * 因此默认不再额外启用陷波；改用其他抽取倍数时可打开 notchHz。
+ */
+static const DecimationConfig DEFAULT_DECIMATION_CONFIG = {
+    860.0f,     // inputRate
+    86,         // decimation
+    3,          // stages
+    0.0f,       // notchHz
+    5.0f,       // notchQ
+    50          // noiseWindow
+};
+
+/**
+ * @class SlidingNoise
+ * @brief 最近 N 个样本的滑动标准差（Welford 增删），用作噪声底统计
+ */
+class SlidingNoise {
+public:
+    SlidingNoise() : _window(NOISE_MAX_WINDOW) { reset(); }
+
+    void setWindow(uint8_t window) {
+        _window = window < 2 ? 2 : (window > NOISE_MAX_WINDOW ? NOISE_MAX_WINDOW : window);
+        reset();
+    }
+
+    void reset() {
+        _head = 0;
+        _count = 0;
+        _mean = 0.0;
+        _m2 = 0.0;
+    }
+
+    void add(double value) {
+        if (_count == _window) {
+            double old = _buffer[_head];
+            double delta = old - _mean;
+            _mean -= delta / (_count - 1);
+            _m2 -= delta * (old - _mean);
+            _count--;
+            if (_m2 < 0.0) _m2 = 0.0;
+        }
+        _buffer[_head] = value;
+        _head = (_head + 1) % _window;
+        _count++;
+        double delta = value - _mean;
+        _mean += delta / _count;
+        _m2 += delta * (value - _mean);
+    }
+
+    bool isFull() const { return _count == _window; }
+    double getMean() const { return _mean; }
+    double getStdDev() const {
+        return _count < 2 ? 0.0 : std::sqrt(_m2 / (_count - 1));
+    }
+
+private:
+    double _buffer[NOISE_MAX_WINDOW];
+    uint8_t _window;
+    uint8_t _head;
+    uint8_t _count;
+    double _mean;
+    double _m2;
+};
+
+/**
+ * @class DecimationFilter
+ * @brief 过采样抽取滤波：可选工频陷波（双二阶）+ N 级 CIC 抽取
+ *
+ * 输入为 ADC 原始码（可带小数，陷波输出即为小数），内部以 1/16 LSB 定点进入 CIC，
+ * 积分器使用无符号 64 位回绕运算，长时间运行不会漂移。输出单位与输入相同，
+ * 直流增益为 1。白噪声条件下输出噪声约为输入的 1/sqrt(R)。
+ */
+class DecimationFilter {
+public:
+    DecimationFilter() { configure(DEFAULT_DECIMATION_CONFIG); }
+
+    void configure(const DecimationConfig& config) {
+        _config = config;
+        if (_config.decimation < 1) _config.decimation = 1;
+        if (_config.stages < 1) _config.stages = 1;
+        if (_config.stages > DECIMATION_MAX_STAGES) _config.stages = DECIMATION_MAX_STAGES;
+
+        // CIC 增益 R^N，再加上 1/16 LSB 的定点缩放
+        _gain = FIXED_SCALE;
+        for (uint8_t i = 0; i < _config.stages; i++) {
+            _gain *= _config.decimation;
+        }
+
+        // RBJ 陷波系数（a0 归一化）
+        _notchEnabled = _config.notchHz > 0.0f && _config.notchHz < _config.inputRate / 2.0f;
+        if (_notchEnabled) {
+            double w0 = 2.0 * M_PI * _config.notchHz / _config.inputRate;
+            double cosw = std::cos(w0);
+            double alpha = std::sin(w0) / (2.0 * (_config.notchQ > 0.0f ? _config.notchQ : 5.0f));
+            double a0 = 1.0 + alpha;
+            _b0 = 1.0 / a0;
+            _b1 = -2.0 * cosw / a0;
+            _b2 = 1.0 / a0;
+            _a1 = -2.0 * cosw / a0;
+            _a2 = (1.0 - alpha) / a0;
+            // 陷波器在直流附近的群延迟（样本）= alpha / (1 - cos w0)
+            _notchDelay = alpha / (1.0 - cosw);
+        } else {
+            _notchDelay = 0.0;
+        }
+
+        _inputNoise.setWindow(_config.noiseWindow);
+        _outputNoise.setWindow(_config.noiseWindow);
+        reset();
+    }
+
+    void reset() {
+        for (uint8_t i = 0; i < DECIMATION_MAX_STAGES; i++) {
+            _integrator[i] = 0;
+            _comb[i] = 0;
+        }
+        _phase = 0;
+        _primed = 0;
+        _x1 = _x2 = _y1 = _y2 = 0.0;
+        _inputNoise.reset();
+        _outputNoise.reset();
+    }
+
+    /**
+     * @brief 送入一个输入样本
+     * @param out 产生输出样本时写入
+     * @return true 本次产生了一个输出样本
+     */
+    bool push(double x, double& out) {
+        _inputNoise.add(x);
+
+        if (_notchEnabled) {
+            double y = _b0 * x + _b1 * _x1 + _b2 * _x2 - _a1 * _y1 - _a2 * _y2;
+            _x2 = _x1; _x1 = x;
+            _y2 = _y1; _y1 = y;
+            x = y;
+        }
+
+        // 积分器（以输入速率运行）
+        uint64_t v = (uint64_t)(int64_t)std::llround(x * FIXED_SCALE);
+        for (uint8_t i = 0; i < _config.stages; i++) {
+            _integrator[i] += v;
+            v = _integrator[i];
+        }
+
+        if (++_phase < _config.decimation) {
+            return false;
+        }
+        _phase = 0;
+
+        // 梳状器（以输出速率运行，差分延迟 M = 1）
+        for (uint8_t i = 0; i < _config.stages; i++) {
+            uint64_t prev = _comb[i];
+            _comb[i] = v;
+            v -= prev;
+        }
+
+        // 前 N 个输出的梳状器历史不完整，丢弃
+        if (_primed < _config.stages) {
+            _primed++;
+            return false;
+        }
+
+        out = (double)(int64_t)v / _gain;
+        _outputNoise.add(out);
+        return true;
+    }
+
+    float getOutputRate() const { return _config.inputRate / _config.decimation; }
+
+    /** @brief 直流附近的群延迟（毫秒）：CIC N(R-1)/2 个输入样本 + 陷波器 */
+    float getLatencyMs() const {
+        double samples = _config.stages * (_config.decimation - 1) / 2.0 + _notchDelay;
+        return (float)(samples * 1000.0 / _config.inputRate);
+    }
+
+    /** @brief 输入/输出在统计窗口内的标准差（与输入同单位） */
+    float getInputNoise() const { return (float)_inputNoise.getStdDev(); }
+    float getOutputNoise() const { return (float)_outputNoise.getStdDev(); }
+    bool isNoiseValid() const { return _outputNoise.isFull(); }
+
+    const DecimationConfig& getConfig() const { return _config; }
+
+private:
+    static constexpr double FIXED_SCALE = 16.0;
+
+    DecimationConfig _config;
+    double _gain;
+
+    uint64_t _integrator[DECIMATION_MAX_STAGES];
+    uint64_t _comb[DECIMATION_MAX_STAGES];
+    uint16_t _phase;
+    uint8_t _primed;
+
+    bool _notchEnabled;
+    double _b0, _b1, _b2, _a1, _a2;
+    double _x1, _x2, _y1, _y2;
+    double _notchDelay;
+
+    SlidingNoise _inputNoise;
+    SlidingNoise _outputNoise;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "I2CMux.h"
+#include "LogModules.h"
 using namespace ArduinoHAL;
 
 I2CMux::I2CMux(uint8_t address) 
@@ -16,7 +17,7 @@ void I2CMux::begin(I2C* wire) {
     }
     // Disable all channels at start
     disableAllChannels();
-    Serial.println("I2C Multiplexer initialized");
+    LOG_I(MUX) Serial.println("I2C Multiplexer initialized");
 }
 
 void I2CMux::setAddress(uint8_t address) {
@@ -113,7 +114,7 @@ void I2CMux::resetI2CBus() {
     Wire.begin();
     Wire.setClock(400000);
     
-    Serial.println("I2C总线已重置");
+    LOG_I(MUX) Serial.println("I2C总线已重置");
 }
 
 void I2CMux::scanI2CDevices() {
@@ -168,13 +169,13 @@ void I2CMux::scanI2CDevices() {
 void I2CMux::lockOLEDChannel() {
     // 选择OLED通道并保持锁定状态
     selectChannel(2); // OLED现在在通道2
-    Serial.println("OLED通道已锁定");
+    LOG_D(MUX) Serial.println("OLED通道已锁定");
 }
 
 void I2CMux::unlockOLEDChannel() {
     // 禁用所有通道，释放锁定
     disableAllChannels();
-    Serial.println("OLED通道已解锁");
+    LOG_D(MUX) Serial.println("OLED通道已解锁");
 }
 
 
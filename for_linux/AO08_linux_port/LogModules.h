@@ -0,0 +1,19 @@
+#ifndef LogModules_h
+#define LogModules_h
+
+#include "LuckfoxArduino.h"
+
+// 各模块的编译期日志级别（LOG_LEVEL_NONE/ERROR/WARN/INFO/DEBUG/TRACE）
+// 未单独指定的模块取 LOG_LEVEL_DEFAULT；make LOG_LEVEL=debug 整体调整，
+// 单个模块用 make LOG_FLAGS="-DLOG_AO08_LEVEL=LOG_LEVEL_DEBUG"。
+//   MUX     I2CMux
+//   AO08    AO08 传感器与校准参数存储
+
+#ifndef LOG_MUX_LEVEL
+#define LOG_MUX_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_AO08_LEVEL
+#define LOG_AO08_LEVEL LOG_LEVEL_DEFAULT
+#endif
+
+#endif
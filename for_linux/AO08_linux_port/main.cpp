@@ -173,6 +173,34 @@ void testVoltageReading() {
     std::cout << "==================\n" << std::endl;
 }
 
+/**
+ * @brief 显示高速采集统计
+ */
+void printAcquisitionStats() {
+    if (!oxygenSensor.isAcquiring()) {
+        std::cout << "\n高速采集未运行，输入 'fast' 启动\n" << std::endl;
+        return;
+    }
+    AO08_Sensor::AcquisitionStats stats = oxygenSensor.getAcquisitionStats();
+    std::cout << "\n=== 高速采集统计 ===" << std::endl;
+    std::cout << "输入样本率: " << stats.inputRate << " SPS" << std::endl;
+    std::cout << "输出率: " << stats.outputRate << " Hz, 群延迟: " << stats.latencyMs << " ms" << std::endl;
+    std::cout << "原始噪声: " << stats.inputNoise_mV * 1000.0f << " uV (标准差)" << std::endl;
+    std::cout << "滤波后噪声: " << stats.outputNoise_mV * 1000.0f << " uV (标准差)";
+    if (!stats.noiseValid) {
+        std::cout << " [统计窗口未满]";
+    }
+    std::cout << std::endl;
+    if (stats.outputNoise_mV > 0.0f) {
+        std::cout << "噪声改善: " << stats.inputNoise_mV / stats.outputNoise_mV << " 倍" << std::endl;
+    }
+    std::cout << "样本: " << stats.samples << ", 输出: " << stats.outputs
+              << ", 读取失败: " << stats.readErrors << std::endl;
+    std::cout << "PGA 档位: " << (int)oxygenSensor.getPga()
+              << ", 量程切换: " << stats.rangeSwitches << " 次" << std::endl;
+    std::cout << "====================\n" << std::endl;
+}
+
 /**
  * @brief 显示帮助信息
  */
@@ -181,6 +209,8 @@ void showHelp() {
     std::cout << "cal / calibrate  - 执行校准流程" << std::endl;
     std::cout << "info / status   - 显示校准参数" << std::endl;
     std::cout << "test / voltage  - 测试电压读取" << std::endl;
+    std::cout << "fast            - 切换高速采集（860 SPS 过采样 + CIC 抽取）" << std::endl;
+    std::cout << "noise           - 显示高速采集的噪声底与延迟" << std::endl;
     std::cout << "clear           - 清除已保存的校准参数" << std::endl;
     std::cout << "help            - 显示此帮助信息" << std::endl;
     std::cout << "exit / quit     - 退出程序" << std::endl;
@@ -229,6 +259,14 @@ bool handleCommands() {
         }
     } else if (command == "test" || command == "voltage") {
         testVoltageReading();
+    } else if (command == "fast") {
+        if (oxygenSensor.isAcquiring()) {
+            oxygenSensor.stopAcquisition();
+        } else if (!oxygenSensor.startAcquisition()) {
+            std::cout << "高速采集启动失败" << std::endl;
+        }
+    } else if (command == "noise") {
+        printAcquisitionStats();
     } else if (command == "exit" || command == "quit") {
         std::cout << "\n退出程序..." << std::endl;
         return false;
@@ -310,6 +348,8 @@ void readSensorData() {
 
 void setup() {
     Serial.begin(115200);
+    // 交互式工具：驱动输出与下面的 std::cout 提示交替出现，日志按调用顺序同步写出
+    logSink().setSynchronous(true);
     
     delay(1000);
     
@@ -1,27 +1,38 @@
 #include "ADS1115.h"
+#include "LogModules.h"
 
 // 构造函数
 ADS1115::ADS1115(uint8_t address, I2CMux* mux, uint8_t channel) 
-    : _address(address), _mux(mux), _channel(channel), _currentConfig(ADS1115_DEFAULT_CONFIG) {
+    : _address(address), _mux(mux), _channel(channel), _currentConfig(ADS1115_DEFAULT_CONFIG),
+      _continuous(false), _rdyGpio(nullptr), _pointerReg(0xFF), _lastSampleUs(0),
+      _autoRangeEnabled(false), _lastPga((ADS1115_DEFAULT_CONFIG >> 9) & 0x0007) {
     _i2cPort = nullptr;
 }
 
+ADS1115::~ADS1115() {
+    delete _rdyGpio;
+}
+
 // 初始化
 bool ADS1115::begin(I2C* wirePort) {
     _i2cPort = wirePort;
     
     // 检查连接
     if (!isConnected()) {
-        Serial.print("ADS1115: 无法连接到地址 0x");
-        Serial.println(_address, HEX);
+        LOG_W(ADS) {
+            Serial.print("ADS1115: 无法连接到地址 0x");
+            Serial.println(_address, HEX);
+        }
         return false;
     }
     
     // 配置默认值
     configure();
     
-    Serial.print("ADS1115: 初始化成功，地址 0x");
-    Serial.println(_address, HEX);
+    LOG_I(ADS) {
+        Serial.print("ADS1115: 初始化成功，地址 0x");
+        Serial.println(_address, HEX);
+    }
     
     return true;
 }
@@ -63,6 +74,7 @@ bool ADS1115::writeRegister(uint8_t reg, uint16_t value) {
     _i2cPort->write((uint8_t)(value >> 8));   // 高字节
     _i2cPort->write((uint8_t)(value & 0xFF)); // 低字节
     uint8_t error = _i2cPort->endTransmission();
+    _pointerReg = (error == 0) ? reg : 0xFF;
     
     return (error == 0);
 }
@@ -76,8 +88,10 @@ uint16_t ADS1115::readRegister(uint8_t reg) {
     _i2cPort->beginTransmission(_address);
     _i2cPort->write(reg);
     if (_i2cPort->endTransmission() != 0) {
+        _pointerReg = 0xFF;
         return 0;
     }
+    _pointerReg = reg;
     
     uint8_t bytesRead = _i2cPort->requestFrom(_address, (uint8_t)2);
     if (bytesRead != 2) {
@@ -125,8 +139,222 @@ bool ADS1115::waitForConversion(unsigned long timeout) {
     return false; // 超时
 }
 
+// 配置字对应的转换周期
+unsigned long ADS1115::conversionPeriodUs(uint16_t config) {
+    static const unsigned int SPS[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+    return 1000000UL / SPS[(config >> 5) & 0x0007];
+}
+
+// 配置字对应的满量程电压
+float ADS1115::fullScaleVolts(uint16_t config) {
+    switch ((config >> 9) & 0x0007) {
+        case 0: return 6.144f;
+        case 1: return 4.096f;
+        case 2: return 2.048f;
+        case 3: return 1.024f;
+        case 4: return 0.512f;
+        default: return 0.256f;  // 5..7 均为 ±0.256V
+    }
+}
+
+// 当前数据速率下的转换周期
+unsigned long ADS1115::getConversionPeriodUs() const {
+    return conversionPeriodUs(_currentConfig);
+}
+
+// 配置 ALERT/RDY 转换完成信号
+bool ADS1115::enableReadyPin(int rdyPin) {
+    // 阈值寄存器写入 RDY 模式所需的值（不用 RDY 引脚时无害）
+    if (!writeRegister(ADS1115_REG_HI_THRESH, ADS1115_RDY_HI_THRESH) ||
+        !writeRegister(ADS1115_REG_LO_THRESH, ADS1115_RDY_LO_THRESH)) {
+        LOG_W(ADS) Serial.println("ADS1115: 写阈值寄存器失败");
+        return false;
+    }
+    
+    delete _rdyGpio;
+    _rdyGpio = nullptr;
+    if (rdyPin >= 0) {
+        _rdyGpio = new GPIO(rdyPin);
+        _rdyGpio->pinMode(INPUT);
+        _rdyGpio->setEdge("falling");
+    }
+    return true;
+}
+
+// 等待 RDY 边沿
+int ADS1115::waitForReady(int timeoutMs) {
+    if (!_rdyGpio) {
+        return -1;
+    }
+    int ret = _rdyGpio->waitForEdge(timeoutMs);
+    if (ret < 0) {
+        // GPIO 不可用，之后退回计时方式
+        delete _rdyGpio;
+        _rdyGpio = nullptr;
+    }
+    return ret;
+}
+
+// 启动单次转换
+bool ADS1115::startConversion(uint16_t config) {
+    config |= ADS1115_OS_BUSY | ADS1115_MODE_SINGLE;
+    if (!writeRegister(ADS1115_REG_CONFIG, config)) {
+        return false;
+    }
+    
+    // 转换期间先把指针移回转换寄存器，结果就绪后只需一次读取
+    pointToConversion();
+    return true;
+}
+
+// 把寄存器指针移到转换寄存器
+bool ADS1115::pointToConversion() {
+    _i2cPort->beginTransmission(_address);
+    _i2cPort->write(ADS1115_REG_CONVERSION);
+    bool ok = (_i2cPort->endTransmission() == 0);
+    _pointerReg = ok ? ADS1115_REG_CONVERSION : 0xFF;
+    return ok;
+}
+
+// 启动连续转换
+bool ADS1115::startContinuous(uint16_t mux, int rdyPin) {
+    if (!selectChannel()) {
+        return false;
+    }
+    
+    if (!enableReadyPin(rdyPin)) {
+        return false;
+    }
+    
+    uint16_t config = _currentConfig;
+    config &= ~(0x7000 | ADS1115_MODE_SINGLE | ADS1115_COMP_QUE_DIS);
+    config |= (mux & 0x7000) | ADS1115_MODE_CONTINUOUS | ADS1115_COMP_QUE_1CONV;
+    if (!configure(config)) {
+        LOG_W(ADS) Serial.println("ADS1115: 启动连续转换失败");
+        return false;
+    }
+    
+    // 把指针停在转换寄存器上，之后每个样本不再写指针
+    pointToConversion();
+    
+    _continuous = true;
+    _lastSampleUs = micros();
+    
+    LOG_I(ADS) {
+        Serial.print("ADS1115: 连续转换已启动，");
+        Serial.print(1000000UL / getConversionPeriodUs());
+        Serial.print(" SPS，");
+        if (_rdyGpio) {
+            Serial.print("ALERT/RDY -> GPIO");
+            Serial.println(rdyPin);
+        } else {
+            Serial.println("按转换周期计时读取");
+        }
+    }
+    return true;
+}
+
+// 停止连续转换，恢复单次模式（芯片回到掉电状态）
+void ADS1115::stopContinuous() {
+    if (!_continuous) {
+        return;
+    }
+    _continuous = false;
+    delete _rdyGpio;
+    _rdyGpio = nullptr;
+    
+    writeRegister(ADS1115_REG_HI_THRESH, ADS1115_DEFAULT_HI_THRESH);
+    writeRegister(ADS1115_REG_LO_THRESH, ADS1115_DEFAULT_LO_THRESH);
+    uint16_t config = _currentConfig | ADS1115_MODE_SINGLE | ADS1115_COMP_QUE_DIS;
+    configure(config);
+}
+
+// 读取转换寄存器：指针已在转换寄存器时只做一次读事务
+bool ADS1115::readConversion(int16_t& value) {
+    if (!selectChannel()) {
+        return false;
+    }
+    
+    if (_pointerReg != ADS1115_REG_CONVERSION && !pointToConversion()) {
+        return false;
+    }
+    
+    if (_i2cPort->requestFrom(_address, (uint8_t)2) != 2) {
+        return false;
+    }
+    uint8_t highByte = _i2cPort->read();
+    uint8_t lowByte = _i2cPort->read();
+    value = (int16_t)(((uint16_t)highByte << 8) | lowByte);
+    return true;
+}
+
+// 连续模式读取
+bool ADS1115::readContinuous(int16_t& value, unsigned long timeoutMs) {
+    if (!_continuous) {
+        return false;
+    }
+    
+    // 睡眠等待 RDY 下降沿，新结果在边沿时已锁存
+    if (waitForReady((int)timeoutMs) == 0) {
+        return false;
+    }
+    
+    if (!_rdyGpio) {
+        // 距上次读取不足一个转换周期则等到下一个结果（内部振荡器误差 ±10%，留出余量）
+        unsigned long periodUs = getConversionPeriodUs() + getConversionPeriodUs() / 10;
+        unsigned long elapsed = micros() - _lastSampleUs;
+        if (elapsed < periodUs) {
+            delayMicroseconds(periodUs - elapsed);
+        }
+    }
+    
+    if (!readConversion(value)) {
+        return false;
+    }
+    _lastSampleUs = micros();
+    
+    if (updateRange(value)) {
+        // 连续模式下写配置会重新开始转换：指针移回转换寄存器，丢弃旧档位可能残留的 RDY 边沿，
+        // 计时从写入时刻重新开始，下一次读到的必定是新档位的结果
+        writeRegister(ADS1115_REG_CONFIG, _currentConfig);
+        pointToConversion();
+        waitForReady(0);
+        _lastSampleUs = micros();
+    }
+    return true;
+}
+
+// 启用/关闭自动量程
+void ADS1115::setAutoRange(bool enable) {
+    _autoRangeEnabled = enable;
+    _autoRange.setPga((_currentConfig >> 9) & 0x0007);
+    _lastPga = (_currentConfig >> 9) & 0x0007;
+}
+
+// 记录结果所用档位并更新自动量程，返回 true 表示 _currentConfig 的 PGA 已改变
+bool ADS1115::updateRange(int16_t value) {
+    _lastPga = (_currentConfig >> 9) & 0x0007;
+    if (!_autoRangeEnabled || !_autoRange.update(value, _lastPga)) {
+        return false;
+    }
+    _currentConfig = (_currentConfig & ~0x0E00) | _autoRange.getConfigBits();
+    return true;
+}
+
 // 读取原始ADC值
-int16_t ADS1115::readRaw(uint8_t mux) {
+int16_t ADS1115::readRaw(uint16_t mux) {
+    if (_continuous) {
+        if ((mux & 0x7000) == (_currentConfig & 0x7000)) {
+            // 最多等两个转换周期
+            int16_t value = 0;
+            readContinuous(value, getConversionPeriodUs() / 500 + 10);
+            return value;
+        }
+        // 读其他输入：退出连续模式，改为单次转换
+        LOG_D(ADS) Serial.println("ADS1115: 读取其他输入，退出连续转换模式");
+        stopContinuous();
+    }
+    
     if (!selectChannel()) {
         return 0;
     }
@@ -147,30 +375,22 @@ int16_t ADS1115::readRaw(uint8_t mux) {
     // 读取转换结果
     uint16_t result = readRegister(ADS1115_REG_CONVERSION);
     
+    // 新档位随下一次转换的配置写入生效
+    updateRange((int16_t)result);
+    
     return (int16_t)result;
 }
 
 // 读取电压值
-float ADS1115::readVoltage(uint8_t mux) {
+float ADS1115::readVoltage(uint16_t mux) {
     int16_t raw = readRaw(mux);
     
     if (raw == 0 && _currentConfig == 0) {
         return 0.0; // 未初始化
     }
     
-    // 获取当前PGA设置
-    uint16_t pga = (_currentConfig >> 9) & 0x0007;
-    float fsr;
-    
-    switch (pga) {
-        case 0: fsr = 6.144; break;
-        case 1: fsr = 4.096; break;
-        case 2: fsr = 2.048; break;
-        case 3: fsr = 1.024; break;
-        case 4: fsr = 0.512; break;
-        case 5: fsr = 0.256; break;
-        default: fsr = 2.048; break;
-    }
+    // 该结果所用PGA对应的满量程
+    float fsr = fullScaleVolts(_autoRangeEnabled ? (uint16_t)(_lastPga << 9) : _currentConfig);
     
     // 16位ADC，LSB = FSR / 32768
     float voltage = (raw * fsr) / 32768.0;
@@ -183,6 +403,7 @@ void ADS1115::setGain(uint8_t gain) {
     uint16_t pgaValue = (gain << 9) & 0x0E00;
     _currentConfig &= ~0x0E00;
     _currentConfig |= pgaValue;
+    _autoRange.setPga(gain);
     writeConfig(_currentConfig);
 }
 
@@ -3,6 +3,7 @@
 
 #include "LuckfoxArduino.h"
 #include "I2CMux.h"
+#include "PgaAutoRange.h"
 
 // 使用 ArduinoHAL 命名空间
 using namespace ArduinoHAL;
@@ -55,6 +56,14 @@ using namespace ArduinoHAL;
 #define ADS1115_COMP_WINDOW     0x0010  // 窗口比较器
 #define ADS1115_COMP_LAT        0x0008  // 锁存
 #define ADS1115_COMP_QUE_DIS    0x0003  // 禁用比较器
+#define ADS1115_COMP_QUE_1CONV  0x0000  // 每次转换后触发 ALERT（配合 RDY 模式）
+
+// ALERT/RDY 转换完成模式：Hi_thresh 最高位为 1、Lo_thresh 最高位为 0，
+// 连续模式下每次转换结束 ALERT/RDY 引脚输出约 8us 的低电平脉冲
+#define ADS1115_RDY_HI_THRESH   0x8000
+#define ADS1115_RDY_LO_THRESH   0x0000
+#define ADS1115_DEFAULT_HI_THRESH 0x7FFF
+#define ADS1115_DEFAULT_LO_THRESH 0x8000
 
 // 默认配置
 #define ADS1115_DEFAULT_CONFIG   (ADS1115_MUX_AIN0_GND | \
@@ -66,6 +75,7 @@ using namespace ArduinoHAL;
 class ADS1115 {
 public:
     ADS1115(uint8_t address = ADS1115_DEFAULT_ADDRESS, I2CMux* mux = nullptr, uint8_t channel = 0);
+    ~ADS1115();
     
     // 初始化和配置
     bool begin(I2C* wirePort = &Wire);
@@ -75,11 +85,11 @@ public:
     // 多路复用器支持
     void setMuxChannel(I2CMux* mux, uint8_t channel);
     
-    // 读取原始ADC值
-    int16_t readRaw(uint8_t mux = ADS1115_MUX_AIN0_GND);
+    // 读取原始ADC值（mux 为 ADS1115_MUX_* 配置位）
+    int16_t readRaw(uint16_t mux = ADS1115_MUX_AIN0_GND);
     
     // 读取电压值（V）
-    float readVoltage(uint8_t mux = ADS1115_MUX_AIN0_GND);
+    float readVoltage(uint16_t mux = ADS1115_MUX_AIN0_GND);
     
     // 配置函数
     void setGain(uint8_t gain);
@@ -95,6 +105,43 @@ public:
     // 等待转换完成
     bool waitForConversion(unsigned long timeout = 100);
     
+    // 连续转换模式
+    // 只写一次配置，之后每个样本只是一次 2 字节读取（寄存器指针保持在转换寄存器）。
+    // rdyPin >= 0 时把 ALERT/RDY 配置为转换完成信号，在该 GPIO 的下降沿上 poll() 睡眠等待；
+    // rdyPin < 0 时按数据速率周期计时读取。
+    bool startContinuous(uint16_t mux, int rdyPin = -1);
+    void stopContinuous();
+    bool isContinuous() const { return _continuous; }
+    
+    // 读取下一次转换结果（仅连续模式），超时或读取失败返回 false
+    bool readContinuous(int16_t& value, unsigned long timeoutMs = 100);
+    
+    // 当前数据速率下的转换周期（微秒）
+    unsigned long getConversionPeriodUs() const;
+    
+    // 底层转换接口（供 ADS1115Scanner 等按输入切换配置的调用方使用）
+    // 把 ALERT/RDY 配置为转换完成信号并在 rdyPin 下降沿上等待；rdyPin < 0 只写阈值
+    bool enableReadyPin(int rdyPin);
+    bool hasReadyPin() const { return _rdyGpio != nullptr; }
+    // 等待 RDY 边沿：1 就绪, 0 超时, -1 未配置 RDY 引脚
+    int waitForReady(int timeoutMs);
+    // 以给定配置启动一次单次转换，随后把寄存器指针移回转换寄存器
+    bool startConversion(uint16_t config);
+    // 读取转换寄存器（指针已在转换寄存器时只有一次 2 字节读取）
+    bool readConversion(int16_t& value);
+    
+    // 配置字对应的转换周期（微秒）与满量程电压（V）
+    static unsigned long conversionPeriodUs(uint16_t config);
+    static float fullScaleVolts(uint16_t config);
+    
+    // PGA 自动量程：按最近结果的幅度为下一次转换选择量程（带回差），从不为选档额外转换。
+    // 启用后 readRaw() 的原始码对应 getLastPga() 档位，readVoltage() 自动按该档位换算。
+    void setAutoRange(bool enable);
+    bool isAutoRange() const { return _autoRangeEnabled; }
+    PgaAutoRange& getAutoRange() { return _autoRange; }
+    uint32_t getRangeSwitchCount() const { return _autoRange.getSwitchCount(); }
+    uint8_t getLastPga() const { return _lastPga; }
+    
     // 测试函数
     void scanAddress();
 
@@ -105,10 +152,23 @@ private:
     uint8_t _channel;
     uint16_t _currentConfig;
     
+    // 连续模式状态
+    bool _continuous;
+    GPIO* _rdyGpio;
+    uint8_t _pointerReg;            // 芯片当前寄存器指针（0xFF 表示未知）
+    unsigned long _lastSampleUs;
+    
+    // 自动量程状态
+    PgaAutoRange _autoRange;
+    bool _autoRangeEnabled;
+    uint8_t _lastPga;               // 最近一个结果所用的档位
+    
     // I2C通信函数
     bool writeRegister(uint8_t reg, uint16_t value);
     uint16_t readRegister(uint8_t reg);
     void writeConfig(uint16_t config);
+    bool updateRange(int16_t value);
+    bool pointToConversion();
 };
 
 #endif
@@ -0,0 +1,159 @@
+#include "ADS1115Scanner.h"
+#include "LogModules.h"
+
+ADS1115Scanner::ADS1115Scanner(ADS1115* ads)
+    : _ads(ads), _inputCount(0), _current(0), _running(false), _converting(false),
+      _startUs(0), _errors(0), _rateWindowUs(0), _rateCount(0), _throughput(0.0f) {
+    clearInputs();
+}
+
+int ADS1115Scanner::addInput(const char* name, uint16_t mux, uint16_t pga, uint16_t dataRate) {
+    if (_running || _inputCount >= ADS1115_SCAN_MAX_INPUTS) {
+        return -1;
+    }
+
+    Input& input = _inputs[_inputCount];
+    input.name = name;
+    // 比较器每次转换后触发：配合 RDY 模式阈值，ALERT/RDY 在转换结束时拉低
+    input.config = (mux & 0x7000) | (pga & 0x0E00) | (dataRate & 0x00E0) |
+                   ADS1115_MODE_SINGLE | ADS1115_COMP_QUE_1CONV;
+    return _inputCount++;
+}
+
+void ADS1115Scanner::clearInputs() {
+    if (_running) {
+        return;
+    }
+    _inputCount = 0;
+    for (uint8_t i = 0; i < ADS1115_SCAN_MAX_INPUTS; i++) {
+        _inputs[i].name = "";
+        _inputs[i].config = ADS1115_DEFAULT_CONFIG;
+        _readings[i].raw = 0;
+        _readings[i].voltage = 0.0f;
+        _readings[i].timestampUs = 0;
+        _readings[i].count = 0;
+        _readings[i].valid = false;
+    }
+}
+
+bool ADS1115Scanner::start(int rdyPin) {
+    if (_ads == nullptr || _inputCount == 0) {
+        LOG_W(ADS) Serial.println("ADS1115Scanner: 未配置输入");
+        return false;
+    }
+
+    _ads->stopContinuous();
+    if (!_ads->enableReadyPin(rdyPin)) {
+        return false;
+    }
+
+    _current = 0;
+    _errors = 0;
+    _rateWindowUs = micros();
+    _rateCount = 0;
+    _throughput = 0.0f;
+    _running = true;
+    _converting = false;
+    kick();
+
+    LOG_I(ADS) {
+        Serial.print("ADS1115Scanner: 扫描 ");
+        Serial.print(_inputCount);
+        Serial.print(" 个输入，理论 ");
+        Serial.print(getConfiguredRate(), 1);
+        Serial.println(" SPS");
+    }
+    return true;
+}
+
+void ADS1115Scanner::stop() {
+    _running = false;
+    _converting = false;
+}
+
+// 启动当前输入的转换
+bool ADS1115Scanner::kick() {
+    _converting = _ads->startConversion(_inputs[_current].config);
+    _startUs = micros();
+    if (!_converting) {
+        _errors++;
+    }
+    return _converting;
+}
+
+// 等待当前转换完成，RDY 超时返回 false
+bool ADS1115Scanner::waitConversion(unsigned long timeoutMs) {
+    int ready = _ads->waitForReady((int)timeoutMs);
+    if (ready >= 0) {
+        return ready > 0;
+    }
+
+    // 没有 RDY 引脚：单次转换含上电时间，内部振荡器误差 ±10%，留出余量
+    unsigned long periodUs = ADS1115::conversionPeriodUs(_inputs[_current].config);
+    unsigned long waitUs = periodUs + periodUs / 10 + 50;
+    unsigned long elapsed = micros() - _startUs;
+    if (elapsed < waitUs) {
+        delayMicroseconds(waitUs - elapsed);
+    }
+    return true;
+}
+
+int ADS1115Scanner::poll(unsigned long timeoutMs) {
+    if (!_running) {
+        return -1;
+    }
+    if (!_converting && !kick()) {
+        return -1;
+    }
+
+    if (!waitConversion(timeoutMs)) {
+        // 没等到 RDY：下次重新启动这一输入的转换
+        _errors++;
+        _converting = false;
+        return -1;
+    }
+
+    // 先启动下一个输入的转换，再读出刚完成的结果
+    uint8_t done = _current;
+    _current = (_current + 1) % _inputCount;
+    kick();
+
+    int16_t raw = 0;
+    if (!_ads->readConversion(raw)) {
+        _errors++;
+        return -1;
+    }
+
+    unsigned long now = micros();
+    ADS1115ScanReading& reading = _readings[done];
+    reading.raw = raw;
+    reading.voltage = raw * ADS1115::fullScaleVolts(_inputs[done].config) / 32768.0f;
+    reading.timestampUs = now;
+    reading.count++;
+    reading.valid = true;
+
+    _rateCount++;
+    unsigned long windowUs = now - _rateWindowUs;
+    if (windowUs >= 1000000UL) {
+        _throughput = _rateCount * 1e6f / windowUs;
+        _rateCount = 0;
+        _rateWindowUs = now;
+    }
+    return done;
+}
+
+const char* ADS1115Scanner::getInputName(uint8_t input) const {
+    return input < _inputCount ? _inputs[input].name : "";
+}
+
+const ADS1115ScanReading& ADS1115Scanner::getReading(uint8_t input) const {
+    return _readings[input < ADS1115_SCAN_MAX_INPUTS ? input : 0];
+}
+
+float ADS1115Scanner::getConfiguredRate() const {
+    unsigned long cycleUs = 0;
+    for (uint8_t i = 0; i < _inputCount; i++) {
+        cycleUs += ADS1115::conversionPeriodUs(_inputs[i].config);
+    }
+    return cycleUs ? _inputCount * 1e6f / cycleUs : 0.0f;
+}
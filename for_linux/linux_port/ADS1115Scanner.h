@@ -0,0 +1,83 @@
+#ifndef ADS1115Scanner_h
+#define ADS1115Scanner_h
+
+#include "ADS1115.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// ADS1115 多输入轮询扫描器
+//
+// 按配置的输入列表（单端或差分，各自的 PGA 与数据速率）循环做单次转换，并做流水化：
+// 一次转换结束后先写下一个输入的配置启动转换，再趁它转换期间读出刚完成的结果
+// （转换寄存器在下一次转换结束前保持不变）。每个样本的死区只有一次配置写入，
+// 有效吞吐接近所配置的 SPS。每个输入保留最新值表，供其他模块随时读取。
+//
+// 扫描期间芯片归扫描器独占，不要再对同一个 ADS1115 调用 readRaw()/startContinuous()。
+
+constexpr uint8_t ADS1115_SCAN_MAX_INPUTS = 8;
+
+struct ADS1115ScanReading {
+    int16_t raw;                // 原始码
+    float voltage;              // 电压（V）
+    unsigned long timestampUs;  // 读出时刻
+    uint32_t count;             // 累计样本数
+    bool valid;                 // 至少读到过一次
+};
+
+class ADS1115Scanner {
+public:
+    ADS1115Scanner(ADS1115* ads);
+
+    // 添加输入，返回输入序号，列表已满或扫描中返回 -1
+    // mux: ADS1115_MUX_*  pga: ADS1115_PGA_*  dataRate: ADS1115_DR_*
+    int addInput(const char* name, uint16_t mux,
+                 uint16_t pga = ADS1115_PGA_2048V, uint16_t dataRate = ADS1115_DR_860SPS);
+    void clearInputs();
+
+    // 开始扫描：rdyPin >= 0 时用 ALERT/RDY 边沿判定转换完成，否则按各输入的转换周期计时
+    bool start(int rdyPin = -1);
+    void stop();
+    bool isRunning() const { return _running; }
+
+    // 等待当前转换完成、启动下一个输入并读出结果
+    // 返回刚更新的输入序号，超时或 I2C 失败返回 -1
+    int poll(unsigned long timeoutMs = 100);
+
+    // 最新值表
+    uint8_t getInputCount() const { return _inputCount; }
+    const char* getInputName(uint8_t input) const;
+    const ADS1115ScanReading& getReading(uint8_t input) const;
+    float getVoltage(uint8_t input) const { return getReading(input).voltage; }
+
+    // 统计
+    float getThroughput() const { return _throughput; }   // 最近一秒的实际样本率（SPS）
+    float getConfiguredRate() const;                      // 按各输入转换周期算出的理论样本率
+    uint32_t getErrorCount() const { return _errors; }
+
+private:
+    struct Input {
+        const char* name;
+        uint16_t config;        // 合成后的配置字（MUX | PGA | DR | 比较器）
+    };
+
+    ADS1115* _ads;
+    Input _inputs[ADS1115_SCAN_MAX_INPUTS];
+    ADS1115ScanReading _readings[ADS1115_SCAN_MAX_INPUTS];
+    uint8_t _inputCount;
+    uint8_t _current;           // 正在转换的输入
+    bool _running;
+    bool _converting;           // 当前输入的转换已成功启动
+    unsigned long _startUs;     // 当前转换启动时刻
+    uint32_t _errors;
+
+    // 吞吐统计
+    unsigned long _rateWindowUs;
+    uint32_t _rateCount;
+    float _throughput;
+
+    bool kick();
+    bool waitConversion(unsigned long timeoutMs);
+};
+
+#endif
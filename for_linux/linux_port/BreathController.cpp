@@ -1,17 +1,12 @@
 #include "BreathController.h"
+#include "LogModules.h"
 
 // 常量定义
 constexpr int STORE_SIZE = 10;
-constexpr int FILTER_WINDOW = 5;
-constexpr float EWMA_ALPHA = 0.3;
 constexpr int ADAPT_CYCLES = 5;
 constexpr unsigned long RECONNECT_INTERVAL = 5000;
 
 BreathController::BreathController(I2CMux* mux) : _mux(mux), acd1100(mux, 5, COMM_I2C), ads1115(nullptr), oxygenSensor(nullptr) {
-    // 初始化滤波历史数组
-    for (int i = 0; i < FILTER_WINDOW; i++) {
-        pressureHistory[i] = NAN;
-    }
 }
 
 void BreathController::begin() {
@@ -27,49 +22,56 @@ void BreathController::begin() {
         _mux->scanI2CDevices();
         
         // 添加完整的I2C总线扫描
-        Serial.println("=== 完整I2C总线扫描 ===");
+        LOG_I(BREATH) Serial.println("=== 完整I2C总线扫描 ===");
         scanI2CBus();
     }
     
     // 初始化气阀控制
-    pinMode(VALVE_PIN, OUTPUT);
+    attachPwm(VALVE_PIN, VALVE_PWM_CHIP, VALVE_PWM_CHANNEL, VALVE_PWM_FREQ);
     analogWrite(VALVE_PIN, 0); // 初始关闭气阀
+    valveLinearizer.load();
+    flowEstimator.load();
+    pressureController.setLinearizer(&valveLinearizer);
     
     // 初始化传感器
     initSensor();
 
     // 初始化OLED
-    Serial.println("正在初始化OLED...");
+    LOG_I(BREATH) Serial.println("正在初始化OLED...");
     
     // 先测试OLED是否可以通过多路复用器访问
-    Serial.println("测试OLED通过多路复用器访问...");
+    LOG_I(BREATH) Serial.println("测试OLED通过多路复用器访问...");
     if (_mux && _mux->selectChannel(2)) {
-        Serial.println("成功选择OLED通道2");
+        LOG_I(BREATH) Serial.println("成功选择OLED通道2");
         delay(100);
         
         // 测试I2C通信
         Wire.beginTransmission(0x3C);
         uint8_t error = Wire.endTransmission();
-        Serial.print("OLED I2C测试结果: ");
-        if (error == 0) {
-            Serial.println("成功");
-        } else {
-            Serial.print("失败，错误代码: ");
-            Serial.println(error);
+        LOG_I(BREATH) {
+            Serial.print("OLED I2C测试结果: ");
+            if (error == 0) {
+                Serial.println("成功");
+            } else {
+                Serial.print("失败，错误代码: ");
+                Serial.println(error);
+            }
         }
     } else {
-        Serial.println("无法选择OLED通道2");
+        LOG_W(BREATH) Serial.println("无法选择OLED通道2");
     }
     
     oled.setMuxChannel(_mux, 2); // OLED现在在通道2
     if (!oled.begin()) {
-        Serial.println("OLED初始化失败! 请检查:");
-        Serial.println("1. OLED模块是否正确连接");
-        Serial.println("2. I2C地址是否正确 (当前: 0x3C)");
-        Serial.println("3. 电源和地线连接");
-        Serial.println("4. 多路复用器通道2是否正常工作");
+        LOG_W(BREATH) {
+            Serial.println("OLED初始化失败! 请检查:");
+            Serial.println("1. OLED模块是否正确连接");
+            Serial.println("2. I2C地址是否正确 (当前: 0x3C)");
+            Serial.println("3. 电源和地线连接");
+            Serial.println("4. 多路复用器通道2是否正常工作");
+        }
     } else {
-        Serial.println("OLED初始化成功!");
+        LOG_I(BREATH) Serial.println("OLED初始化成功!");
         
         // 重置显示确保干净状态
         oled.resetDisplay();
@@ -90,7 +92,7 @@ void BreathController::begin() {
     probeFlowSensor();
 
     // 初始化气体浓度传感器
-    Serial.println("正在初始化ACD1100气体浓度传感器...");
+    LOG_I(BREATH) Serial.println("正在初始化ACD1100气体浓度传感器...");
     
     // 根据通信模式初始化
     bool initResult = false;
@@ -103,25 +105,29 @@ void BreathController::begin() {
     }
     
     if (!initResult) {
-        Serial.println("ACD1100初始化失败! 请检查:");
-        if (acd1100.getCommunicationMode() == COMM_UART) {
-            Serial.println("1. UART连接是否正确（TX连接到RX，RX连接到TX）");
-            Serial.println("2. 波特率是否正确（1200）");
-            Serial.println("3. 传感器电源是否正常");
-        } else {
-            Serial.println("1. ACD1100模块是否正确连接");
-            Serial.println("2. I2C地址是否正确 (当前: 0x2A)");
-            Serial.println("3. 多路复用器通道4是否正常工作");
+        LOG_W(BREATH) {
+            Serial.println("ACD1100初始化失败! 请检查:");
+            if (acd1100.getCommunicationMode() == COMM_UART) {
+                Serial.println("1. UART连接是否正确（TX连接到RX，RX连接到TX）");
+                Serial.println("2. 波特率是否正确（1200）");
+                Serial.println("3. 传感器电源是否正常");
+            } else {
+                Serial.println("1. ACD1100模块是否正确连接");
+                Serial.println("2. I2C地址是否正确 (当前: 0x2A)");
+                Serial.println("3. 多路复用器通道4是否正常工作");
+            }
         }
     } else {
-        Serial.println("ACD1100初始化成功!");
+        LOG_I(BREATH) Serial.println("ACD1100初始化成功!");
     }
     
     // 初始化氧传感器（如果已配置）
     if (oxygenSensor != nullptr) {
         oxygenSensor->begin();
-        Serial.println("氧传感器初始化完成！");
-        Serial.println("提示: 使用calibrateShortCircuit()和calibrateAirEnvironment()进行校准");
+        LOG_I(BREATH) {
+            Serial.println("氧传感器初始化完成！");
+            Serial.println("提示: 使用calibrateShortCircuit()和calibrateAirEnvironment()进行校准");
+        }
     }
     
     // 执行初始校准
@@ -140,23 +146,30 @@ void BreathController::setADS1115Channel(uint8_t channel) {
     // 创建ADS1115实例（地址0x4A，使用多路复用器）
     ads1115 = new ADS1115(0x4A, _mux, channel);
     
-    Serial.print("ADS1115已配置在I2C多路复用器通道 ");
-    Serial.println(channel);
+    LOG_I(BREATH) {
+        Serial.print("ADS1115已配置在I2C多路复用器通道 ");
+        Serial.println(channel);
+    }
 }
 
 // 初始化氧传感器
 void BreathController::initializeOxygenSensor() {
     if (ads1115 == nullptr) {
-        Serial.println("错误: ADS1115未初始化！");
+        LOG_E(BREATH) Serial.println("错误: ADS1115未初始化！");
         return;
     }
     
     // 初始化ADS1115
     if (!ads1115->begin()) {
-        Serial.println("ADS1115初始化失败！");
+        LOG_E(BREATH) Serial.println("ADS1115初始化失败！");
         return;
     }
     
+    // 氧浓度只用 AIN0，连续转换免去每次读数的配置写入和固定等待
+    if (!ads1115->startContinuous(ADS1115_MUX_AIN0_GND, ADS1115_RDY_PIN)) {
+        LOG_W(BREATH) Serial.println("ADS1115连续转换启动失败，使用单次转换");
+    }
+    
     // 创建氧传感器实例
     if (oxygenSensor != nullptr) {
         delete oxygenSensor;
@@ -164,12 +177,11 @@ void BreathController::initializeOxygenSensor() {
     oxygenSensor = new OxygenSensor(ads1115, ADS1115_MUX_AIN0_GND);
     oxygenSensor->begin();
     
-    Serial.println("氧传感器初始化完成！");
+    LOG_I(BREATH) Serial.println("氧传感器初始化完成！");
 }
 
 void BreathController::update() {
     static unsigned long lastLogTime = 0;
-    static unsigned long lastSensorLogTime = 0;
     
     // 如果没有多路复用器，使用默认方式
     if (!_mux) {
@@ -177,6 +189,12 @@ void BreathController::update() {
         return;
     }
     
+    // 本周期主（通道1）/备用（通道3）气压读数，遍历结束后统一融合
+    float mainKpa = 0.0f, backupKpa = 0.0f;
+    float mainTemp = 0.0f, backupTemp = 0.0f;
+    bool mainRead = false, backupRead = false;
+    bool pressureScanned = false;
+    
     // 遍历所有启用的多路复用器通道读取传感器数据（跳过OLED通道）
     for (uint8_t i = 0; i < _mux->getChannelCount(); i++) {
         if (_mux->isChannelEnabled(i)) {
@@ -196,9 +214,11 @@ void BreathController::update() {
                 
                 // 等待采集完成
                 unsigned long startTime = millis();
+                bool acquired = true;
                 while (!operateCheck() && !dataCheck()) {
                     if (millis() - startTime > 100) {
-                        Serial.println("采集超时!");
+                        LOG_W(BREATH) Serial.println("采集超时!");
+                        acquired = false;
                         break;
                     }
                     delay(5);
@@ -217,78 +237,33 @@ void BreathController::update() {
                     float temperature_c = calculateTemperature(temperature_adc);
                     float pressure_kpa = (calculatePressure(pressure_adc, k_value, temperature_c) + 1032) / 12.10111;
                     
-                    // 应用双重滤波
-                    float filtered_pressure = applyMovingAverage(pressure_kpa);
-                    filtered_pressure = applyEWMA(filtered_pressure);
-                    
-                    // 设置基准值
-                    if (!isBaseSet) {
-                        basePressure = filtered_pressure;
-                        baseTemperature = temperature_c;
-                        isBaseSet = true;
-                    }
-                    
-                    // 计算相对于基准值的差值
-                    float pressureDiff = filtered_pressure - basePressure;
-                    
-                    // 存储差值
-                    storedPressures[storeIndex] = pressureDiff;
-                    storedTemperatures[storeIndex] = temperature_c - baseTemperature;
-                    
-                    // 呼吸状态检测（使用主气压传感器所在通道：1）
+                    pressureScanned = true;
                     if (i == 1) {
-                        currentState = detectBreathState(filtered_pressure);
-                        
-                        // 气阀控制
-                        if (assistEnabled) {
-                            controlValve();
-                        }
-                        
-                        // 显示信息（降低频率到每500ms一次）
-                        if (millis() - lastSensorLogTime > 500) {
-                            Serial.print("主传感器 - 压力: ");
-                            Serial.print(filtered_pressure, 2);
-                            Serial.print("kPa, 温度: ");
-                            Serial.print(temperature_c, 1);
-                            Serial.print("°C, 状态: ");
-                            switch(currentState) {
-                                case INHALE: Serial.print("吸气"); break;
-                                case EXHALE: Serial.print("呼气"); break;
-                                case PEAK: Serial.print("峰值"); break;
-                                case TROUGH: Serial.print("谷值"); break;
-                            }
-                            Serial.println();
-                            lastSensorLogTime = millis();
-                        }
-                        
-                        // 自适应调整
-                        adaptiveModelAdjustment();
-                        
-                        // 删除所有关于wifiConnected和sendDataOverWiFi的代码块
+                        mainKpa = pressure_kpa;
+                        mainTemp = temperature_c;
+                        mainRead = acquired;
                     } else if (i == 3) {
-                        // 备用传感器输出（降低频率到每500ms一次）
-                        static unsigned long lastBackupLogTime = 0;
-                        if (millis() - lastBackupLogTime > 500) {
-                            Serial.print("备用传感器 - 压力: ");
-                            Serial.print(filtered_pressure, 2);
-                            Serial.print("kPa, 温度: ");
-                            Serial.print(temperature_c, 1);
-                            Serial.print("°C, 差值: ");
-                            Serial.print(pressureDiff, 3);
-                            Serial.println("kPa");
-                            lastBackupLogTime = millis();
-                        }
+                        backupKpa = pressure_kpa;
+                        backupTemp = temperature_c;
+                        backupRead = acquired;
                     }
                     
                 } else if (config.sensorAddr == FLOW_SENSOR_ADDR) {
                     // 流量传感器（仅在探测到可用时读取）
                     if (flowSensorAvailable && (int)i == flowSensorChannel) {
                         flowRate = readFlowRate();
+                        flowValid = (flowRate >= 0.0f);
+                        if (flowValid) {
+                            flowSampleCount++;
+                            volumeIntegrator.addSample(micros(), flowRate);
+                        }
                         static unsigned long lastFlowLogTime = 0;
                         if (millis() - lastFlowLogTime > 1000) {
-                            Serial.print("流量: ");
-                            Serial.print(flowRate, 0);
-                            Serial.println(" ml/min");
+                            LOG_D(BREATH) {
+                                Serial.print("流量: ");
+                                Serial.print(flowRate, 0);
+                                Serial.println(" ml/min");
+                            }
                             lastFlowLogTime = millis();
                         }
                     }
@@ -297,20 +272,27 @@ void BreathController::update() {
         }
     }
     
+    // 主/备气压融合，随后做呼吸检测与气阀控制
+    if (pressureScanned) {
+        updatePressure(mainKpa, mainRead, mainTemp, backupKpa, backupRead, backupTemp);
+    }
+    
     // 更新气体浓度传感器数据
     static unsigned long lastGasLogTime = 0;
     static unsigned long lastDebugTime = 0;
     
     // 每5秒输出一次调试信息
     if (millis() - lastDebugTime > 5000) {
-        Serial.print("ACD1100调试 - 连接状态: ");
-        Serial.print(acd1100.isConnected() ? "已连接" : "未连接");
-        Serial.print(", 错误码: ");
-        Serial.println(acd1100.getLastError());
+        LOG_D(BREATH) {
+            Serial.print("ACD1100调试 - 连接状态: ");
+            Serial.print(acd1100.isConnected() ? "已连接" : "未连接");
+            Serial.print(", 错误码: ");
+            Serial.println(acd1100.getLastError());
+        }
         
         // 如果连接失败，尝试简化测试
         if (!acd1100.isConnected()) {
-            Serial.println("ACD1100: 尝试简化测试读取");
+            LOG_D(BREATH) Serial.println("ACD1100: 尝试简化测试读取");
             acd1100.testSimpleRead();
         }
         
@@ -320,11 +302,13 @@ void BreathController::update() {
     if (acd1100.update()) {
         // 每2秒输出一次气体浓度数据
         if (millis() - lastGasLogTime > 2000) {
-            Serial.print("ACD1100 - CO2: ");
-            Serial.print(acd1100.getFilteredCO2(), 0);
-            Serial.print("ppm, 空气质量: ");
-            Serial.print(acd1100.getAirQuality());
-            Serial.println("级");
+            LOG_I(BREATH) {
+                Serial.print("ACD1100 - CO2: ");
+                Serial.print(acd1100.getFilteredCO2(), 0);
+                Serial.print("ppm, 空气质量: ");
+                Serial.print(acd1100.getAirQuality());
+                Serial.println("级");
+            }
             lastGasLogTime = millis();
         }
     }
@@ -332,11 +316,13 @@ void BreathController::update() {
     // 读取氧传感器数据
     static unsigned long lastOxygenLogTime = 0;
     if (oxygenSensor != nullptr && oxygenSensor->isCalibrated()) {
-        float oxygenPercent = oxygenSensor->readOxygenConcentration();
+        oxygenPercent = oxygenSensor->readOxygenConcentration();
         if (millis() - lastOxygenLogTime > 2000) {
-            Serial.print("氧传感器 - 氧气浓度: ");
-            Serial.print(oxygenPercent, 2);
-            Serial.println("%");
+            LOG_I(BREATH) {
+                Serial.print("氧传感器 - 氧气浓度: ");
+                Serial.print(oxygenPercent, 2);
+                Serial.println("%");
+            }
             lastOxygenLogTime = millis();
         }
     }
@@ -351,12 +337,51 @@ void BreathController::update() {
     }
     oled.update(filteredPressure, baseTemperature, stateStr, (valveOpening/MAX_VALVE_OPEN)*100, flowRate);
     
+    // 输出本周期采样帧
+    publishSample();
+    
     // 移动到下一个存储位置
     storeIndex = (storeIndex + 1) % STORE_SIZE;
     
     delay(100); // 每100ms读取一次，提高读取速度
 }
 
+bool BreathController::calibrateFlowZero(unsigned long durationMs) {
+    if (flowSensorAvailable) {
+        LOG_I(BREATH) Serial.println("[Flow] 使用独立流量传感器，无需差压零点");
+        return false;
+    }
+    LOG_I(BREATH) Serial.println("[Flow] 差压零点标定，请保持气路无流量...");
+    
+    float sum = 0.0f;
+    int samples = 0;
+    unsigned long start = millis();
+    while (millis() - start < durationMs) {
+        uint32_t flowSamplesBefore = flowSampleCount;
+        update();
+        if (flowSampleCount != flowSamplesBefore) {
+            sum += flowEstimator.getRawDifferentialPa();
+            samples++;
+        }
+        delay(10);
+    }
+    
+    if (samples == 0) {
+        LOG_W(BREATH) Serial.println("[Flow] 未读到两路压力，零点标定失败");
+        return false;
+    }
+    
+    flowEstimator.setZeroOffset(sum / samples);
+    LOG_I(BREATH) {
+        Serial.print("[Flow] 零点: ");
+        Serial.print(flowEstimator.getZeroOffset(), 1);
+        Serial.print(" Pa (");
+        Serial.print(samples);
+        Serial.println(" 个样本)");
+    }
+    return flowEstimator.save();
+}
+
 void BreathController::probeFlowSensor() {
     flowSensorAvailable = false;
     flowSensorChannel = -1;
@@ -366,23 +391,38 @@ void BreathController::probeFlowSensor() {
         if (!_mux->isChannelEnabled(i)) continue;
         MuxChannelConfig config = _mux->getChannelConfig(i);
         if (config.sensorAddr != FLOW_SENSOR_ADDR) continue;
-        if (!_mux->selectChannel(i)) continue;
         
-        // 简单探测：请求2字节，若能返回>=2则认为存在
-        Wire.requestFrom((int)config.sensorAddr, (int)2);
-        if (Wire.available() >= 2) {
+        flowMeter.setMuxChannel(_mux, i);
+        if (flowMeter.begin(&Wire)) {
             flowSensorAvailable = true;
             flowSensorChannel = (int)i;
-            Serial.print("检测到流量传感器于通道 ");
-            Serial.println(flowSensorChannel);
-            // 读取并丢弃探测字节
-            while (Wire.available()) (void)Wire.read();
+            LOG_I(BREATH) {
+                Serial.print("检测到流量传感器于通道 ");
+                Serial.println(flowSensorChannel);
+            }
             break;
         }
-        while (Wire.available()) (void)Wire.read();
     }
     if (!flowSensorAvailable) {
-        Serial.println("未检测到流量传感器");
+        LOG_W(BREATH) Serial.println("未检测到流量传感器");
+    }
+    
+    // 没有流量计时两路气压分处节流件两侧用作差压流量，不再是同一压力的冗余读数：
+    // 只融合上游一路，下游一路只参与压差
+    bool differential = !flowSensorAvailable;
+    bool upstreamIsMain = flowEstimator.getConfig().upstreamIsMain;
+    pressureFusion.setExcluded(PRESSURE_SENSOR_MAIN, differential && !upstreamIsMain);
+    pressureFusion.setExcluded(PRESSURE_SENSOR_BACKUP, differential && upstreamIsMain);
+    
+    // CAFS3000 只给出无符号流量，测不到呼气方向：潮气量只报 VTi，不估计/补偿漏气
+    VolumeIntegratorConfig volumeConfig = volumeIntegrator.getConfig();
+    volumeConfig.bidirectional = differential;
+    volumeIntegrator.setConfig(volumeConfig);
+    if (differential) {
+        LOG_I(BREATH) {
+            Serial.print("差压流量模式：气压融合只使用");
+            Serial.println(upstreamIsMain ? "主传感器（上游）" : "备用传感器（上游）");
+        }
     }
 }
 
@@ -480,10 +520,12 @@ void BreathController::writeRegister(uint8_t reg, uint8_t value) {
     Wire.write(reg);
     Wire.write(value);
     if (Wire.endTransmission() != 0) {
-        Serial.print("I2C写入失败 @ 通道 ");
-        Serial.print(_mux->getActiveChannel());
-        Serial.print(", 寄存器 0x");
-        Serial.println(reg, HEX);
+        LOG_W(BREATH) {
+            Serial.print("I2C写入失败 @ 通道 ");
+            Serial.print(_mux->getActiveChannel());
+            Serial.print(", 寄存器 0x");
+            Serial.println(reg, HEX);
+        }
     }
 }
 
@@ -495,10 +537,12 @@ uint8_t BreathController::readRegister(uint8_t reg) {
     Wire.beginTransmission(currentSensorAddr);
     Wire.write(reg);
     if (Wire.endTransmission(false) != 0) {
-        Serial.print("I2C寻址失败 @ 通道 ");
-        Serial.print(_mux->getActiveChannel());
-        Serial.print(", 寄存器 0x");
-        Serial.println(reg, HEX);
+        LOG_W(BREATH) {
+            Serial.print("I2C寻址失败 @ 通道 ");
+            Serial.print(_mux->getActiveChannel());
+            Serial.print(", 寄存器 0x");
+            Serial.println(reg, HEX);
+        }
         return 0;
     }
     
@@ -506,29 +550,24 @@ uint8_t BreathController::readRegister(uint8_t reg) {
     if (bytes == 1) {
         return Wire.read();
     }
-    Serial.print("读取失败, 通道 ");
-    Serial.print(_mux->getActiveChannel());
-    Serial.print(", 收到");
-    Serial.print(bytes);
-    Serial.println("字节");
+    LOG_W(BREATH) {
+        Serial.print("读取失败, 通道 ");
+        Serial.print(_mux->getActiveChannel());
+        Serial.print(", 收到");
+        Serial.print(bytes);
+        Serial.println("字节");
+    }
     return 0;
 }
 
 float BreathController::readFlowRate() {
-    if (!_mux) return -1.0f;
-    
-    uint8_t currentSensorAddr = _mux->getChannelConfig(_mux->getActiveChannel()).sensorAddr;
+    if (!flowSensorAvailable) return -1.0f;
     
-    Wire.requestFrom((int)currentSensorAddr, (int)2);
-    if (Wire.available() >= 2) {
-        uint8_t highByte = Wire.read();
-        uint8_t lowByte = Wire.read();
-        uint16_t rawValue = (highByte << 8) | lowByte;
-        
-        float flow_lpm = rawValue / 100.0f;
-        return flow_lpm * 1000.0f;
+    float flow_lpm;
+    if (!flowMeter.read(flow_lpm)) {
+        return -1.0f;
     }
-    return -1.0f;
+    return flow_lpm * 1000.0f;
 }
 
 // ... 其余方法保持不变
@@ -582,45 +621,166 @@ float BreathController::calculatePressure(uint32_t adc_value, uint32_t k, float
     return pressure;
 }
 
-float BreathController::applyMovingAverage(float newValue) {
-    pressureHistory[historyIndex] = newValue;
-    historyIndex = (historyIndex + 1) % FILTER_WINDOW;
+void BreathController::updatePressure(float mainKpa, bool mainRead, float mainTemp,
+                                      float backupKpa, bool backupRead, float backupTemp) {
+    static unsigned long lastSensorLogTime = 0;
+    static unsigned long lastBackupLogTime = 0;
     
-    float sum = 0.0;
-    int count = 0;
-    for (int i = 0; i < FILTER_WINDOW; i++) {
-        if (!isnan(pressureHistory[i])) {
-            sum += pressureHistory[i];
-            count++;
+    unsigned long now = micros();
+    float dt = lastFusionUs ? (now - lastFusionUs) / 1e6f : 0.0f;
+    lastFusionUs = now;
+    
+    filteredPressure = pressureFusion.update(mainKpa, mainRead, backupKpa, backupRead, dt);
+    if (!pressureFusion.isValid()) {
+        return;
+    }
+    
+    // 两路都超时或被剔除：融合值只是保持的旧估计。不送给压力闭环（由其测量超时关阀），
+    // 也不据此做呼吸检测和开环气阀步进
+    if (pressureFusion.getLastUsedCount() == 0) {
+        static unsigned long lastNoPressureLogTime = 0;
+        if (millis() - lastNoPressureLogTime > 1000) {
+            LOG_W(BREATH) Serial.println("本周期没有可用的气压读数，暂停呼吸检测与气阀控制");
+            lastNoPressureLogTime = millis();
         }
+        return;
     }
     
-    return (count > 0) ? (sum / count) : newValue;
-}
-
-float BreathController::applyEWMA(float newValue) {
-    if (!isFilterInitialized) {
-        filteredPressure = newValue;
-        isFilterInitialized = true;
-        return newValue;
+    // 温度取参与融合的传感器
+    const PressureSensorHealth& mainHealth = pressureFusion.getHealth(PRESSURE_SENSOR_MAIN);
+    float temperature_c = (mainRead && mainHealth.healthy) ? mainTemp : backupTemp;
+    currentTemperature = temperature_c;
+    temperatureValid = true;
+    
+    backupPressure = backupKpa;
+    backupPressureValid = backupRead;
+    
+    // 没有独立流量计时由同周期两路压差估计流量，与压力同帧发布
+    if (!flowSensorAvailable && mainRead && backupRead) {
+        flowRate = flowEstimator.update(mainKpa, backupKpa, temperature_c);
+        flowValid = true;
+        flowSampleCount++;
+        volumeIntegrator.addSample(now, flowRate);
+        static unsigned long lastFlowLogTime = 0;
+        if (millis() - lastFlowLogTime > 1000) {
+            LOG_D(BREATH) {
+                Serial.print("差压流量: ");
+                Serial.print(flowRate, 0);
+                Serial.print(" ml/min (压差 ");
+                Serial.print(flowEstimator.getDifferentialPa(), 1);
+                Serial.println(" Pa)");
+            }
+            lastFlowLogTime = millis();
+        }
     }
     
-    filteredPressure = EWMA_ALPHA * newValue + (1 - EWMA_ALPHA) * filteredPressure;
-    return filteredPressure;
+    // 设置基准值
+    if (!isBaseSet) {
+        basePressure = filteredPressure;
+        baseTemperature = temperature_c;
+        isBaseSet = true;
+    }
+    
+    // 计算相对于基准值的差值
+    float pressureDiff = filteredPressure - basePressure;
+    
+    // 存储差值
+    storedPressures[storeIndex] = pressureDiff;
+    storedTemperatures[storeIndex] = temperature_c - baseTemperature;
+    
+    // 呼吸状态检测
+    BreathState previousState = currentState;
+    currentState = detectBreathState(filteredPressure);
+    
+    // 进入吸气即一次呼吸触发：结算上一呼吸的潮气量
+    if (currentState == INHALE && previousState != INHALE && volumeIntegrator.markBreathStart(now)) {
+        const BreathVolume& breath = volumeIntegrator.getLastBreath();
+        LOG_I(BREATH) {
+            Serial.print("潮气量 #");
+            Serial.print(breath.index);
+            Serial.print(": VTi ");
+            Serial.print(breath.vtiMl, 0);
+            if (breath.hasExpiratory) {
+                Serial.print(" ml, VTe ");
+                Serial.print(breath.vteMl, 0);
+                Serial.print(" ml, 漏气 ");
+                Serial.print(breath.leakPercent, 1);
+                Serial.print("% (");
+                Serial.print(volumeIntegrator.getLeakFlow(), 0);
+                Serial.println(" ml/min)");
+            } else {
+                Serial.println(" ml（单向流量计，无 VTe/漏气）");
+            }
+        }
+    }
+    
+    pressureGauge = pressureDiff;
+    
+    // 压力闭环只取最新值，由控制线程按自己的频率使用
+    if (pressureController.isRunning()) {
+        pressureController.updateMeasurement(pressureDiff, toControlPhase(currentState));
+    }
+    
+    // 气阀控制
+    if (assistEnabled) {
+        controlValve();
+    }
+    
+    // 显示信息（降低频率到每500ms一次）
+    if (millis() - lastSensorLogTime > 500) {
+        LOG_I(BREATH) {
+            Serial.print("融合压力: ");
+            Serial.print(filteredPressure, 2);
+            Serial.print("kPa (±");
+            Serial.print(pressureFusion.getStdDev(), 3);
+            Serial.print("), 温度: ");
+            Serial.print(temperature_c, 1);
+            Serial.print("°C, 状态: ");
+            switch(currentState) {
+                case INHALE: Serial.print("吸气"); break;
+                case EXHALE: Serial.print("呼气"); break;
+                case PEAK: Serial.print("峰值"); break;
+                case TROUGH: Serial.print("谷值"); break;
+            }
+            Serial.print(", 主: ");
+            Serial.print(PressureFusion::faultName(mainHealth.fault));
+            Serial.println();
+        }
+        lastSensorLogTime = millis();
+    }
+    
+    // 备用传感器输出（降低频率到每500ms一次）
+    if (backupRead && millis() - lastBackupLogTime > 500) {
+        const PressureSensorHealth& backupHealth = pressureFusion.getHealth(PRESSURE_SENSOR_BACKUP);
+        LOG_D(BREATH) {
+            Serial.print("备用传感器 - 压力: ");
+            Serial.print(backupKpa, 2);
+            Serial.print("kPa, 零点偏差: ");
+            Serial.print(pressureFusion.getBackupOffset(), 3);
+            Serial.print("kPa, 噪声: ");
+            Serial.print(backupHealth.noiseKpa, 3);
+            Serial.print("kPa, 状态: ");
+            Serial.println(PressureFusion::faultName(backupHealth.fault));
+        }
+        lastBackupLogTime = millis();
+    }
+    
+    // 自适应调整
+    adaptiveModelAdjustment();
 }
 
 void BreathController::calibrateZeroPoint() {
     const int CALIB_SAMPLES = 10;
     float sum = 0.0;
     
-    Serial.println("\n开始零点校准...");
+    LOG_I(BREATH) Serial.println("\n开始零点校准...");
     
     for (int i = 0; i < CALIB_SAMPLES; i++) {
         startAcquisition();
         unsigned long startTime = millis();
         while (!operateCheck() && !dataCheck()) {
             if (millis() - startTime > 100) {
-                Serial.println("校准采集超时!");
+                LOG_W(BREATH) Serial.println("校准采集超时!");
                 return;
             }
             delay(5);
@@ -631,16 +791,18 @@ void BreathController::calibrateZeroPoint() {
         float pressure = calculatePressure(pressure_adc, k_value, baseTemperature);
         sum += pressure;
         
-       Serial.print(".");
+       LOG_I(BREATH) Serial.print(".");
         delay(100);
     }
     
     basePressure = sum / CALIB_SAMPLES;
-    Serial.println("\n零点校准完成!");
-    Serial.print("新基准压力: ");
-    Serial.print(basePressure, 4);
-    Serial.println(" kPa");
-    Serial.println("---------------------");
+    LOG_I(BREATH) {
+        Serial.println("\n零点校准完成!");
+        Serial.print("新基准压力: ");
+        Serial.print(basePressure, 4);
+        Serial.println(" kPa");
+        Serial.println("---------------------");
+    }
 }
 
 BreathState BreathController::detectBreathState(float pressure) {
@@ -694,6 +856,17 @@ BreathState BreathController::detectBreathState(float pressure) {
 }
 
 void BreathController::controlValve() {
+    // 特性扫描期间气阀由扫描程序直接驱动
+    if (valveSweepActive) {
+        return;
+    }
+    
+    // 压力闭环运行时气阀由控制线程驱动，这里只同步开度用于显示与记录
+    if (pressureController.isRunning()) {
+        valveOpening = pressureController.getOutput();
+        return;
+    }
+    
     switch(currentState) {
         case INHALE:
             valveOpening = constrain(valveOpening + 10 * responseFactor, 0, MAX_VALVE_OPEN * assistLevel);
@@ -711,7 +884,118 @@ void BreathController::controlValve() {
             break;
     }
     
-    analogWrite(VALVE_PIN, (int)valveOpening); 
+    analogWrite(VALVE_PIN, (int)lround(valveLinearizer.apply(valveOpening)));
+}
+
+bool BreathController::characterizeValve(bool useFlow, const ValveSweepConfig& config) {
+    if (pressureController.isRunning()) {
+        LOG_W(BREATH) Serial.println("[ValveLUT] 压力闭环运行中，无法扫描");
+        return false;
+    }
+    float duties[VALVE_SWEEP_MAX_POINTS];
+    float responses[VALVE_SWEEP_MAX_POINTS];
+    uint8_t count = 0;
+    // 步长下限保证全量程扫描点数不超过 VALVE_SWEEP_MAX_POINTS
+    uint8_t minStep = (MAX_VALVE_OPEN + VALVE_SWEEP_MAX_POINTS - 3) / (VALVE_SWEEP_MAX_POINTS - 2);
+    uint8_t step = config.dutyStep > minStep ? config.dutyStep : minStep;
+    bool ok = true;
+    
+    LOG_I(BREATH) {
+        Serial.print("[ValveLUT] 开始气阀特性扫描，响应量: ");
+        Serial.println(useFlow ? "流量" : "压力");
+    }
+    valveSweepActive = true;
+    
+    for (int duty = 0; ok && count < VALVE_SWEEP_MAX_POINTS; duty += step) {
+        if (duty > MAX_VALVE_OPEN) {
+            // 最后一级固定为全开
+            if (count > 0 && duties[count - 1] >= MAX_VALVE_OPEN) break;
+            duty = MAX_VALVE_OPEN;
+        }
+        valveOpening = duty;
+        analogWrite(VALVE_PIN, duty);
+        
+        // 等待稳定（期间继续采集，让滤波器跟上）
+        unsigned long start = millis();
+        while (millis() - start < config.settleMs) {
+            update();
+            delay(10);
+        }
+        
+        // 取平均
+        float sum = 0.0f;
+        int samples = 0;
+        start = millis();
+        while (millis() - start < config.sampleMs || samples == 0) {
+            uint32_t flowSamplesBefore = flowSampleCount;
+            update();
+            if (useFlow) {
+                // flowValid 在发布采样帧后即清除，用计数判断本周期是否有新流量
+                if (flowSampleCount != flowSamplesBefore) {
+                    sum += flowRate;
+                    samples++;
+                }
+            } else {
+                sum += pressureGauge;
+                samples++;
+            }
+            if (millis() - start > config.sampleMs + 1000) {
+                LOG_W(BREATH) Serial.println("[ValveLUT] 采样超时，扫描中止");
+                ok = false;
+                break;
+            }
+            delay(10);
+        }
+        if (!ok) break;
+        
+        duties[count] = duty;
+        responses[count] = sum / samples;
+        count++;
+        
+        LOG_I(BREATH) {
+            Serial.print("  占空比 ");
+            Serial.print(duty);
+            Serial.print(" -> ");
+            Serial.println(responses[count - 1], 3);
+        }
+    }
+    
+    valveOpening = 0;
+    analogWrite(VALVE_PIN, 0);
+    valveSweepActive = false;
+    
+    if (!ok || !valveLinearizer.build(duties, responses, count)) {
+        return false;
+    }
+    valveLinearizer.save();
+    valveLinearizer.print();
+    return true;
+}
+
+ControlPhase BreathController::toControlPhase(BreathState state) {
+    switch (state) {
+        case INHALE: return CONTROL_PHASE_INSPIRATION;
+        case PEAK:   return CONTROL_PHASE_PLATEAU;
+        case EXHALE: return CONTROL_PHASE_EXPIRATION;
+        default:     return CONTROL_PHASE_BASELINE;
+    }
+}
+
+bool BreathController::enablePressureControl(unsigned long rateHz, int rtPriority) {
+    if (!pressureController.begin(rateHz, rtPriority)) {
+        return false;
+    }
+    LOG_I(BREATH) Serial.println("气阀控制模式: 压力闭环");
+    return true;
+}
+
+void BreathController::disablePressureControl() {
+    if (!pressureController.isRunning()) {
+        return;
+    }
+    pressureController.end();
+    valveOpening = 0;
+    LOG_I(BREATH) Serial.println("气阀控制模式: 开环步进");
 }
 
 void BreathController::adaptiveModelAdjustment() {
@@ -725,31 +1009,86 @@ void BreathController::adaptiveModelAdjustment() {
         if (avgPressureDiff > 1.5 * pressureThreshold) {
             pressureThreshold *= 1.1;
             responseFactor *= 1.05;
-            Serial.println("模型调整: 增加灵敏度");
+            LOG_D(BREATH) Serial.println("模型调整: 增加灵敏度");
         } 
         else if (avgPressureDiff < 0.7 * pressureThreshold) {
             pressureThreshold *= 0.9;
             responseFactor *= 0.95;
-            Serial.println("模型调整: 降低灵敏度");
+            LOG_D(BREATH) Serial.println("模型调整: 降低灵敏度");
         }
         
         pressureThreshold = constrain(pressureThreshold, 0.2, 2.0);
         responseFactor = constrain(responseFactor, 0.5, 2.0);
         
-        Serial.print("新阈值: ");
-        Serial.print(pressureThreshold, 2);
-        Serial.print(" kPa, 响应因子: ");
-        Serial.println(responseFactor, 2);
+        LOG_D(BREATH) {
+            Serial.print("新阈值: ");
+            Serial.print(pressureThreshold, 2);
+            Serial.print(" kPa, 响应因子: ");
+            Serial.println(responseFactor, 2);
+        }
+    }
+}
+
+void BreathController::addSampleSink(SampleSink* sink) {
+    if (sink == nullptr) return;
+    for (size_t i = 0; i < _sampleSinks.size(); i++) {
+        if (_sampleSinks[i] == sink) return;
+    }
+    _sampleSinks.push_back(sink);
+}
+
+void BreathController::removeSampleSink(SampleSink* sink) {
+    for (size_t i = 0; i < _sampleSinks.size(); i++) {
+        if (_sampleSinks[i] == sink) {
+            _sampleSinks.erase(_sampleSinks.begin() + i);
+            return;
+        }
     }
 }
 
+void BreathController::publishSample() {
+    if (_sampleSinks.empty()) {
+        backupPressureValid = false;
+        flowValid = false;
+        temperatureValid = false;
+        return;
+    }
+    
+    SampleFrame frame;
+    frame.timestampUs = epochMicros();
+    frame.values[CH_PRESSURE] = filteredPressure;
+    frame.values[CH_PRESSURE_BACKUP] = backupPressure;
+    frame.values[CH_FLOW] = flowRate;
+    frame.values[CH_CO2] = acd1100.filteredCO2;
+    frame.values[CH_O2] = oxygenPercent;
+    frame.values[CH_TEMPERATURE] = currentTemperature;
+    frame.values[CH_VALVE] = valveOpening;
+    frame.values[CH_VOLUME] = volumeIntegrator.getVolume();
+    frame.breathState = (uint8_t)currentState;
+    frame.flags = 0;
+    if (backupPressureValid) frame.flags |= FRAME_FLAG_BACKUP_VALID;
+    if (flowValid) frame.flags |= FRAME_FLAG_FLOW_VALID;
+    if (temperatureValid) frame.flags |= FRAME_FLAG_TEMP_VALID;
+    if (oxygenSensor != nullptr && oxygenSensor->isCalibrated()) frame.flags |= FRAME_FLAG_O2_VALID;
+    
+    for (size_t i = 0; i < _sampleSinks.size(); i++) {
+        _sampleSinks[i]->onSample(frame);
+    }
+    
+    backupPressureValid = false;
+    flowValid = false;
+    temperatureValid = false;
+}
+
 // 删除所有与WiFi相关的函数体和调用、注释、诊断输出
 
 // 设置ACD1100通信模式
 void BreathController::setACD1100CommunicationMode(ACD1100_COMM_MODE mode) {
     acd1100.setCommunicationMode(mode);
-    Serial.print("ACD1100通信模式已切换为: ");
-    Serial.println(mode == COMM_I2C ? "I2C" : "UART");
+    LOG_I(BREATH) {
+        Serial.print("ACD1100通信模式已切换为: ");
+        Serial.println(mode == COMM_I2C ? "I2C" : "UART");
+    }
 }
 
 void BreathController::setACD1100UartPort(HardwareSerial* serialPort) {
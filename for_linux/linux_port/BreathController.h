@@ -7,14 +7,26 @@
 #include "gas_concentration.h"  // 包含气体浓度传感器库
 #include "ADS1115.h"
 #include "oxygen_sensor.h"
+#include "SampleFrame.h"
+#include "PressureController.h"
+#include "ValveLinearizer.h"
+#include "PressureFusion.h"
+#include "FlowEstimator.h"
+#include "CAFS3000.h"
+#include "VolumeIntegrator.h"
+#include <vector>
 
 // 使用 ArduinoHAL 命名空间
 using namespace ArduinoHAL;
 
 // 硬件配置
 constexpr uint8_t VALVE_PIN = 3;          // 气阀控制引脚
+constexpr int VALVE_PWM_CHIP = 0;          // 气阀 PWM 所在 pwmchip（/sys/class/pwm/pwmchipN，按设备树修改）
+constexpr int VALVE_PWM_CHANNEL = 0;       // 气阀 PWM 通道
+constexpr unsigned long VALVE_PWM_FREQ = 1000; // 气阀 PWM 频率 (Hz)
 constexpr float BREATH_THRESHOLD = 0.5;    // 呼吸检测阈值(kPa)
 constexpr uint8_t MAX_VALVE_OPEN = 255;    // 气阀最大开度
+constexpr int ADS1115_RDY_PIN = -1;        // ADS1115 ALERT/RDY 所接 GPIO，-1 为未接线（按转换周期计时读取）
 
 // 传感器配置
 constexpr uint8_t SENSOR_ADDR = 0x6D;      // 气压传感器I2C地址
@@ -54,10 +66,39 @@ public:
     
     // 数据访问方法
     float getPressure() const { return filteredPressure; }
+    const PressureFusion& getPressureFusion() const { return pressureFusion; }
     float getTemperature() const { return baseTemperature; }
     float getFlow() const { return flowRate; }
-    float getCO2Percentage() const { return acd1100.getCO2Concentration(); }
+    float getVolume() const { return volumeIntegrator.getVolume(); }
+    const VolumeIntegrator& getVolumeIntegrator() const { return volumeIntegrator; }
+    float getCO2Percentage() const { return acd1100.filteredCO2 / 10000.0f; }  // ppm -> %
     float getO2Percentage() const { return oxygenSensor ? oxygenSensor->getOxygenPercentage() : 0.0f; }
+    float getValveOpening() const { return valveOpening; }
+    // 气阀占空比最近一次实际写入 PWM 的时刻（micros()），0 表示尚未驱动
+    unsigned long getValveActuationUs() const {
+        PWM* pwm = pwmPin(VALVE_PIN);
+        return pwm ? pwm->getLastActuationUs() : 0;
+    }
+    
+    // 压力闭环模式：气阀改由 PressureController 在独立线程上按设定压力驱动，
+    // 关闭后恢复按呼吸状态步进的开环控制
+    bool enablePressureControl(unsigned long rateHz = 500, int rtPriority = 0);
+    void disablePressureControl();
+    bool isPressureControlEnabled() const { return pressureController.isRunning(); }
+    PressureController& getPressureController() { return pressureController; }
+    
+    // 气阀特性扫描：逐级设置占空比并记录稳态流量（useFlow）或主气压表压，
+    // 建立线性化查找表并保存；扫描期间暂停呼吸控制，需在压力闭环关闭时调用
+    bool characterizeValve(bool useFlow, const ValveSweepConfig& config = DEFAULT_VALVE_SWEEP);
+    ValveLinearizer& getValveLinearizer() { return valveLinearizer; }
+    
+    // 差压流量：无流量时调用，取 durationMs 内两路压差平均值作为零点并保存
+    bool calibrateFlowZero(unsigned long durationMs = 2000);
+    FlowEstimator& getFlowEstimator() { return flowEstimator; }
+    
+    // 采样帧输出（波形记录器等），每个主传感器采集周期调用一次
+    void addSampleSink(SampleSink* sink);
+    void removeSampleSink(SampleSink* sink);
     
     // 多路复用器访问
     void setMux(I2CMux* mux) { _mux = mux; }
@@ -94,8 +135,8 @@ private:
     // 数据处理
     float calculateTemperature(uint16_t adc_value);
     float calculatePressure(uint32_t adc_value, uint32_t k, float temperature);
-    float applyMovingAverage(float newValue);
-    float applyEWMA(float newValue);
+    void updatePressure(float mainKpa, bool mainRead, float mainTemp,
+                        float backupKpa, bool backupRead, float backupTemp);
     
     // 校准
     void calibrateZeroPoint();
@@ -103,8 +144,12 @@ private:
     // 呼吸检测与控制
     BreathState detectBreathState(float pressure);
     void controlValve();
+    static ControlPhase toControlPhase(BreathState state);
     void adaptiveModelAdjustment();
     
+    // 采样帧发布
+    void publishSample();
+    
     // 成员变量
     float storedPressures[10] = {0};
     float storedTemperatures[10] = {0};
@@ -114,11 +159,19 @@ private:
     float baseTemperature = 0.0;
 
     float flowRate = 0.0;   // 当前流量值(ml/min)
-    
-    float pressureHistory[5];
-    int historyIndex = 0;
-    float filteredPressure = 0.0;
-    bool isFilterInitialized = false;
+    float backupPressure = 0.0;     // 备用传感器滤波后压力(kPa)
+    bool backupPressureValid = false;
+    float currentTemperature = 0.0;  // 最近一次参与融合的传感器温度(°C)
+    bool temperatureValid = false;
+    bool flowValid = false;
+    uint32_t flowSampleCount = 0;   // 累计有效流量样本数（flowValid 每帧清除，按计数判断是否有新值）
+    float oxygenPercent = 0.0;
+    
+    PressureFusion pressureFusion;  // 主/备气压卡尔曼融合
+    unsigned long lastFusionUs = 0;
+    float filteredPressure = 0.0;   // 融合后的压力(kPa)
+    FlowEstimator flowEstimator;    // 主/备传感器差压 -> 流量
+    VolumeIntegrator volumeIntegrator;  // 流量 -> 容积波形与每次呼吸的 VTi/VTe
     
     BreathState currentState = EXHALE;
     unsigned long lastBreathTime = 0;
@@ -128,6 +181,10 @@ private:
     int breathCount = 0;
     
     float valveOpening = 0;
+    PressureController pressureController{VALVE_PIN, (float)MAX_VALVE_OPEN};
+    ValveLinearizer valveLinearizer{(float)MAX_VALVE_OPEN};
+    bool valveSweepActive = false;
+    float pressureGauge = 0.0;      // 主气压相对基线的表压(kPa)
     float assistLevel = 0.5;
     bool assistEnabled = true;
     
@@ -150,8 +207,12 @@ private:
     OxygenSensor* oxygenSensor;
 
     // 流量传感器状态
+    CAFS3000 flowMeter{FLOW_SENSOR_ADDR};
     bool flowSensorAvailable = false;
     int8_t flowSensorChannel = -1;
+    
+    // 采样帧消费者
+    std::vector<SampleSink*> _sampleSinks;
 };
 
 #endif
\ No newline at end of file
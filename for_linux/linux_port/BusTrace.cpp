@@ -0,0 +1,291 @@
+#include "BusTrace.h"
+#include "LogModules.h"
+#include <cstdio>
+
+static const char I2C_TRACE_MAGIC[8] = {'B', 'R', 'I', '2', 'C', 'T', 'R', 0};
+static const unsigned long TRACE_FLUSH_INTERVAL_MS = 1000;
+
+// ===================== I2CTraceRecorder =====================
+
+I2CTraceRecorder::I2CTraceRecorder(const std::string& path)
+    : _path(path), _file(nullptr), _records(0), _lastFlush(0) {
+}
+
+I2CTraceRecorder::~I2CTraceRecorder() {
+    end();
+}
+
+bool I2CTraceRecorder::begin() {
+    if (_file) return true;
+
+    _file = fopen(_path.c_str(), "wb");
+    if (!_file) {
+        LOG_E(STORE) {
+            Serial.print("[BusTrace] 无法创建轨迹文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+    setvbuf(_file, nullptr, _IOFBF, 64 * 1024);
+
+    I2CTraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, I2C_TRACE_MAGIC, sizeof(I2C_TRACE_MAGIC));
+    header.version = I2C_TRACE_VERSION;
+    header.startUs = micros();
+    fwrite(&header, sizeof(header), 1, _file);
+
+    _lastFlush = millis();
+    i2cBusHook() = this;
+
+    LOG_I(STORE) {
+        Serial.print("[BusTrace] 录制I2C事务到 ");
+        Serial.println(_path);
+    }
+    return true;
+}
+
+void I2CTraceRecorder::end() {
+    if (i2cBusHook() == this) {
+        i2cBusHook() = nullptr;
+    }
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+void I2CTraceRecorder::writeRecord(uint8_t type, uint8_t addr, uint8_t status,
+                                   uint16_t length, const uint8_t* data, uint16_t storedLength) {
+    if (!_file) return;
+
+    I2CTraceRecordHeader rec;
+    rec.timestampUs = micros();
+    rec.type = type;
+    rec.addr = addr;
+    rec.status = status;
+    rec.reserved = 0;
+    rec.length = length;
+    rec.storedLength = storedLength;
+    fwrite(&rec, sizeof(rec), 1, _file);
+    if (storedLength > 0) {
+        fwrite(data, 1, storedLength, _file);
+    }
+    _records++;
+
+    // 定期刷新，异常退出时最多丢失约 1 秒数据
+    if (millis() - _lastFlush >= TRACE_FLUSH_INTERVAL_MS) {
+        fflush(_file);
+        _lastFlush = millis();
+    }
+}
+
+void I2CTraceRecorder::onWrite(uint8_t addr, const uint8_t* data, size_t len, uint8_t status) {
+    uint16_t length = (uint16_t)(len > 0xFFFF ? 0xFFFF : len);
+    uint16_t stored = length < I2C_TRACE_MAX_WRITE_BYTES ? length : I2C_TRACE_MAX_WRITE_BYTES;
+    writeRecord(I2C_TRACE_WRITE, addr, status, length, data, stored);
+}
+
+void I2CTraceRecorder::onRead(uint8_t addr, const uint8_t* data, ssize_t result) {
+    if (result < 0) {
+        writeRecord(I2C_TRACE_READ, addr, 1, 0, nullptr, 0);
+    } else {
+        uint16_t length = (uint16_t)(result > 0xFFFF ? 0xFFFF : result);
+        writeRecord(I2C_TRACE_READ, addr, 0, length, data, length);
+    }
+}
+
+// ===================== I2CTraceReplayer =====================
+
+I2CTraceReplayer::I2CTraceReplayer(const std::string& path)
+    : _path(path), _cursor(0), _startUs(0), _skipped(0), _misses(0), _writeMismatches(0) {
+}
+
+I2CTraceReplayer::~I2CTraceReplayer() {
+    end();
+}
+
+bool I2CTraceReplayer::begin() {
+    FILE* file = fopen(_path.c_str(), "rb");
+    if (!file) {
+        LOG_E(STORE) {
+            Serial.print("[BusTrace] 无法打开轨迹文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    _data.resize(size > 0 ? (size_t)size : 0);
+    size_t got = _data.empty() ? 0 : fread(_data.data(), 1, _data.size(), file);
+    fclose(file);
+
+    const I2CTraceFileHeader* header = reinterpret_cast<const I2CTraceFileHeader*>(_data.data());
+    if (got < sizeof(I2CTraceFileHeader) ||
+        memcmp(header->magic, I2C_TRACE_MAGIC, sizeof(I2C_TRACE_MAGIC)) != 0 ||
+        header->version != I2C_TRACE_VERSION) {
+        LOG_E(STORE) Serial.println("[BusTrace] 轨迹文件格式不匹配");
+        _data.clear();
+        return false;
+    }
+    _startUs = header->startUs;
+
+    // 建立记录索引（末尾不完整的记录丢弃）
+    _index.clear();
+    size_t offset = sizeof(I2CTraceFileHeader);
+    while (offset + sizeof(I2CTraceRecordHeader) <= got) {
+        const I2CTraceRecordHeader* rec = reinterpret_cast<const I2CTraceRecordHeader*>(&_data[offset]);
+        size_t next = offset + sizeof(I2CTraceRecordHeader) + rec->storedLength;
+        if (next > got) break;
+        _index.push_back(offset);
+        offset = next;
+    }
+    _cursor = 0;
+
+    enableVirtualClock(_startUs);
+    i2cBusHook() = this;
+    pwmHook() = this;
+
+    LOG_I(STORE) {
+        Serial.print("[BusTrace] 回放 ");
+        Serial.print(_path);
+        Serial.print(", 共 ");
+        Serial.print((unsigned long)_index.size());
+        Serial.print(" 条事务, 时长 ");
+        Serial.print((float)((getEndUs() - _startUs) / 1000000.0), 1);
+        Serial.println(" 秒");
+    }
+    return true;
+}
+
+void I2CTraceReplayer::end() {
+    if (pwmHook() == this) {
+        pwmHook() = nullptr;
+    }
+    if (i2cBusHook() == this) {
+        i2cBusHook() = nullptr;
+        disableVirtualClock();
+    }
+}
+
+long I2CTraceReplayer::findNext(uint8_t type, uint8_t addr) const {
+    size_t limit = _cursor + I2C_TRACE_RESYNC_WINDOW;
+    if (limit > _index.size()) limit = _index.size();
+    for (size_t i = _cursor; i < limit; i++) {
+        const I2CTraceRecordHeader& rec = header(i);
+        if (rec.type == type && rec.addr == addr) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+void I2CTraceReplayer::consume(size_t i) {
+    _skipped += i - _cursor;
+    _cursor = i + 1;
+    // 虚拟时间不早于录制时该事务完成的时间，保证超时/节流等时间分支与录制时一致
+    advanceVirtualClockTo(header(i).timestampUs);
+}
+
+bool I2CTraceReplayer::replayWrite(uint8_t addr, const uint8_t* data, size_t len, uint8_t& status) {
+    long i = findNext(I2C_TRACE_WRITE, addr);
+    if (i < 0) {
+        _misses++;
+        status = 4;     // 其他错误
+        return true;
+    }
+
+    const I2CTraceRecordHeader& rec = header((size_t)i);
+    size_t compare = rec.storedLength < len ? rec.storedLength : len;
+    if (rec.length != len || memcmp(payload((size_t)i), data, compare) != 0) {
+        _writeMismatches++;
+    }
+    status = rec.status;
+    consume((size_t)i);
+    return true;
+}
+
+bool I2CTraceReplayer::replayRead(uint8_t addr, uint8_t* data, size_t len, ssize_t& result) {
+    long i = findNext(I2C_TRACE_READ, addr);
+    if (i < 0) {
+        _misses++;
+        result = -1;
+        return true;
+    }
+
+    const I2CTraceRecordHeader& rec = header((size_t)i);
+    if (rec.status != 0) {
+        result = -1;
+    } else {
+        size_t n = rec.length < len ? rec.length : len;
+        memcpy(data, payload((size_t)i), n);
+        result = (ssize_t)n;
+    }
+    consume((size_t)i);
+    return true;
+}
+
+// ===================== ReplayEventLog =====================
+
+static const char* STATE_NAMES[] = { "INHALE", "EXHALE", "PEAK", "TROUGH" };
+
+ReplayEventLog::ReplayEventLog(const std::string& path)
+    : _path(path), _file(nullptr), _hasLast(false), _lastValve(0), _lastState(0),
+      _cycles(0), _valveEvents(0), _stateEvents(0) {
+}
+
+ReplayEventLog::~ReplayEventLog() {
+    end();
+}
+
+bool ReplayEventLog::begin() {
+    if (_path == "-") {
+        _file = stdout;
+    } else {
+        _file = fopen(_path.c_str(), "w");
+    }
+    if (!_file) {
+        LOG_E(STORE) {
+            Serial.print("[BusTrace] 无法创建事件文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+    fprintf(_file, "timestamp_us,event,value,state,pressure_kpa\n");
+    return true;
+}
+
+void ReplayEventLog::end() {
+    if (_file && _file != stdout) {
+        fclose(_file);
+    } else if (_file) {
+        fflush(_file);
+    }
+    _file = nullptr;
+}
+
+void ReplayEventLog::onSample(const SampleFrame& frame) {
+    if (!_file) return;
+    _cycles++;
+
+    const char* stateName = frame.breathState < 4 ? STATE_NAMES[frame.breathState] : "?";
+    float valve = frame.values[CH_VALVE];
+    float pressure = frame.values[CH_PRESSURE];
+
+    if (!_hasLast || frame.breathState != _lastState) {
+        fprintf(_file, "%llu,state,%u,%s,%.4f\n", (unsigned long long)frame.timestampUs,
+                frame.breathState, stateName, pressure);
+        _stateEvents++;
+    }
+    if (!_hasLast || valve != _lastValve) {
+        fprintf(_file, "%llu,valve,%.3f,%s,%.4f\n", (unsigned long long)frame.timestampUs,
+                valve, stateName, pressure);
+        _valveEvents++;
+    }
+
+    _hasLast = true;
+    _lastState = frame.breathState;
+    _lastValve = valve;
+}
@@ -0,0 +1,145 @@
+#ifndef BusTrace_h
+#define BusTrace_h
+
+#include "LuckfoxArduino.h"
+#include "SampleFrame.h"
+#include <cstdio>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// I2C 总线事务录制/回放
+//
+// 录制：I2CTraceRecorder 作为 I2CBusHook 安装后，真实设备上的每次写/读事务
+// 连同完成时间 micros() 追加到轨迹文件。
+// 回放：I2CTraceReplayer 按顺序把录制的读数据当作总线响应返回给驱动，
+// 配合虚拟时钟，使 BreathController 走与实时采集完全相同的驱动与换算路径。
+// 回放期间同时安装为 PwmHook，气阀指令只记账，不驱动真实的 PWM 通道。
+//
+// 文件 = I2CTraceFileHeader + 若干 (I2CTraceRecordHeader + storedLength 字节数据)
+
+constexpr uint32_t I2C_TRACE_VERSION = 1;
+constexpr uint16_t I2C_TRACE_MAX_WRITE_BYTES = 32;   // 写事务只保存前 N 字节（OLED 帧数据较大）
+constexpr size_t I2C_TRACE_RESYNC_WINDOW = 64;       // 回放失配时向前搜索的记录数
+
+enum I2CTraceType {
+    I2C_TRACE_WRITE = 'W',
+    I2C_TRACE_READ = 'R'
+};
+
+struct I2CTraceFileHeader {
+    char magic[8];              // "BRI2CTR\0"
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t startUs;           // 开始录制时的 micros()
+};
+
+struct I2CTraceRecordHeader {
+    uint64_t timestampUs;       // 事务完成时的 micros()
+    uint8_t type;               // I2CTraceType
+    uint8_t addr;
+    uint8_t status;             // 写：endTransmission 结果码；读：0 成功，1 失败
+    uint8_t reserved;
+    uint16_t length;            // 写：发送字节数；读：实际返回字节数
+    uint16_t storedLength;      // 随后保存的数据字节数
+};
+
+class I2CTraceRecorder : public I2CBusHook {
+public:
+    I2CTraceRecorder(const std::string& path);
+    ~I2CTraceRecorder();
+
+    // 创建轨迹文件并安装为总线钩子
+    bool begin();
+    // 卸载钩子并关闭文件
+    void end();
+
+    void onWrite(uint8_t addr, const uint8_t* data, size_t len, uint8_t status) override;
+    void onRead(uint8_t addr, const uint8_t* data, ssize_t result) override;
+
+    uint64_t getRecordCount() const { return _records; }
+
+private:
+    std::string _path;
+    FILE* _file;
+    uint64_t _records;
+    unsigned long _lastFlush;
+
+    void writeRecord(uint8_t type, uint8_t addr, uint8_t status,
+                     uint16_t length, const uint8_t* data, uint16_t storedLength);
+};
+
+class I2CTraceReplayer : public I2CBusHook, public PwmHook {
+public:
+    I2CTraceReplayer(const std::string& path);
+    ~I2CTraceReplayer();
+
+    // 载入轨迹文件，启用虚拟时钟并安装为总线钩子与 PWM 钩子
+    bool begin();
+    // 卸载钩子，恢复真实时钟（回放中创建的 PWM 通道保持不访问硬件）
+    void end();
+
+    bool replayWrite(uint8_t addr, const uint8_t* data, size_t len, uint8_t& status) override;
+    bool replayRead(uint8_t addr, uint8_t* data, size_t len, ssize_t& result) override;
+
+    // 轨迹已全部消费
+    bool finished() const { return _cursor >= _index.size(); }
+
+    size_t getRecordCount() const { return _index.size(); }
+    size_t getPosition() const { return _cursor; }
+    uint64_t getStartUs() const { return _startUs; }
+    uint64_t getEndUs() const { return _index.empty() ? _startUs : header(_index.size() - 1).timestampUs; }
+    uint64_t getSkippedCount() const { return _skipped; }
+    uint64_t getMissCount() const { return _misses; }
+    uint64_t getWriteMismatchCount() const { return _writeMismatches; }
+
+private:
+    std::string _path;
+    std::vector<uint8_t> _data;     // 整个轨迹文件
+    std::vector<size_t> _index;     // 每条记录头在 _data 中的偏移
+    size_t _cursor;
+    uint64_t _startUs;
+
+    uint64_t _skipped;              // 为重新对齐跳过的记录
+    uint64_t _misses;               // 在搜索窗口内找不到匹配的事务
+    uint64_t _writeMismatches;      // 写入内容与录制不一致
+
+    const I2CTraceRecordHeader& header(size_t i) const {
+        return *reinterpret_cast<const I2CTraceRecordHeader*>(&_data[_index[i]]);
+    }
+    const uint8_t* payload(size_t i) const { return &_data[_index[i] + sizeof(I2CTraceRecordHeader)]; }
+
+    // 从当前位置查找下一条匹配记录，返回其序号；找不到返回 -1
+    long findNext(uint8_t type, uint8_t addr) const;
+    void consume(size_t i);
+};
+
+// 回放输出：把控制器产生的气阀指令和呼吸状态变化写成 CSV，便于回归比对
+//   timestamp_us,event,value,state,pressure_kpa
+//   event = valve（气阀开度变化，value 为新开度）| state（呼吸状态变化，value 为状态序号）
+class ReplayEventLog : public SampleSink {
+public:
+    ReplayEventLog(const std::string& path);
+    ~ReplayEventLog();
+
+    bool begin();
+    void end();
+
+    void onSample(const SampleFrame& frame) override;
+
+    uint64_t getCycleCount() const { return _cycles; }
+    uint64_t getValveEventCount() const { return _valveEvents; }
+    uint64_t getStateEventCount() const { return _stateEvents; }
+
+private:
+    std::string _path;
+    FILE* _file;
+    bool _hasLast;
+    float _lastValve;
+    uint8_t _lastState;
+    uint64_t _cycles;
+    uint64_t _valveEvents;
+    uint64_t _stateEvents;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "CAFS3000.h"
+#include "LogModules.h"
+
+CAFS3000::CAFS3000(uint8_t address, I2CMux* mux, uint8_t channel, float fullScaleLpm)
+    : _i2cPort(nullptr), _address(address), _mux(mux), _channel(channel),
+      _fullScaleLpm(fullScaleLpm), _countsPerLpm(CAFS3000_COUNTS_PER_LPM),
+      _crcMode(CAFS_CRC_AUTO), _crcEnabled(false), _lastFlow(0.0f) {
+    resetStats();
+}
+
+bool CAFS3000::begin(I2C* wirePort) {
+    _i2cPort = wirePort;
+
+    if (!isConnected()) {
+        LOG_W(FLOW) {
+            Serial.print("CAFS3000: 无法连接到地址 0x");
+            Serial.println(_address, HEX);
+        }
+        return false;
+    }
+
+    // 上电后前几帧可能还没有完成第一次测量
+    uint8_t frame[3];
+    for (uint8_t i = 0; i < CAFS3000_WARMUP_FRAMES; i++) {
+        readFrame(frame, 2);
+        delay(2);
+    }
+
+    if (_crcMode == CAFS_CRC_AUTO) {
+        _crcEnabled = detectCrc();
+    } else {
+        _crcEnabled = (_crcMode == CAFS_CRC_ON);
+    }
+
+    resetStats();
+    LOG_I(FLOW) {
+        Serial.print("CAFS3000: 初始化成功，地址 0x");
+        Serial.print(_address, HEX);
+        Serial.print("，满量程 ");
+        Serial.print(_fullScaleLpm, 1);
+        Serial.print(" L/min，CRC ");
+        Serial.println(_crcEnabled ? "启用" : "未启用");
+    }
+    return true;
+}
+
+// 只读探测：器件不接受没有有效载荷的空写
+bool CAFS3000::isConnected() {
+    if (_i2cPort == nullptr || !selectChannel()) {
+        return false;
+    }
+    uint8_t frame[2];
+    return readFrame(frame, sizeof(frame));
+}
+
+bool CAFS3000::selectChannel() {
+    if (_mux == nullptr) {
+        return true;
+    }
+    return _mux->selectChannel(_channel);
+}
+
+void CAFS3000::setMuxChannel(I2CMux* mux, uint8_t channel) {
+    _mux = mux;
+    _channel = channel;
+}
+
+void CAFS3000::setRange(float fullScaleLpm, float countsPerLpm) {
+    if (fullScaleLpm > 0.0f) {
+        _fullScaleLpm = fullScaleLpm;
+    }
+    if (countsPerLpm > 0.0f) {
+        _countsPerLpm = countsPerLpm;
+    }
+}
+
+void CAFS3000::setCrcMode(CafsCrcMode mode) {
+    _crcMode = mode;
+    if (mode != CAFS_CRC_AUTO) {
+        _crcEnabled = (mode == CAFS_CRC_ON);
+    }
+}
+
+void CAFS3000::resetStats() {
+    _stats.reads = 0;
+    _stats.busErrors = 0;
+    _stats.crcErrors = 0;
+    _stats.rangeErrors = 0;
+}
+
+// CRC-8：多项式 x^8 + x^5 + x^4 + 1 (0x31)，初值 0xFF，无反射
+uint8_t CAFS3000::crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+bool CAFS3000::readFrame(uint8_t* buf, size_t len) {
+    if (_i2cPort->requestFrom(_address, len) != len || _i2cPort->available() < (int)len) {
+        while (_i2cPort->available()) (void)_i2cPort->read();
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)_i2cPort->read();
+    }
+    return true;
+}
+
+// 没有 CRC 的固件第 3 字节通常是重复的数据或 0xFF，连续几帧都碰巧吻合的概率可以忽略
+bool CAFS3000::detectCrc() {
+    uint8_t frame[3];
+    uint8_t matched = 0;
+    for (uint8_t i = 0; i < CAFS3000_CRC_PROBE_FRAMES; i++) {
+        if (!readFrame(frame, 3)) {
+            return false;
+        }
+        if (crc8(frame, 2) == frame[2] && !(frame[0] == 0xFF && frame[1] == 0xFF)) {
+            matched++;
+        }
+        delay(2);
+    }
+    return matched == CAFS3000_CRC_PROBE_FRAMES;
+}
+
+bool CAFS3000::readRaw(uint16_t& raw) {
+    if (_i2cPort == nullptr || !selectChannel()) {
+        _stats.busErrors++;
+        return false;
+    }
+
+    uint8_t frame[3];
+    size_t len = _crcEnabled ? 3 : 2;
+    if (!readFrame(frame, len)) {
+        _stats.busErrors++;
+        return false;
+    }
+    if (_crcEnabled && crc8(frame, 2) != frame[2]) {
+        _stats.crcErrors++;
+        return false;
+    }
+
+    uint16_t value = ((uint16_t)frame[0] << 8) | frame[1];
+    if (value == 0xFFFF) {
+        _stats.rangeErrors++;
+        return false;
+    }
+    raw = value;
+    return true;
+}
+
+bool CAFS3000::read(float& flowLpm) {
+    uint16_t raw;
+    if (!readRaw(raw)) {
+        return false;
+    }
+
+    float flow = raw / _countsPerLpm;
+    if (flow > _fullScaleLpm * 1.1f) {
+        _stats.rangeErrors++;
+        return false;
+    }
+
+    _stats.reads++;
+    _lastFlow = flow;
+    flowLpm = flow;
+    return true;
+}
+
+bool CAFS3000::changeAddress(uint8_t newAddress) {
+    if (newAddress > 0x7F || _i2cPort == nullptr || !selectChannel()) {
+        return false;
+    }
+
+    _i2cPort->beginTransmission(_address);
+    _i2cPort->write(CAFS3000_CMD_SET_ADDRESS);
+    _i2cPort->write((uint8_t)0x00);
+    _i2cPort->write(newAddress);
+    if (_i2cPort->endTransmission() != 0) {
+        LOG_W(FLOW) Serial.println("CAFS3000: 修改地址失败");
+        return false;
+    }
+
+    LOG_I(FLOW) {
+        Serial.print("CAFS3000: 地址 0x");
+        Serial.print(_address, HEX);
+        Serial.print(" -> 0x");
+        Serial.print(newAddress, HEX);
+        Serial.println("，重新上电后生效");
+    }
+    _address = newAddress;
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef CAFS3000_h
+#define CAFS3000_h
+
+#include "LuckfoxArduino.h"
+#include "I2CMux.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// Consensic CAFS3000/CAFS4000 气体质量流量计 I2C 驱动
+//
+// 按《CAFS3000-4000 气体质量流量计 I2C 通信协议 v1.2》：
+//   - 默认 7 位地址 0x50
+//   - 上电即连续测量，主机直接读 2 字节（高字节在前），数值 = 流量(L/min) * 100
+//   - 修改地址：写 0xE7 0x00 <新地址>，重新上电生效
+// 协议里没有启动/停止命令，begin() 只在探测到器件后丢弃上电后的前几帧；
+// 之后每个样本只有一次 2 字节读操作，不写任何命令，通道已选中时可以 100 Hz 以上采样。
+//
+// 协议 v1.2 没有定义校验字节。部分固件在流量字后附带 CRC-8（多项式 0x31、初值 0xFF，
+// 与 Sensirion 流量计相同）；begin() 会多读 1 字节连续几帧比对 CRC，全部吻合才启用校验，
+// 也可用 setCrcMode() 强制指定。不论有无 CRC，都会拒绝 0xFFFF（总线上拉/器件未应答）
+// 和超过量程的读数。
+
+constexpr uint8_t CAFS3000_DEFAULT_ADDRESS = 0x50;
+constexpr uint8_t CAFS3000_CMD_SET_ADDRESS = 0xE7;
+constexpr float CAFS3000_COUNTS_PER_LPM = 100.0f;  // 协议规定的流量字分辨率 0.01 L/min
+constexpr uint8_t CAFS3000_WARMUP_FRAMES = 3;      // begin() 丢弃的上电帧数
+constexpr uint8_t CAFS3000_CRC_PROBE_FRAMES = 4;   // 判定是否带 CRC 的比对帧数
+
+enum CafsCrcMode {
+    CAFS_CRC_AUTO = 0,      // begin() 自动检测
+    CAFS_CRC_OFF,           // 只读 2 字节
+    CAFS_CRC_ON             // 读 3 字节，第 3 字节为 CRC-8
+};
+
+struct CafsStats {
+    uint32_t reads;         // 成功读数
+    uint32_t busErrors;     // I2C 读失败或字节数不足
+    uint32_t crcErrors;     // CRC 不符
+    uint32_t rangeErrors;   // 0xFFFF 或超量程
+};
+
+class CAFS3000 {
+public:
+    // fullScaleLpm：所用型号的满量程 (L/min)，超过 1.1 倍满量程的读数视为无效
+    CAFS3000(uint8_t address = CAFS3000_DEFAULT_ADDRESS, I2CMux* mux = nullptr, uint8_t channel = 0,
+             float fullScaleLpm = 100.0f);
+
+    // 探测器件、丢弃上电帧并（AUTO 时）检测 CRC
+    bool begin(I2C* wirePort = &Wire);
+    bool isConnected();
+
+    void setMuxChannel(I2CMux* mux, uint8_t channel);
+    uint8_t getAddress() const { return _address; }
+
+    // 量程：满量程与每 L/min 对应的计数（默认按协议 100）
+    void setRange(float fullScaleLpm, float countsPerLpm = CAFS3000_COUNTS_PER_LPM);
+    float getFullScale() const { return _fullScaleLpm; }
+
+    void setCrcMode(CafsCrcMode mode);
+    bool isCrcEnabled() const { return _crcEnabled; }
+
+    // 读取一个样本 (L/min)，读失败或校验失败返回 false 且不修改 flowLpm
+    bool read(float& flowLpm);
+    bool readRaw(uint16_t& raw);
+    float getLastFlow() const { return _lastFlow; }
+
+    // 修改器件地址（0x00–0x7F），重新上电后生效；成功后本对象改用新地址
+    bool changeAddress(uint8_t newAddress);
+
+    const CafsStats& getStats() const { return _stats; }
+    void resetStats();
+
+    static uint8_t crc8(const uint8_t* data, size_t len);
+
+private:
+    I2C* _i2cPort;
+    uint8_t _address;
+    I2CMux* _mux;
+    uint8_t _channel;
+    float _fullScaleLpm;
+    float _countsPerLpm;
+    CafsCrcMode _crcMode;
+    bool _crcEnabled;
+    float _lastFlow;
+    CafsStats _stats;
+
+    bool selectChannel();
+    bool readFrame(uint8_t* buf, size_t len);
+    bool detectCrc();
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef CalibrationSampler_h
+#define CalibrationSampler_h
+
+#include "LuckfoxArduino.h"
+#include <cmath>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 校准采样器（非阻塞）
+//
+// 取代“固定等待 N 秒 + 取 M 次平均”的阻塞式校准：调用方按自己的节奏（定时器、
+// 工作线程循环等）每读一次 ADC 调用一次 addSample()，采样器用 Welford 算法在
+// 最近 window 个样本的滑动窗口上维护均值/方差，窗口填满且标准差低于阈值即判定稳定，
+// 以窗口均值作为校准结果。信号仍在漂移时窗口会持续滑动，直到稳定或超时。
+//
+// 与 ADS1115 驱动一样只依赖 millis()，可在 AO08_linux_port 与 linux_port 之间原样共用。
+
+struct CalibrationConfig {
+    unsigned long settleMs;     // 开始后至少等待的时间，期间样本只用于显示、不参与判稳
+    unsigned long timeoutMs;    // 超过该时间仍未稳定则失败
+    uint8_t window;             // 判稳窗口样本数（<= CALIBRATION_MAX_WINDOW）
+    float maxStdDev;            // 窗口标准差阈值（与样本同单位）
+    uint8_t maxReadFailures;    // 连续读取失败次数上限
+};
+
+constexpr uint8_t CALIBRATION_MAX_WINDOW = 64;
+
+class CalibrationSampler {
+public:
+    enum Status {
+        IDLE = 0,
+        SETTLING,       // 等待最短稳定时间
+        SAMPLING,       // 窗口未满或尚未稳定
+        STABLE,         // 完成：getMean() 为校准结果
+        TIMEOUT,        // 完成：超时仍不稳定
+        READ_FAILED,    // 完成：ADC 连续读取失败
+        REJECTED,       // 完成：信号稳定但结果未通过合理性检查
+        CANCELLED       // 完成：被调用方取消
+    };
+
+    CalibrationSampler() : _status(IDLE), _startMs(0) {
+        _config.settleMs = 0;
+        _config.timeoutMs = 0;
+        _config.window = 1;
+        _config.maxStdDev = 0.0f;
+        _config.maxReadFailures = 1;
+        resetWindow();
+    }
+
+    void start(const CalibrationConfig& config) {
+        _config = config;
+        if (_config.window < 2) _config.window = 2;
+        if (_config.window > CALIBRATION_MAX_WINDOW) _config.window = CALIBRATION_MAX_WINDOW;
+        if (_config.maxReadFailures == 0) _config.maxReadFailures = 1;
+        resetWindow();
+        _startMs = millis();
+        _status = SETTLING;
+    }
+
+    // 加入一个样本，返回最新状态
+    Status addSample(float value) {
+        if (!isRunning()) return _status;
+        _readFailures = 0;
+        _lastValue = value;
+
+        unsigned long elapsed = millis() - _startMs;
+        if (_status == SETTLING) {
+            if (elapsed < _config.settleMs) {
+                return checkTimeout(elapsed);
+            }
+            _status = SAMPLING;
+        }
+
+        push(value);
+        if (_count >= _config.window && getStdDev() <= _config.maxStdDev) {
+            _status = STABLE;
+            return _status;
+        }
+        return checkTimeout(elapsed);
+    }
+
+    // 记录一次读取失败
+    Status addFailure() {
+        if (!isRunning()) return _status;
+        if (++_readFailures >= _config.maxReadFailures) {
+            _status = READ_FAILED;
+            return _status;
+        }
+        return checkTimeout(millis() - _startMs);
+    }
+
+    void cancel() {
+        if (isRunning()) _status = CANCELLED;
+    }
+
+    // 调用方对稳定结果的合理性检查未通过
+    void reject() {
+        if (_status == STABLE) _status = REJECTED;
+    }
+
+    Status getStatus() const { return _status; }
+    bool isRunning() const { return _status == SETTLING || _status == SAMPLING; }
+
+    // 当前窗口统计量
+    uint8_t getCount() const { return _count; }
+    float getMean() const { return (float)_mean; }
+    float getStdDev() const {
+        if (_count < 2) return 0.0f;
+        double variance = _m2 / (_count - 1);
+        return variance > 0.0 ? (float)std::sqrt(variance) : 0.0f;
+    }
+    float getLastValue() const { return _lastValue; }
+    unsigned long getElapsedMs() const { return millis() - _startMs; }
+
+    // 进度 0..1：等待阶段按时间，采样阶段按窗口填充程度，完成为 1
+    float getProgress() const {
+        if (_status == IDLE) return 0.0f;
+        if (!isRunning()) return 1.0f;
+        if (_status == SETTLING) {
+            return _config.settleMs ? 0.5f * getElapsedMs() / _config.settleMs : 0.0f;
+        }
+        return 0.5f + 0.49f * _count / _config.window;
+    }
+
+    // 稳定度 0..1：阈值 / 当前标准差，>= 1 表示窗口已满足判稳条件
+    float getStability() const {
+        if (_count < 2) return 0.0f;
+        float sd = getStdDev();
+        if (sd <= _config.maxStdDev) return 1.0f;
+        return _config.maxStdDev / sd;
+    }
+
+    static const char* statusName(Status status) {
+        switch (status) {
+            case IDLE:        return "空闲";
+            case SETTLING:    return "等待稳定";
+            case SAMPLING:    return "采样中";
+            case STABLE:      return "已稳定";
+            case TIMEOUT:     return "超时";
+            case READ_FAILED: return "读取失败";
+            case REJECTED:    return "结果不合理";
+            case CANCELLED:   return "已取消";
+        }
+        return "?";
+    }
+
+private:
+    CalibrationConfig _config;
+    Status _status;
+    unsigned long _startMs;
+    uint8_t _readFailures;
+    float _lastValue;
+
+    // 滑动窗口 + Welford 增量均值/二阶矩
+    float _window[CALIBRATION_MAX_WINDOW];
+    uint8_t _head;
+    uint8_t _count;
+    double _mean;
+    double _m2;
+
+    void resetWindow() {
+        _head = 0;
+        _count = 0;
+        _mean = 0.0;
+        _m2 = 0.0;
+        _readFailures = 0;
+        _lastValue = 0.0f;
+    }
+
+    void push(float value) {
+        if (_count == _config.window) {
+            // 移出最旧样本（Welford 逆运算）
+            double old = _window[_head];
+            double delta = old - _mean;
+            _mean -= delta / (_count - 1);
+            _m2 -= delta * (old - _mean);
+            _count--;
+            if (_m2 < 0.0) _m2 = 0.0;
+        }
+        _window[_head] = value;
+        _head = (_head + 1) % _config.window;
+        _count++;
+        double delta = value - _mean;
+        _mean += delta / _count;
+        _m2 += delta * (value - _mean);
+    }
+
+    Status checkTimeout(unsigned long elapsed) {
+        if (_config.timeoutMs && elapsed >= _config.timeoutMs) {
+            _status = TIMEOUT;
+        }
+        return _status;
+    }
+};
+
+#endif
@@ -0,0 +1,815 @@
+#include "ColumnarStore.h"
+#include "LogModules.h"
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <cfloat>
+
+static const char COLUMNAR_MAGIC[8] = {'B', 'R', 'C', 'O', 'L', 0, 0, 0};
+static const uint32_t COLUMNAR_CHUNK_MAGIC = 0x4B4E4843;   // "CHNK"
+
+// 列索引
+static const int COL_TIMESTAMP = 0;
+static const int COL_CHANNEL0 = 1;
+static const int COL_STATE = CH_COUNT + 1;
+static const int COL_FLAGS = CH_COUNT + 2;
+
+// 每行各列最坏情况编码位数（用于按内存预算计算块行数）
+static const size_t WORST_TS_BITS = 80;       // 首差值 varint 最长 10 字节
+static const size_t WORST_FLOAT_BITS = 44;    // 1 + 1 + 5 + 5 + 32
+static const size_t WORST_RUN_BITS = 24;      // 值 varint 2 字节 + 游程 varint 1 字节
+static const size_t COLUMN_SLACK_BYTES = 16;
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static inline uint64_t zigzagEncode(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t zigzagDecode(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float bitsToFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static bool readFully(int fd, void* buf, size_t len, off_t offset) {
+    uint8_t* p = static_cast<uint8_t*>(buf);
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, offset);
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+        offset += n;
+    }
+    return true;
+}
+
+// ===================== BitWriter / BitReader =====================
+
+void BitWriter::writeBits(uint64_t value, int bits) {
+    for (int i = bits - 1; i >= 0; i--) {
+        if ((_bitPos >> 3) >= _capacity) return;   // 调用方已按最坏情况分配，不应发生
+        if ((value >> i) & 1) {
+            _buf[_bitPos >> 3] |= (uint8_t)(0x80 >> (_bitPos & 7));
+        }
+        _bitPos++;
+    }
+}
+
+void BitWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        writeBits((value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+    writeBits(value, 8);
+}
+
+uint64_t BitReader::readBits(int bits) {
+    uint64_t value = 0;
+    for (int i = 0; i < bits; i++) {
+        uint8_t bit = 0;
+        if ((_bitPos >> 3) < _size) {
+            bit = (_buf[_bitPos >> 3] >> (7 - (_bitPos & 7))) & 1;
+        }
+        _bitPos++;
+        value = (value << 1) | bit;
+    }
+    return value;
+}
+
+uint64_t BitReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint64_t byte = readBits(8);
+        value |= (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+        if (overrun()) break;
+    }
+    return value;
+}
+
+// 已有文件与当前格式不符（升级后通道数变化等）时改名保留，不拒绝写入也不覆盖
+static bool rotateIncompatible(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return true;
+    ColumnarFileHeader header;
+    ssize_t n = pread(fd, &header, sizeof(header), 0);
+    ::close(fd);
+
+    bool magicOk = (n == (ssize_t)sizeof(header) && memcmp(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) == 0);
+    if (n == 0 || (magicOk && header.version == COLUMNAR_FILE_VERSION && header.channelCount == CH_COUNT)) {
+        return true;
+    }
+
+    std::string rotated = path + (magicOk ? ".v" + std::to_string(header.version) : std::string(".old"));
+    if (::rename(path.c_str(), rotated.c_str()) != 0) {
+        LOG_E(STORE) {
+            Serial.print("[Columnar] 旧趋势文件格式不符且无法改名: ");
+            Serial.println(rotated);
+        }
+        return false;
+    }
+    LOG_W(STORE) {
+        Serial.print("[Columnar] 旧趋势文件格式不符，已改名为 ");
+        Serial.println(rotated);
+    }
+    return true;
+}
+
+// ===================== ColumnarWriter =====================
+
+ColumnarWriter::ColumnarWriter(const std::string& path, size_t memoryBudget, unsigned long chunkSpanMs)
+    : _path(path), _memoryBudget(memoryBudget), _chunkSpanMs(chunkSpanMs), _fd(-1),
+      _active(0), _columns(_buffers[0].columns), _maxRows(0),
+      _pending(-1), _stopWriter(false), _lastWriteOk(true),
+      _rows(0), _firstTs(0), _prevTs(0), _prevDelta(0),
+      _chunkCount(0), _droppedChunks(0), _bytesWritten(0), _rowsWritten(0) {
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    end();
+}
+
+bool ColumnarWriter::begin() {
+    if (_fd >= 0) return true;
+
+    // 按最坏情况划分内存预算（两组缓冲各占一半）
+    size_t bufferBudget = _memoryBudget / 2;
+    size_t worstRowBits = WORST_TS_BITS + CH_COUNT * WORST_FLOAT_BITS + 2 * WORST_RUN_BITS;
+    size_t slack = COLUMNAR_COLUMN_COUNT * COLUMN_SLACK_BYTES;
+    if (bufferBudget <= slack + worstRowBits) {
+        LOG_E(STORE) Serial.println("[Columnar] 内存预算过小");
+        return false;
+    }
+    _maxRows = (uint32_t)(((bufferBudget - slack) * 8) / worstRowBits);
+
+    size_t columnBytes[COLUMNAR_COLUMN_COUNT];
+    columnBytes[COL_TIMESTAMP] = (_maxRows * WORST_TS_BITS + 7) / 8 + COLUMN_SLACK_BYTES;
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        columnBytes[COL_CHANNEL0 + ch] = (_maxRows * WORST_FLOAT_BITS + 7) / 8 + COLUMN_SLACK_BYTES;
+    }
+    columnBytes[COL_STATE] = (_maxRows * WORST_RUN_BITS + 7) / 8 + COLUMN_SLACK_BYTES;
+    columnBytes[COL_FLAGS] = columnBytes[COL_STATE];
+
+    size_t total = 0;
+    for (uint32_t c = 0; c < COLUMNAR_COLUMN_COUNT; c++) total += columnBytes[c];
+    for (int b = 0; b < 2; b++) {
+        ChunkBuffer& buffer = _buffers[b];
+        buffer.arena.assign(total, 0);
+        size_t offset = 0;
+        for (uint32_t c = 0; c < COLUMNAR_COLUMN_COUNT; c++) {
+            buffer.columns[c].attach(&buffer.arena[offset], columnBytes[c]);
+            offset += columnBytes[c];
+        }
+    }
+    _active = 0;
+    _columns = _buffers[0].columns;
+
+    if (!rotateIncompatible(_path)) {
+        return false;
+    }
+
+    _fd = ::open(_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0) {
+        LOG_E(STORE) {
+            Serial.print("[Columnar] 无法打开文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(_fd, &st) != 0) {
+        end();
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        ColumnarFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+        header.version = COLUMNAR_FILE_VERSION;
+        header.channelCount = CH_COUNT;
+        if (::write(_fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+            LOG_E(STORE) Serial.println("[Columnar] 写入文件头失败");
+            end();
+            return false;
+        }
+    } else if (!truncateIncompleteTail()) {
+        end();
+        return false;
+    }
+
+    lseek(_fd, 0, SEEK_END);
+    resetChunk();
+
+    _pending = -1;
+    _stopWriter = false;
+    _lastWriteOk = true;
+    _writerThread = std::thread(&ColumnarWriter::writerLoop, this);
+
+    LOG_I(STORE) {
+        Serial.print("[Columnar] 趋势存储 ");
+        Serial.print(_path);
+        Serial.print(", 每块最多 ");
+        Serial.print((unsigned long)_maxRows);
+        Serial.println(" 行");
+    }
+    return true;
+}
+
+// 掉电可能留下写了一半的数据块：逐块检查，截掉第一个不完整/校验失败的块及其后内容
+bool ColumnarWriter::truncateIncompleteTail() {
+    ColumnarFileHeader header;
+    if (!readFully(_fd, &header, sizeof(header), 0) ||
+        memcmp(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0 ||
+        header.version != COLUMNAR_FILE_VERSION || header.channelCount != CH_COUNT) {
+        LOG_E(STORE) Serial.println("[Columnar] 文件格式不匹配，拒绝追加");
+        return false;
+    }
+
+    struct stat st;
+    fstat(_fd, &st);
+    off_t offset = sizeof(ColumnarFileHeader);
+    off_t lastChunk = -1;
+    ColumnarChunkHeader chunk;
+
+    while (offset + (off_t)sizeof(chunk) <= st.st_size) {
+        if (!readFully(_fd, &chunk, sizeof(chunk), offset) || chunk.magic != COLUMNAR_CHUNK_MAGIC ||
+            offset + (off_t)sizeof(chunk) + (off_t)chunk.payloadSize > st.st_size) {
+            break;
+        }
+        lastChunk = offset;
+        offset += sizeof(chunk) + chunk.payloadSize;
+        _chunkCount++;
+    }
+
+    // 只有最后一个块可能在写入时被打断，只需校验它
+    if (lastChunk >= 0) {
+        readFully(_fd, &chunk, sizeof(chunk), lastChunk);
+        std::vector<uint8_t> payload(chunk.payloadSize);
+        if (!readFully(_fd, payload.data(), payload.size(), lastChunk + sizeof(chunk)) ||
+            crc32Update(0, payload.data(), payload.size()) != chunk.payloadCrc) {
+            offset = lastChunk;
+            _chunkCount--;
+        }
+    }
+
+    if (offset != st.st_size) {
+        LOG_W(STORE) {
+            Serial.print("[Columnar] 截掉末尾不完整数据 ");
+            Serial.print((unsigned long)(st.st_size - offset));
+            Serial.println(" 字节");
+        }
+        if (ftruncate(_fd, offset) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ColumnarWriter::end() {
+    if (_fd >= 0) {
+        flush();
+        stopWriter();
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+void ColumnarWriter::stopWriter() {
+    if (_writerThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_writerMutex);
+            _stopWriter = true;
+        }
+        _writerCond.notify_all();
+        _writerThread.join();
+    }
+}
+
+void ColumnarWriter::resetChunk() {
+    for (uint32_t c = 0; c < COLUMNAR_COLUMN_COUNT; c++) {
+        _columns[c].reset();
+    }
+    _rows = 0;
+    _firstTs = 0;
+    _prevTs = 0;
+    _prevDelta = 0;
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        _prevBits[ch] = 0;
+        _prevLeading[ch] = -1;
+        _prevTrailing[ch] = 0;
+        _sum[ch] = 0.0;
+        _min[ch] = FLT_MAX;
+        _max[ch] = -FLT_MAX;
+    }
+    _runValue[0] = _runValue[1] = 0;
+    _runLength[0] = _runLength[1] = 0;
+}
+
+void ColumnarWriter::encodeTimestamp(uint64_t ts) {
+    BitWriter& w = _columns[COL_TIMESTAMP];
+    if (_rows == 0) {
+        w.writeBits(ts, 64);
+        _firstTs = ts;
+    } else if (_rows == 1) {
+        _prevDelta = (int64_t)(ts - _prevTs);
+        w.writeVarint(zigzagEncode(_prevDelta));
+    } else {
+        int64_t delta = (int64_t)(ts - _prevTs);
+        uint64_t dod = zigzagEncode(delta - _prevDelta);
+        if (dod == 0) {
+            w.writeBits(0x0, 1);
+        } else if (dod < (1u << 7)) {
+            w.writeBits(0x2, 2);
+            w.writeBits(dod, 7);
+        } else if (dod < (1u << 12)) {
+            w.writeBits(0x6, 3);
+            w.writeBits(dod, 12);
+        } else if (dod < (1u << 20)) {
+            w.writeBits(0xE, 4);
+            w.writeBits(dod, 20);
+        } else {
+            w.writeBits(0xF, 4);
+            w.writeBits(dod, 64);
+        }
+        _prevDelta = delta;
+    }
+    _prevTs = ts;
+}
+
+void ColumnarWriter::encodeFloat(int ch, float value) {
+    BitWriter& w = _columns[COL_CHANNEL0 + ch];
+    uint32_t bits = floatBits(value);
+
+    if (_rows == 0) {
+        w.writeBits(bits, 32);
+    } else {
+        uint32_t x = bits ^ _prevBits[ch];
+        if (x == 0) {
+            w.writeBits(0, 1);
+        } else {
+            w.writeBits(1, 1);
+            int leading = __builtin_clz(x);
+            int trailing = __builtin_ctz(x);
+            if (leading > 31) leading = 31;
+
+            if (_prevLeading[ch] >= 0 && leading >= _prevLeading[ch] && trailing >= _prevTrailing[ch]) {
+                // 有效位落在上一个窗口内，复用窗口
+                int len = 32 - _prevLeading[ch] - _prevTrailing[ch];
+                w.writeBits(0, 1);
+                w.writeBits(x >> _prevTrailing[ch], len);
+            } else {
+                int len = 32 - leading - trailing;
+                w.writeBits(1, 1);
+                w.writeBits((uint64_t)leading, 5);
+                w.writeBits((uint64_t)(len - 1), 5);
+                w.writeBits(x >> trailing, len);
+                _prevLeading[ch] = leading;
+                _prevTrailing[ch] = trailing;
+            }
+        }
+    }
+    _prevBits[ch] = bits;
+
+    if (value < _min[ch]) _min[ch] = value;
+    if (value > _max[ch]) _max[ch] = value;
+    _sum[ch] += value;
+}
+
+void ColumnarWriter::encodeRun(int which, uint8_t value) {
+    if (_runLength[which] > 0 && value == _runValue[which]) {
+        _runLength[which]++;
+        return;
+    }
+    if (_runLength[which] > 0) {
+        BitWriter& w = _columns[which == 0 ? COL_STATE : COL_FLAGS];
+        w.writeVarint(_runValue[which]);
+        w.writeVarint(_runLength[which]);
+    }
+    _runValue[which] = value;
+    _runLength[which] = 1;
+}
+
+void ColumnarWriter::closeRuns() {
+    for (int which = 0; which < 2; which++) {
+        if (_runLength[which] > 0) {
+            BitWriter& w = _columns[which == 0 ? COL_STATE : COL_FLAGS];
+            w.writeVarint(_runValue[which]);
+            w.writeVarint(_runLength[which]);
+            _runLength[which] = 0;
+        }
+    }
+}
+
+bool ColumnarWriter::append(const SampleFrame& frame) {
+    if (_fd < 0) return false;
+
+    // 墙上时钟被回拨（NTP/RTC 校时）：先封掉当前块，保证每个块内时间戳单调、
+    // 块头的首末时间戳仍是有效区间；回拨前后的块时间范围可能重叠，查询按块各自判断
+    if (_rows > 0 && frame.timestampUs < _prevTs) {
+        LOG_W(STORE) {
+            Serial.print("[Columnar] 时钟回拨 ");
+            Serial.print((float)((_prevTs - frame.timestampUs) / 1000.0), 1);
+            Serial.println(" ms，提前封块");
+        }
+        sealChunk();
+    }
+
+    // 块已满或时间跨度超限时封块交给写线程
+    if (_rows > 0 && (_rows >= _maxRows ||
+                      frame.timestampUs - _firstTs >= (uint64_t)_chunkSpanMs * 1000ULL)) {
+        sealChunk();
+    }
+
+    encodeTimestamp(frame.timestampUs);
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        encodeFloat(ch, frame.values[ch]);
+    }
+    encodeRun(0, frame.breathState);
+    encodeRun(1, frame.flags);
+    _rows++;
+    return true;
+}
+
+// 封好当前块交给写线程并切换到另一组缓冲；写线程还在写上一块时丢弃当前块，不等待
+bool ColumnarWriter::sealChunk() {
+    if (_rows == 0) return true;
+
+    closeRuns();
+
+    ColumnarChunkHeader& header = _buffers[_active].header;
+    memset(&header, 0, sizeof(header));
+    header.magic = COLUMNAR_CHUNK_MAGIC;
+    header.rowCount = _rows;
+    header.firstTimestampUs = _firstTs;
+    header.lastTimestampUs = _prevTs;
+
+    uint32_t offset = 0;
+    for (uint32_t c = 0; c < COLUMNAR_COLUMN_COUNT; c++) {
+        uint32_t size = (uint32_t)_columns[c].bytes();
+        header.columnOffset[c] = offset;
+        header.columnSize[c] = size;
+        offset += size;
+    }
+    header.payloadSize = offset;
+
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        header.summary[ch].minValue = _min[ch];
+        header.summary[ch].maxValue = _max[ch];
+        header.summary[ch].meanValue = (float)(_sum[ch] / _rows);
+    }
+
+    bool handedOff = false;
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        if (_pending < 0) {
+            _pending = _active;
+            handedOff = true;
+        }
+    }
+
+    if (handedOff) {
+        _writerCond.notify_all();
+        _active ^= 1;
+        _columns = _buffers[_active].columns;
+    } else {
+        _droppedChunks++;
+        LOG_W(STORE) Serial.println("[Columnar] 上一数据块尚未写完，丢弃当前块");
+    }
+
+    resetChunk();
+    return handedOff;
+}
+
+// 写线程中执行：校验、写出并落盘一个已封好的块
+bool ColumnarWriter::writeChunk(ChunkBuffer& buffer) {
+    ColumnarChunkHeader& header = buffer.header;
+
+    struct iovec iov[1 + COLUMNAR_COLUMN_COUNT];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+
+    uint32_t crc = 0;
+    for (uint32_t c = 0; c < COLUMNAR_COLUMN_COUNT; c++) {
+        uint8_t* data = buffer.columns[c].data();
+        uint32_t size = header.columnSize[c];
+        crc = crc32Update(crc, data, size);
+        iov[1 + c].iov_base = data;
+        iov[1 + c].iov_len = size;
+    }
+    header.payloadCrc = crc;
+
+    ssize_t expected = (ssize_t)(sizeof(header) + header.payloadSize);
+    ssize_t written = writev(_fd, iov, 1 + COLUMNAR_COLUMN_COUNT);
+    if (written != expected) {
+        LOG_E(STORE) Serial.println("[Columnar] 写入数据块失败");
+        return false;
+    }
+
+    fdatasync(_fd);
+    _chunkCount++;
+    _bytesWritten += (uint64_t)written;
+    _rowsWritten += header.rowCount;
+    return true;
+}
+
+void ColumnarWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (true) {
+        _writerCond.wait(lock, [this] { return _pending >= 0 || _stopWriter; });
+        if (_pending < 0) break;   // 停止且没有待写的块
+
+        int index = _pending;
+        lock.unlock();
+        bool ok = writeChunk(_buffers[index]);
+        lock.lock();
+
+        _lastWriteOk = ok;
+        _pending = -1;
+        _writerCond.notify_all();
+    }
+}
+
+bool ColumnarWriter::flush() {
+    if (_fd < 0) return true;
+
+    // 先等上一块写完，保证当前块不会被丢弃
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    _writerCond.wait(lock, [this] { return _pending < 0; });
+    if (_rows == 0) return _lastWriteOk;
+    lock.unlock();
+
+    sealChunk();
+
+    lock.lock();
+    _writerCond.wait(lock, [this] { return _pending < 0; });
+    return _lastWriteOk;
+}
+
+// ===================== ColumnarReader =====================
+
+void ColumnarQueryResult::clear() {
+    timestamps.clear();
+    for (int ch = 0; ch < CH_COUNT; ch++) values[ch].clear();
+    states.clear();
+    flags.clear();
+    chunksScanned = 0;
+    chunksSkipped = 0;
+}
+
+ColumnarReader::ColumnarReader(const std::string& path)
+    : _path(path), _fd(-1), _scanOffset(0) {
+}
+
+ColumnarReader::~ColumnarReader() {
+    close();
+}
+
+bool ColumnarReader::open() {
+    close();
+    _fd = ::open(_path.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        LOG_E(STORE) {
+            Serial.print("[Columnar] 无法打开文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+
+    ColumnarFileHeader header;
+    if (!readFully(_fd, &header, sizeof(header), 0) ||
+        memcmp(header.magic, COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0 ||
+        header.version != COLUMNAR_FILE_VERSION || header.channelCount != CH_COUNT) {
+        LOG_E(STORE) Serial.println("[Columnar] 文件格式不匹配");
+        close();
+        return false;
+    }
+
+    _scanOffset = sizeof(ColumnarFileHeader);
+    return refresh();
+}
+
+void ColumnarReader::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _chunks.clear();
+    _scanOffset = 0;
+}
+
+bool ColumnarReader::refresh() {
+    if (_fd < 0) return false;
+
+    struct stat st;
+    if (fstat(_fd, &st) != 0) return false;
+
+    ChunkIndex entry;
+    while (_scanOffset + (off_t)sizeof(ColumnarChunkHeader) <= st.st_size) {
+        if (!readFully(_fd, &entry.header, sizeof(entry.header), _scanOffset) ||
+            entry.header.magic != COLUMNAR_CHUNK_MAGIC) {
+            break;
+        }
+        off_t end = _scanOffset + (off_t)sizeof(ColumnarChunkHeader) + (off_t)entry.header.payloadSize;
+        if (end > st.st_size) break;   // 写入端尚未写完
+
+        entry.offset = _scanOffset + (off_t)sizeof(ColumnarChunkHeader);
+        _chunks.push_back(entry);
+        _scanOffset = end;
+    }
+    return true;
+}
+
+bool ColumnarReader::decodeChunk(const ChunkIndex& chunk, uint64_t fromUs, uint64_t toUs,
+                                 uint32_t columnMask, ColumnarQueryResult& out) {
+    const ColumnarChunkHeader& h = chunk.header;
+    uint32_t rows = h.rowCount;
+
+    // 时间戳列
+    _columnBuf.resize(h.columnSize[COL_TIMESTAMP]);
+    if (!readFully(_fd, _columnBuf.data(), _columnBuf.size(), chunk.offset + h.columnOffset[COL_TIMESTAMP])) {
+        return false;
+    }
+    std::vector<uint64_t> ts(rows);
+    {
+        BitReader r(_columnBuf.data(), _columnBuf.size());
+        int64_t delta = 0;
+        for (uint32_t i = 0; i < rows; i++) {
+            if (i == 0) {
+                ts[i] = r.readBits(64);
+            } else if (i == 1) {
+                delta = zigzagDecode(r.readVarint());
+                ts[i] = ts[i - 1] + delta;
+            } else {
+                uint64_t dod = 0;
+                if (r.readBits(1) == 0) {
+                    dod = 0;
+                } else if (r.readBits(1) == 0) {
+                    dod = r.readBits(7);
+                } else if (r.readBits(1) == 0) {
+                    dod = r.readBits(12);
+                } else if (r.readBits(1) == 0) {
+                    dod = r.readBits(20);
+                } else {
+                    dod = r.readBits(64);
+                }
+                delta += zigzagDecode(dod);
+                ts[i] = ts[i - 1] + delta;
+            }
+        }
+        if (r.overrun()) return false;
+    }
+
+    // 落在查询范围内的行区间（块内时间戳单调）
+    uint32_t first = 0;
+    while (first < rows && ts[first] < fromUs) first++;
+    uint32_t last = first;
+    while (last < rows && ts[last] <= toUs) last++;
+    if (first == last) return true;
+
+    out.timestamps.insert(out.timestamps.end(), ts.begin() + first, ts.begin() + last);
+
+    // 通道列
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        if (!(columnMask & COLUMN_MASK_CHANNEL(ch))) continue;
+
+        int col = COL_CHANNEL0 + ch;
+        _columnBuf.resize(h.columnSize[col]);
+        if (!readFully(_fd, _columnBuf.data(), _columnBuf.size(), chunk.offset + h.columnOffset[col])) {
+            return false;
+        }
+
+        BitReader r(_columnBuf.data(), _columnBuf.size());
+        uint32_t prev = 0;
+        int leading = 0;
+        int trailing = 0;
+        std::vector<float>& dst = out.values[ch];
+        for (uint32_t i = 0; i < last; i++) {
+            uint32_t bits;
+            if (i == 0) {
+                bits = (uint32_t)r.readBits(32);
+            } else if (r.readBits(1) == 0) {
+                bits = prev;
+            } else {
+                if (r.readBits(1) == 1) {
+                    leading = (int)r.readBits(5);
+                    int len = (int)r.readBits(5) + 1;
+                    trailing = 32 - leading - len;
+                }
+                int len = 32 - leading - trailing;
+                bits = prev ^ ((uint32_t)r.readBits(len) << trailing);
+            }
+            prev = bits;
+            if (i >= first) dst.push_back(bitsToFloat(bits));
+        }
+        if (r.overrun()) return false;
+    }
+
+    // 状态/标志列
+    for (int which = 0; which < 2; which++) {
+        uint32_t mask = (which == 0) ? COLUMN_MASK_STATE : COLUMN_MASK_FLAGS;
+        if (!(columnMask & mask)) continue;
+
+        int col = (which == 0) ? COL_STATE : COL_FLAGS;
+        _columnBuf.resize(h.columnSize[col]);
+        if (!readFully(_fd, _columnBuf.data(), _columnBuf.size(), chunk.offset + h.columnOffset[col])) {
+            return false;
+        }
+
+        BitReader r(_columnBuf.data(), _columnBuf.size());
+        std::vector<uint8_t>& dst = (which == 0) ? out.states : out.flags;
+        uint32_t row = 0;
+        while (row < last && !r.overrun()) {
+            uint8_t value = (uint8_t)r.readVarint();
+            uint32_t run = (uint32_t)r.readVarint();
+            for (uint32_t k = 0; k < run && row < last; k++, row++) {
+                if (row >= first) dst.push_back(value);
+            }
+        }
+        if (row < last) return false;
+    }
+
+    return true;
+}
+
+bool ColumnarReader::read(uint64_t fromUs, uint64_t toUs, uint32_t columnMask,
+                          ColumnarQueryResult& out, const ColumnarValueFilter* filter) {
+    out.clear();
+    if (_fd < 0) return false;
+
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        const ColumnarChunkHeader& h = _chunks[i].header;
+
+        // 依据块摘要跳过不相交的块
+        bool skip = (h.lastTimestampUs < fromUs || h.firstTimestampUs > toUs);
+        if (!skip && filter && filter->channel >= 0 && filter->channel < CH_COUNT) {
+            const ColumnSummary& s = h.summary[filter->channel];
+            skip = (s.maxValue < filter->minValue || s.minValue > filter->maxValue);
+        }
+        if (skip) {
+            out.chunksSkipped++;
+            continue;
+        }
+
+        out.chunksScanned++;
+        if (!decodeChunk(_chunks[i], fromUs, toUs, columnMask, out)) {
+            LOG_W(STORE) {
+                Serial.print("[Columnar] 数据块解码失败, 序号 ");
+                Serial.println((unsigned long)i);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ColumnarReader::summarize(uint64_t fromUs, uint64_t toUs, int channel, ColumnSummary& out) const {
+    if (channel < 0 || channel >= CH_COUNT) return false;
+
+    double sum = 0.0;
+    uint64_t rows = 0;
+    out.minValue = FLT_MAX;
+    out.maxValue = -FLT_MAX;
+    for (size_t i = 0; i < _chunks.size(); i++) {
+        const ColumnarChunkHeader& h = _chunks[i].header;
+        if (h.lastTimestampUs < fromUs || h.firstTimestampUs > toUs) continue;
+
+        const ColumnSummary& s = h.summary[channel];
+        if (s.minValue < out.minValue) out.minValue = s.minValue;
+        if (s.maxValue > out.maxValue) out.maxValue = s.maxValue;
+        sum += (double)s.meanValue * h.rowCount;
+        rows += h.rowCount;
+    }
+    if (rows == 0) return false;
+    out.meanValue = (float)(sum / rows);
+    return true;
+}
@@ -0,0 +1,241 @@
+#ifndef ColumnarStore_h
+#define ColumnarStore_h
+
+#include "LuckfoxArduino.h"
+#include "SampleFrame.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 长期趋势存储：分块列式压缩格式
+//
+// 文件 = ColumnarFileHeader + 若干数据块，每个数据块：
+//   ColumnarChunkHeader（行数、时间范围、各通道 min/max/mean、各列偏移与长度、CRC）
+//   列数据：时间戳列 | CH_COUNT 个通道列 | 呼吸状态列 | 标志列
+//
+// 编码方式：
+//   时间戳   - 首值原样 + 首差值 zigzag varint，其后为 delta-of-delta 变长位编码
+//   通道数值 - Gorilla 风格 XOR 浮点压缩
+//   状态/标志 - (值, 游程长度) varint RLE
+//
+// 已有文件的版本或通道数与当前不符时改名为 <路径>.v<旧版本> 保留，再新建文件。
+//
+// 写入端在固定内存预算内工作：所有列缓冲区在 begin() 时按最坏情况一次性分配，
+// 分成两组交替使用。缓冲满或超过块时长时封好当前块交给后台写线程落盘，
+// 采集线程立即切到另一组继续编码；上一块还没写完时新块被丢弃并计数。
+// 读取端只解码被请求的列，并可依据块摘要跳过时间范围或数值范围不相交的块。
+//
+// 时间戳为 epochMicros()（Unix 微秒）。时钟回拨时写入端提前封块，块内始终单调，
+// 但回拨前后的块时间范围可能重叠，此时查询结果按写入顺序而不是时间顺序排列。
+
+constexpr uint32_t COLUMNAR_FILE_VERSION = 3;              // 2: 增加 CH_VOLUME; 3: 时间戳改为 Unix 微秒
+constexpr uint32_t COLUMNAR_COLUMN_COUNT = CH_COUNT + 3;   // 时间戳 + 通道 + 状态 + 标志
+constexpr size_t COLUMNAR_DEFAULT_BUDGET = 64 * 1024;       // 写入端内存预算(字节)
+constexpr unsigned long COLUMNAR_DEFAULT_CHUNK_MS = 60000;  // 单个数据块最长时间跨度
+constexpr const char* COLUMNAR_DEFAULT_PATH = "/root/breath_trend.col";
+
+// 列选择掩码（时间戳列总是会被解码）
+constexpr uint32_t COLUMN_MASK_CHANNEL(int ch) { return 1u << ch; }
+constexpr uint32_t COLUMN_MASK_STATE = 1u << CH_COUNT;
+constexpr uint32_t COLUMN_MASK_FLAGS = 1u << (CH_COUNT + 1);
+constexpr uint32_t COLUMN_MASK_ALL = (1u << (CH_COUNT + 2)) - 1;
+
+struct ColumnSummary {
+    float minValue;
+    float maxValue;
+    float meanValue;
+};
+
+struct ColumnarFileHeader {
+    char magic[8];              // "BRCOL\0\0\0"
+    uint32_t version;
+    uint32_t channelCount;
+};
+
+struct ColumnarChunkHeader {
+    uint32_t magic;             // COLUMNAR_CHUNK_MAGIC
+    uint32_t rowCount;
+    uint64_t firstTimestampUs;
+    uint64_t lastTimestampUs;
+    uint32_t payloadSize;       // 紧随块头的列数据总字节数
+    uint32_t payloadCrc;        // 列数据 CRC32
+    ColumnSummary summary[CH_COUNT];
+    uint32_t columnOffset[COLUMNAR_COLUMN_COUNT];  // 相对列数据起点
+    uint32_t columnSize[COLUMNAR_COLUMN_COUNT];
+};
+
+// 位流写入/读取（高位在前）
+class BitWriter {
+public:
+    BitWriter() : _buf(nullptr), _capacity(0), _bitPos(0) {}
+    void attach(uint8_t* buf, size_t capacity) { _buf = buf; _capacity = capacity; reset(); }
+    void reset() { _bitPos = 0; if (_buf) memset(_buf, 0, _capacity); }
+    void writeBits(uint64_t value, int bits);
+    void writeVarint(uint64_t value);
+    size_t bytes() const { return (_bitPos + 7) / 8; }
+    size_t capacity() const { return _capacity; }
+    uint8_t* data() const { return _buf; }
+private:
+    uint8_t* _buf;
+    size_t _capacity;
+    size_t _bitPos;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* buf, size_t size) : _buf(buf), _size(size), _bitPos(0) {}
+    uint64_t readBits(int bits);
+    uint64_t readVarint();
+    bool overrun() const { return _bitPos > _size * 8; }
+private:
+    const uint8_t* _buf;
+    size_t _size;
+    size_t _bitPos;
+};
+
+// 流式写入端，可作为 SampleSink 直接挂到 BreathController
+class ColumnarWriter : public SampleSink {
+public:
+    ColumnarWriter(const std::string& path = COLUMNAR_DEFAULT_PATH,
+                   size_t memoryBudget = COLUMNAR_DEFAULT_BUDGET,
+                   unsigned long chunkSpanMs = COLUMNAR_DEFAULT_CHUNK_MS);
+    ~ColumnarWriter();
+
+    // 打开文件（截掉末尾不完整的数据块后追加），启动后台写线程
+    bool begin();
+    // 写出当前缓冲并关闭
+    void end();
+
+    // 热路径：只做内存编码，块满时交给后台写线程，不做系统调用
+    bool append(const SampleFrame& frame);
+    void onSample(const SampleFrame& frame) override { append(frame); }
+
+    // 立即写出当前块并等待落盘（阻塞，不要在采集线程中调用）
+    bool flush();
+
+    uint32_t getRowsPerChunk() const { return _maxRows; }
+    uint32_t getChunkCount() const { return _chunkCount.load(); }
+    uint32_t getDroppedChunks() const { return _droppedChunks.load(); }
+    uint64_t getBytesWritten() const { return _bytesWritten.load(); }
+    uint64_t getRowsWritten() const { return _rowsWritten.load(); }
+
+private:
+    // 一组列缓冲区及封好的块头
+    struct ChunkBuffer {
+        std::vector<uint8_t> arena;
+        BitWriter columns[COLUMNAR_COLUMN_COUNT];
+        ColumnarChunkHeader header;
+    };
+
+    std::string _path;
+    size_t _memoryBudget;
+    unsigned long _chunkSpanMs;
+    int _fd;
+
+    // 预分配的两组缓冲，_columns 指向正在编码的一组
+    ChunkBuffer _buffers[2];
+    int _active;
+    BitWriter* _columns;
+    uint32_t _maxRows;
+
+    // 后台写线程：_pending 为等待落盘的缓冲序号（-1 表示空闲）
+    std::thread _writerThread;
+    std::mutex _writerMutex;
+    std::condition_variable _writerCond;
+    int _pending;
+    bool _stopWriter;
+    bool _lastWriteOk;
+
+    // 当前块状态
+    uint32_t _rows;
+    uint64_t _firstTs;
+    uint64_t _prevTs;
+    int64_t _prevDelta;
+    uint32_t _prevBits[CH_COUNT];
+    int _prevLeading[CH_COUNT];
+    int _prevTrailing[CH_COUNT];
+    double _sum[CH_COUNT];
+    float _min[CH_COUNT];
+    float _max[CH_COUNT];
+    uint8_t _runValue[2];
+    uint32_t _runLength[2];
+
+    // 统计
+    std::atomic<uint32_t> _chunkCount;
+    std::atomic<uint32_t> _droppedChunks;
+    std::atomic<uint64_t> _bytesWritten;
+    std::atomic<uint64_t> _rowsWritten;
+
+    void resetChunk();
+    bool sealChunk();
+    bool writeChunk(ChunkBuffer& buffer);
+    void writerLoop();
+    void stopWriter();
+    void encodeTimestamp(uint64_t ts);
+    void encodeFloat(int ch, float value);
+    void encodeRun(int which, uint8_t value);
+    void closeRuns();
+    bool truncateIncompleteTail();
+};
+
+// 查询结果：按列存放，未请求的列为空
+struct ColumnarQueryResult {
+    std::vector<uint64_t> timestamps;
+    std::vector<float> values[CH_COUNT];
+    std::vector<uint8_t> states;
+    std::vector<uint8_t> flags;
+    uint32_t chunksScanned;
+    uint32_t chunksSkipped;
+
+    void clear();
+    size_t size() const { return timestamps.size(); }
+};
+
+// 数值范围过滤：只解码该通道 [minValue, maxValue] 与块摘要相交的块
+struct ColumnarValueFilter {
+    int channel;
+    float minValue;
+    float maxValue;
+};
+
+class ColumnarReader {
+public:
+    ColumnarReader(const std::string& path = COLUMNAR_DEFAULT_PATH);
+    ~ColumnarReader();
+
+    // 打开文件并建立块索引（只读取块头）
+    bool open();
+    void close();
+    // 重新扫描新追加的块（用于读取仍在写入的文件）
+    bool refresh();
+
+    size_t getChunkCount() const { return _chunks.size(); }
+    const ColumnarChunkHeader& getChunk(size_t index) const { return _chunks[index].header; }
+
+    // 读取 [fromUs, toUs] 内的行，只解码 columnMask 指定的列
+    bool read(uint64_t fromUs, uint64_t toUs, uint32_t columnMask,
+              ColumnarQueryResult& out, const ColumnarValueFilter* filter = nullptr);
+
+    // 仅依据块摘要计算通道在时间范围内的 min/max/mean（不解码数据，边界块整体计入）
+    bool summarize(uint64_t fromUs, uint64_t toUs, int channel, ColumnSummary& out) const;
+
+private:
+    struct ChunkIndex {
+        off_t offset;               // 列数据起点在文件中的偏移
+        ColumnarChunkHeader header;
+    };
+
+    std::string _path;
+    int _fd;
+    off_t _scanOffset;
+    std::vector<ChunkIndex> _chunks;
+    std::vector<uint8_t> _columnBuf;
+
+    bool decodeChunk(const ChunkIndex& chunk, uint64_t fromUs, uint64_t toUs,
+                     uint32_t columnMask, ColumnarQueryResult& out);
+};
+
+#endif
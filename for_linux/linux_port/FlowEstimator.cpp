@@ -0,0 +1,133 @@
+#include "FlowEstimator.h"
+#include "LogModules.h"
+
+FlowEstimator::FlowEstimator(const OrificeConfig& config)
+    : _config(config), _zeroPa(0.0f), _rawDpPa(0.0f), _dpPa(0.0f), _flow(0.0f), _points(0) {
+}
+
+// 参考密度下 |dp| 对应的流量 (ml/min)
+float FlowEstimator::referenceFlow(float dpPa) const {
+    float s = sqrtf(dpPa);
+
+    if (_points == 0) {
+        float d = _config.orificeDiameterMm / 1000.0f;
+        float beta = _config.orificeDiameterMm / _config.pipeDiameterMm;
+        float area = (float)M_PI * d * d / 4.0f;
+        float k = _config.dischargeCoeff * area / sqrtf(1.0f - beta * beta * beta * beta);
+        float m3s = k * sqrtf(2.0f / FLOW_REF_DENSITY) * s;
+        return m3s * 6.0e7f;    // m^3/s -> ml/min
+    }
+
+    // 表外按端点斜率外推（纯平方根律）
+    if (s <= _sqrtDp[0]) {
+        return _calFlow[0] / _sqrtDp[0] * s;
+    }
+    for (uint8_t i = 1; i < _points; i++) {
+        if (s <= _sqrtDp[i]) {
+            float t = (s - _sqrtDp[i - 1]) / (_sqrtDp[i] - _sqrtDp[i - 1]);
+            return _calFlow[i - 1] + t * (_calFlow[i] - _calFlow[i - 1]);
+        }
+    }
+    return _calFlow[_points - 1] / _sqrtDp[_points - 1] * s;
+}
+
+float FlowEstimator::update(float mainKpa, float backupKpa, float temperatureC) {
+    float upstream = _config.upstreamIsMain ? mainKpa : backupKpa;
+    float downstream = _config.upstreamIsMain ? backupKpa : mainKpa;
+    _rawDpPa = (upstream - downstream) * 1000.0f;
+    _dpPa = _rawDpPa - _zeroPa;
+
+    float magnitude = fabsf(_dpPa);
+    if (magnitude < _config.deadbandPa) {
+        _flow = 0.0f;
+        return _flow;
+    }
+
+    // 温度修正：Q ∝ 1/sqrt(rho)，等压下 rho ∝ 1/T
+    float tempRatio = (273.15f + temperatureC) / (273.15f + FLOW_REF_TEMPERATURE_C);
+    if (!(tempRatio > 0.5f && tempRatio < 2.0f)) {
+        tempRatio = 1.0f;   // 温度读数异常时不修正
+    }
+
+    _flow = referenceFlow(magnitude) * sqrtf(tempRatio);
+    if (_dpPa < 0.0f) {
+        _flow = -_flow;
+    }
+    return _flow;
+}
+
+bool FlowEstimator::setCalibration(const float* dpPa, const float* flowMlMin, uint8_t count) {
+    if (count == 0 || count > FLOW_CAL_MAX_POINTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (dpPa[i] <= 0.0f || flowMlMin[i] <= 0.0f ||
+            (i > 0 && (dpPa[i] <= dpPa[i - 1] || flowMlMin[i] < flowMlMin[i - 1]))) {
+            LOG_W(FLOW) Serial.println("[Flow] 标定表须为正且按压差递增");
+            return false;
+        }
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        _sqrtDp[i] = sqrtf(dpPa[i]);
+        _calFlow[i] = flowMlMin[i];
+    }
+    _points = count;
+    return true;
+}
+
+bool FlowEstimator::save(const char* ns) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return false;
+    }
+    prefs.putFloat("zero_pa", _zeroPa);
+    prefs.putInt("points", _points);
+    for (uint8_t i = 0; i < _points; i++) {
+        std::string dpKey = "dp" + std::to_string(i);
+        std::string qKey = "q" + std::to_string(i);
+        prefs.putFloat(dpKey.c_str(), _sqrtDp[i] * _sqrtDp[i]);
+        prefs.putFloat(qKey.c_str(), _calFlow[i]);
+    }
+    prefs.end();
+    LOG_I(FLOW) Serial.println("[Flow] 流量标定已保存");
+    return true;
+}
+
+bool FlowEstimator::load(const char* ns) {
+    Preferences prefs;
+    if (!prefs.begin(ns, true)) {
+        return false;
+    }
+    if (!prefs.isKey("zero_pa")) {
+        prefs.end();
+        LOG_W(FLOW) Serial.println("[Flow] 未找到流量标定，使用孔板模型且零点为 0");
+        return false;
+    }
+
+    _zeroPa = prefs.getFloat("zero_pa", 0.0f);
+    int points = prefs.getInt("points", 0);
+    float dp[FLOW_CAL_MAX_POINTS];
+    float q[FLOW_CAL_MAX_POINTS];
+    if (points < 0 || points > FLOW_CAL_MAX_POINTS) {
+        points = 0;
+    }
+    for (int i = 0; i < points; i++) {
+        std::string dpKey = "dp" + std::to_string(i);
+        std::string qKey = "q" + std::to_string(i);
+        dp[i] = prefs.getFloat(dpKey.c_str(), 0.0f);
+        q[i] = prefs.getFloat(qKey.c_str(), 0.0f);
+    }
+    prefs.end();
+
+    if (points == 0 || !setCalibration(dp, q, (uint8_t)points)) {
+        _points = 0;
+    }
+
+    LOG_I(FLOW) {
+        Serial.print("[Flow] 流量标定已加载，零点 ");
+        Serial.print(_zeroPa, 1);
+        Serial.print(" Pa，标定点 ");
+        Serial.println(_points);
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef FlowEstimator_h
+#define FlowEstimator_h
+
+#include "LuckfoxArduino.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 差压流量估计
+//
+// 主（通道1）与备用（通道3）两个 XGZP6847D 位于同一节流件（孔板/文丘里）两侧，
+// 每个采集周期的两路读数之差即节流压差，按平方根律换算流量：
+//   Q = sign(dp) * f(|dp|) * sqrt(rho_ref / rho(T))
+// f 在没有标定表时为理想孔板公式 Cd * A / sqrt(1 - beta^4) * sqrt(2|dp|/rho_ref)；
+// 有标定表时在 sqrt(dp) 域线性插值（表内每段都满足平方根律，表外按端点斜率外推）。
+// 温度修正按理想气体在等压下 rho 与绝对温度成反比。
+//
+// 零点与标定表保存在 Preferences 命名空间 "flow_cal" 中。
+
+constexpr uint8_t FLOW_CAL_MAX_POINTS = 16;
+constexpr const char* FLOW_CAL_NAMESPACE = "flow_cal";
+constexpr float FLOW_REF_TEMPERATURE_C = 20.0f;
+constexpr float FLOW_REF_DENSITY = 1.204f;          // 20°C、101.325 kPa 空气密度 (kg/m^3)
+
+struct OrificeConfig {
+    float orificeDiameterMm;    // 节流孔径
+    float pipeDiameterMm;       // 管道内径
+    float dischargeCoeff;       // 流出系数 Cd
+    float deadbandPa;           // 压差死区，低于此值输出 0（开方会放大零点附近的噪声）
+    bool upstreamIsMain;        // 主传感器在上游：正压差为吸气方向
+};
+
+static const OrificeConfig DEFAULT_ORIFICE_CONFIG = {
+    4.0f,       // orificeDiameterMm
+    15.0f,      // pipeDiameterMm
+    0.61f,      // dischargeCoeff（锐边孔板典型值）
+    5.0f,       // deadbandPa
+    true        // upstreamIsMain
+};
+
+class FlowEstimator {
+public:
+    FlowEstimator(const OrificeConfig& config = DEFAULT_ORIFICE_CONFIG);
+
+    void setConfig(const OrificeConfig& config) { _config = config; }
+    const OrificeConfig& getConfig() const { return _config; }
+
+    // 两路同周期读数 (kPa) 与气体温度 (°C) -> 流量 (ml/min)，正值为吸气方向
+    float update(float mainKpa, float backupKpa, float temperatureC);
+
+    float getFlow() const { return _flow; }
+    float getDifferentialPa() const { return _dpPa; }     // 扣除零点后的压差
+
+    // 零点：无流量时两路读数之差 (Pa)
+    void setZeroOffset(float pa) { _zeroPa = pa; }
+    float getZeroOffset() const { return _zeroPa; }
+    float getRawDifferentialPa() const { return _rawDpPa; }
+
+    // 标定表：(压差 Pa, 参考温度下流量 ml/min)，按压差升序，只取正方向，负方向镜像
+    bool setCalibration(const float* dpPa, const float* flowMlMin, uint8_t count);
+    void clearCalibration() { _points = 0; }
+    uint8_t getCalibrationPoints() const { return _points; }
+
+    bool save(const char* ns = FLOW_CAL_NAMESPACE);
+    bool load(const char* ns = FLOW_CAL_NAMESPACE);
+
+private:
+    OrificeConfig _config;
+    float _zeroPa;
+    float _rawDpPa;
+    float _dpPa;
+    float _flow;
+
+    uint8_t _points;
+    float _sqrtDp[FLOW_CAL_MAX_POINTS];
+    float _calFlow[FLOW_CAL_MAX_POINTS];
+
+    float referenceFlow(float dpPa) const;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "I2CMux.h"
+#include "LogModules.h"
 
 I2CMux::I2CMux(uint8_t address) 
     : _address(address), _activeChannel(255), _channelCount(0) {
@@ -12,7 +13,7 @@ I2CMux::I2CMux(uint8_t address)
 void I2CMux::begin() {
     // 禁用所有通道开始
     disableAllChannels();
-    Serial.println("I2C多路复用器初始化完成");
+    LOG_I(MUX) Serial.println("I2C多路复用器初始化完成");
 }
 
 void I2CMux::setAddress(uint8_t address) {
@@ -25,21 +26,25 @@ void I2CMux::addChannel(uint8_t channel, uint8_t sensorAddr, const char* sensorN
         if (channel >= _channelCount) {
             _channelCount = channel + 1;
         }
-        Serial.print("添加多路复用器通道: ");
-        Serial.print(channel);
-        Serial.print(", 传感器地址: 0x");
-        Serial.print(sensorAddr, HEX);
-        Serial.print(", 名称: ");
-        Serial.println(sensorName);
+        LOG_D(MUX) {
+            Serial.print("添加多路复用器通道: ");
+            Serial.print(channel);
+            Serial.print(", 传感器地址: 0x");
+            Serial.print(sensorAddr, HEX);
+            Serial.print(", 名称: ");
+            Serial.println(sensorName);
+        }
     }
 }
 
 void I2CMux::enableChannel(uint8_t channel, bool enable) {
     if (channel < MAX_MUX_CHANNELS) {
         _channels[channel].enabled = enable;
-        Serial.print("通道 ");
-        Serial.print(channel);
-        Serial.println(enable ? " 已启用" : " 已禁用");
+        LOG_D(MUX) {
+            Serial.print("通道 ");
+            Serial.print(channel);
+            Serial.println(enable ? " 已启用" : " 已禁用");
+        }
     }
 }
 
@@ -65,8 +70,10 @@ bool I2CMux::selectChannel(uint8_t channel) {
             delay(20); // 减少延迟时间，提高切换速度
             return true;
         } else {
-            Serial.print("选择多路复用器通道失败，错误代码: ");
-            Serial.println(error);
+            LOG_W(MUX) {
+                Serial.print("选择多路复用器通道失败，错误代码: ");
+                Serial.println(error);
+            }
             return false;
         }
     }
@@ -120,7 +127,7 @@ void I2CMux::resetI2CBus() {
     Wire.begin();
     Wire.setClock(400000);
     
-    Serial.println("I2C总线已重置");
+    LOG_I(MUX) Serial.println("I2C总线已重置");
 }
 
 void I2CMux::scanI2CDevices() {
@@ -175,11 +182,11 @@ void I2CMux::scanI2CDevices() {
 void I2CMux::lockOLEDChannel() {
     // 选择OLED通道并保持锁定状态
     selectChannel(2); // OLED现在在通道2
-    Serial.println("OLED通道已锁定");
+    LOG_D(MUX) Serial.println("OLED通道已锁定");
 }
 
 void I2CMux::unlockOLEDChannel() {
     // 禁用所有通道，释放锁定
     disableAllChannels();
-    Serial.println("OLED通道已解锁");
+    LOG_D(MUX) Serial.println("OLED通道已解锁");
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef LogModules_h
+#define LogModules_h
+
+#include "LuckfoxArduino.h"
+
+// 各模块的编译期日志级别（LOG_LEVEL_NONE/ERROR/WARN/INFO/DEBUG/TRACE）
+// 未单独指定的模块取 LOG_LEVEL_DEFAULT；make LOG_LEVEL=debug 整体调整，
+// 单个模块用 make LOG_FLAGS="-DLOG_GAS_LEVEL=LOG_LEVEL_TRACE"。
+//   BREATH  BreathController 采集与呼吸控制
+//   MUX     I2CMux
+//   GAS     ACD1100 CO2 传感器
+//   O2      电化学氧传感器
+//   ADS     ADS1115 与多输入扫描
+//   OLED    OLED 显示
+//   FLOW    CAFS3000、差压流量、潮气量
+//   CTRL    压力闭环、气阀线性化
+//   FUSION  主/备气压融合
+//   STORE   波形记录、趋势存储、总线录制回放
+//   TELEM   共享内存与网络遥测
+
+#ifndef LOG_BREATH_LEVEL
+#define LOG_BREATH_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_MUX_LEVEL
+#define LOG_MUX_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_GAS_LEVEL
+#define LOG_GAS_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_O2_LEVEL
+#define LOG_O2_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_ADS_LEVEL
+#define LOG_ADS_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_OLED_LEVEL
+#define LOG_OLED_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_FLOW_LEVEL
+#define LOG_FLOW_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_CTRL_LEVEL
+#define LOG_CTRL_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_FUSION_LEVEL
+#define LOG_FUSION_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_STORE_LEVEL
+#define LOG_STORE_LEVEL LOG_LEVEL_DEFAULT
+#endif
+#ifndef LOG_TELEM_LEVEL
+#define LOG_TELEM_LEVEL LOG_LEVEL_DEFAULT
+#endif
+
+#endif
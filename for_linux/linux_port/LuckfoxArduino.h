@@ -12,9 +12,22 @@
 #include <sys/ioctl.h>
 #include <cstdint>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdarg>
+#include <algorithm>
+#include <sys/stat.h>
 #include <termios.h>
+#include <poll.h>
+#include <dirent.h>
+#include <syslog.h>
 #include <map>
 #include <cmath>    // 数学函数: isnan, fabs 等
+#include <atomic>
+#include <mutex>
+#include <time.h>
+#include <linux/gpio.h>
 
 // I2C ioctl 命令
 #ifndef I2C_SLAVE
@@ -63,25 +76,643 @@ using std::ceil;
 
 namespace ArduinoHAL {
 
+    // --- 虚拟时钟 (回放模式) ---
+    // 启用后 millis()/micros() 返回虚拟时间，delay() 只推进虚拟时间而不休眠，
+    // 使控制逻辑可以按 CPU 速度回放录制数据。
+    // 使用函数内静态变量，保证所有编译单元共享同一个时钟。
+    struct VirtualClock {
+        std::atomic<bool> enabled;
+        std::atomic<uint64_t> nowUs;
+    };
+
+    inline VirtualClock& virtualClock() {
+        static VirtualClock clock = { {false}, {0} };
+        return clock;
+    }
+
+    inline void enableVirtualClock(uint64_t startUs) {
+        virtualClock().nowUs.store(startUs);
+        virtualClock().enabled.store(true);
+    }
+
+    inline void disableVirtualClock() {
+        virtualClock().enabled.store(false);
+    }
+
+    inline bool isVirtualClock() {
+        return virtualClock().enabled.load(std::memory_order_relaxed);
+    }
+
+    inline void advanceVirtualClock(uint64_t us) {
+        virtualClock().nowUs.fetch_add(us);
+    }
+
+    // 虚拟时间只向前推进
+    inline void advanceVirtualClockTo(uint64_t us) {
+        uint64_t now = virtualClock().nowUs.load();
+        while (us > now && !virtualClock().nowUs.compare_exchange_weak(now, us)) {
+        }
+    }
+
     // --- 时间函数 ---
     inline unsigned long millis() {
+        if (isVirtualClock()) {
+            return (unsigned long)(virtualClock().nowUs.load() / 1000);
+        }
         using namespace std::chrono;
         return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
     }
 
     inline unsigned long micros() {
+        if (isVirtualClock()) {
+            return (unsigned long)virtualClock().nowUs.load();
+        }
         using namespace std::chrono;
         return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
     }
 
+    // 64 位墙上时钟（CLOCK_REALTIME，微秒）。micros() 在 32 位目标上约 71.6 分钟回绕且从开机计时，
+    // 落盘或跨进程的采样时间戳用这个；回放时返回虚拟时间
+    inline uint64_t epochMicros() {
+        if (isVirtualClock()) {
+            return virtualClock().nowUs.load();
+        }
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000);
+    }
+
     inline void delay(unsigned long ms) {
+        if (isVirtualClock()) {
+            advanceVirtualClock((uint64_t)ms * 1000);
+            return;
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(ms));
     }
 
     inline void delayMicroseconds(unsigned int us) {
+        if (isVirtualClock()) {
+            advanceVirtualClock(us);
+            return;
+        }
         std::this_thread::sleep_for(std::chrono::microseconds(us));
     }
 
+    // --- 异步日志输出 ---
+    // Serial.print() 与 HAL 自身的消息不在调用线程上写 stdout：先放进本线程的行缓冲，
+    // 遇到换行（或缓冲满）时把整行作为一条记录放入无锁 MPSC 环形队列，由后台线程批量写到
+    // stdout/stderr、文件或 syslog。队列满时丢弃并计数，调用线程从不阻塞在输出上。
+    // Serial.print() 的数值参数不在调用线程上格式化：行缓冲里只记下类型和原始值，
+    // 由后台线程写出前展开成文本（logPrintf() 的格式串仍在调用线程上格式化，只用于 HAL 自身的消息）。
+    // 进程退出时（atexit）排空队列；需要与直接写 stdout 的输出保持先后顺序时调用 Serial.flush()。
+#ifndef LOG_SINK_SLOTS
+#define LOG_SINK_SLOTS 512          // 队列记录数，须为 2 的幂
+#endif
+    constexpr size_t LOG_RECORD_BYTES = 240;       // 单条记录（一行）的最大字节数，超长的行拆成多条
+    constexpr unsigned long LOG_SINK_IDLE_US = 5000;   // 队列空时后台线程的轮询间隔
+
+    // 记录中的延迟格式化参数：LOG_ARG_MARKER、1 字节类型、8 字节原始值、1 字节参数（小数位）。
+    // 0xFF 不会出现在合法 UTF-8 中；文本里真有 0xFF 字节时记为 LOG_ARG_BYTE
+    constexpr uint8_t LOG_ARG_MARKER = 0xFF;
+    constexpr size_t LOG_ARG_BYTES = 11;
+    constexpr int LOG_ARG_MAX_DECIMALS = 15;
+    // 一条记录展开后的最大长度：每个参数最多 56 字节（float 最大值 39 位整数 + 符号 + 小数点 + 15 位小数）
+    constexpr size_t LOG_RENDER_BYTES = LOG_RECORD_BYTES / LOG_ARG_BYTES * 56 + LOG_RECORD_BYTES;
+
+    enum LogArgType : uint8_t {
+        LOG_ARG_BYTE = 0,   // 原样输出一个 0xFF 字节
+        LOG_ARG_INT,        // int64_t，%lld
+        LOG_ARG_UINT,       // uint64_t，%llu
+        LOG_ARG_HEX,        // 0x%x
+        LOG_ARG_OCT,        // 0%o
+        LOG_ARG_BIN,        // 0b 加 32 位
+        LOG_ARG_FLOAT       // double，%.*f
+    };
+
+    // 把一条记录中的参数展开成文本，返回写入 out 的字节数（超出 cap 的部分截掉）
+    inline size_t logRender(const char* data, size_t len, char* out, size_t cap) {
+        size_t n = 0;
+        size_t i = 0;
+        while (i < len && n < cap) {
+            const char* marker = (const char*)memchr(data + i, (char)LOG_ARG_MARKER, len - i);
+            size_t text = marker ? (size_t)(marker - (data + i)) : len - i;
+            if (text > cap - n) text = cap - n;
+            memcpy(out + n, data + i, text);
+            n += text;
+            i += text;
+            if (!marker || n >= cap || i + LOG_ARG_BYTES > len) break;
+
+            uint8_t type = (uint8_t)data[i + 1];
+            uint64_t bits;
+            memcpy(&bits, data + i + 2, sizeof(bits));
+            int param = (uint8_t)data[i + 10];
+            i += LOG_ARG_BYTES;
+
+            int w = 0;
+            switch (type) {
+                case LOG_ARG_BYTE:
+                    out[n] = (char)LOG_ARG_MARKER;
+                    w = 1;
+                    break;
+                case LOG_ARG_INT:
+                    w = snprintf(out + n, cap - n, "%lld", (long long)(int64_t)bits);
+                    break;
+                case LOG_ARG_UINT:
+                    w = snprintf(out + n, cap - n, "%llu", (unsigned long long)bits);
+                    break;
+                case LOG_ARG_HEX:
+                    w = snprintf(out + n, cap - n, "0x%x", (unsigned int)bits);
+                    break;
+                case LOG_ARG_OCT:
+                    w = snprintf(out + n, cap - n, "0%o", (unsigned int)bits);
+                    break;
+                case LOG_ARG_BIN:
+                    if (cap - n >= 34) {
+                        out[n] = '0';
+                        out[n + 1] = 'b';
+                        for (int b = 31; b >= 0; b--) {
+                            out[n + 33 - b] = ((bits >> b) & 1) ? '1' : '0';
+                        }
+                        w = 34;
+                    }
+                    break;
+                case LOG_ARG_FLOAT: {
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+                    w = snprintf(out + n, cap - n, "%.*f", param, value);
+                    break;
+                }
+                default:
+                    break;
+            }
+            if (w > 0) n += std::min((size_t)w, cap - n);
+        }
+        return n;
+    }
+
+    enum LogRecordFlags : uint8_t {
+        LOG_RECORD_STDERR = 0x01    // 错误输出：stdout 模式下写 stderr，syslog 模式下为 LOG_ERR
+    };
+
+    enum LogOutput {
+        LOG_OUTPUT_STDOUT,
+        LOG_OUTPUT_FILE,
+        LOG_OUTPUT_SYSLOG
+    };
+
+    class LogSink {
+    private:
+        struct Slot {
+            std::atomic<size_t> seq;
+            uint16_t len;
+            uint8_t flags;
+            char data[LOG_RECORD_BYTES];
+        };
+
+        static_assert((LOG_SINK_SLOTS & (LOG_SINK_SLOTS - 1)) == 0, "LOG_SINK_SLOTS must be a power of two");
+
+        Slot slots[LOG_SINK_SLOTS];
+        std::atomic<size_t> enqueuePos;
+        size_t dequeuePos;                  // 只由后台线程（或停止后的调用线程）访问
+        std::atomic<size_t> drainedPos;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> written;
+        uint64_t reportedDrops;
+
+        std::atomic<bool> accepting;
+        std::atomic<bool> synchronous;
+        std::atomic<bool> running;
+        std::thread worker;
+
+        std::mutex outputMtx;               // 只在输出端与切换输出目标之间使用，不涉及写日志的线程
+        LogOutput output;
+        int fileFd;
+        bool syslogOpen;
+        std::string syslogLine;
+
+        // 有界 MPSC 队列：每个槽的序号表示它可写（== 写位置）还是可读（== 写位置 + 1），
+        // 生产者只用 CAS 抢占写位置
+        bool enqueue(const char* data, size_t len, uint8_t flags) {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Slot* slot;
+            for (;;) {
+                slot = &slots[pos & (LOG_SINK_SLOTS - 1)];
+                size_t seq = slot->seq.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            slot->len = (uint16_t)len;
+            slot->flags = flags;
+            memcpy(slot->data, data, len);
+            slot->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        void writeAll(int fd, const char* data, size_t len) {
+            while (len > 0) {
+                ssize_t n = ::write(fd, data, len);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    return;
+                }
+                data += n;
+                len -= (size_t)n;
+            }
+        }
+
+        // 调用方持有 outputMtx
+        void emit(const char* data, size_t len, uint8_t flags) {
+            if (len == 0) return;
+            switch (output) {
+                case LOG_OUTPUT_FILE:
+                    writeAll(fileFd, data, len);
+                    break;
+                case LOG_OUTPUT_SYSLOG:
+                    for (size_t i = 0; i < len; i++) {
+                        if (data[i] == '\n') {
+                            syslog((flags & LOG_RECORD_STDERR) ? LOG_ERR : LOG_INFO, "%s", syslogLine.c_str());
+                            syslogLine.clear();
+                        } else {
+                            syslogLine += data[i];
+                        }
+                    }
+                    break;
+                default:
+                    fwrite(data, 1, len, (flags & LOG_RECORD_STDERR) ? stderr : stdout);
+                    break;
+            }
+        }
+
+        // 取出当前可读的全部记录，同一流的相邻记录合并成一次写；返回取出的条数
+        size_t drain() {
+            char batch[4096];
+            char text[LOG_RENDER_BYTES];
+            size_t batchLen = 0;
+            uint8_t batchFlags = 0;
+            size_t count = 0;
+
+            std::lock_guard<std::mutex> lock(outputMtx);
+            for (;;) {
+                Slot& slot = slots[dequeuePos & (LOG_SINK_SLOTS - 1)];
+                if (slot.seq.load(std::memory_order_acquire) != dequeuePos + 1) {
+                    break;
+                }
+                size_t textLen = logRender(slot.data, slot.len, text, sizeof(text));
+                if (batchLen > 0 && (slot.flags != batchFlags || batchLen + textLen > sizeof(batch))) {
+                    emit(batch, batchLen, batchFlags);
+                    batchLen = 0;
+                }
+                batchFlags = slot.flags;
+                memcpy(batch + batchLen, text, textLen);
+                batchLen += textLen;
+                slot.seq.store(dequeuePos + LOG_SINK_SLOTS, std::memory_order_release);
+                dequeuePos++;
+                count++;
+            }
+            emit(batch, batchLen, batchFlags);
+
+            uint64_t drops = dropped.load(std::memory_order_relaxed);
+            if (drops != reportedDrops) {
+                int n = snprintf(batch, sizeof(batch), "[Log] 日志队列已满，丢弃 %llu 条\n",
+                                 (unsigned long long)(drops - reportedDrops));
+                emit(batch, (size_t)n, LOG_RECORD_STDERR);
+                reportedDrops = drops;
+            }
+            if (count > 0 && output == LOG_OUTPUT_STDOUT) {
+                fflush(stdout);
+                fflush(stderr);
+            }
+            written.fetch_add(count, std::memory_order_relaxed);
+            drainedPos.store(dequeuePos, std::memory_order_release);
+            return count;
+        }
+
+        void drainLoop() {
+            while (running.load(std::memory_order_acquire)) {
+                if (drain() == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(LOG_SINK_IDLE_US));
+                }
+            }
+            drain();
+        }
+
+        void closeOutput() {
+            if (fileFd >= 0) {
+                close(fileFd);
+                fileFd = -1;
+            }
+            if (syslogOpen) {
+                closelog();
+                syslogOpen = false;
+            }
+            syslogLine.clear();
+        }
+
+    public:
+        LogSink() : enqueuePos(0), dequeuePos(0), drainedPos(0), dropped(0), written(0), reportedDrops(0),
+                    accepting(true), synchronous(false), running(true), output(LOG_OUTPUT_STDOUT), fileFd(-1), syslogOpen(false) {
+            for (size_t i = 0; i < LOG_SINK_SLOTS; i++) {
+                slots[i].seq.store(i, std::memory_order_relaxed);
+            }
+            worker = std::thread(&LogSink::drainLoop, this);
+        }
+
+        LogSink(const LogSink&) = delete;
+        LogSink& operator=(const LogSink&) = delete;
+
+        // 放入一条记录；队列满时丢弃并计数。停止后或同步模式下直接写出
+        bool push(const char* data, size_t len, uint8_t flags = 0) {
+            if (len > LOG_RECORD_BYTES) len = LOG_RECORD_BYTES;
+            if (!accepting.load(std::memory_order_acquire) || synchronous.load(std::memory_order_relaxed)) {
+                char text[LOG_RENDER_BYTES];
+                size_t textLen = logRender(data, len, text, sizeof(text));
+                std::lock_guard<std::mutex> lock(outputMtx);
+                emit(text, textLen, flags);
+                if (output == LOG_OUTPUT_STDOUT) fflush((flags & LOG_RECORD_STDERR) ? stderr : stdout);
+                return true;
+            }
+            if (!enqueue(data, len, flags)) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        // 等待此前放入的记录全部写出（最多 timeoutMs）
+        bool flush(unsigned long timeoutMs = 1000) {
+            size_t target = enqueuePos.load(std::memory_order_acquire);
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+            while (running.load(std::memory_order_acquire) &&
+                   drainedPos.load(std::memory_order_acquire) < target) {
+                if (std::chrono::steady_clock::now() > deadline) return false;
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+            return true;
+        }
+
+        // 同步模式：在调用线程上直接写出，供与 std::cout 交替输出的交互式工具保持先后顺序
+        void setSynchronous(bool sync) {
+            if (sync) flush();
+            synchronous.store(sync, std::memory_order_relaxed);
+        }
+
+        // 排空队列并停止后台线程，之后的记录在调用线程上同步写出
+        void stop() {
+            accepting.store(false, std::memory_order_release);
+            running.store(false, std::memory_order_release);
+            if (worker.joinable()) {
+                worker.join();
+            }
+            drain();
+        }
+
+        void logToStdout() {
+            std::lock_guard<std::mutex> lock(outputMtx);
+            closeOutput();
+            output = LOG_OUTPUT_STDOUT;
+        }
+
+        bool logToFile(const std::string& path) {
+            int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (fd < 0) return false;
+            std::lock_guard<std::mutex> lock(outputMtx);
+            closeOutput();
+            fileFd = fd;
+            output = LOG_OUTPUT_FILE;
+            return true;
+        }
+
+        // ident 须在整个进程生命周期内有效（openlog 不复制）
+        void logToSyslog(const char* ident, int facility = LOG_USER) {
+            std::lock_guard<std::mutex> lock(outputMtx);
+            closeOutput();
+            openlog(ident, LOG_PID, facility);
+            syslogOpen = true;
+            output = LOG_OUTPUT_SYSLOG;
+        }
+
+        uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+        uint64_t getWrittenCount() const { return written.load(std::memory_order_relaxed); }
+    };
+
+    inline void stopLogSink();
+
+    // 进程内唯一的输出端，首次写日志时创建；有意不析构，静态对象析构期间的日志仍可同步写出
+    inline LogSink& logSink() {
+        static LogSink* sink = []() {
+            LogSink* s = new LogSink();
+            atexit(stopLogSink);
+            return s;
+        }();
+        return *sink;
+    }
+
+    // 本线程尚未成行的输出；POD，线程退出时无需析构
+    struct LogLine {
+        char data[LOG_RECORD_BYTES];
+        uint16_t len;
+        uint8_t flags;
+        uint32_t suppressed;        // 限频丢弃的条数，在下一行行首以 "(+N) " 标出
+    };
+
+    inline LogLine& logLine() {
+        static thread_local LogLine line;
+        return line;
+    }
+
+    inline void logFlushLine() {
+        LogLine& line = logLine();
+        if (line.len > 0) {
+            logSink().push(line.data, line.len, line.flags);
+            line.len = 0;
+        }
+    }
+
+    inline void stopLogSink() {
+        logFlushLine();
+        logSink().stop();
+    }
+
+    // 切换输出流时先交出已有内容；新行行首补上限频丢弃计数
+    inline LogLine& logBeginWrite(uint8_t flags) {
+        LogLine& line = logLine();
+        if (line.len > 0 && line.flags != flags) {
+            logFlushLine();
+        }
+        line.flags = flags;
+        if (line.len == 0 && line.suppressed > 0) {
+            line.len = (uint16_t)snprintf(line.data, LOG_RECORD_BYTES, "(+%u) ", line.suppressed);
+            line.suppressed = 0;
+        }
+        return line;
+    }
+
+    // 记下一个延迟格式化的参数（参数不跨记录拆开）
+    inline void logWriteArg(LogArgType type, uint64_t bits, uint8_t param = 0, uint8_t flags = 0) {
+        LogLine& line = logBeginWrite(flags);
+        if (LOG_RECORD_BYTES - line.len < LOG_ARG_BYTES) {
+            logFlushLine();
+        }
+        char* p = line.data + line.len;
+        p[0] = (char)LOG_ARG_MARKER;
+        p[1] = (char)type;
+        memcpy(p + 2, &bits, sizeof(bits));
+        p[10] = (char)param;
+        line.len += (uint16_t)LOG_ARG_BYTES;
+        if (line.len == LOG_RECORD_BYTES) {
+            logFlushLine();
+        }
+    }
+
+    inline void logWrite(const char* data, size_t len, uint8_t flags = 0) {
+        // 文本中的 0xFF 与参数标记冲突，拆开后单独记录（合法 UTF-8 不会走到这里）
+        const char* marker = (const char*)memchr(data, (char)LOG_ARG_MARKER, len);
+        if (marker) {
+            size_t head = (size_t)(marker - data);
+            logWrite(data, head, flags);
+            logWriteArg(LOG_ARG_BYTE, 0, 0, flags);
+            logWrite(marker + 1, len - head - 1, flags);
+            return;
+        }
+
+        LogLine& line = logBeginWrite(flags);
+        while (len > 0) {
+            size_t room = LOG_RECORD_BYTES - line.len;
+            const char* nl = (const char*)memchr(data, '\n', len);
+            size_t take = nl ? (size_t)(nl - data) + 1 : len;
+            if (take > room) take = room;
+            memcpy(line.data + line.len, data, take);
+            line.len += (uint16_t)take;
+            data += take;
+            len -= take;
+            if (line.len == LOG_RECORD_BYTES || line.data[line.len - 1] == '\n') {
+                logFlushLine();
+            }
+        }
+    }
+
+    inline void logVFormat(uint8_t flags, const char* fmt, va_list args) {
+        char buf[LOG_RECORD_BYTES];
+        int n = vsnprintf(buf, sizeof(buf), fmt, args);
+        if (n < 0) return;
+        logWrite(buf, std::min((size_t)n, sizeof(buf) - 1), flags);
+    }
+
+    __attribute__((format(printf, 1, 2)))
+    inline void logPrintf(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        logVFormat(0, fmt, args);
+        va_end(args);
+    }
+
+    __attribute__((format(printf, 1, 2)))
+    inline void logErrorf(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        logVFormat(LOG_RECORD_STDERR, fmt, args);
+        va_end(args);
+    }
+
+    // --- 日志级别与限频 ---
+    // 每个模块的编译期级别为 LOG_<模块>_LEVEL，默认取 LOG_LEVEL_DEFAULT，可在编译命令行单独覆盖
+    // （如 -DLOG_GAS_LEVEL=LOG_LEVEL_DEBUG）；模块列表见各工程的 LogModules.h，HAL 自身为 HAL。
+    // 用法：LOG_W(MUX) Serial.println("...");  多条输出组成一行时加花括号：LOG_D(GAS) { ... }
+    // 低于模块级别的语句条件为编译期常量 false，整段（连同字符串常量）被编译器删除。
+    // 启用的语句按调用点限频：每个调用点一个令牌桶（默认突发 20 条，之后每秒 5 条），
+    // 被丢弃的条数在该调用点下一次输出时以 "(+N) " 前缀给出。
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+#endif
+#ifndef LOG_HAL_LEVEL
+#define LOG_HAL_LEVEL LOG_LEVEL_DEFAULT
+#endif
+
+#define LOG_ENABLED(mod, level) (LOG_##mod##_LEVEL >= (level))
+#define LOG_AT(mod, level) \
+    if (!(LOG_ENABLED(mod, level) && \
+          []() -> ::ArduinoHAL::LogRateLimiter& { static ::ArduinoHAL::LogRateLimiter site; return site; }().allow())) {} else
+#define LOG_E(mod) LOG_AT(mod, LOG_LEVEL_ERROR)
+#define LOG_W(mod) LOG_AT(mod, LOG_LEVEL_WARN)
+#define LOG_I(mod) LOG_AT(mod, LOG_LEVEL_INFO)
+#define LOG_D(mod) LOG_AT(mod, LOG_LEVEL_DEBUG)
+#define LOG_T(mod) LOG_AT(mod, LOG_LEVEL_TRACE)
+
+    struct LogRateConfig {
+        std::atomic<uint32_t> burst;
+        std::atomic<uint32_t> perSecond;    // 0 表示不限频
+    };
+
+    inline LogRateConfig& logRateConfig() {
+        static LogRateConfig config = { {20}, {5} };
+        return config;
+    }
+
+    inline void setLogRateLimit(uint32_t burst, uint32_t perSecond) {
+        logRateConfig().burst.store(burst);
+        logRateConfig().perSecond.store(perSecond);
+    }
+
+    // 调用点令牌桶，无锁：令牌（按 1/1000 条定点计数）与上次补充时刻 millis() 打包在一个
+    // 64 位原子量里，一次 CAS 完成补充与扣减；回放时按虚拟时间限频
+    class LogRateLimiter {
+    private:
+        static constexpr uint32_t UNPRIMED = UINT32_MAX;   // 令牌字段的初值：首次调用时装满
+        std::atomic<uint64_t> state;        // 高 32 位 millis()，低 32 位令牌
+        std::atomic<uint32_t> suppressed;
+
+    public:
+        LogRateLimiter() : state(UNPRIMED), suppressed(0) {}
+
+        bool allow() {
+            uint32_t rate = logRateConfig().perSecond.load(std::memory_order_relaxed);
+            if (rate != 0) {
+                uint64_t cap = std::min((uint64_t)logRateConfig().burst.load(std::memory_order_relaxed) * 1000,
+                                        (uint64_t)UNPRIMED - 1);
+                uint32_t now = (uint32_t)millis();
+                uint64_t cur = state.load(std::memory_order_relaxed);
+                bool granted;
+                for (;;) {
+                    uint32_t last = (uint32_t)(cur >> 32);
+                    uint32_t tokens = (uint32_t)cur;
+                    // 其他线程已用更晚的时刻补充过时不倒退
+                    uint32_t elapsed = (int32_t)(now - last) > 0 ? now - last : 0;
+                    uint64_t avail = (tokens == UNPRIMED) ? cap
+                                   : std::min(cap, (uint64_t)tokens + (uint64_t)elapsed * rate);
+                    granted = avail >= 1000;
+                    uint64_t next = ((uint64_t)(elapsed || tokens == UNPRIMED ? now : last) << 32) |
+                                    (uint32_t)(granted ? avail - 1000 : avail);
+                    if (state.compare_exchange_weak(cur, next, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                if (!granted) {
+                    suppressed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            if (suppressed.load(std::memory_order_relaxed) != 0) {
+                logLine().suppressed += suppressed.exchange(0, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    };
+
     // --- 数学和工具函数 ---
     template<typename T>
     inline T constrain(T value, T min_val, T max_val) {
@@ -126,52 +757,166 @@ namespace ArduinoHAL {
         return std::rand() % max_val;
     }
 
-    // --- 全局函数：pinMode/digitalWrite (简化版本) ---
-    // 注意：简化实现，建议创建 GPIO 对象进行控制
-    inline void pinMode(int pin, const char* mode) {
-        // 占位符实现
-        static bool warned = false;
-        if (!warned) {
-            std::cout << "[pinMode] 警告: GPIO 功能简化实现，建议使用 GPIO 类" << std::endl;
-            warned = true;
+    // --- GPIO 字符设备后端 (/dev/gpiochipN, uAPI v2) ---
+    // 行句柄请求后一直保持打开：读、写各只需一次 ioctl；同一请求中的多条线可原子地
+    // 同时设置/读取（如气阀使能与报警输出）；输入线可请求边沿事件，事件带内核时间戳。
+    // 内核头文件不支持 v2 接口时 request() 返回 false，调用方可退回 sysfs。
+    struct GpioEdgeEvent {
+        uint32_t offset;        // 芯片内线序号
+        bool rising;            // true 上升沿, false 下降沿
+        uint64_t timestampNs;   // 内核时间戳（CLOCK_MONOTONIC）
+        uint32_t seqno;         // 该请求内的事件序号（可据此发现丢失的事件）
+    };
+
+    class GpioLines {
+    public:
+        enum Direction { LINE_INPUT, LINE_OUTPUT };
+        enum Edge { EDGE_NONE = 0, EDGE_RISING = 1, EDGE_FALLING = 2, EDGE_BOTH = 3 };
+
+        GpioLines(const std::string& chip = "/dev/gpiochip0") : chip_path(chip) {}
+        GpioLines(const GpioLines&) = delete;
+        GpioLines& operator=(const GpioLines&) = delete;
+
+        ~GpioLines() {
+            release();
         }
-        // TODO: 实际应该创建全局 GPIO 对象映射表
-    }
 
-    inline void digitalWrite(int pin, int value) {
-        // 占位符实现
-        static bool warned = false;
-        if (!warned) {
-            std::cout << "[digitalWrite] 警告: GPIO 功能简化实现，建议使用 GPIO 类" << std::endl;
-            warned = true;
+        // 请求一组线；位序号（setValues/getValues 的 bit i）对应 offsets[i]
+        bool request(const std::vector<unsigned>& offsets, Direction dir, Edge edge = EDGE_NONE,
+                     uint64_t initial_values = 0, const char* consumer = "breath_controller") {
+            release();
+#ifdef GPIO_V2_GET_LINE_IOCTL
+            if (offsets.empty() || offsets.size() > GPIO_V2_LINES_MAX) return false;
+
+            int chip_fd = open(chip_path.c_str(), O_RDWR | O_CLOEXEC);
+            if (chip_fd < 0) return false;
+
+            struct gpio_v2_line_request req;
+            memset(&req, 0, sizeof(req));
+            for (size_t i = 0; i < offsets.size(); i++) {
+                req.offsets[i] = offsets[i];
+            }
+            req.num_lines = offsets.size();
+            strncpy(req.consumer, consumer, GPIO_MAX_NAME_SIZE - 1);
+
+            if (dir == LINE_OUTPUT) {
+                req.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+                req.config.num_attrs = 1;
+                req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+                req.config.attrs[0].attr.values = initial_values;
+                req.config.attrs[0].mask = allMask(offsets.size());
+            } else {
+                req.config.flags = GPIO_V2_LINE_FLAG_INPUT;
+                if (edge & EDGE_RISING) req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_RISING;
+                if (edge & EDGE_FALLING) req.config.flags |= GPIO_V2_LINE_FLAG_EDGE_FALLING;
+            }
+
+            int ret = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req);
+            close(chip_fd);
+            if (ret < 0) return false;
+
+            line_fd = req.fd;
+            line_count = offsets.size();
+            return true;
+#else
+            (void)offsets; (void)dir; (void)edge; (void)initial_values; (void)consumer;
+            return false;
+#endif
         }
-        // TODO: 实际应该使用全局 GPIO 对象映射表
-    }
 
-    inline int digitalRead(int pin) {
-        // 占位符实现
-        return 0;
-    }
+        void release() {
+            if (line_fd >= 0) {
+                close(line_fd);
+                line_fd = -1;
+            }
+            line_count = 0;
+        }
+
+        bool isOpen() const { return line_fd >= 0; }
+        size_t count() const { return line_count; }
+
+        // 原子设置：只改 mask 中为 1 的线
+        bool setValues(uint64_t bits, uint64_t mask) {
+#ifdef GPIO_V2_LINE_SET_VALUES_IOCTL
+            if (line_fd < 0) return false;
+            struct gpio_v2_line_values values;
+            values.bits = bits;
+            values.mask = mask & allMask(line_count);
+            return ioctl(line_fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == 0;
+#else
+            (void)bits; (void)mask;
+            return false;
+#endif
+        }
 
-    // --- 全局函数：analogWrite (PWM 输出占位符) ---
-    // 注意：简化实现，仅用于编译通过
-    // 实际使用时需要根据硬件配置 PWM
-    inline void analogWrite(int pin, int value) {
-        // 占位符实现：实际需要配置 /sys/class/pwm/
-        // 这里仅打印调试信息
-        static bool warned = false;
-        if (!warned) {
-            std::cout << "[analogWrite] 警告: PWM 功能未完全实现，需要手动配置硬件" << std::endl;
-            warned = true;
+        // 原子读取 mask 中的线
+        bool getValues(uint64_t& bits, uint64_t mask = ~0ULL) {
+#ifdef GPIO_V2_LINE_GET_VALUES_IOCTL
+            if (line_fd < 0) return false;
+            struct gpio_v2_line_values values;
+            values.bits = 0;
+            values.mask = mask & allMask(line_count);
+            if (ioctl(line_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) != 0) return false;
+            bits = values.bits;
+            return true;
+#else
+            (void)bits; (void)mask;
+            return false;
+#endif
         }
-        // TODO: 实现真实的 PWM 控制
-    }
+
+        // 等待一个边沿事件：返回 1 有事件, 0 超时, -1 出错; timeoutMs < 0 表示一直等待
+        int waitEvent(GpioEdgeEvent& event, int timeoutMs) {
+#ifdef GPIO_V2_GET_LINE_IOCTL
+            if (line_fd < 0) return -1;
+            struct pollfd pfd;
+            pfd.fd = line_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            int ret = poll(&pfd, 1, timeoutMs);
+            if (ret <= 0) return ret;
+
+            struct gpio_v2_line_event raw;
+            if (::read(line_fd, &raw, sizeof(raw)) != (ssize_t)sizeof(raw)) return -1;
+            event.offset = raw.offset;
+            event.rising = (raw.id == GPIO_V2_LINE_EVENT_RISING_EDGE);
+            event.timestampNs = raw.timestamp_ns;
+            event.seqno = raw.line_seqno;
+            return 1;
+#else
+            (void)event; (void)timeoutMs;
+            return -1;
+#endif
+        }
+
+        // 丢弃已排队的事件
+        void flushEvents() {
+            GpioEdgeEvent event;
+            while (waitEvent(event, 0) > 0) {}
+        }
+
+    private:
+        std::string chip_path;
+        int line_fd = -1;
+        size_t line_count = 0;
+
+        static uint64_t allMask(size_t n) {
+            return n >= 64 ? ~0ULL : ((1ULL << n) - 1);
+        }
+    };
 
     // --- GPIO 控制类 (模拟 pinMode/digitalWrite) ---
+    // 引脚号沿用 sysfs 编号：芯片 = pin / 32，线序号 = pin % 32（如 GPIO1_C7 = 55）。
+    // 优先走字符设备，行句柄常驻，digitalWrite/digitalRead 各一次 ioctl；
+    // 打不开 /dev/gpiochipN 或该线已被 sysfs 导出时退回 sysfs 文件接口。
     class GPIO {
     private:
         int pin;
         bool exported = false;
+        int value_fd = -1;      // sysfs 边沿等待用的常驻 value 文件描述符
+        GpioLines lines;        // 字符设备行句柄
+        bool output = false;
+        GpioLines::Edge edge = GpioLines::EDGE_NONE;
 
         void write_sysfs(const std::string& path, const std::string& value) {
             std::ofstream fs(path);
@@ -192,10 +937,20 @@ namespace ArduinoHAL {
             return value;
         }
 
+        bool requestLine() {
+            std::vector<unsigned> offsets(1, (unsigned)(pin % 32));
+            return lines.request(offsets,
+                                 output ? GpioLines::LINE_OUTPUT : GpioLines::LINE_INPUT,
+                                 output ? GpioLines::EDGE_NONE : edge);
+        }
+
     public:
-        GPIO(int gpio_pin) : pin(gpio_pin) {}
+        GPIO(int gpio_pin) : pin(gpio_pin), lines("/dev/gpiochip" + std::to_string(gpio_pin / 32)) {}
+        GPIO(const GPIO&) = delete;
+        GPIO& operator=(const GPIO&) = delete;
 
         ~GPIO() {
+           if (value_fd >= 0) close(value_fd);
            // 可选：析构时 unexport，但通常保留以供后续使用
            // if (exported) write_sysfs("/sys/class/gpio/unexport", std::to_string(pin));
         }
@@ -212,33 +967,165 @@ namespace ArduinoHAL {
         }
 
         void pinMode(const std::string& mode) {
+            output = (mode == OUTPUT);
+            if (requestLine()) return;
+
             begin();
             write_sysfs("/sys/class/gpio/gpio" + std::to_string(pin) + "/direction", mode);
         }
 
         void digitalWrite(int value) {
+            if (lines.isOpen()) {
+                lines.setValues(value ? 1 : 0, 1);
+                return;
+            }
             write_sysfs("/sys/class/gpio/gpio" + std::to_string(pin) + "/value", std::to_string(value));
         }
 
         int digitalRead() {
+            if (lines.isOpen()) {
+                uint64_t bits = 0;
+                return lines.getValues(bits, 1) ? (int)(bits & 1) : 0;
+            }
             std::string val = read_sysfs("/sys/class/gpio/gpio" + std::to_string(pin) + "/value");
             try {
                 return std::stoi(val);
             } catch (...) { return 0; }
         }
+
+        // 设置边沿中断: "none" / "rising" / "falling" / "both"（需先 pinMode("in")）
+        void setEdge(const std::string& edge_name) {
+            edge = edge_name == "rising" ? GpioLines::EDGE_RISING
+                 : edge_name == "falling" ? GpioLines::EDGE_FALLING
+                 : edge_name == "both" ? GpioLines::EDGE_BOTH
+                 : GpioLines::EDGE_NONE;
+            if (!output && !exported && requestLine()) return;
+
+            begin();
+            write_sysfs("/sys/class/gpio/gpio" + std::to_string(pin) + "/edge", edge_name);
+            if (value_fd < 0) {
+                std::string path = "/sys/class/gpio/gpio" + std::to_string(pin) + "/value";
+                value_fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+                if (value_fd < 0) {
+                    LOG_E(HAL) logErrorf("[GPIO] Failed to open %s\n", path.c_str());
+                    return;
+                }
+            }
+            clearEdge();
+        }
+
+        // 等待一次边沿事件（睡眠等待不占 CPU）
+        // 返回 1 有事件, 0 超时, -1 未配置边沿或出错; timeoutMs < 0 表示一直等待
+        // timestampNs 非空时写入事件时间戳（字符设备为内核时间戳，sysfs 为唤醒时刻）
+        int waitForEdge(int timeoutMs, uint64_t* timestampNs = nullptr) {
+            if (lines.isOpen()) {
+                GpioEdgeEvent event;
+                int ret = lines.waitEvent(event, timeoutMs);
+                if (ret > 0 && timestampNs) *timestampNs = event.timestampNs;
+                return ret;
+            }
+
+            if (value_fd < 0) return -1;
+            struct pollfd pfd;
+            pfd.fd = value_fd;
+            pfd.events = POLLPRI | POLLERR;
+            pfd.revents = 0;
+            int ret = poll(&pfd, 1, timeoutMs);
+            if (ret <= 0) return ret;
+            clearEdge();
+            if (timestampNs) {
+                struct timespec ts;
+                clock_gettime(CLOCK_MONOTONIC, &ts);
+                *timestampNs = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+            }
+            return 1;
+        }
+
+        // 是否在使用字符设备后端
+        bool isCharDevice() const { return lines.isOpen(); }
+
+    private:
+        // sysfs 要求读一次 value 才会重新武装 POLLPRI
+        void clearEdge() {
+            char buf[8];
+            lseek(value_fd, 0, SEEK_SET);
+            ssize_t n = ::read(value_fd, buf, sizeof(buf));
+            (void)n;
+        }
     };
 
+    // --- 全局函数：pinMode/digitalWrite/digitalRead ---
+    // 引脚号与 GPIO 类相同。首次 pinMode() 时创建该引脚的 GPIO 对象并常驻，之后的
+    // digitalWrite()/digitalRead() 直接复用行句柄，不再打开文件。
+    inline GPIO* gpioPin(int pin, bool create) {
+        static std::map<int, GPIO*> pins;   // 进程生命周期内常驻，不释放
+        static std::mutex pins_mutex;
+        std::lock_guard<std::mutex> lock(pins_mutex);
+        std::map<int, GPIO*>::iterator it = pins.find(pin);
+        if (it != pins.end()) return it->second;
+        if (!create) return nullptr;
+        GPIO* gpio = new GPIO(pin);
+        pins[pin] = gpio;
+        return gpio;
+    }
+
+    inline void pinMode(int pin, const char* mode) {
+        gpioPin(pin, true)->pinMode(mode);
+    }
+
+    inline void digitalWrite(int pin, int value) {
+        GPIO* gpio = gpioPin(pin, false);
+        if (!gpio) {
+            LOG_W(HAL) logErrorf("[digitalWrite] 引脚 %d 未调用 pinMode()\n", pin);
+            return;
+        }
+        gpio->digitalWrite(value);
+    }
+
+    inline int digitalRead(int pin) {
+        GPIO* gpio = gpioPin(pin, false);
+        return gpio ? gpio->digitalRead() : 0;
+    }
+
+    // --- PWM 钩子 ---
+    // 安装后新 begin() 的 PWM 通道不访问 /sys/class/pwm（不导出、不使能），
+    // 占空比写入只做记账并通知钩子。用于总线回放等不应驱动真实气阀的场合。
+    class PwmHook {
+    public:
+        virtual ~PwmHook() {}
+        virtual void onDuty(int /*chip*/, int /*channel*/, unsigned long /*duty_ns*/) {}
+    };
+
+    inline PwmHook*& pwmHook() {
+        static PwmHook* hook = nullptr;
+        return hook;
+    }
+
     // --- PWM 控制类 (模拟 analogWrite) ---
     // Linux PWM需要指定 芯片号(chip) 和 通道号(channel)
     // 例如: PWM0_CH1 -> chip 0, channel 1 (具体取决于设备树配置，可能需要要在 /sys/class/pwm/ 下查看)
+    // duty_cycle 文件在 begin() 时打开并常驻，每次更新只是一次 pwrite()，
+    // 与上次相同的占空比直接跳过，可在控制环路频率（>= 500 Hz）下调用。
     class PWM {
     private:
         int chip;
         int channel;
         unsigned long period_ns = 1000000; // 默认周期 1ms (1kHz)
+        int duty_fd = -1;                  // 常驻的 duty_cycle 文件描述符
+        long last_duty_ns = -1;            // 已写入的占空比，-1 表示未知
+        unsigned long last_actuation_us = 0;
+        uint32_t write_count = 0;
+        uint32_t skip_count = 0;
+        uint32_t error_count = 0;
+        bool simulated = false;            // begin() 时已安装 PwmHook：不访问 sysfs
+
+        std::string channelPath() const {
+            return "/sys/class/pwm/pwmchip" + std::to_string(chip) + "/pwm" + std::to_string(channel);
+        }
 
         void write_pwm(const std::string& file, const std::string& value) {
-            std::string path = "/sys/class/pwm/pwmchip" + std::to_string(chip) + "/pwm" + std::to_string(channel) + "/" + file;
+            if (simulated) return;
+            std::string path = channelPath() + "/" + file;
             std::ofstream fs(path);
             if (fs.is_open()) {
                 fs << value;
@@ -248,11 +1135,21 @@ namespace ArduinoHAL {
 
     public:
         PWM(int pwm_chip, int pwm_channel) : chip(pwm_chip), channel(pwm_channel) {}
+        PWM(const PWM&) = delete;
+        PWM& operator=(const PWM&) = delete;
+
+        ~PWM() {
+            if (duty_fd >= 0) close(duty_fd);
+        }
 
         void begin() {
+             last_duty_ns = -1;
+             simulated = (pwmHook() != nullptr);
+             if (simulated) return;
+
              // 导出PWM通道
              std::string export_path = "/sys/class/pwm/pwmchip" + std::to_string(chip) + "/export";
-             std::string channel_path = "/sys/class/pwm/pwmchip" + std::to_string(chip) + "/pwm" + std::to_string(channel);
+             std::string channel_path = channelPath();
              
              if (access(channel_path.c_str(), F_OK) != 0) {
                  std::ofstream fs(export_path);
@@ -262,14 +1159,30 @@ namespace ArduinoHAL {
                      delay(50); 
                  }
              }
+
+             if (duty_fd < 0) {
+                 std::string duty_path = channel_path + "/duty_cycle";
+                 duty_fd = open(duty_path.c_str(), O_WRONLY | O_CLOEXEC);
+                 if (duty_fd < 0) {
+                     LOG_E(HAL) logErrorf("[PWM] Failed to open %s\n", duty_path.c_str());
+                 }
+             }
         }
 
         // 设置频率 (Hz)
         void setFrequency(unsigned long freq_hz) {
-            period_ns = 1000000000UL / freq_hz;
+            if (freq_hz == 0) return;
+            unsigned long new_period = 1000000000UL / freq_hz;
+            // 内核要求 duty <= period：缩短周期前先把占空比按比例缩下来
+            if (last_duty_ns > 0 && (unsigned long)last_duty_ns > new_period) {
+                setDutyNs((unsigned long)((double)last_duty_ns * new_period / period_ns));
+            }
+            period_ns = new_period;
             write_pwm("period", std::to_string(period_ns));
         }
 
+        unsigned long getPeriodNs() const { return period_ns; }
+
         // 启动PWM
         void enable() {
             write_pwm("enable", "1");
@@ -280,13 +1193,44 @@ namespace ArduinoHAL {
             write_pwm("enable", "0");
         }
 
+        // 直接设置占空比（纳秒），与上次相同时不写入
+        // 返回 false 表示写入失败（未 begin() 或内核拒绝）
+        bool setDutyNs(unsigned long duty_ns) {
+            if (duty_ns > period_ns) duty_ns = period_ns;
+            if ((long)duty_ns == last_duty_ns) {
+                skip_count++;
+                return true;
+            }
+            if (simulated) {
+                PwmHook* hook = pwmHook();
+                if (hook) hook->onDuty(chip, channel, duty_ns);
+            } else {
+                if (duty_fd < 0) {
+                    error_count++;
+                    return false;
+                }
+
+                char buf[24];
+                int len = snprintf(buf, sizeof(buf), "%lu", duty_ns);
+                if (pwrite(duty_fd, buf, len, 0) != len) {
+                    error_count++;
+                    last_duty_ns = -1;
+                    return false;
+                }
+            }
+            last_duty_ns = (long)duty_ns;
+            last_actuation_us = micros();
+            write_count++;
+            return true;
+        }
+
         // 模拟Arduino的 analogWrite (0-255)
         void analogWrite(int duty) {
             if (duty < 0) duty = 0;
             if (duty > 255) duty = 255;
             
             unsigned long duty_ns = (period_ns * duty) / 255;
-            write_pwm("duty_cycle", std::to_string(duty_ns));
+            setDutyNs(duty_ns);
         }
         
         // 更精确的占空比设置 (0.0 - 1.0)
@@ -294,37 +1238,485 @@ namespace ArduinoHAL {
              if (percent < 0.0) percent = 0.0;
              if (percent > 1.0) percent = 1.0;
              unsigned long duty_ns = (unsigned long)(period_ns * percent);
-             write_pwm("duty_cycle", std::to_string(duty_ns));
+             setDutyNs(duty_ns);
         }
+
+        // 最近一次实际写入 duty_cycle 的时刻（micros()），及写入/跳过/失败次数
+        unsigned long getLastActuationUs() const { return last_actuation_us; }
+        long getDutyNs() const { return last_duty_ns; }
+        uint32_t getWriteCount() const { return write_count; }
+        uint32_t getSkipCount() const { return skip_count; }
+        uint32_t getErrorCount() const { return error_count; }
     };
 
+    // --- 全局函数：analogWrite ---
+    // 引脚需先用 attachPwm() 绑定到 pwmchip/通道，之后 analogWrite(pin, 0..255) 直接更新该通道的占空比。
+    inline PWM* pwmPin(int pin, PWM* attach = nullptr) {
+        static std::map<int, PWM*> pins;    // 进程生命周期内常驻，不释放
+        static std::mutex pins_mutex;
+        std::lock_guard<std::mutex> lock(pins_mutex);
+        if (attach) {
+            std::map<int, PWM*>::iterator it = pins.find(pin);
+            if (it != pins.end()) delete it->second;
+            pins[pin] = attach;
+            return attach;
+        }
+        std::map<int, PWM*>::iterator it = pins.find(pin);
+        return it != pins.end() ? it->second : nullptr;
+    }
+
+    // 把引脚绑定到 PWM 通道：导出、设置频率、占空比清零并使能
+    inline PWM* attachPwm(int pin, int chip, int channel, unsigned long freq_hz = 1000) {
+        PWM* pwm = new PWM(chip, channel);
+        pwm->begin();
+        pwm->setDutyNs(0);
+        pwm->setFrequency(freq_hz);
+        pwm->enable();
+        return pwmPin(pin, pwm);
+    }
+
+    inline void analogWrite(int pin, int value) {
+        PWM* pwm = pwmPin(pin);
+        if (!pwm) {
+            static bool warned = false;
+            if (!warned) {
+                LOG_W(HAL) logErrorf("[analogWrite] 引脚 %d 未调用 attachPwm()\n", pin);
+                warned = true;
+            }
+            return;
+        }
+        pwm->analogWrite(value);
+    }
+
     // --- ADC 控制类 (模拟 analogRead) ---
     // 通常位于 /sys/bus/iio/devices/iio:device0/in_voltageX_raw
     class ADC {
     private:
         int channel;
         std::string device_path;
+        int fd;
 
     public:
-        ADC(int adc_channel, int device_idx = 0) : channel(adc_channel) {
+        ADC(int adc_channel, int device_idx = 0) : channel(adc_channel), fd(-1) {
             device_path = "/sys/bus/iio/devices/iio:device" + std::to_string(device_idx) + "/";
         }
 
+        ~ADC() {
+            if (fd >= 0) close(fd);
+        }
+
+        ADC(const ADC&) = delete;
+        ADC& operator=(const ADC&) = delete;
+
+        // in_voltageX_raw 首次读取时打开并常驻，之后每次从偏移 0 pread 触发一次新的转换，
+        // 省去每个样本的 open/close 与流解析。需要 kHz 级采样时用 IIOBuffer。
         int analogRead() {
-            std::string path = device_path + "in_voltage" + std::to_string(channel) + "_raw";
+            if (fd < 0) {
+                std::string path = device_path + "in_voltage" + std::to_string(channel) + "_raw";
+                fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) return -1; // 读取失败
+            }
+            char buf[24];
+            ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+            if (n <= 0) return -1;
+            buf[n] = '\0';
+            char* end = nullptr;
+            long value = strtol(buf, &end, 10);
+            if (end == buf) return -1;
+            return (int)value;
+        }
+    };
+
+    // --- IIO 缓冲采集 (kHz 级模拟采样) ---
+    // 由触发器（默认在 configfs 中创建 hrtimer 触发器）按固定频率启动转换，内核把启用的
+    // 扫描元素打包写入 /dev/iio:deviceN。采集线程在 poll() 上睡眠，按块读出后依
+    // scan_elements/*_type 的描述（字节序、符号、有效位、移位）解包，连同时间戳放入
+    // 单生产者/单消费者环形缓冲，下游用 read() 批量取出。
+    // 启用了 in_timestamp 时使用内核在触发时刻打的时间戳（时钟切换为 monotonic），
+    // 否则按读出时刻与采样周期倒推。环形缓冲满时丢弃新样本并计入 getOverruns()。
+    constexpr size_t IIO_MAX_SCAN_CHANNELS = 8;
+
+    struct IIOSample {
+        int64_t timestampNs;                    // CLOCK_MONOTONIC
+        int32_t values[IIO_MAX_SCAN_CHANNELS];  // 按 begin() 传入的通道顺序
+    };
+
+    class IIOBuffer {
+    private:
+        struct ScanElement {
+            int index;          // scan_elements/*_index，决定在记录中的顺序
+            int slot;           // IIOSample::values 下标，时间戳为 -1
+            size_t offset;      // 在记录中的字节偏移
+            uint8_t bytes;      // 存储宽度
+            uint8_t realBits;
+            uint8_t shift;
+            bool isSigned;
+            bool bigEndian;
+        };
+
+        int device_idx;
+        std::string device_path;
+        std::string dev_node;
+        int fd;
+        std::vector<ScanElement> elements;
+        std::vector<std::string> enabled_names;
+        size_t record_bytes;
+        size_t block_samples;
+        unsigned long sample_rate;
+        bool has_timestamp;
+        std::string created_trigger;    // 本对象在 configfs 中创建的触发器目录
+
+        std::vector<IIOSample> ring;
+        size_t ring_mask;
+        std::atomic<size_t> head;       // 采集线程写位置
+        std::atomic<size_t> tail;       // 消费者读位置
+        std::atomic<bool> running;
+        std::atomic<uint64_t> sample_count;
+        std::atomic<uint64_t> overruns;
+        std::thread worker;
+
+        static bool writeAttr(const std::string& path, const std::string& value) {
+            std::ofstream fs(path);
+            if (!fs.is_open()) return false;
+            fs << value;
+            fs.flush();
+            return fs.good();
+        }
+
+        static bool readAttr(const std::string& path, std::string& value) {
             std::ifstream fs(path);
+            if (!fs.is_open()) return false;
+            std::getline(fs, value);
+            return true;
+        }
+
+        // 类型描述形如 "le:s12/16>>4"
+        static bool parseType(const std::string& type, ScanElement& el) {
+            char endian = 0, sign = 0;
+            unsigned real = 0, storage = 0, shift = 0;
+            if (sscanf(type.c_str(), "%ce:%c%u/%u>>%u", &endian, &sign, &real, &storage, &shift) != 5) {
+                return false;
+            }
+            if (storage == 0 || storage > 64 || storage % 8 != 0 || real == 0 || real > storage) {
+                return false;
+            }
+            el.bigEndian = (endian == 'b');
+            el.isSigned = (sign == 's');
+            el.realBits = (uint8_t)real;
+            el.bytes = (uint8_t)(storage / 8);
+            el.shift = (uint8_t)shift;
+            return true;
+        }
+
+        static int64_t extract(const uint8_t* rec, const ScanElement& el) {
+            uint64_t raw = 0;
+            for (uint8_t i = 0; i < el.bytes; i++) {
+                uint8_t b = el.bigEndian ? rec[el.offset + i] : rec[el.offset + el.bytes - 1 - i];
+                raw = (raw << 8) | b;
+            }
+            raw >>= el.shift;
+            if (el.realBits < 64) {
+                uint64_t mask = (1ULL << el.realBits) - 1;
+                raw &= mask;
+                if (el.isSigned && (raw & (1ULL << (el.realBits - 1)))) {
+                    raw |= ~mask;
+                }
+            }
+            return (int64_t)raw;
+        }
+
+        // 先解析类型与序号，成功后才使能：内核中使能的元素必须都在 elements 里，
+        // 否则 computeLayout() 算出的记录长度偏小，所有样本都会错位
+        bool enableElement(const std::string& name, int slot) {
+            std::string base = device_path + "scan_elements/" + name;
+            std::string type, index;
+            ScanElement el;
+            el.slot = slot;
+            el.offset = 0;
+            if (!readAttr(base + "_type", type) || !readAttr(base + "_index", index) || !parseType(type, el)) {
+                LOG_W(HAL) logErrorf("[IIO] Unsupported scan element %s type '%s'\n", name.c_str(), type.c_str());
+                return false;
+            }
+            el.index = atoi(index.c_str());
+            if (!writeAttr(base + "_en", "1")) {
+                return false;
+            }
+            enabled_names.push_back(name);
+            elements.push_back(el);
+            return true;
+        }
+
+        // 关闭全部扫描元素：上次运行（或其他程序）留下的使能元素同样会进入记录
+        void disableAllElements() {
+            std::string dir = device_path + "scan_elements/";
+            DIR* d = opendir(dir.c_str());
+            if (!d) return;
+            while (struct dirent* entry = readdir(d)) {
+                std::string name = entry->d_name;
+                if (name.size() > 3 && name.compare(name.size() - 3, 3, "_en") == 0) {
+                    writeAttr(dir + name, "0");
+                }
+            }
+            closedir(d);
+        }
+
+        // 按 index 排列，每个元素按自身存储宽度对齐，整条记录按最宽元素对齐
+        void computeLayout() {
+            std::sort(elements.begin(), elements.end(),
+                      [](const ScanElement& a, const ScanElement& b) { return a.index < b.index; });
+            size_t offset = 0;
+            size_t align = 1;
+            for (auto& el : elements) {
+                offset = (offset + el.bytes - 1) / el.bytes * el.bytes;
+                el.offset = offset;
+                offset += el.bytes;
+                if (el.bytes > align) align = el.bytes;
+            }
+            record_bytes = (offset + align - 1) / align * align;
+        }
+
+        bool setupTrigger(const std::string& trigger) {
+            std::string name = trigger;
+            if (name.empty()) {
+                name = "hal-iio" + std::to_string(device_idx);
+                std::string dir = "/sys/kernel/config/iio/triggers/hrtimer/" + name;
+                if (mkdir(dir.c_str(), 0755) == 0) {
+                    created_trigger = dir;
+                } else if (errno != EEXIST) {
+                    // 没有 hrtimer 触发器时，自带定时的设备可以直接设置采样率
+                    if (writeAttr(device_path + "sampling_frequency", std::to_string(sample_rate))) {
+                        return true;
+                    }
+                    LOG_E(HAL) {
+                        logErrorf("[IIO] Failed to create hrtimer trigger %s\n", dir.c_str());
+                        logErrorf("[IIO] Make sure configfs is mounted and iio-trig-hrtimer is loaded\n");
+                    }
+                    return false;
+                }
+            }
+
+            for (int i = 0; i < 64; i++) {
+                std::string tdir = "/sys/bus/iio/devices/trigger" + std::to_string(i) + "/";
+                std::string tname;
+                if (readAttr(tdir + "name", tname) && tname == name) {
+                    writeAttr(tdir + "sampling_frequency", std::to_string(sample_rate));
+                    break;
+                }
+            }
+
+            if (!writeAttr(device_path + "trigger/current_trigger", name)) {
+                LOG_E(HAL) logErrorf("[IIO] Failed to attach trigger %s\n", name.c_str());
+                return false;
+            }
+            return true;
+        }
+
+        void push(const IIOSample& sample) {
+            size_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) > ring_mask) {
+                overruns++;
+                return;
+            }
+            ring[h & ring_mask] = sample;
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        void captureLoop() {
+            std::vector<uint8_t> block(record_bytes * block_samples);
+            int64_t period_ns = 1000000000LL / (int64_t)sample_rate;
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+
+            while (running) {
+                int ret = poll(&pfd, 1, 100);
+                if (ret < 0 && errno != EINTR) {
+                    LOG_E(HAL) logErrorf("[IIO] poll failed on %s\n", dev_node.c_str());
+                    break;
+                }
+                if (ret <= 0) continue;
+
+                ssize_t n = ::read(fd, block.data(), block.size());
+                if (n <= 0) continue;
+
+                struct timespec now;
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                int64_t read_ns = (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+                size_t records = (size_t)n / record_bytes;
+
+                for (size_t r = 0; r < records; r++) {
+                    const uint8_t* rec = block.data() + r * record_bytes;
+                    IIOSample sample;
+                    sample.timestampNs = read_ns - (int64_t)(records - 1 - r) * period_ns;
+                    for (const auto& el : elements) {
+                        int64_t value = extract(rec, el);
+                        if (el.slot < 0) {
+                            sample.timestampNs = value;
+                        } else {
+                            sample.values[el.slot] = (int32_t)value;
+                        }
+                    }
+                    push(sample);
+                }
+                sample_count += records;
+            }
+        }
+
+    public:
+        IIOBuffer(int idx = 0)
+            : device_idx(idx), fd(-1), record_bytes(0), block_samples(0), sample_rate(0),
+              has_timestamp(false), ring_mask(0), head(0), tail(0), running(false),
+              sample_count(0), overruns(0) {
+            device_path = "/sys/bus/iio/devices/iio:device" + std::to_string(idx) + "/";
+            dev_node = "/dev/iio:device" + std::to_string(idx);
+        }
+
+        ~IIOBuffer() {
+            stop();
+        }
+
+        // channels：in_voltageX 的通道号（最多 IIO_MAX_SCAN_CHANNELS 个）
+        // ringSamples：环形缓冲容量（向上取 2 的幂），blockSamples：每次 read() 的样本数
+        // trigger 为空时创建 hrtimer 触发器，否则使用已有的同名触发器
+        bool begin(const std::vector<int>& channels, unsigned long rateHz,
+                   size_t ringSamples = 8192, size_t blockSamples = 256, const std::string& trigger = "") {
+            if (running || channels.empty() || channels.size() > IIO_MAX_SCAN_CHANNELS || rateHz == 0) {
+                return false;
+            }
+            sample_rate = rateHz;
+            block_samples = blockSamples ? blockSamples : 1;
+
+            // 缓冲使能期间不能修改扫描元素与触发器
+            writeAttr(device_path + "buffer/enable", "0");
+            disableAllElements();
+            elements.clear();
+            enabled_names.clear();
+            for (size_t i = 0; i < channels.size(); i++) {
+                if (!enableElement("in_voltage" + std::to_string(channels[i]), (int)i)) {
+                    LOG_E(HAL) logErrorf("[IIO] Failed to enable in_voltage%d\n", channels[i]);
+                    stop();
+                    return false;
+                }
+            }
+            writeAttr(device_path + "current_timestamp_clock", "monotonic");
+            has_timestamp = enableElement("in_timestamp", -1);
+            computeLayout();
+
+            if (!setupTrigger(trigger)) {
+                stop();
+                return false;
+            }
+
+            size_t capacity = 1;
+            while (capacity < ringSamples || capacity < block_samples) capacity <<= 1;
+            ring.assign(capacity, IIOSample());
+            ring_mask = capacity - 1;
+            head = 0;
+            tail = 0;
+            sample_count = 0;
+            overruns = 0;
+
+            // 内核缓冲留 4 块余量，水位线为一块，poll() 每块唤醒一次
+            writeAttr(device_path + "buffer/length", std::to_string(block_samples * 4));
+            writeAttr(device_path + "buffer/watermark", std::to_string(block_samples));
+
+            fd = open(dev_node.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+            if (fd < 0) {
+                LOG_E(HAL) logErrorf("[IIO] Failed to open %s\n", dev_node.c_str());
+                stop();
+                return false;
+            }
+            if (!writeAttr(device_path + "buffer/enable", "1")) {
+                LOG_E(HAL) logErrorf("[IIO] Failed to enable buffer on %s\n", device_path.c_str());
+                stop();
+                return false;
+            }
+
+            running = true;
+            worker = std::thread(&IIOBuffer::captureLoop, this);
+            LOG_I(HAL) logPrintf("[IIO] Buffered capture on %s: %zu channel(s) at %lu Hz, %zu bytes/sample%s\n",
+                                 dev_node.c_str(), channels.size(), rateHz, record_bytes,
+                                 has_timestamp ? ", kernel timestamps" : "");
+            return true;
+        }
+
+        void stop() {
+            running = false;
+            if (worker.joinable()) worker.join();
+
+            if (fd >= 0 || !enabled_names.empty()) {
+                writeAttr(device_path + "buffer/enable", "0");
+            }
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+            if (!created_trigger.empty()) {
+                writeAttr(device_path + "trigger/current_trigger", "\n");
+                rmdir(created_trigger.c_str());
+                created_trigger.clear();
+            }
+            for (const auto& name : enabled_names) {
+                writeAttr(device_path + "scan_elements/" + name + "_en", "0");
+            }
+            enabled_names.clear();
+        }
+
+        bool isRunning() const { return running; }
+
+        // 消费者：取出最多 max 个样本，返回实际个数（仅允许一个消费者线程）
+        size_t read(IIOSample* out, size_t max) {
+            size_t t = tail.load(std::memory_order_relaxed);
+            size_t n = head.load(std::memory_order_acquire) - t;
+            if (n > max) n = max;
+            for (size_t i = 0; i < n; i++) {
+                out[i] = ring[(t + i) & ring_mask];
+            }
+            tail.store(t + n, std::memory_order_release);
+            return n;
+        }
+
+        size_t available() const {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+
+        // 原始码到毫伏的系数（in_voltageX_scale，或所有通道共用的 in_voltage_scale）
+        float getScale(int channel) const {
             std::string value;
-            if (fs.is_open()) {
-                fs >> value;
-                fs.close();
-                try {
-                    return std::stoi(value);
-                } catch (...) { return -1; }
+            if (readAttr(device_path + "in_voltage" + std::to_string(channel) + "_scale", value) ||
+                readAttr(device_path + "in_voltage_scale", value)) {
+                return strtof(value.c_str(), nullptr);
             }
-            return -1; // 读取失败
+            return 0.0f;
         }
+
+        unsigned long getSampleRate() const { return sample_rate; }
+        size_t getRecordBytes() const { return record_bytes; }
+        bool hasTimestamp() const { return has_timestamp; }
+        uint64_t getSampleCount() const { return sample_count; }
+        uint64_t getOverruns() const { return overruns; }
     };
 
+    // --- I2C 总线钩子 (事务录制/回放) ---
+    // 所有 I2C 实例共享同一个钩子；未安装时行为与原实现完全一致。
+    class I2CBusHook {
+    public:
+        virtual ~I2CBusHook() {}
+
+        // 回放：返回 true 表示由钩子给出结果，不访问真实设备
+        virtual bool replayWrite(uint8_t /*addr*/, const uint8_t* /*data*/, size_t /*len*/, uint8_t& /*status*/) { return false; }
+        virtual bool replayRead(uint8_t /*addr*/, uint8_t* /*data*/, size_t /*len*/, ssize_t& /*result*/) { return false; }
+
+        // 录制：真实事务完成后的通知
+        virtual void onWrite(uint8_t /*addr*/, const uint8_t* /*data*/, size_t /*len*/, uint8_t /*status*/) {}
+        virtual void onRead(uint8_t /*addr*/, const uint8_t* /*data*/, ssize_t /*result*/) {}
+    };
+
+    inline I2CBusHook*& i2cBusHook() {
+        static I2CBusHook* hook = nullptr;
+        return hook;
+    }
+
     // --- I2C 控制类 (核心传感器通信) ---
     class I2C {
     private:
@@ -353,10 +1745,12 @@ namespace ArduinoHAL {
         void begin(int sda_pin = -1, int scl_pin = -1) {
             fd = open(device.c_str(), O_RDWR);
             if (fd < 0) {
-                std::cerr << "[I2C] Failed to open device: " << device << std::endl;
-                std::cerr << "[I2C] Make sure I2C is enabled via luckfox-config" << std::endl;
+                LOG_E(HAL) {
+                    logErrorf("[I2C] Failed to open device: %s\n", device.c_str());
+                    logErrorf("[I2C] Make sure I2C is enabled via luckfox-config\n");
+                }
             } else {
-                std::cout << "[I2C] Opened " << device << " successfully" << std::endl;
+                LOG_I(HAL) logPrintf("[I2C] Opened %s successfully\n", device.c_str());
             }
         }
 
@@ -373,29 +1767,25 @@ namespace ArduinoHAL {
             tx_buffer.clear();
             
             if (fd >= 0 && ioctl(fd, I2C_SLAVE, addr) < 0) {
-                std::cerr << "[I2C] Failed to set slave address 0x" 
-                          << std::hex << (int)addr << std::dec << std::endl;
+                LOG_W(HAL) logErrorf("[I2C] Failed to set slave address 0x%x\n", addr);
             }
         }
 
         // 结束传输并发送数据
-        uint8_t endTransmission(bool sendStop = true) {
-            if (fd < 0) return 4; // 其他错误
-            
-            if (tx_buffer.empty()) {
-                return 0; // 成功
+        uint8_t endTransmission(bool /*sendStop*/ = true) {
+            I2CBusHook* hook = i2cBusHook();
+            uint8_t status = 0;
+            if (hook && hook->replayWrite(current_addr, tx_buffer.data(), tx_buffer.size(), status)) {
+                tx_buffer.clear();
+                return status;
             }
 
-            ssize_t result = ::write(fd, tx_buffer.data(), tx_buffer.size());
-            tx_buffer.clear();
-            
-            if (result < 0) {
-                std::cerr << "[I2C] Write failed to address 0x" 
-                          << std::hex << (int)current_addr << std::dec << std::endl;
-                return 2; // NACK on address
+            status = transmit();
+            if (hook) {
+                hook->onWrite(current_addr, tx_buffer.data(), tx_buffer.size(), status);
             }
-            
-            return 0; // 成功
+            tx_buffer.clear();
+            return status;
         }
 
         // 写入单字节到缓冲区
@@ -413,22 +1803,20 @@ namespace ArduinoHAL {
         }
 
         // 从设备读取数据
-        size_t requestFrom(uint8_t addr, size_t len, bool sendStop = true) {
-            if (fd < 0) return 0;
-            
-            if (ioctl(fd, I2C_SLAVE, addr) < 0) {
-                std::cerr << "[I2C] Failed to set slave address for read 0x" 
-                          << std::hex << (int)addr << std::dec << std::endl;
-                return 0;
-            }
-
+        size_t requestFrom(uint8_t addr, size_t len, bool /*sendStop*/ = true) {
+            I2CBusHook* hook = i2cBusHook();
             rx_buffer.clear();
             rx_buffer.resize(len);
-            
-            ssize_t result = ::read(fd, rx_buffer.data(), len);
+
+            ssize_t result = -1;
+            if (!(hook && hook->replayRead(addr, rx_buffer.data(), len, result))) {
+                result = receive(addr, len);
+                if (hook) {
+                    hook->onRead(addr, rx_buffer.data(), result);
+                }
+            }
+
             if (result < 0) {
-                std::cerr << "[I2C] Read failed from address 0x" 
-                          << std::hex << (int)addr << std::dec << std::endl;
                 rx_buffer.clear();
                 return 0;
             }
@@ -454,7 +1842,41 @@ namespace ArduinoHAL {
         void setClock(uint32_t frequency) {
             // Linux I2C 驱动通常在设备树中配置频率
             // 这里仅作记录
-            std::cout << "[I2C] Clock frequency set to " << frequency << " Hz (may require DT config)" << std::endl;
+            LOG_I(HAL) logPrintf("[I2C] Clock frequency set to %u Hz (may require DT config)\n", (unsigned int)frequency);
+        }
+
+    private:
+        // 实际写入设备，返回 endTransmission 结果码
+        uint8_t transmit() {
+            if (fd < 0) return 4; // 其他错误
+            
+            if (tx_buffer.empty()) {
+                return 0; // 成功
+            }
+
+            ssize_t result = ::write(fd, tx_buffer.data(), tx_buffer.size());
+            if (result < 0) {
+                LOG_W(HAL) logErrorf("[I2C] Write failed to address 0x%x\n", current_addr);
+                return 2; // NACK on address
+            }
+            
+            return 0; // 成功
+        }
+
+        // 实际从设备读取到 rx_buffer，失败返回 -1
+        ssize_t receive(uint8_t addr, size_t len) {
+            if (fd < 0) return -1;
+            
+            if (ioctl(fd, I2C_SLAVE, addr) < 0) {
+                LOG_W(HAL) logErrorf("[I2C] Failed to set slave address for read 0x%x\n", addr);
+                return -1;
+            }
+
+            ssize_t result = ::read(fd, rx_buffer.data(), len);
+            if (result < 0) {
+                LOG_W(HAL) logErrorf("[I2C] Read failed from address 0x%x\n", addr);
+            }
+            return result;
         }
     };
 
@@ -469,7 +1891,7 @@ namespace ArduinoHAL {
             memset(&tty, 0, sizeof(tty));
 
             if (tcgetattr(fd, &tty) != 0) {
-                std::cerr << "[UART] Error getting port attributes" << std::endl;
+                LOG_E(HAL) logErrorf("[UART] Error getting port attributes\n");
                 return false;
             }
 
@@ -512,7 +1934,7 @@ namespace ArduinoHAL {
             tty.c_cc[VMIN] = 0;
 
             if (tcsetattr(fd, TCSANOW, &tty) != 0) {
-                std::cerr << "[UART] Error setting port attributes" << std::endl;
+                LOG_E(HAL) logErrorf("[UART] Error setting port attributes\n");
                 return false;
             }
 
@@ -529,13 +1951,15 @@ namespace ArduinoHAL {
         void begin(unsigned long baud, uint32_t config = 0) {
             fd = open(device.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
             if (fd < 0) {
-                std::cerr << "[UART] Failed to open device: " << device << std::endl;
-                std::cerr << "[UART] Make sure UART is enabled via luckfox-config" << std::endl;
+                LOG_E(HAL) {
+                    logErrorf("[UART] Failed to open device: %s\n", device.c_str());
+                    logErrorf("[UART] Make sure UART is enabled via luckfox-config\n");
+                }
                 return;
             }
 
             if (configure_port(baud)) {
-                std::cout << "[UART] Opened " << device << " at " << baud << " baud" << std::endl;
+                LOG_I(HAL) logPrintf("[UART] Opened %s at %lu baud\n", device.c_str(), baud);
             } else {
                 close(fd);
                 fd = -1;
@@ -640,7 +2064,7 @@ namespace ArduinoHAL {
             
             std::ofstream fs(config_file);
             if (!fs.is_open()) {
-                std::cerr << "[Preferences] Failed to save to " << config_file << std::endl;
+                LOG_E(HAL) logErrorf("[Preferences] Failed to save to %s\n", config_file.c_str());
                 return;
             }
 
@@ -659,8 +2083,7 @@ namespace ArduinoHAL {
             config_file = get_config_path();
             
             load_from_file();
-            std::cout << "[Preferences] Opened namespace '" << name 
-                      << "' (" << (readonly ? "RO" : "RW") << ")" << std::endl;
+            LOG_I(HAL) logPrintf("[Preferences] Opened namespace '%s' (%s)\n", name, readonly ? "RO" : "RW");
             return true;
         }
 
@@ -749,30 +2172,33 @@ namespace ArduinoHAL {
     };
     
     // --- 简易的 Serial 模拟 (用于打印调试信息到终端) ---
+    // 控制台输出经 logWrite() 进入异步日志队列，格式与原先直接写 std::cout 时一致；
+    // 数值只记下原始值，由日志后台线程格式化
     class SerialMock {
     public:
         void begin(int baud) {
-            std::cout << "[Serial] Init at " << baud << " (Mocked to stdout)" << std::endl;
-        }
-        void print(const char* str) { std::cout << str; }
-        void print(const std::string& str) { std::cout << str; }
-        void print(int val) { std::cout << val; }
-        void print(unsigned int val) { std::cout << val; }
-        void print(long val) { std::cout << val; }
-        void print(unsigned long val) { std::cout << val; }
+            LOG_I(HAL) logPrintf("[Serial] Init at %d (Mocked to stdout)\n", baud);
+        }
+        // 写出本线程未成行的内容并等待队列排空
+        void flush() {
+            logFlushLine();
+            logSink().flush();
+        }
+        void print(const char* str) { logWrite(str, strlen(str)); }
+        void print(const std::string& str) { logWrite(str.data(), str.size()); }
+        void print(int val) { logWriteArg(LOG_ARG_INT, (uint64_t)(int64_t)val); }
+        void print(unsigned int val) { logWriteArg(LOG_ARG_UINT, val); }
+        void print(long val) { logWriteArg(LOG_ARG_INT, (uint64_t)(int64_t)val); }
+        void print(unsigned long val) { logWriteArg(LOG_ARG_UINT, val); }
         void print(int val, int format) { 
             if (format == HEX) {
-                std::cout << "0x" << std::hex << val << std::dec;
+                logWriteArg(LOG_ARG_HEX, (unsigned int)val);
             } else if (format == BIN) {
-                // 二进制输出
-                std::cout << "0b";
-                for (int i = 31; i >= 0; i--) {
-                    std::cout << ((val >> i) & 1);
-                }
+                logWriteArg(LOG_ARG_BIN, (unsigned int)val);
             } else if (format == OCT) {
-                std::cout << "0" << std::oct << val << std::dec;
+                logWriteArg(LOG_ARG_OCT, (unsigned int)val);
             } else {
-                std::cout << val;
+                print(val);
             }
         }
         void print(unsigned int val, int format) {
@@ -782,37 +2208,40 @@ namespace ArduinoHAL {
             print((int)val, format);
         }
         void print(float val, int decimals = 2) { 
-            std::cout << std::fixed;
-            std::cout.precision(decimals);
-            std::cout << val; 
-        }
-        void println(const char* str) { std::cout << str << std::endl; }
-        void println(const std::string& str) { std::cout << str << std::endl; }
-        void println(int val) { std::cout << val << std::endl; }
-        void println(unsigned int val) { std::cout << val << std::endl; }
-        void println(long val) { std::cout << val << std::endl; }
-        void println(unsigned long val) { std::cout << val << std::endl; }
+            double value = val;
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            int digits = decimals < 0 ? 6 : std::min(decimals, LOG_ARG_MAX_DECIMALS);   // 负数同 printf，取 6 位
+            logWriteArg(LOG_ARG_FLOAT, bits, (uint8_t)digits);
+        }
+        void println(const char* str) { print(str); println(); }
+        void println(const std::string& str) { print(str); println(); }
+        void println(int val) { print(val); println(); }
+        void println(unsigned int val) { print(val); println(); }
+        void println(long val) { print(val); println(); }
+        void println(unsigned long val) { print(val); println(); }
         void println(int val, int format) { 
             print(val, format);
-            std::cout << std::endl;
+            println();
         }
         void println(unsigned int val, int format) {
             print((int)val, format);
-            std::cout << std::endl;
+            println();
         }
         void println(uint8_t val, int format) {
             print((int)val, format);
-            std::cout << std::endl;
+            println();
         }
         void println(float val, int decimals = 2) { 
             print(val, decimals);
-            std::cout << std::endl;
+            println();
         }
-        void println() { std::cout << std::endl; }
+        void println() { logWrite("\n", 1); }
     };
     
     // --- 全局实例定义 ---
-    static SerialMock Serial;
+    // SerialMock 没有状态，构造/析构都是空的：不引用 Serial 的翻译单元会报 unused-variable
+    __attribute__((unused)) static SerialMock Serial;
     static I2C Wire;
     static HardwareSerial Serial1("/dev/ttyS1");  // UART1
     static HardwareSerial Serial2("/dev/ttyS2");  // UART2
@@ -1,4 +1,5 @@
 #include "OLEDDisplay.h"
+#include "LogModules.h"
 
 // Linux 版本 - OLED 功能暂时禁用
 // 需要移植 Adafruit_SSD1306 库或使用其他 Linux 显示方案
@@ -24,12 +25,16 @@ void OLEDDisplay::selectDisplayChannel() {
 
 bool OLEDDisplay::begin() {
 #ifdef OLED_DISABLED
-    Serial.println("[OLED] 显示功能已禁用 - 需要移植 Adafruit_SSD1306 库");
-    Serial.println("[OLED] 传感器数据将通过串口输出");
+    LOG_I(OLED) {
+        Serial.println("[OLED] 显示功能已禁用 - 需要移植 Adafruit_SSD1306 库");
+        Serial.println("[OLED] 传感器数据将通过串口输出");
+    }
     return false;
 #else
-    Serial.print("开始初始化OLED，通道: ");
-    Serial.println(_channel);
+    LOG_I(OLED) {
+        Serial.print("开始初始化OLED，通道: ");
+        Serial.println(_channel);
+    }
     // TODO: 实现 Linux 版本的 OLED 初始化
     return false;
 #endif
@@ -37,7 +42,7 @@ bool OLEDDisplay::begin() {
 
 void OLEDDisplay::testDisplay() {
 #ifdef OLED_DISABLED
-    Serial.println("[OLED] 测试显示 - 功能已禁用");
+    LOG_I(OLED) Serial.println("[OLED] 测试显示 - 功能已禁用");
     return;
 #else
     // TODO: 实现测试显示
@@ -51,26 +56,28 @@ void OLEDDisplay::update(float pressure, float temperature, const std::string& s
     if (millis() - lastPrint < 1000) return;  // 每秒打印一次
     lastPrint = millis();
     
-    Serial.println("================================");
-    Serial.print("压力: ");
-    Serial.print(pressure, 2);
-    Serial.println(" kPa");
+    LOG_I(OLED) {
+        Serial.println("================================");
+        Serial.print("压力: ");
+        Serial.print(pressure, 2);
+        Serial.println(" kPa");
     
-    Serial.print("温度: ");
-    Serial.print(temperature, 1);
-    Serial.println(" °C");
+        Serial.print("温度: ");
+        Serial.print(temperature, 1);
+        Serial.println(" °C");
     
-    Serial.print("流量: ");
-    Serial.print(flow, 0);
-    Serial.println(" ml/min");
+        Serial.print("流量: ");
+        Serial.print(flow, 0);
+        Serial.println(" ml/min");
     
-    Serial.print("阀门: ");
-    Serial.print(valvePercent, 0);
-    Serial.println(" %");
+        Serial.print("阀门: ");
+        Serial.print(valvePercent, 0);
+        Serial.println(" %");
     
-    Serial.print("状态: ");
-    Serial.println(state.c_str());
-    Serial.println("================================");
+        Serial.print("状态: ");
+        Serial.println(state.c_str());
+        Serial.println("================================");
+    }
 #else
     // TODO: 实现真实的 OLED 更新
 #endif
@@ -86,7 +93,7 @@ void OLEDDisplay::clearGraphs() {
 
 void OLEDDisplay::resetDisplay() {
 #ifdef OLED_DISABLED
-    Serial.println("[OLED] 重置显示 - 功能已禁用");
+    LOG_I(OLED) Serial.println("[OLED] 重置显示 - 功能已禁用");
     return;
 #else
     // TODO: 实现重置显示
@@ -95,7 +102,7 @@ void OLEDDisplay::resetDisplay() {
 
 void OLEDDisplay::simpleTest() {
 #ifdef OLED_DISABLED
-    Serial.println("[OLED] 简单测试 - 功能已禁用");
+    LOG_I(OLED) Serial.println("[OLED] 简单测试 - 功能已禁用");
     return;
 #else
     // TODO: 实现简单测试
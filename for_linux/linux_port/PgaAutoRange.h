@@ -0,0 +1,118 @@
+#ifndef PgaAutoRange_h
+#define PgaAutoRange_h
+
+#include "LuckfoxArduino.h"
+#include <cmath>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// ADS1115 PGA 自动量程
+//
+// 只根据已经完成的转换结果决定“下一次”转换用哪一档，从不为选档额外做转换：
+//   - 结果超过当前量程的 upFraction（或已削顶）时立即换到能容纳它的较大量程；
+//   - 连续 holdSamples 个结果都低于更小一档量程的 downFraction 时才放大一档。
+// 两个门限之间的区间即回差，信号在门限附近抖动不会来回切换。
+//
+// 档位下标与配置寄存器 PGA[11:9] 一致：0 = ±6.144V ... 5 = ±0.256V。
+// 与 CalibrationSampler 一样不依赖具体驱动，可在 AO08_linux_port 与 linux_port 之间原样共用。
+
+constexpr uint8_t PGA_RANGE_COUNT = 6;
+
+class PgaAutoRange {
+public:
+    PgaAutoRange(uint8_t pga = 2)
+        : _coarsest(0), _finest(PGA_RANGE_COUNT - 1),
+          _upFraction(0.9f), _downFraction(0.7f), _holdSamples(16),
+          _upSwitches(0), _downSwitches(0), _clips(0) {
+        setPga(pga);
+    }
+
+    // 允许使用的档位范围
+    void setLimits(uint8_t coarsest, uint8_t finest) {
+        if (finest >= PGA_RANGE_COUNT) finest = PGA_RANGE_COUNT - 1;
+        if (coarsest > finest) coarsest = finest;
+        _coarsest = coarsest;
+        _finest = finest;
+        setPga(_pga);
+    }
+
+    void setThresholds(float upFraction, float downFraction, uint16_t holdSamples) {
+        _upFraction = upFraction;
+        _downFraction = downFraction < upFraction ? downFraction : upFraction;
+        _holdSamples = holdSamples ? holdSamples : 1;
+        _holdCount = 0;
+    }
+
+    // 手动指定档位（不计入切换次数）
+    void setPga(uint8_t pga) {
+        if (pga < _coarsest) pga = _coarsest;
+        if (pga > _finest) pga = _finest;
+        _pga = pga;
+        _holdCount = 0;
+    }
+
+    uint8_t getPga() const { return _pga; }
+    uint16_t getConfigBits() const { return (uint16_t)_pga << 9; }
+
+    // 用一次转换结果更新；pgaUsed 为该结果实际使用的档位
+    // 返回 true 表示下一次转换应换用 getPga()
+    bool update(int16_t code, uint8_t pgaUsed) {
+        bool clipped = (code == 32767 || code == -32768);
+        if (clipped) _clips++;
+
+        // 流水线中仍以旧档位完成的结果不参与判断
+        if (pgaUsed != _pga) return false;
+
+        float volts = std::fabs((float)code) * fullScaleVolts(pgaUsed) / 32768.0f;
+
+        // 缩小增益：立即换到能容纳该值的档位
+        if ((clipped || volts > _upFraction * fullScaleVolts(_pga)) && _pga > _coarsest) {
+            do {
+                _pga--;
+            } while (_pga > _coarsest && volts > _upFraction * fullScaleVolts(_pga));
+            _holdCount = 0;
+            _upSwitches++;
+            return true;
+        }
+
+        // 放大增益：持续足够久才换一档
+        if (_pga < _finest && volts < _downFraction * fullScaleVolts(_pga + 1)) {
+            if (++_holdCount >= _holdSamples) {
+                _pga++;
+                _holdCount = 0;
+                _downSwitches++;
+                return true;
+            }
+        } else {
+            _holdCount = 0;
+        }
+        return false;
+    }
+
+    // 统计
+    uint32_t getSwitchCount() const { return _upSwitches + _downSwitches; }
+    uint32_t getUpSwitchCount() const { return _upSwitches; }      // 换到较大量程
+    uint32_t getDownSwitchCount() const { return _downSwitches; }  // 换到较小量程
+    uint32_t getClipCount() const { return _clips; }
+    void resetCounters() { _upSwitches = _downSwitches = _clips = 0; }
+
+    static float fullScaleVolts(uint8_t pga) {
+        static const float FSR[PGA_RANGE_COUNT] = {6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f};
+        return FSR[pga < PGA_RANGE_COUNT ? pga : PGA_RANGE_COUNT - 1];
+    }
+
+private:
+    uint8_t _pga;
+    uint8_t _coarsest;
+    uint8_t _finest;
+    float _upFraction;
+    float _downFraction;
+    uint16_t _holdSamples;
+    uint16_t _holdCount;
+    uint32_t _upSwitches;
+    uint32_t _downSwitches;
+    uint32_t _clips;
+};
+
+#endif
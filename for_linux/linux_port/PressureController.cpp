@@ -0,0 +1,245 @@
+#include "PressureController.h"
+#include "LogModules.h"
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+PressureController::PressureController(int valvePin, float outputMax)
+    : _valvePin(valvePin), _outputMax(outputMax), _linearizer(nullptr), _rateHz(500), _running(false),
+      _measuredKpa(0.0f), _measuredUs(0), _phase(CONTROL_PHASE_BASELINE), _measurementCount(0),
+      _staleTimeoutUs(500000UL), _gains(DEFAULT_PID_GAINS), _profile(DEFAULT_PRESSURE_PROFILE),
+      _integral(0.0f), _derivative(0.0f), _lastMeasured(0.0f), _lastMeasuredUs(0),
+      _lastPhase(-1), _phaseStartUs(0), _phaseStartSetpoint(0.0f), _setpoint(0.0f),
+      _stale(true), _output(0.0f), _jitterSumUs(0.0), _errorSqSum(0.0), _errorSamples(0) {
+    resetStats();
+}
+
+PressureController::~PressureController() {
+    end();
+}
+
+uint64_t PressureController::monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+bool PressureController::begin(unsigned long rateHz, int rtPriority) {
+    if (_running) return true;
+
+    if (rateHz < PRESSURE_CONTROL_MIN_HZ) rateHz = PRESSURE_CONTROL_MIN_HZ;
+    if (rateHz > PRESSURE_CONTROL_MAX_HZ) rateHz = PRESSURE_CONTROL_MAX_HZ;
+    _rateHz = rateHz;
+
+    _integral = 0.0f;
+    _derivative = 0.0f;
+    _lastMeasuredUs = 0;
+    _lastPhase = -1;
+    _setpoint = _profile.peepKpa;
+    _stale = true;
+    resetStats();
+
+    _running = true;
+    _thread = std::thread(&PressureController::controlLoop, this, rtPriority);
+
+    LOG_I(CTRL) {
+        Serial.print("[PressureCtl] 压力闭环启动，控制频率 ");
+        Serial.print(_rateHz);
+        Serial.println(" Hz");
+    }
+    return true;
+}
+
+void PressureController::end() {
+    if (!_running) return;
+    _running = false;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    // 退出闭环时关闭气阀，由调用方重新接管
+    writeOutput(0.0f);
+    LOG_I(CTRL) Serial.println("[PressureCtl] 压力闭环停止");
+}
+
+void PressureController::updateMeasurement(float pressureKpa, ControlPhase phase) {
+    _measuredKpa.store(pressureKpa, std::memory_order_relaxed);
+    _phase.store(phase, std::memory_order_relaxed);
+    _measuredUs.store(monotonicUs(), std::memory_order_release);
+    _measurementCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PressureController::setGains(const PidGains& gains) {
+    std::lock_guard<std::mutex> lock(_paramMutex);
+    _gains = gains;
+}
+
+void PressureController::setProfile(const PressureProfile& profile) {
+    std::lock_guard<std::mutex> lock(_paramMutex);
+    _profile = profile;
+}
+
+PidGains PressureController::getGains() const {
+    std::lock_guard<std::mutex> lock(_paramMutex);
+    return _gains;
+}
+
+PressureProfile PressureController::getProfile() const {
+    std::lock_guard<std::mutex> lock(_paramMutex);
+    return _profile;
+}
+
+PressureControlStats PressureController::getStats() const {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    PressureControlStats stats = _stats;
+    stats.measurements = _measurementCount.load();
+    return stats;
+}
+
+void PressureController::resetStats() {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    memset(&_stats, 0, sizeof(_stats));
+    _stats.rateHz = _rateHz;
+    _jitterSumUs = 0.0;
+    _errorSqSum = 0.0;
+    _errorSamples = 0;
+}
+
+void PressureController::controlLoop(int rtPriority) {
+    if (rtPriority > 0) {
+        struct sched_param param;
+        param.sched_priority = rtPriority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            LOG_W(CTRL) Serial.println("[PressureCtl] 无法设置实时优先级，以普通优先级运行");
+        }
+    }
+
+    const uint64_t periodNs = 1000000000ULL / _rateHz;
+    const float dt = 1.0f / _rateHz;
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (_running) {
+        // 以绝对时间推进，睡眠误差不会累积
+        next.tv_nsec += periodNs;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+
+        uint64_t wakeUs = monotonicUs();
+        uint64_t targetUs = (uint64_t)next.tv_sec * 1000000ULL + next.tv_nsec / 1000;
+        float jitterUs = wakeUs > targetUs ? (float)(wakeUs - targetUs) : 0.0f;
+
+        step(wakeUs, dt);
+
+        uint64_t doneUs = monotonicUs();
+        bool overrun = doneUs - targetUs >= periodNs / 1000;
+        if (overrun) {
+            // 已错过下一个周期：从当前时刻重新对齐，不追赶
+            clock_gettime(CLOCK_MONOTONIC, &next);
+        }
+
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _stats.loops++;
+        if (overrun) _stats.overruns++;
+        _jitterSumUs += jitterUs;
+        _stats.jitterMeanUs = (float)(_jitterSumUs / _stats.loops);
+        if (jitterUs > _stats.jitterMaxUs) _stats.jitterMaxUs = jitterUs;
+        float execUs = (float)(doneUs - wakeUs);
+        if (execUs > _stats.execMaxUs) _stats.execMaxUs = execUs;
+    }
+}
+
+// 设定值轨迹：相位切换时从当前设定值出发，按上升/下降时间线性过渡到该相位的目标
+float PressureController::setpointAt(uint64_t nowUs, int phase, const PressureProfile& profile) {
+    if (phase != _lastPhase) {
+        _lastPhase = phase;
+        _phaseStartUs = nowUs;
+        _phaseStartSetpoint = _setpoint;
+    }
+
+    float target = (phase == CONTROL_PHASE_INSPIRATION || phase == CONTROL_PHASE_PLATEAU)
+                   ? profile.inspiratoryKpa : profile.peepKpa;
+    float rampMs = target > _phaseStartSetpoint ? profile.riseTimeMs : profile.fallTimeMs;
+    float elapsedMs = (nowUs - _phaseStartUs) / 1000.0f;
+    if (rampMs <= 0.0f || elapsedMs >= rampMs) {
+        return target;
+    }
+    return _phaseStartSetpoint + (target - _phaseStartSetpoint) * (elapsedMs / rampMs);
+}
+
+void PressureController::step(uint64_t nowUs, float dt) {
+    PidGains gains;
+    PressureProfile profile;
+    {
+        std::lock_guard<std::mutex> lock(_paramMutex);
+        gains = _gains;
+        profile = _profile;
+    }
+
+    uint64_t measuredUs = _measuredUs.load(std::memory_order_acquire);
+    if (measuredUs == 0 || nowUs - measuredUs > _staleTimeoutUs.load()) {
+        // 测量超时：关阀、清积分，等待新测量
+        if (!_stale) {
+            _stale = true;
+            std::lock_guard<std::mutex> lock(_statsMutex);
+            _stats.staleEvents++;
+        }
+        _integral = 0.0f;
+        _derivative = 0.0f;
+        _lastMeasuredUs = 0;
+        writeOutput(0.0f);
+        return;
+    }
+    _stale = false;
+
+    float measured = _measuredKpa.load(std::memory_order_relaxed);
+
+    // 微分只在有新测量时更新（采集远慢于控制），并做一阶低通
+    if (measuredUs != _lastMeasuredUs) {
+        if (_lastMeasuredUs != 0 && measuredUs > _lastMeasuredUs) {
+            float dtm = (measuredUs - _lastMeasuredUs) / 1e6f;
+            float raw = (measured - _lastMeasured) / dtm;
+            float alpha = dtm / (gains.derivTauMs / 1000.0f + dtm);
+            _derivative += alpha * (raw - _derivative);
+        }
+        _lastMeasured = measured;
+        _lastMeasuredUs = measuredUs;
+    }
+
+    _setpoint = setpointAt(nowUs, _phase.load(std::memory_order_relaxed), profile);
+    float error = _setpoint - measured;
+
+    float feedForward = gains.kff * _setpoint + gains.ffOffset;
+    float unsaturated = feedForward + gains.kp * error + _integral - gains.kd * _derivative;
+    float output = constrain(unsaturated, 0.0f, _outputMax);
+
+    // 积分 + 反算抗饱和：输出被限幅时把积分往回拉
+    _integral += (gains.ki * error + gains.kaw * (output - unsaturated)) * dt;
+    _integral = constrain(_integral, -_outputMax, _outputMax);
+
+    writeOutput(output);
+
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _errorSqSum += (double)error * error;
+    _errorSamples++;
+    float absError = fabs(error);
+    if (absError > _stats.errorMaxKpa) _stats.errorMaxKpa = absError;
+    _stats.errorRmsKpa = (float)sqrt(_errorSqSum / _errorSamples);
+    _stats.setpointKpa = _setpoint;
+    _stats.output = output;
+}
+
+void PressureController::writeOutput(float output) {
+    _output.store(output);
+    float duty = _linearizer ? _linearizer->apply(output) : output;
+    PWM* pwm = pwmPin(_valvePin);
+    if (pwm) {
+        // 直接按比例写纳秒占空比，分辨率高于 0..255
+        pwm->setDutyPercentage(duty / _outputMax);
+    } else {
+        analogWrite(_valvePin, (int)lround(duty));
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef PressureController_h
+#define PressureController_h
+
+#include "LuckfoxArduino.h"
+#include "ValveLinearizer.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 压力闭环控制（PID + 前馈），运行在独立的定频线程上
+//
+// 采集侧每得到一个主气压值就调用 updateMeasurement()，只写几个原子量；控制线程按
+// 固定频率（200~1000 Hz）读取最新压力、按呼吸相位生成设定值轨迹、计算气阀开度并
+// 直接写 PWM。控制线程从不访问 I2C，慢传感器卡住只会让测量值变旧：超过
+// staleTimeoutMs 没有新测量时气阀关闭并清零积分，直到测量恢复。
+//
+// 压力均为相对基线的表压（kPa），输出为气阀开度 0..outputMax（与 analogWrite 同量纲）。
+
+constexpr unsigned long PRESSURE_CONTROL_MIN_HZ = 200;
+constexpr unsigned long PRESSURE_CONTROL_MAX_HZ = 1000;
+
+// 呼吸相位（由 BreathController 的呼吸状态映射而来）
+enum ControlPhase {
+    CONTROL_PHASE_BASELINE = 0,     // 呼气末，维持 PEEP
+    CONTROL_PHASE_INSPIRATION,      // 吸气，设定值从 PEEP 斜坡升到吸气压力
+    CONTROL_PHASE_PLATEAU,          // 吸气峰值，保持吸气压力
+    CONTROL_PHASE_EXPIRATION        // 呼气，设定值斜坡降回 PEEP
+};
+
+struct PidGains {
+    float kp;           // 比例 (开度/kPa)
+    float ki;           // 积分 (开度/(kPa·s))
+    float kd;           // 微分 (开度·s/kPa)，作用于测量值，避免设定值阶跃冲击
+    float kff;          // 前馈 (开度/kPa)，按设定值给出稳态开度
+    float ffOffset;     // 前馈偏置 (开度)
+    float kaw;          // 抗积分饱和反算增益 (1/s)
+    float derivTauMs;   // 微分一阶滤波时间常数
+};
+
+struct PressureProfile {
+    float inspiratoryKpa;   // 吸气目标压力
+    float peepKpa;          // 呼气末正压
+    float riseTimeMs;       // 吸气上升时间
+    float fallTimeMs;       // 呼气下降时间
+};
+
+// 默认参数需按气路实测整定
+static const PidGains DEFAULT_PID_GAINS = {
+    60.0f,      // kp
+    120.0f,     // ki
+    0.0f,       // kd
+    40.0f,      // kff
+    0.0f,       // ffOffset
+    5.0f,       // kaw
+    20.0f       // derivTauMs
+};
+
+static const PressureProfile DEFAULT_PRESSURE_PROFILE = {
+    1.0f,       // inspiratoryKpa（约 10 cmH2O）
+    0.3f,       // peepKpa
+    200.0f,     // riseTimeMs
+    300.0f      // fallTimeMs
+};
+
+struct PressureControlStats {
+    unsigned long rateHz;       // 配置的控制频率
+    uint64_t loops;             // 已执行的控制周期
+    uint32_t overruns;          // 错过整个周期的次数
+    float jitterMeanUs;         // 唤醒时刻相对理想时刻的平均延迟
+    float jitterMaxUs;
+    float execMaxUs;            // 单个周期计算+输出耗时最大值
+    float errorRmsKpa;          // 跟踪误差（设定值 - 测量值）均方根
+    float errorMaxKpa;          // 跟踪误差绝对值最大值
+    uint32_t staleEvents;       // 进入测量超时保护的次数
+    uint64_t measurements;      // 收到的测量次数
+    float setpointKpa;          // 最近一个周期的设定值
+    float output;               // 最近一个周期的开度
+};
+
+class PressureController {
+public:
+    PressureController(int valvePin, float outputMax = 255.0f);
+    ~PressureController();
+    PressureController(const PressureController&) = delete;
+    PressureController& operator=(const PressureController&) = delete;
+
+    // 启动控制线程；rtPriority > 0 时尝试以 SCHED_FIFO 该优先级运行（需要 root）
+    bool begin(unsigned long rateHz = 500, int rtPriority = 0);
+    void end();
+    bool isRunning() const { return _running.load(); }
+
+    // 采集侧调用：只写原子量，不阻塞
+    void updateMeasurement(float pressureKpa, ControlPhase phase);
+
+    void setGains(const PidGains& gains);
+    void setProfile(const PressureProfile& profile);
+    // 输出前经气阀线性化表（可为 nullptr）；须在 begin() 之前设置
+    void setLinearizer(const ValveLinearizer* linearizer) { _linearizer = linearizer; }
+    void setStaleTimeout(unsigned long ms) { _staleTimeoutUs.store(ms * 1000UL); }
+    PidGains getGains() const;
+    PressureProfile getProfile() const;
+
+    float getOutput() const { return _output.load(); }
+    PressureControlStats getStats() const;
+    void resetStats();
+
+private:
+    int _valvePin;
+    float _outputMax;
+    const ValveLinearizer* _linearizer;
+    unsigned long _rateHz;
+
+    std::thread _thread;
+    std::atomic<bool> _running;
+
+    // 采集侧 -> 控制线程
+    std::atomic<float> _measuredKpa;
+    std::atomic<uint64_t> _measuredUs;      // 0 表示尚无测量
+    std::atomic<int> _phase;
+    std::atomic<uint64_t> _measurementCount;
+    std::atomic<unsigned long> _staleTimeoutUs;
+
+    // 参数（控制线程每周期拷贝一次）
+    mutable std::mutex _paramMutex;
+    PidGains _gains;
+    PressureProfile _profile;
+
+    // 控制线程状态
+    float _integral;
+    float _derivative;
+    float _lastMeasured;
+    uint64_t _lastMeasuredUs;
+    int _lastPhase;
+    uint64_t _phaseStartUs;
+    float _phaseStartSetpoint;
+    float _setpoint;
+    bool _stale;
+    std::atomic<float> _output;
+
+    // 统计
+    mutable std::mutex _statsMutex;
+    PressureControlStats _stats;
+    double _jitterSumUs;
+    double _errorSqSum;
+    uint64_t _errorSamples;     // 参与误差统计的周期数（不含测量超时）
+
+    void controlLoop(int rtPriority);
+    void step(uint64_t nowUs, float dt);
+    float setpointAt(uint64_t nowUs, int phase, const PressureProfile& profile);
+    void writeOutput(float output);
+    static uint64_t monotonicUs();
+};
+
+#endif
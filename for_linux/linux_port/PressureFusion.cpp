@@ -0,0 +1,258 @@
+#include "PressureFusion.h"
+#include "LogModules.h"
+
+PressureFusion::PressureFusion(const PressureFusionConfig& config) : _config(config) {
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        _excluded[id] = false;
+    }
+    reset();
+}
+
+void PressureFusion::reset() {
+    _initialized = false;
+    _x[0] = _x[1] = 0.0f;
+    _p[0][0] = _p[1][1] = 1.0f;
+    _p[0][1] = _p[1][0] = 0.0f;
+    _offset = 0.0f;
+    _offsetValid = false;
+    _lastUsed = 0;
+    _divergeCount = 0;
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        _health[id].healthy = true;
+        _health[id].fault = PRESSURE_FAULT_NONE;
+        _health[id].noiseKpa = _config.initialNoiseKpa;
+        _health[id].lastInnovation = 0.0f;
+        _health[id].faultCount = 0;
+        _noiseVar[id] = _config.initialNoiseKpa * _config.initialNoiseKpa;
+        _lastRaw[id] = NAN;
+        _stuckCount[id] = 0;
+        _goodCount[id] = 0;
+        if (_excluded[id]) {
+            _health[id].healthy = false;
+            _health[id].fault = PRESSURE_FAULT_EXCLUDED;
+        }
+    }
+}
+
+void PressureFusion::setExcluded(PressureSensorId id, bool excluded) {
+    if (_excluded[id] == excluded) return;
+    _excluded[id] = excluded;
+    _health[id].healthy = false;
+    _health[id].fault = PRESSURE_FAULT_EXCLUDED;
+    _goodCount[id] = 0;
+    _stuckCount[id] = 0;
+    _lastRaw[id] = NAN;
+    _divergeCount = 0;
+}
+
+const char* PressureFusion::faultName(PressureSensorFault fault) {
+    switch (fault) {
+        case PRESSURE_FAULT_DROPOUT:  return "掉线";
+        case PRESSURE_FAULT_STUCK:    return "卡死";
+        case PRESSURE_FAULT_DIVERGED: return "发散";
+        case PRESSURE_FAULT_EXCLUDED: return "不参与融合";
+        default:                      return "正常";
+    }
+}
+
+float PressureFusion::getStdDev() const {
+    return sqrtf(_p[0][0] > 0.0f ? _p[0][0] : 0.0f);
+}
+
+uint8_t PressureFusion::getHealthyCount() const {
+    uint8_t count = 0;
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        if (_health[id].healthy) count++;
+    }
+    return count;
+}
+
+void PressureFusion::markFault(uint8_t id, PressureSensorFault fault) {
+    if (_health[id].healthy) {
+        _health[id].faultCount++;
+        LOG_W(FUSION) {
+            Serial.print("[Fusion] ");
+            Serial.print(id == PRESSURE_SENSOR_MAIN ? "主" : "备用");
+            Serial.print("传感器剔除: ");
+            Serial.println(faultName(fault));
+        }
+    }
+    _health[id].healthy = false;
+    _health[id].fault = fault;
+    _goodCount[id] = 0;
+}
+
+void PressureFusion::markGood(uint8_t id, bool consistent) {
+    if (_health[id].healthy) {
+        return;
+    }
+    if (!consistent) {
+        _goodCount[id] = 0;
+        return;
+    }
+    if (++_goodCount[id] >= _config.recoverSamples) {
+        _health[id].healthy = true;
+        _health[id].fault = PRESSURE_FAULT_NONE;
+        _goodCount[id] = 0;
+        LOG_I(FUSION) {
+            Serial.print("[Fusion] ");
+            Serial.print(id == PRESSURE_SENSOR_MAIN ? "主" : "备用");
+            Serial.println("传感器恢复");
+        }
+    }
+}
+
+// 匀速模型预测：F = [1 dt; 0 1]，Q 为白噪声加速度的离散化
+void PressureFusion::predict(float dt) {
+    if (dt <= 0.0f) return;
+    _x[0] += _x[1] * dt;
+
+    float p00 = _p[0][0] + dt * (_p[1][0] + _p[0][1]) + dt * dt * _p[1][1];
+    float p01 = _p[0][1] + dt * _p[1][1];
+    float p11 = _p[1][1];
+    float q = _config.processNoise;
+    _p[0][0] = p00 + q * dt * dt * dt / 3.0f;
+    _p[0][1] = _p[1][0] = p01 + q * dt * dt / 2.0f;
+    _p[1][1] = p11 + q * dt;
+}
+
+// 标量量测更新 H = [1 0]，同时在线估计该路的量测噪声
+void PressureFusion::correct(uint8_t id, float z) {
+    float innovation = z - _x[0];
+
+    // E[v^2] = P00 + R：扣除预测方差后的新息能量即量测噪声
+    float minVar = _config.minNoiseKpa * _config.minNoiseKpa;
+    float sample = innovation * innovation - _p[0][0];
+    _noiseVar[id] += _config.noiseAlpha * ((sample > minVar ? sample : minVar) - _noiseVar[id]);
+
+    float s = _p[0][0] + _noiseVar[id];
+    float k0 = _p[0][0] / s;
+    float k1 = _p[1][0] / s;
+    _x[0] += k0 * innovation;
+    _x[1] += k1 * innovation;
+
+    float p00 = _p[0][0], p01 = _p[0][1], p11 = _p[1][1];
+    _p[0][0] = (1.0f - k0) * p00;
+    _p[0][1] = _p[1][0] = (1.0f - k0) * p01;
+    _p[1][1] = p11 - k1 * p01;
+
+    _health[id].noiseKpa = sqrtf(_noiseVar[id]);
+}
+
+float PressureFusion::update(float mainKpa, bool mainOk, float backupKpa, bool backupOk, float dtSec) {
+    float raw[PRESSURE_SENSOR_COUNT] = { mainKpa, backupKpa };
+    bool ok[PRESSURE_SENSOR_COUNT] = { mainOk && std::isfinite(mainKpa), backupOk && std::isfinite(backupKpa) };
+    _lastUsed = 0;
+
+    // 掉线与卡死（被排除的一路直接跳过，不计为故障）
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        if (_excluded[id]) {
+            ok[id] = false;
+            continue;
+        }
+        if (!ok[id]) {
+            markFault(id, PRESSURE_FAULT_DROPOUT);
+            continue;
+        }
+        if (raw[id] == _lastRaw[id]) {
+            if (_stuckCount[id] < 255) _stuckCount[id]++;
+            if (_stuckCount[id] >= _config.stuckSamples) {
+                markFault(id, PRESSURE_FAULT_STUCK);
+                ok[id] = false;
+            }
+        } else {
+            _stuckCount[id] = 0;
+        }
+        _lastRaw[id] = raw[id];
+    }
+
+    // 首个有效周期直接取读数初始化
+    if (!_initialized) {
+        uint8_t first = ok[PRESSURE_SENSOR_MAIN] ? PRESSURE_SENSOR_MAIN : PRESSURE_SENSOR_BACKUP;
+        if (!ok[first]) {
+            return _x[0];
+        }
+        if (ok[PRESSURE_SENSOR_MAIN] && ok[PRESSURE_SENSOR_BACKUP]) {
+            _offset = backupKpa - mainKpa;
+            _offsetValid = true;
+        }
+        _x[0] = first == PRESSURE_SENSOR_MAIN ? mainKpa : backupKpa - _offset;
+        _x[1] = 0.0f;
+        _p[0][0] = _noiseVar[first];
+        _p[0][1] = _p[1][0] = 0.0f;
+        _p[1][1] = 1.0f;
+        _initialized = true;
+        _lastUsed = (ok[PRESSURE_SENSOR_MAIN] && ok[PRESSURE_SENSOR_BACKUP]) ? 2 : 1;
+        return _x[0];
+    }
+
+    predict(dtSec);
+
+    // 备用传感器扣除零点偏差后与主传感器同一基准
+    float z[PRESSURE_SENSOR_COUNT] = { mainKpa, backupKpa - (_offsetValid ? _offset : 0.0f) };
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        _health[id].lastInnovation = ok[id] ? z[id] - _x[0] : 0.0f;
+    }
+
+    // 发散表决：预测作为第三票，偏离预测较远的一路本周期即不参与，持续发散才判故障
+    if (ok[PRESSURE_SENSOR_MAIN] && ok[PRESSURE_SENSOR_BACKUP] &&
+        fabsf(z[PRESSURE_SENSOR_MAIN] - z[PRESSURE_SENSOR_BACKUP]) > _config.divergenceKpa) {
+        uint8_t bad = fabsf(_health[PRESSURE_SENSOR_MAIN].lastInnovation) >
+                      fabsf(_health[PRESSURE_SENSOR_BACKUP].lastInnovation)
+                      ? PRESSURE_SENSOR_MAIN : PRESSURE_SENSOR_BACKUP;
+        if (_divergeCount < 255) _divergeCount++;
+        if (_divergeCount >= _config.divergenceSamples) {
+            markFault(bad, PRESSURE_FAULT_DIVERGED);
+        }
+        ok[bad] = false;
+    } else {
+        _divergeCount = 0;
+    }
+
+    // 被剔除的传感器：与预测一致的周期累计到一定数量才恢复
+    float gate = 3.0f * sqrtf(_p[0][0]) + _config.divergenceKpa;
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        if (ok[id]) {
+            markGood(id, fabsf(_health[id].lastInnovation) < gate);
+        }
+    }
+
+    bool use[PRESSURE_SENSOR_COUNT];
+    uint8_t used = 0;
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        use[id] = ok[id] && _health[id].healthy;
+        if (use[id]) used++;
+    }
+    // 只剩一路时拒绝明显的野值
+    if (used == 1) {
+        for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+            if (use[id] && fabsf(_health[id].lastInnovation) > _config.innovationGateKpa) {
+                use[id] = false;
+                used = 0;
+            }
+        }
+    }
+
+    for (uint8_t id = 0; id < PRESSURE_SENSOR_COUNT; id++) {
+        if (use[id]) {
+            correct(id, z[id]);
+        }
+    }
+    _lastUsed = used;
+
+    if (used == 0) {
+        // 没有可用读数：保持估计，不按速度外推
+        _x[1] = 0.0f;
+    } else if (use[PRESSURE_SENSOR_MAIN] && use[PRESSURE_SENSOR_BACKUP]) {
+        // 两路都健康：跟踪备用传感器零点偏差（高频差异被 EWMA 平均掉）
+        float diff = backupKpa - mainKpa;
+        if (_offsetValid) {
+            _offset += _config.offsetAlpha * (diff - _offset);
+        } else {
+            _offset = diff;
+            _offsetValid = true;
+        }
+    }
+
+    return _x[0];
+}
@@ -0,0 +1,125 @@
+#ifndef PressureFusion_h
+#define PressureFusion_h
+
+#include "LuckfoxArduino.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 主/备气压传感器融合
+//
+// 状态为 [压力, 压力变化率] 的匀速模型卡尔曼滤波，每个采集周期依次用两路健康
+// 传感器的读数做量测更新。每路传感器的量测噪声由新息在线估计，备用传感器相对
+// 主传感器的零点偏差在两路都健康时缓慢跟踪并扣除。带速度状态的预测在呼吸压力
+// 斜坡上几乎没有滞后，而两路独立噪声平均后噪声低于任一单路。
+//
+// 故障表决：两路只有两票，以滤波器的一步预测作为第三票。
+//   - 掉线：本周期未读到或读数非有限值，立即剔除
+//   - 卡死：原始读数连续 stuckSamples 个周期完全不变
+//   - 发散：两路之差连续超过 divergenceKpa，剔除新息（相对预测）较大的一路；
+//           只剩一路时新息超过 innovationGateKpa 的读数不参与更新
+// 被剔除的传感器需连续 recoverSamples 个周期与估计一致才恢复使用。
+//
+// 融合假设两路测的是同一压力。两路分处节流件两侧用作差压流量时不成立（压差随流量
+// 可达数 kPa，会被当作零点偏差吸收或触发发散表决），此时用 setExcluded() 把下游
+// 一路排除在融合之外，只融合上游一路。
+
+enum PressureSensorId {
+    PRESSURE_SENSOR_MAIN = 0,
+    PRESSURE_SENSOR_BACKUP = 1,
+    PRESSURE_SENSOR_COUNT
+};
+
+enum PressureSensorFault {
+    PRESSURE_FAULT_NONE = 0,
+    PRESSURE_FAULT_DROPOUT,
+    PRESSURE_FAULT_STUCK,
+    PRESSURE_FAULT_DIVERGED,
+    PRESSURE_FAULT_EXCLUDED     // 按配置不参与融合（setExcluded）
+};
+
+struct PressureFusionConfig {
+    float processNoise;         // 压力二阶导（kPa/s^2）的功率谱密度，越大跟踪越快、噪声越大
+    float initialNoiseKpa;      // 量测噪声标准差初值
+    float minNoiseKpa;          // 量测噪声估计下限
+    float noiseAlpha;           // 噪声估计的 EWMA 系数
+    float offsetAlpha;          // 备用传感器零点偏差的 EWMA 系数
+    float divergenceKpa;        // 两路差值超过此值视为发散
+    float innovationGateKpa;    // 单路运行时的新息门限
+    uint8_t divergenceSamples;  // 发散持续周期数
+    uint8_t stuckSamples;       // 读数不变判为卡死的周期数
+    uint8_t recoverSamples;     // 恢复所需的连续正常周期数
+};
+
+static const PressureFusionConfig DEFAULT_FUSION_CONFIG = {
+    50.0f,      // processNoise
+    0.05f,      // initialNoiseKpa
+    0.005f,     // minNoiseKpa
+    0.05f,      // noiseAlpha
+    0.002f,     // offsetAlpha
+    1.5f,       // divergenceKpa
+    3.0f,       // innovationGateKpa
+    3,          // divergenceSamples
+    20,         // stuckSamples
+    10          // recoverSamples
+};
+
+struct PressureSensorHealth {
+    bool healthy;               // 本周期参与融合
+    PressureSensorFault fault;  // 最近一次被剔除的原因（healthy 时为 NONE）
+    float noiseKpa;             // 量测噪声标准差估计
+    float lastInnovation;       // 最近一次新息（读数 - 预测）
+    uint32_t faultCount;        // 累计被剔除次数
+};
+
+class PressureFusion {
+public:
+    PressureFusion(const PressureFusionConfig& config = DEFAULT_FUSION_CONFIG);
+
+    void reset();
+
+    // 排除/恢复某一路：排除后该路读数不参与融合、零点跟踪与发散表决，也不计为故障；
+    // 恢复后与被剔除的传感器一样，连续 recoverSamples 个周期与估计一致才重新使用
+    void setExcluded(PressureSensorId id, bool excluded);
+    bool isExcluded(PressureSensorId id) const { return _excluded[id]; }
+
+    // 送入一个周期的两路读数（kPa）；ok = false 表示该路本周期未读到
+    // dtSec 为距上次调用的时间；返回融合后的压力
+    float update(float mainKpa, bool mainOk, float backupKpa, bool backupOk, float dtSec);
+
+    bool isValid() const { return _initialized; }
+    // 最近一次 update() 实际参与量测更新的传感器数；为 0 时估计只是保持的旧值
+    uint8_t getLastUsedCount() const { return _lastUsed; }
+    float getPressure() const { return _x[0]; }
+    float getRate() const { return _x[1]; }                 // kPa/s
+    float getStdDev() const;                                // 估计标准差
+    float getBackupOffset() const { return _offset; }       // 备用 - 主 的零点偏差
+    uint8_t getHealthyCount() const;
+    const PressureSensorHealth& getHealth(PressureSensorId id) const { return _health[id]; }
+
+    static const char* faultName(PressureSensorFault fault);
+
+private:
+    PressureFusionConfig _config;
+    bool _initialized;
+    float _x[2];                // 状态：压力、变化率
+    float _p[2][2];             // 协方差
+    float _offset;              // 备用传感器零点偏差
+    bool _offsetValid;
+    uint8_t _lastUsed;
+
+    PressureSensorHealth _health[PRESSURE_SENSOR_COUNT];
+    bool _excluded[PRESSURE_SENSOR_COUNT];
+    float _noiseVar[PRESSURE_SENSOR_COUNT];
+    float _lastRaw[PRESSURE_SENSOR_COUNT];
+    uint8_t _stuckCount[PRESSURE_SENSOR_COUNT];
+    uint8_t _goodCount[PRESSURE_SENSOR_COUNT];
+    uint8_t _divergeCount;
+
+    void predict(float dt);
+    void correct(uint8_t id, float z);
+    void markFault(uint8_t id, PressureSensorFault fault);
+    void markGood(uint8_t id, bool consistent);
+};
+
+#endif
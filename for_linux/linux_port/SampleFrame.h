@@ -0,0 +1,43 @@
+#ifndef SampleFrame_h
+#define SampleFrame_h
+
+#include <cstdint>
+
+// 采样帧：BreathController 每完成一次主气压传感器采集后产生一帧，
+// 包含所有通道在同一时刻的最新值，供记录器/遥测等下游模块使用。
+
+// 通道编号（顺序即文件/内存中的存储顺序，新增通道只能追加在末尾）
+enum SampleChannel {
+    CH_PRESSURE = 0,        // 主气压 (kPa, 滤波后)
+    CH_PRESSURE_BACKUP,     // 备用气压 (kPa, 滤波后)
+    CH_FLOW,                // 流量 (ml/min)
+    CH_CO2,                 // CO2 (ppm)
+    CH_O2,                  // O2 (%)
+    CH_TEMPERATURE,         // 温度 (°C, 气压传感器实测)
+    CH_VALVE,               // 气阀开度 (0-255)
+    CH_VOLUME,              // 容积 (ml, 每次呼吸触发归零)
+    CH_COUNT
+};
+
+// 帧标志位
+constexpr uint8_t FRAME_FLAG_BACKUP_VALID = 0x01;  // 备用气压值本周期有效
+constexpr uint8_t FRAME_FLAG_FLOW_VALID   = 0x02;  // 流量值本周期有效
+constexpr uint8_t FRAME_FLAG_O2_VALID     = 0x04;  // 氧浓度已校准且有效
+constexpr uint8_t FRAME_FLAG_TEMP_VALID   = 0x08;  // 温度本周期有新读数（否则为上次读数）
+
+struct SampleFrame {
+    uint64_t timestampUs;       // epochMicros() 墙上时钟时间戳（Unix 微秒）
+    float values[CH_COUNT];     // 各通道数值，按 SampleChannel 索引
+    uint8_t breathState;        // BreathState
+    uint8_t flags;              // FRAME_FLAG_*
+};
+
+// 采样帧消费者接口（记录器、遥测发布等）
+// onSample 在采集线程中调用，实现必须是非阻塞的
+class SampleSink {
+public:
+    virtual ~SampleSink() {}
+    virtual void onSample(const SampleFrame& frame) = 0;
+};
+
+#endif
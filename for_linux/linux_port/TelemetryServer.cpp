@@ -0,0 +1,361 @@
+#include "TelemetryServer.h"
+#include "LogModules.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
+
+static_assert((STREAM_QUEUE_SIZE & (STREAM_QUEUE_SIZE - 1)) == 0, "STREAM_QUEUE_SIZE 必须是 2 的幂");
+
+static const int POLL_INTERVAL_MS = 10;
+static const size_t SAMPLE_FIXED_BYTES = sizeof(uint64_t) + 2;   // timestampUs + breathState + flags
+
+// 批超时使用真实单调时钟（回放模式下也按真实时间发送）
+static uint64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+TelemetryServer::TelemetryServer(const std::string& path)
+    : _path(path), _listenFd(-1), _running(false), _clientCount(0),
+      _head(0), _tail(0), _queueDrops(0), _pendingQueueDrops(0) {
+}
+
+TelemetryServer::~TelemetryServer() {
+    end();
+}
+
+// 清理上次异常退出留下的套接字文件；仍有进程在监听（另一个控制器实例）
+// 或路径不是套接字时拒绝，不能接管别人的套接字
+static bool removeStaleSocket(const struct sockaddr_un& addr) {
+    struct stat st;
+    if (lstat(addr.sun_path, &st) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        return false;
+    }
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        return false;
+    }
+    bool listening = (connect(probe, (const struct sockaddr*)&addr, sizeof(addr)) == 0 || errno != ECONNREFUSED);
+    ::close(probe);
+    if (listening) {
+        return false;
+    }
+    return unlink(addr.sun_path) == 0 || errno == ENOENT;
+}
+
+bool TelemetryServer::begin() {
+    if (_running) return true;
+
+    if (_path.size() >= sizeof(((struct sockaddr_un*)0)->sun_path)) {
+        LOG_E(TELEM) Serial.println("[Stream] 套接字路径过长");
+        return false;
+    }
+
+    _listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listenFd < 0) {
+        LOG_E(TELEM) Serial.println("[Stream] 创建套接字失败");
+        return false;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, _path.c_str(), sizeof(addr.sun_path) - 1);
+    if (!removeStaleSocket(addr)) {
+        LOG_E(TELEM) {
+            Serial.print("[Stream] ");
+            Serial.print(_path);
+            Serial.println(" 已被占用（另有进程在监听或不是套接字）");
+        }
+        ::close(_listenFd);
+        _listenFd = -1;
+        return false;
+    }
+
+    if (bind(_listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(_listenFd, STREAM_MAX_CLIENTS) != 0) {
+        LOG_E(TELEM) {
+            Serial.print("[Stream] 无法监听 ");
+            Serial.println(_path);
+        }
+        ::close(_listenFd);
+        _listenFd = -1;
+        return false;
+    }
+
+    _running = true;
+    _thread = std::thread(&TelemetryServer::serverLoop, this);
+
+    LOG_I(TELEM) {
+        Serial.print("[Stream] 遥测流监听 ");
+        Serial.println(_path);
+    }
+    return true;
+}
+
+void TelemetryServer::end() {
+    if (_running) {
+        _running = false;
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+    for (size_t i = _clients.size(); i > 0; i--) {
+        closeClient(i - 1);
+    }
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+        _listenFd = -1;
+        unlink(_path.c_str());
+    }
+}
+
+void TelemetryServer::onSample(const SampleFrame& frame) {
+    size_t head = _head.load(std::memory_order_relaxed);
+    size_t tail = _tail.load(std::memory_order_acquire);
+    if (head - tail >= STREAM_QUEUE_SIZE) {
+        // 服务线程跟不上：丢弃本帧，不阻塞采集
+        _queueDrops.fetch_add(1, std::memory_order_relaxed);
+        _pendingQueueDrops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _queue[head & (STREAM_QUEUE_SIZE - 1)] = frame;
+    _head.store(head + 1, std::memory_order_release);
+}
+
+size_t TelemetryServer::sampleSize(uint32_t mask) {
+    size_t size = SAMPLE_FIXED_BYTES;
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        if (mask & (1u << ch)) size += sizeof(float);
+    }
+    return size;
+}
+
+void TelemetryServer::appendMessage(std::vector<uint8_t>& out, uint8_t type, const void* payload, size_t len) {
+    uint32_t length = (uint32_t)(len + 1);
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&length);
+    out.insert(out.end(), p, p + sizeof(length));
+    out.push_back(type);
+    const uint8_t* data = static_cast<const uint8_t*>(payload);
+    out.insert(out.end(), data, data + len);
+}
+
+void TelemetryServer::serverLoop() {
+    std::vector<struct pollfd> fds;
+
+    while (_running) {
+        fds.clear();
+        struct pollfd listenPoll = { _listenFd, POLLIN, 0 };
+        fds.push_back(listenPoll);
+        for (size_t i = 0; i < _clients.size(); i++) {
+            struct pollfd p = { _clients[i].fd, POLLIN, 0 };
+            if (_clients[i].pending.size() > _clients[i].pendingOffset) {
+                p.events |= POLLOUT;
+            }
+            fds.push_back(p);
+        }
+
+        int ready = poll(fds.data(), fds.size(), POLL_INTERVAL_MS);
+        if (ready < 0 && errno != EINTR) {
+            LOG_E(TELEM) Serial.println("[Stream] poll 失败，服务线程退出");
+            break;
+        }
+
+        // 处理已有客户端（倒序，便于删除）
+        for (size_t i = _clients.size(); i > 0; i--) {
+            const struct pollfd& p = fds[i];
+            Client& c = _clients[i - 1];
+            bool ok = true;
+            if (p.revents & (POLLERR | POLLHUP | POLLNVAL)) ok = false;
+            if (ok && (p.revents & POLLIN)) ok = readClient(c);
+            if (ok && (p.revents & POLLOUT)) ok = flushClient(c);
+            if (!ok) closeClient(i - 1);
+        }
+
+        if (fds[0].revents & POLLIN) {
+            acceptClient();
+        }
+
+        // 把队列丢帧计入每个客户端
+        uint32_t queueDrops = _pendingQueueDrops.exchange(0);
+        if (queueDrops > 0) {
+            for (size_t i = 0; i < _clients.size(); i++) {
+                _clients[i].dropped += queueDrops;
+            }
+        }
+
+        // 取出采集线程送来的所有帧
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t head = _head.load(std::memory_order_acquire);
+        while (tail != head) {
+            dispatch(_queue[tail & (STREAM_QUEUE_SIZE - 1)]);
+            tail++;
+        }
+        _tail.store(tail, std::memory_order_release);
+
+        // 超时的未满批也发送出去，然后尽量写出
+        uint64_t now = monotonicUs();
+        for (size_t i = _clients.size(); i > 0; i--) {
+            Client& c = _clients[i - 1];
+            if (c.batchCount > 0 && now - c.batchStartUs >= STREAM_BATCH_TIMEOUT_MS * 1000ULL) {
+                finishBatch(c);
+            }
+            if (!flushClient(c)) {
+                closeClient(i - 1);
+            }
+        }
+    }
+}
+
+void TelemetryServer::acceptClient() {
+    int fd = accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+
+    if ((int)_clients.size() >= STREAM_MAX_CLIENTS) {
+        ::close(fd);
+        return;
+    }
+
+    Client c;
+    c.fd = fd;
+    c.pendingOffset = 0;
+    c.dropped = 0;
+
+    // 默认订阅：全部通道、不抽取、每批 10 个样本
+    StreamSubscribe sub;
+    sub.channelMask = (1u << CH_COUNT) - 1;
+    sub.decimation = 1;
+    sub.batchSize = 10;
+    resetSubscription(c, sub);
+
+    StreamHello hello;
+    hello.version = STREAM_PROTOCOL_VERSION;
+    hello.channelCount = CH_COUNT;
+    appendMessage(c.pending, STREAM_MSG_HELLO, &hello, sizeof(hello));
+
+    _clients.push_back(c);
+    _clientCount = (int)_clients.size();
+}
+
+void TelemetryServer::closeClient(size_t i) {
+    ::close(_clients[i].fd);
+    _clients.erase(_clients.begin() + i);
+    _clientCount = (int)_clients.size();
+}
+
+void TelemetryServer::resetSubscription(Client& c, const StreamSubscribe& sub) {
+    c.sub = sub;
+    c.sub.channelMask &= (1u << CH_COUNT) - 1;
+    if (c.sub.decimation == 0) c.sub.decimation = 1;
+    if (c.sub.batchSize == 0) c.sub.batchSize = 1;
+    if (c.sub.batchSize > STREAM_MAX_BATCH) c.sub.batchSize = STREAM_MAX_BATCH;
+    c.decimationCounter = 0;
+    c.batch.clear();
+    c.batch.reserve(sizeof(StreamBatchHeader) + c.sub.batchSize * sampleSize(c.sub.channelMask));
+    c.batchCount = 0;
+}
+
+bool TelemetryServer::readClient(Client& c) {
+    uint8_t buf[256];
+    ssize_t n = ::read(c.fd, buf, sizeof(buf));
+    if (n == 0) return false;   // 对端关闭
+    if (n < 0) return errno == EAGAIN || errno == EINTR;
+
+    c.inbox.insert(c.inbox.end(), buf, buf + n);
+
+    // 解析完整的消息
+    while (c.inbox.size() >= sizeof(uint32_t)) {
+        uint32_t length;
+        memcpy(&length, c.inbox.data(), sizeof(length));
+        if (length == 0 || length > 1024) return false;   // 协议错误
+        if (c.inbox.size() < sizeof(length) + length) break;
+
+        uint8_t type = c.inbox[sizeof(length)];
+        if (type == STREAM_MSG_SUBSCRIBE && length - 1 >= sizeof(StreamSubscribe)) {
+            StreamSubscribe sub;
+            memcpy(&sub, &c.inbox[sizeof(length) + 1], sizeof(sub));
+            resetSubscription(c, sub);
+        }
+        c.inbox.erase(c.inbox.begin(), c.inbox.begin() + sizeof(length) + length);
+    }
+    return true;
+}
+
+bool TelemetryServer::flushClient(Client& c) {
+    while (c.pendingOffset < c.pending.size()) {
+        ssize_t n = send(c.fd, &c.pending[c.pendingOffset], c.pending.size() - c.pendingOffset,
+                         MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+            // 已发送部分超过一半时压缩缓冲区，避免长期部分积压导致无限增长
+            if (c.pendingOffset > c.pending.size() / 2) {
+                c.pending.erase(c.pending.begin(), c.pending.begin() + c.pendingOffset);
+                c.pendingOffset = 0;
+            }
+            return true;
+        }
+        c.pendingOffset += (size_t)n;
+    }
+    c.pending.clear();
+    c.pendingOffset = 0;
+    return true;
+}
+
+void TelemetryServer::dispatch(const SampleFrame& frame) {
+    for (size_t i = 0; i < _clients.size(); i++) {
+        Client& c = _clients[i];
+        if (c.decimationCounter++ % c.sub.decimation != 0) continue;
+        addSample(c, frame);
+    }
+}
+
+void TelemetryServer::addSample(Client& c, const SampleFrame& frame) {
+    if (c.batchCount == 0) {
+        c.batch.resize(sizeof(StreamBatchHeader));
+        c.batchStartUs = monotonicUs();
+    }
+
+    const uint8_t* ts = reinterpret_cast<const uint8_t*>(&frame.timestampUs);
+    c.batch.insert(c.batch.end(), ts, ts + sizeof(frame.timestampUs));
+    c.batch.push_back(frame.breathState);
+    c.batch.push_back(frame.flags);
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        if (!(c.sub.channelMask & (1u << ch))) continue;
+        const uint8_t* v = reinterpret_cast<const uint8_t*>(&frame.values[ch]);
+        c.batch.insert(c.batch.end(), v, v + sizeof(float));
+    }
+    c.batchCount++;
+
+    if (c.batchCount >= c.sub.batchSize) {
+        finishBatch(c);
+    }
+}
+
+void TelemetryServer::finishBatch(Client& c) {
+    if (c.batchCount == 0) return;
+
+    // 客户端积压过多：丢弃整批并计数，下一批的 dropped 字段告知客户端
+    if (c.pending.size() - c.pendingOffset + c.batch.size() > STREAM_MAX_PENDING_BYTES) {
+        c.dropped += c.batchCount;
+        c.batchCount = 0;
+        return;
+    }
+
+    StreamBatchHeader header;
+    header.channelMask = c.sub.channelMask;
+    header.count = c.batchCount;
+    header.sampleSize = (uint16_t)sampleSize(c.sub.channelMask);
+    header.dropped = c.dropped;
+    memcpy(c.batch.data(), &header, sizeof(header));
+
+    appendMessage(c.pending, STREAM_MSG_BATCH, c.batch.data(), c.batch.size());
+    c.dropped = 0;
+    c.batchCount = 0;
+}
@@ -0,0 +1,117 @@
+#ifndef TelemetryServer_h
+#define TelemetryServer_h
+
+#include "LuckfoxArduino.h"
+#include "SampleFrame.h"
+#include <atomic>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// Unix 域套接字二进制遥测流
+//
+// 采集线程只把 SampleFrame 推入单生产者/单消费者无锁环形队列（满则丢弃并计数，
+// 绝不阻塞）；服务线程用 poll() 管理监听与所有客户端连接，按各自订阅打包发送。
+//
+// 所有消息均为 [uint32 长度][uint8 类型][负载]，长度不含自身 4 字节，本机字节序。
+//
+// 客户端 -> 服务端
+//   STREAM_MSG_SUBSCRIBE  StreamSubscribe
+// 服务端 -> 客户端
+//   STREAM_MSG_HELLO      StreamHello（连接后立即发送）
+//   STREAM_MSG_BATCH      StreamBatchHeader + count 个样本，每个样本：
+//                         uint64 timestampUs, uint8 breathState, uint8 flags,
+//                         随后按通道序号递增依次为订阅通道的 float 值
+
+constexpr uint32_t STREAM_PROTOCOL_VERSION = 1;
+constexpr const char* STREAM_DEFAULT_PATH = "/tmp/breath_telemetry.sock";
+constexpr size_t STREAM_QUEUE_SIZE = 1024;            // 采集 -> 服务线程队列（2 的幂）
+constexpr int STREAM_MAX_CLIENTS = 8;
+constexpr size_t STREAM_MAX_PENDING_BYTES = 256 * 1024;  // 单个客户端未发送数据上限
+constexpr uint16_t STREAM_MAX_BATCH = 256;
+constexpr unsigned long STREAM_BATCH_TIMEOUT_MS = 100;   // 未凑满的批最长等待时间
+
+enum StreamMessageType {
+    STREAM_MSG_HELLO = 1,
+    STREAM_MSG_SUBSCRIBE = 2,
+    STREAM_MSG_BATCH = 3
+};
+
+#pragma pack(push, 1)
+struct StreamHello {
+    uint32_t version;           // STREAM_PROTOCOL_VERSION
+    uint32_t channelCount;      // CH_COUNT
+};
+
+struct StreamSubscribe {
+    uint32_t channelMask;       // 1 << SampleChannel
+    uint16_t decimation;        // 每 N 个样本发送 1 个（>= 1）
+    uint16_t batchSize;         // 每批样本数（1..STREAM_MAX_BATCH）
+};
+
+struct StreamBatchHeader {
+    uint32_t channelMask;
+    uint16_t count;
+    uint16_t sampleSize;        // 单个样本字节数
+    uint32_t dropped;           // 自上一批以来因客户端过慢或队列满而丢弃的样本数
+};
+#pragma pack(pop)
+
+class TelemetryServer : public SampleSink {
+public:
+    TelemetryServer(const std::string& path = STREAM_DEFAULT_PATH);
+    ~TelemetryServer();
+
+    // 创建监听套接字并启动服务线程
+    bool begin();
+    void end();
+
+    // 采集线程调用：无锁入队，不做系统调用
+    void onSample(const SampleFrame& frame) override;
+
+    int getClientCount() const { return _clientCount.load(); }
+    uint64_t getQueueDrops() const { return _queueDrops.load(); }
+
+private:
+    struct Client {
+        int fd;
+        StreamSubscribe sub;
+        uint32_t decimationCounter;
+        std::vector<uint8_t> batch;     // 正在累积的批
+        uint16_t batchCount;
+        uint64_t batchStartUs;          // 本批第一个样本入批时间（超时即发送）
+        std::vector<uint8_t> pending;   // 已打包待发送
+        size_t pendingOffset;
+        std::vector<uint8_t> inbox;     // 未解析完的请求
+        uint32_t dropped;
+    };
+
+    std::string _path;
+    int _listenFd;
+    std::thread _thread;
+    std::atomic<bool> _running;
+    std::atomic<int> _clientCount;
+
+    // SPSC 队列
+    SampleFrame _queue[STREAM_QUEUE_SIZE];
+    std::atomic<size_t> _head;          // 生产者写入位置
+    std::atomic<size_t> _tail;          // 消费者读取位置
+    std::atomic<uint64_t> _queueDrops;
+    std::atomic<uint32_t> _pendingQueueDrops;
+
+    std::vector<Client> _clients;
+
+    void serverLoop();
+    void acceptClient();
+    void closeClient(size_t i);
+    bool readClient(Client& c);
+    bool flushClient(Client& c);
+    void dispatch(const SampleFrame& frame);
+    void addSample(Client& c, const SampleFrame& frame);
+    void finishBatch(Client& c);
+    void resetSubscription(Client& c, const StreamSubscribe& sub);
+    static void appendMessage(std::vector<uint8_t>& out, uint8_t type, const void* payload, size_t len);
+    static size_t sampleSize(uint32_t mask);
+};
+
+#endif
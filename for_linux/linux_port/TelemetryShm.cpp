@@ -0,0 +1,322 @@
+#include "TelemetryShm.h"
+#include "LogModules.h"
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <time.h>
+
+static_assert(sizeof(TelemetryShmHeader) <= TELEMETRY_HEADER_SIZE, "TelemetryShmHeader 超出头部页");
+
+// 心跳使用真实单调时钟，回放模式下的虚拟时钟不影响查看者判断
+static uint64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static size_t telemetryMapSize(uint32_t capacity) {
+    return TELEMETRY_HEADER_SIZE + (size_t)capacity * sizeof(TelemetrySlot);
+}
+
+// 段头记录的写者是否仍在工作：进程存在（且不是自己）并且心跳未过期
+static bool publisherAlive(const TelemetryShmHeader* header) {
+    uint64_t pid = __atomic_load_n(&header->publisherPid, __ATOMIC_ACQUIRE);
+    if (pid == 0 || pid == (uint64_t)getpid() || kill((pid_t)pid, 0) != 0) return false;
+    uint64_t heartbeat = __atomic_load_n(&header->heartbeatUs, __ATOMIC_RELAXED);
+    uint64_t now = monotonicUs();
+    return now < heartbeat || now - heartbeat < TELEMETRY_STALE_MS * 1000ULL;
+}
+
+// 只映射头部页检查已有段是否属于另一个活着的写者（段尺寸可能与本进程配置不同）
+static bool segmentHasLivePublisher(int fd, size_t size) {
+    if (size < TELEMETRY_HEADER_SIZE) return false;
+    void* p = mmap(nullptr, TELEMETRY_HEADER_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return false;
+    const TelemetryShmHeader* header = static_cast<const TelemetryShmHeader*>(p);
+    bool alive = header->magic == TELEMETRY_MAGIC && publisherAlive(header);
+    munmap(p, TELEMETRY_HEADER_SIZE);
+    return alive;
+}
+
+// ===================== TelemetryPublisher =====================
+
+TelemetryPublisher::TelemetryPublisher(const std::string& name, uint32_t capacity)
+    : _name(name), _capacity(capacity), _fd(-1), _map(nullptr), _mapSize(0),
+      _header(nullptr), _slots(nullptr) {
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    end();
+}
+
+bool TelemetryPublisher::begin() {
+    if (_header) return true;
+    if (_capacity == 0) return false;
+
+    _mapSize = telemetryMapSize(_capacity);
+    _fd = shm_open(_name.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0) {
+        LOG_E(TELEM) {
+            Serial.print("[Telemetry] 无法创建共享内存: ");
+            Serial.println(_name);
+        }
+        return false;
+    }
+
+    // 另一个写者仍在发布时不接管：复位环形缓冲会让两个进程交替覆盖同一数据流。
+    // 写者在发布期间一直持有段上的文件锁（进程退出时由内核释放），同时启动的两个写者
+    // 只有一个能拿到；段头的 pid 仍存在且心跳未过期也视为有活着的写者
+    struct stat st;
+    if (flock(_fd, LOCK_EX | LOCK_NB) != 0 || fstat(_fd, &st) != 0 ||
+        segmentHasLivePublisher(_fd, (size_t)st.st_size)) {
+        LOG_E(TELEM) {
+            Serial.print("[Telemetry] ");
+            Serial.print(_name);
+            Serial.println(" 已有正在运行的发布进程，不接管（用 --shm 指定其他名称）");
+        }
+        ::close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    // 已存在但尺寸不同的旧段不能原地改尺寸（已映射的查看者会 SIGBUS），删除后重建；
+    // 以 O_EXCL 创建，期间被别的写者抢先创建则放弃
+    if (st.st_size != 0 && (size_t)st.st_size != _mapSize) {
+        ::close(_fd);
+        shm_unlink(_name.c_str());
+        _fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (_fd < 0 || flock(_fd, LOCK_EX | LOCK_NB) != 0) {
+            LOG_E(TELEM) Serial.println("[Telemetry] 重建共享内存失败");
+            end();
+            return false;
+        }
+        st.st_size = 0;
+    }
+
+    if (st.st_size == 0 && ftruncate(_fd, _mapSize) != 0) {
+        LOG_E(TELEM) Serial.println("[Telemetry] 设置共享内存大小失败");
+        end();
+        return false;
+    }
+
+    void* p = mmap(nullptr, _mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (p == MAP_FAILED) {
+        LOG_E(TELEM) Serial.println("[Telemetry] 映射共享内存失败");
+        end();
+        return false;
+    }
+    _map = static_cast<uint8_t*>(p);
+    _header = reinterpret_cast<TelemetryShmHeader*>(_map);
+    _slots = reinterpret_cast<TelemetrySlot*>(_map + TELEMETRY_HEADER_SIZE);
+
+    // 复用旧段时沿用 generation 计数，查看者据此发现重启
+    uint64_t generation = 0;
+    if (_header->magic == TELEMETRY_MAGIC && _header->version == TELEMETRY_VERSION) {
+        generation = __atomic_load_n(&_header->generation, __ATOMIC_RELAXED);
+    }
+
+    // 先把 writeIndex 清零并作废所有槽，再发布新的布局信息
+    __atomic_store_n(&_header->writeIndex, 0, __ATOMIC_RELEASE);
+    for (uint32_t i = 0; i < _capacity; i++) {
+        __atomic_store_n(&_slots[i].index, 0, __ATOMIC_RELAXED);
+    }
+    _header->magic = TELEMETRY_MAGIC;
+    _header->version = TELEMETRY_VERSION;
+    _header->headerSize = TELEMETRY_HEADER_SIZE;
+    _header->slotSize = sizeof(TelemetrySlot);
+    _header->channelCount = CH_COUNT;
+    _header->ringCapacity = _capacity;
+    __atomic_store_n(&_header->snapshotSeq, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_header->heartbeatUs, monotonicUs(), __ATOMIC_RELAXED);
+    __atomic_store_n(&_header->publisherPid, (uint64_t)getpid(), __ATOMIC_RELAXED);
+    __atomic_store_n(&_header->generation, generation + 1, __ATOMIC_RELEASE);
+
+    LOG_I(TELEM) {
+        Serial.print("[Telemetry] 共享内存 ");
+        Serial.print(_name);
+        Serial.print(", 环形缓冲 ");
+        Serial.print((unsigned long)_capacity);
+        Serial.println(" 帧");
+    }
+    return true;
+}
+
+void TelemetryPublisher::end() {
+    // 只清除自己的 pid，begin() 放弃接管时不影响正在运行的写者
+    if (_header) {
+        uint64_t self = (uint64_t)getpid();
+        __atomic_compare_exchange_n(&_header->publisherPid, &self, 0,
+                                    false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    }
+    if (_map) {
+        munmap(_map, _mapSize);
+        _map = nullptr;
+    }
+    _header = nullptr;
+    _slots = nullptr;
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+void TelemetryPublisher::publish(const SampleFrame& frame) {
+    if (!_header) return;
+
+    // 环形缓冲：槽序号清零 -> 写帧 -> release 写入序号
+    uint64_t index = _header->writeIndex + 1;
+    TelemetrySlot& slot = _slots[(index - 1) % _capacity];
+    __atomic_store_n(&slot.index, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot.frame = frame;
+    __atomic_store_n(&slot.index, index, __ATOMIC_RELEASE);
+
+    // 快照 seqlock
+    uint64_t seq = _header->snapshotSeq;
+    __atomic_store_n(&_header->snapshotSeq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    _header->snapshot = frame;
+    __atomic_store_n(&_header->snapshotSeq, seq + 2, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&_header->writeIndex, index, __ATOMIC_RELEASE);
+    __atomic_store_n(&_header->heartbeatUs, monotonicUs(), __ATOMIC_RELAXED);
+}
+
+// ===================== TelemetryReader =====================
+
+TelemetryReader::TelemetryReader(const std::string& name)
+    : _name(name), _fd(-1), _map(nullptr), _mapSize(0), _header(nullptr), _slots(nullptr),
+      _capacity(0), _generation(0) {
+}
+
+TelemetryReader::~TelemetryReader() {
+    detach();
+}
+
+bool TelemetryReader::attach() {
+    detach();
+
+    _fd = shm_open(_name.c_str(), O_RDONLY, 0);
+    if (_fd < 0) {
+        return false;   // 写者尚未启动，由调用方决定是否重试
+    }
+
+    struct stat st;
+    if (fstat(_fd, &st) != 0 || (size_t)st.st_size < TELEMETRY_HEADER_SIZE) {
+        detach();
+        return false;
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+    if (p == MAP_FAILED) {
+        detach();
+        return false;
+    }
+    _map = static_cast<uint8_t*>(p);
+    _mapSize = st.st_size;
+
+    const TelemetryShmHeader* header = reinterpret_cast<const TelemetryShmHeader*>(_map);
+    if (header->magic != TELEMETRY_MAGIC || header->version != TELEMETRY_VERSION ||
+        header->headerSize != TELEMETRY_HEADER_SIZE || header->slotSize != sizeof(TelemetrySlot) ||
+        header->channelCount != CH_COUNT ||
+        telemetryMapSize(header->ringCapacity) > _mapSize) {
+        LOG_E(TELEM) Serial.println("[Telemetry] 共享内存布局版本不匹配");
+        detach();
+        return false;
+    }
+
+    _header = header;
+    _slots = reinterpret_cast<const TelemetrySlot*>(_map + TELEMETRY_HEADER_SIZE);
+    _capacity = header->ringCapacity;
+    _generation = __atomic_load_n(&header->generation, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+void TelemetryReader::detach() {
+    if (_map) {
+        munmap(_map, _mapSize);
+        _map = nullptr;
+    }
+    _header = nullptr;
+    _slots = nullptr;
+    _capacity = 0;
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool TelemetryReader::isPublisherAlive() const {
+    if (!_header) return false;
+    uint64_t pid = __atomic_load_n(&_header->publisherPid, __ATOMIC_ACQUIRE);
+    if (pid == 0 || kill((pid_t)pid, 0) != 0) return false;
+    uint64_t heartbeat = __atomic_load_n(&_header->heartbeatUs, __ATOMIC_RELAXED);
+    uint64_t now = monotonicUs();
+    return now < heartbeat || now - heartbeat < TELEMETRY_STALE_MS * 1000ULL;
+}
+
+bool TelemetryReader::publisherRestarted() const {
+    if (!_header) return false;
+    return __atomic_load_n(&_header->generation, __ATOMIC_ACQUIRE) != _generation;
+}
+
+bool TelemetryReader::readSnapshot(SampleFrame& out) const {
+    if (!_header) return false;
+    for (int attempt = 0; attempt < 16; attempt++) {
+        uint64_t s1 = __atomic_load_n(&_header->snapshotSeq, __ATOMIC_ACQUIRE);
+        if (s1 == 0) return false;
+        if (s1 & 1) continue;
+        memcpy(&out, (const void*)&_header->snapshot, sizeof(out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&_header->snapshotSeq, __ATOMIC_RELAXED) == s1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t TelemetryReader::latestIndex() const {
+    if (!_header) return 0;
+    return __atomic_load_n(&_header->writeIndex, __ATOMIC_ACQUIRE);
+}
+
+uint64_t TelemetryReader::oldestIndex() const {
+    uint64_t latest = latestIndex();
+    if (latest == 0) return 0;
+    return latest > _capacity ? latest - _capacity + 1 : 1;
+}
+
+const SampleFrame* TelemetryReader::frameAt(uint64_t index) const {
+    if (!_header || index == 0) return nullptr;
+    const TelemetrySlot& slot = _slots[(index - 1) % _capacity];
+    if (__atomic_load_n(&slot.index, __ATOMIC_ACQUIRE) != index) return nullptr;
+    return &slot.frame;
+}
+
+bool TelemetryReader::isStillValid(uint64_t index) const {
+    if (!_header || index == 0) return false;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    const TelemetrySlot& slot = _slots[(index - 1) % _capacity];
+    return __atomic_load_n(&slot.index, __ATOMIC_RELAXED) == index;
+}
+
+size_t TelemetryReader::readSince(uint64_t afterIndex, SampleFrame* out, size_t maxCount, uint64_t* lastIndex) const {
+    if (!_header || maxCount == 0) return 0;
+
+    uint64_t latest = latestIndex();
+    uint64_t oldest = oldestIndex();
+    uint64_t index = afterIndex + 1;
+    if (index < oldest) index = oldest;
+
+    size_t count = 0;
+    for (; index <= latest && count < maxCount; index++) {
+        const SampleFrame* frame = frameAt(index);
+        if (!frame) continue;
+        memcpy(&out[count], frame, sizeof(SampleFrame));
+        if (!isStillValid(index)) continue;     // 拷贝期间被覆盖
+        count++;
+        if (lastIndex) *lastIndex = index;
+    }
+    return count;
+}
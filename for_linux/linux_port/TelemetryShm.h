@@ -0,0 +1,125 @@
+#ifndef TelemetryShm_h
+#define TelemetryShm_h
+
+#include "LuckfoxArduino.h"
+#include "SampleFrame.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 共享内存遥测通道（POSIX shm）
+//
+// breath_controller 作为唯一写者发布最新快照与波形环形缓冲区，
+// GUI、日志等任意数量的查看者以只读方式映射同一段共享内存，互不影响控制循环。
+//
+//   [0, TELEMETRY_HEADER_SIZE)    TelemetryShmHeader（含 seqlock 保护的最新快照），独占一页
+//   [TELEMETRY_HEADER_SIZE, ...)  ringCapacity 个 TelemetrySlot
+//
+// 布局带版本号：查看者在 attach 时校验 magic/version/各结构尺寸，不匹配即拒绝。
+// 写者每次启动递增 generation，查看者据此发现控制进程重启并重新对齐读位置。
+// 同一时刻只允许一个写者：段上的文件锁被占用、或段头 pid 存在且心跳未过期时 begin() 失败。
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x4D4C4554;        // "TELM"
+constexpr uint32_t TELEMETRY_VERSION = 1;
+constexpr size_t TELEMETRY_HEADER_SIZE = 4096;
+constexpr uint32_t TELEMETRY_DEFAULT_CAPACITY = 4096;   // 环形缓冲区帧数
+constexpr const char* TELEMETRY_DEFAULT_NAME = "/breath_telemetry";
+constexpr unsigned long TELEMETRY_STALE_MS = 1000;      // 心跳超过该时间视为写者已停止
+
+struct TelemetryShmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;        // TELEMETRY_HEADER_SIZE
+    uint32_t slotSize;          // sizeof(TelemetrySlot)
+    uint32_t channelCount;      // CH_COUNT
+    uint32_t ringCapacity;
+    uint64_t generation;        // 写者启动次数（每次 begin() 递增）
+    uint64_t publisherPid;
+    uint64_t heartbeatUs;       // 最近一次发布时的 CLOCK_MONOTONIC（不受回放虚拟时钟影响）
+
+    // 最新快照（seqlock：奇数表示正在写入）
+    uint64_t snapshotSeq;
+    SampleFrame snapshot;
+
+    // 已发布的总帧数；第 n 帧（从 1 开始）位于 slot[(n - 1) % ringCapacity]
+    uint64_t writeIndex;
+};
+
+struct TelemetrySlot {
+    uint64_t index;             // 帧序号；0 表示正在写入或空槽
+    SampleFrame frame;
+};
+
+// 写者：作为 SampleSink 挂到 BreathController
+class TelemetryPublisher : public SampleSink {
+public:
+    TelemetryPublisher(const std::string& name = TELEMETRY_DEFAULT_NAME,
+                       uint32_t capacity = TELEMETRY_DEFAULT_CAPACITY);
+    ~TelemetryPublisher();
+
+    // 创建（或复用）共享内存段并初始化布局
+    bool begin();
+    // 解除映射（保留共享内存段，查看者仍可看到最后的数据）
+    void end();
+
+    // 热路径：只有内存写入
+    void publish(const SampleFrame& frame);
+    void onSample(const SampleFrame& frame) override { publish(frame); }
+
+    bool isOpen() const { return _header != nullptr; }
+    const std::string& getName() const { return _name; }
+
+private:
+    std::string _name;
+    uint32_t _capacity;
+    int _fd;
+    uint8_t* _map;
+    size_t _mapSize;
+    TelemetryShmHeader* _header;
+    TelemetrySlot* _slots;
+};
+
+// 只读查看者：可同时存在多个
+class TelemetryReader {
+public:
+    TelemetryReader(const std::string& name = TELEMETRY_DEFAULT_NAME);
+    ~TelemetryReader();
+
+    bool attach();
+    void detach();
+    bool isAttached() const { return _header != nullptr; }
+
+    // 写者心跳正常且进程存在
+    bool isPublisherAlive() const;
+    // 写者是否在 attach 之后重启过（重启后应重新 attach 并从 latestIndex() 开始读）
+    bool publisherRestarted() const;
+
+    // 读取最新快照（seqlock 拷贝），写者尚未发布时返回 false
+    bool readSnapshot(SampleFrame& out) const;
+
+    // 已发布的最新帧序号（0 表示尚无数据）
+    uint64_t latestIndex() const;
+    // 仍可读取的最旧帧序号
+    uint64_t oldestIndex() const;
+    uint32_t getCapacity() const { return _capacity; }
+
+    // 零拷贝访问：直接返回映射内存中的帧。
+    // 使用完毕后须以 isStillValid() 确认该帧在使用期间未被覆盖。
+    const SampleFrame* frameAt(uint64_t index) const;
+    bool isStillValid(uint64_t index) const;
+
+    // 拷贝读取 afterIndex 之后的帧，最多 maxCount 条，返回实际条数
+    size_t readSince(uint64_t afterIndex, SampleFrame* out, size_t maxCount, uint64_t* lastIndex = nullptr) const;
+
+private:
+    std::string _name;
+    int _fd;
+    uint8_t* _map;
+    size_t _mapSize;
+    const TelemetryShmHeader* _header;
+    const TelemetrySlot* _slots;
+    uint32_t _capacity;
+    uint64_t _generation;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "ValveLinearizer.h"
+#include "LogModules.h"
+
+ValveLinearizer::ValveLinearizer(float outputMax) : _outputMax(outputMax), _valid(false) {
+    reset();
+}
+
+void ValveLinearizer::reset() {
+    for (uint8_t k = 0; k < VALVE_LUT_SIZE; k++) {
+        _table[k] = _outputMax * k / (VALVE_LUT_SIZE - 1);
+    }
+    _valid = false;
+}
+
+bool ValveLinearizer::build(const float* duty, const float* response, uint8_t count) {
+    if (count < 3 || count > VALVE_SWEEP_MAX_POINTS) {
+        LOG_W(CTRL) Serial.println("[ValveLUT] 扫描点数不足");
+        return false;
+    }
+
+    // 保序回归（相邻违例合并）：测量噪声造成的回落被拉平为单调不减
+    float level[VALVE_SWEEP_MAX_POINTS];
+    uint8_t width[VALVE_SWEEP_MAX_POINTS];
+    uint8_t blocks = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        level[blocks] = response[i];
+        width[blocks] = 1;
+        blocks++;
+        while (blocks > 1 && level[blocks - 2] > level[blocks - 1]) {
+            uint8_t w = width[blocks - 2] + width[blocks - 1];
+            level[blocks - 2] = (level[blocks - 2] * width[blocks - 2] + level[blocks - 1] * width[blocks - 1]) / w;
+            width[blocks - 2] = w;
+            blocks--;
+        }
+    }
+    float y[VALVE_SWEEP_MAX_POINTS];
+    uint8_t n = 0;
+    for (uint8_t b = 0; b < blocks; b++) {
+        for (uint8_t j = 0; j < width[b]; j++) {
+            y[n++] = level[b];
+        }
+    }
+
+    float span = y[count - 1] - y[0];
+    if (span <= 0.0f) {
+        LOG_W(CTRL) Serial.println("[ValveLUT] 响应无变化，无法建表");
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        y[i] = (y[i] - y[0]) / span;
+    }
+
+    // 求逆：第 k 点取响应首次达到 k/(N-1) 的占空比，0 点取死区边缘
+    uint8_t seg = 0;
+    for (uint8_t k = 0; k < VALVE_LUT_SIZE; k++) {
+        float target = k == 0 ? VALVE_DEADBAND_FRACTION : (float)k / (VALVE_LUT_SIZE - 1);
+        while (seg < count - 2 && y[seg + 1] < target) {
+            seg++;
+        }
+        float y0 = y[seg];
+        float y1 = y[seg + 1];
+        float d = duty[seg + 1];
+        if (y1 > y0 && target > y0) {
+            d = duty[seg] + (target - y0) / (y1 - y0) * (duty[seg + 1] - duty[seg]);
+        } else if (target <= y0) {
+            d = duty[seg];
+        }
+        _table[k] = constrain(d, 0.0f, _outputMax);
+    }
+
+    _valid = true;
+    LOG_I(CTRL) {
+        Serial.print("[ValveLUT] 建表完成，死区边缘占空比 ");
+        Serial.println(_table[0], 1);
+    }
+    return true;
+}
+
+float ValveLinearizer::apply(float opening) const {
+    if (!_valid) {
+        return opening;
+    }
+    if (opening <= 0.0f) {
+        return 0.0f;
+    }
+
+    float x = opening / _outputMax * (VALVE_LUT_SIZE - 1);
+    if (x >= VALVE_LUT_SIZE - 1) {
+        return _table[VALVE_LUT_SIZE - 1];
+    }
+    uint8_t i = (uint8_t)x;
+    float frac = x - i;
+    return _table[i] + frac * (_table[i + 1] - _table[i]);
+}
+
+bool ValveLinearizer::save(const char* ns) {
+    if (!_valid) {
+        return false;
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        LOG_E(CTRL) Serial.println("[ValveLUT] 无法打开存储");
+        return false;
+    }
+    prefs.putInt("points", VALVE_LUT_SIZE);
+    for (uint8_t k = 0; k < VALVE_LUT_SIZE; k++) {
+        std::string key = "d" + std::to_string(k);
+        prefs.putFloat(key.c_str(), _table[k]);
+    }
+    prefs.putBool("is_valid", true);
+    prefs.end();
+
+    LOG_I(CTRL) Serial.println("[ValveLUT] 查找表已保存");
+    return true;
+}
+
+bool ValveLinearizer::load(const char* ns) {
+    Preferences prefs;
+    if (!prefs.begin(ns, true)) {
+        return false;
+    }
+    if (!prefs.getBool("is_valid", false) || prefs.getInt("points", 0) != VALVE_LUT_SIZE) {
+        prefs.end();
+        LOG_W(CTRL) Serial.println("[ValveLUT] 未找到查找表，气阀按线性开度输出");
+        return false;
+    }
+
+    float table[VALVE_LUT_SIZE];
+    for (uint8_t k = 0; k < VALVE_LUT_SIZE; k++) {
+        std::string key = "d" + std::to_string(k);
+        table[k] = prefs.getFloat(key.c_str(), -1.0f);
+        // 存储内容损坏（缺项或不单调）时不启用
+        if (table[k] < 0.0f || table[k] > _outputMax || (k > 0 && table[k] < table[k - 1])) {
+            prefs.end();
+            LOG_W(CTRL) Serial.println("[ValveLUT] 查找表无效，忽略");
+            return false;
+        }
+    }
+    prefs.end();
+
+    for (uint8_t k = 0; k < VALVE_LUT_SIZE; k++) {
+        _table[k] = table[k];
+    }
+    _valid = true;
+    LOG_I(CTRL) {
+        Serial.print("[ValveLUT] 查找表已加载，死区边缘占空比 ");
+        Serial.println(_table[0], 1);
+    }
+    return true;
+}
+
+void ValveLinearizer::print() const {
+    Serial.println("=== 气阀线性化表 (开度 -> 占空比) ===");
+    for (uint8_t k = 0; k < VALVE_LUT_SIZE; k++) {
+        Serial.print(_outputMax * k / (VALVE_LUT_SIZE - 1), 1);
+        Serial.print(" -> ");
+        Serial.println(_table[k], 1);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef ValveLinearizer_h
+#define ValveLinearizer_h
+
+#include "LuckfoxArduino.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 比例阀线性化查找表
+//
+// 比例阀的稳态流量/压力与占空比强非线性，且在小占空比处有死区。用一次扫描
+// （逐级设置占空比、记录稳态响应）得到特性曲线，保序回归成单调后求逆，得到
+// “期望相对响应 -> 占空比”的等间距表。控制器仍按 0..outputMax 的线性开度计算，
+// 输出前经 apply() 查表（O(1) 线性插值），全量程内增益一致，近关闭处直接越过死区。
+//
+// 表与校准参数一样保存在 Preferences 中；没有表时 apply() 原样返回开度。
+
+constexpr uint8_t VALVE_LUT_SIZE = 33;              // 逆表点数（等间距，含两端）
+constexpr uint8_t VALVE_SWEEP_MAX_POINTS = 64;      // 扫描点数上限
+constexpr float VALVE_DEADBAND_FRACTION = 0.02f;    // 响应达到满量程的该比例即视为越过死区
+constexpr const char* VALVE_LUT_NAMESPACE = "valve_lut";
+
+struct ValveSweepConfig {
+    uint8_t dutyStep;           // 占空比步长（0..255 量纲）
+    unsigned long settleMs;     // 每级设置后等待稳定的时间
+    unsigned long sampleMs;     // 稳定后取平均的时间
+};
+
+static const ValveSweepConfig DEFAULT_VALVE_SWEEP = {
+    8,          // dutyStep
+    400,        // settleMs
+    200         // sampleMs
+};
+
+class ValveLinearizer {
+public:
+    ValveLinearizer(float outputMax = 255.0f);
+
+    // 由扫描数据建表：duty 升序，response 为对应的稳态响应（流量或压力）
+    bool build(const float* duty, const float* response, uint8_t count);
+
+    // 线性开度 -> 实际占空比；0 保持关闭
+    float apply(float opening) const;
+
+    bool isValid() const { return _valid; }
+    float getDeadbandDuty() const { return _valid ? _table[0] : 0.0f; }
+    void reset();
+
+    // Preferences 存取
+    bool save(const char* ns = VALVE_LUT_NAMESPACE);
+    bool load(const char* ns = VALVE_LUT_NAMESPACE);
+    void print() const;
+
+private:
+    float _outputMax;
+    float _table[VALVE_LUT_SIZE];   // _table[k]：达到 k/(N-1) 满量程响应所需占空比
+    bool _valid;
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "VolumeIntegrator.h"
+
+VolumeIntegrator::VolumeIntegrator(const VolumeIntegratorConfig& config) : _config(config) {
+    reset();
+}
+
+void VolumeIntegrator::reset() {
+    _hasSample = false;
+    _lastUs = 0;
+    _lastFlow = 0.0f;
+    _inBreath = false;
+    _breathStartUs = 0;
+    _volume = 0.0;
+    _vti = 0.0;
+    _vte = 0.0;
+    _leakFlow = 0.0f;
+    _leakValid = false;
+    _last = BreathVolume();
+    _gapCount = 0;
+}
+
+float VolumeIntegrator::addSample(unsigned long timestampUs, float flowMlMin) {
+    if (!std::isfinite(flowMlMin)) {
+        return (float)_volume;
+    }
+    if (!_hasSample) {
+        _hasSample = true;
+        _lastUs = timestampUs;
+        _lastFlow = flowMlMin;
+        return (float)_volume;
+    }
+
+    unsigned long dtUs = timestampUs - _lastUs;
+    if (dtUs > _config.maxGapUs) {
+        _gapCount++;
+        _lastUs = timestampUs;
+        _lastFlow = flowMlMin;
+        return (float)_volume;
+    }
+
+    // ml/min * us -> ml
+    double dtMin = dtUs / 60.0e6;
+    double q0 = _lastFlow;
+    double q1 = flowMlMin;
+
+    // 吸气/呼气两部分：同号区间整段计入，异号区间在线性插值的过零点拆开
+    double inspired = 0.0;
+    double expired = 0.0;
+    if (q0 >= 0.0 && q1 >= 0.0) {
+        inspired = 0.5 * (q0 + q1) * dtMin;
+    } else if (q0 <= 0.0 && q1 <= 0.0) {
+        expired = -0.5 * (q0 + q1) * dtMin;
+    } else {
+        double f = q0 / (q0 - q1);
+        double a0 = 0.5 * q0 * f * dtMin;
+        double a1 = 0.5 * q1 * (1.0 - f) * dtMin;
+        inspired = q0 > 0.0 ? a0 : a1;
+        expired = q0 > 0.0 ? -a1 : -a0;
+    }
+    _vti += inspired;
+    _vte += expired;
+
+    double net = inspired - expired;
+    if (_config.leakCompensation && _config.bidirectional && _leakValid) {
+        net -= _leakFlow * dtMin;
+    }
+    _volume += net;
+
+    _lastUs = timestampUs;
+    _lastFlow = flowMlMin;
+    return (float)_volume;
+}
+
+bool VolumeIntegrator::markBreathStart(unsigned long timestampUs) {
+    if (!_inBreath) {
+        _inBreath = true;
+        _breathStartUs = timestampUs;
+        _volume = 0.0;
+        _vti = 0.0;
+        _vte = 0.0;
+        return false;
+    }
+
+    unsigned long durationMs = (timestampUs - _breathStartUs) / 1000UL;
+    if (durationMs < _config.minBreathMs) {
+        return false;
+    }
+
+    BreathVolume breath;
+    breath.index = _last.index + 1;
+    breath.durationMs = durationMs;
+    breath.vtiMl = (float)_vti;
+    breath.hasExpiratory = _config.bidirectional;
+    if (breath.hasExpiratory) {
+        breath.vteMl = (float)_vte;
+        breath.leakMl = (float)(_vti - _vte);
+        breath.leakPercent = _vti > 0.0 ? (float)((_vti - _vte) / _vti * 100.0) : 0.0f;
+        breath.leakFlowMlMin = breath.leakMl / (durationMs / 60000.0f);
+    } else {
+        breath.vteMl = NAN;
+        breath.leakMl = NAN;
+        breath.leakPercent = NAN;
+        breath.leakFlowMlMin = NAN;
+    }
+    _last = breath;
+
+    // 单向流量源的 VTi - VTe 就是 VTi 本身，不能当漏气估计
+    if (!breath.hasExpiratory) {
+        _leakValid = false;
+    } else if (_leakValid) {
+        _leakFlow += _config.leakAlpha * (breath.leakFlowMlMin - _leakFlow);
+    } else {
+        _leakFlow = breath.leakFlowMlMin;
+        _leakValid = true;
+    }
+
+    _breathStartUs = timestampUs;
+    _volume = 0.0;
+    _vti = 0.0;
+    _vte = 0.0;
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef VolumeIntegrator_h
+#define VolumeIntegrator_h
+
+#include "LuckfoxArduino.h"
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 潮气量积分
+//
+// 每个带时间戳的流量样本（ml/min，正值为吸气）按实际采样间隔做梯形积分：
+//   V += (q[k-1] + q[k]) / 2 * (t[k] - t[k-1])
+// 时间戳取 micros()（按无符号差值计算，跨越回绕也正确），累加用 double。
+// 流量过零的区间按线性插值的过零点拆分，吸气、呼气两部分分别计入 VTi、VTe。
+// 两个样本间隔超过 maxGapUs（读数中断）时不跨缺口积分，从新样本重新开始。
+//
+// 呼吸检测每次进入吸气时调用 markBreathStart() 结束上一呼吸：
+//   VTi = 吸气方向流量的积分，VTe = 呼气方向流量积分的绝对值，漏气量 = VTi - VTe
+// 平均漏气流量 (VTi - VTe) / 呼吸时长 在呼吸之间做 EWMA。容积波形每次呼吸从 0 开始；
+// 开启漏气补偿时先从流量中扣除估计的漏气流量再积分，波形在呼气末回到基线附近，
+// 不会因漏气或流量零点偏差逐呼吸漂移。VTi/VTe 始终由未补偿的流量计算。
+// 流量源只能测单向流量（bidirectional = false，如 CAFS3000）时 VTe 恒为 0，
+// 漏气量没有意义：不报告 VTe 与漏气、不估计漏气流量，也不做漏气补偿。
+
+struct VolumeIntegratorConfig {
+    unsigned long maxGapUs;     // 样本间隔上限，超过视为读数中断
+    unsigned long minBreathMs;  // 短于此时长的呼吸触发视为误触发
+    float leakAlpha;            // 漏气流量的呼吸间 EWMA 系数
+    bool leakCompensation;      // 容积波形扣除估计漏气流量
+    bool bidirectional;         // 流量源能测出呼气方向（负值）
+};
+
+static const VolumeIntegratorConfig DEFAULT_VOLUME_CONFIG = {
+    500000,     // maxGapUs
+    500,        // minBreathMs
+    0.3f,       // leakAlpha
+    true,       // leakCompensation
+    true        // bidirectional
+};
+
+struct BreathVolume {
+    uint32_t index;             // 呼吸序号（从 1 开始）
+    unsigned long durationMs;   // 触发到下一次触发的时长
+    float vtiMl;                // 吸气潮气量
+    bool hasExpiratory;         // 以下各项有效（流量源为双向）；否则为 NAN
+    float vteMl;                // 呼气潮气量
+    float leakMl;               // VTi - VTe
+    float leakPercent;          // 漏气量占 VTi 的百分比
+    float leakFlowMlMin;        // 本呼吸的平均漏气流量
+};
+
+class VolumeIntegrator {
+public:
+    VolumeIntegrator(const VolumeIntegratorConfig& config = DEFAULT_VOLUME_CONFIG);
+
+    void reset();
+    void setConfig(const VolumeIntegratorConfig& config) { _config = config; }
+    const VolumeIntegratorConfig& getConfig() const { return _config; }
+
+    // 送入一个流量样本，返回当前容积 (ml)
+    float addSample(unsigned long timestampUs, float flowMlMin);
+
+    // 呼吸触发：结束上一呼吸并开始新呼吸，完成了一次有效呼吸时返回 true
+    bool markBreathStart(unsigned long timestampUs);
+
+    float getVolume() const { return (float)_volume; }
+    float getCurrentVti() const { return (float)_vti; }
+    float getCurrentVte() const { return (float)_vte; }
+
+    bool hasBreath() const { return _last.index > 0; }
+    const BreathVolume& getLastBreath() const { return _last; }
+    float getLeakFlow() const { return _leakValid ? _leakFlow : NAN; }   // 未估计时为 NAN
+    uint32_t getGapCount() const { return _gapCount; }
+
+private:
+    VolumeIntegratorConfig _config;
+
+    bool _hasSample;
+    unsigned long _lastUs;
+    float _lastFlow;
+
+    bool _inBreath;
+    unsigned long _breathStartUs;
+    double _volume;             // 容积波形（漏气补偿后）
+    double _vti;
+    double _vte;
+
+    float _leakFlow;            // 漏气流量估计 (ml/min)
+    bool _leakValid;
+    BreathVolume _last;
+    uint32_t _gapCount;
+};
+
+#endif
@@ -0,0 +1,428 @@
+#include "WaveformRecorder.h"
+#include "LogModules.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <cerrno>
+
+static const char WAVEFORM_MAGIC[8] = {'B', 'R', 'W', 'A', 'V', 'E', 0, 0};
+
+// 记录校验和：覆盖 timestampUs 到 reserved（不含 seq 与 checksum 本身）
+static uint32_t recordChecksum(const WaveformRecord& rec) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&rec.timestampUs);
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(&rec.checksum);
+    uint32_t hash = 2166136261u;
+    while (p < end) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t pageSize() {
+    static size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+// ===================== WaveformRecorder =====================
+
+WaveformRecorder::WaveformRecorder(const std::string& path, uint32_t capacity, unsigned long syncIntervalMs)
+    : _path(path), _capacity(capacity > 0 ? capacity : 1), _syncIntervalMs(syncIntervalMs),
+      _fd(-1), _map(nullptr), _mapSize(0), _header(nullptr), _records(nullptr), _nextSeq(1),
+      _stopSync(false), _syncedSeq(0), _syncCount(0) {
+}
+
+WaveformRecorder::~WaveformRecorder() {
+    end();
+}
+
+// 已有文件与当前格式不符（升级后通道数变化、容量修改等）时改名保留，不覆盖旧记录
+static bool rotateIncompatible(const std::string& path, uint32_t capacity) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return true;
+    WaveformFileHeader header;
+    ssize_t n = pread(fd, &header, sizeof(header), 0);
+    ::close(fd);
+
+    bool magicOk = (n == (ssize_t)sizeof(header) && memcmp(header.magic, WAVEFORM_MAGIC, sizeof(WAVEFORM_MAGIC)) == 0);
+    if (magicOk && header.version == WAVEFORM_FILE_VERSION && header.headerSize == WAVEFORM_HEADER_SIZE &&
+        header.recordSize == sizeof(WaveformRecord) && header.channelCount == CH_COUNT &&
+        header.capacity == capacity) {
+        return true;
+    }
+    if (n == 0) return true;   // 空文件，直接初始化
+
+    std::string rotated = path + (magicOk ? ".v" + std::to_string(header.version) : std::string(".old"));
+    if (::rename(path.c_str(), rotated.c_str()) != 0) {
+        LOG_E(STORE) {
+            Serial.print("[Recorder] 旧记录文件格式不符且无法改名: ");
+            Serial.println(rotated);
+        }
+        return false;
+    }
+    LOG_W(STORE) {
+        Serial.print("[Recorder] 旧记录文件格式不符，已改名为 ");
+        Serial.println(rotated);
+    }
+    return true;
+}
+
+bool WaveformRecorder::openFile(bool& created) {
+    if (!rotateIncompatible(_path, _capacity)) {
+        return false;
+    }
+
+    struct stat st;
+    created = (::stat(_path.c_str(), &st) != 0);
+
+    _fd = ::open(_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_fd < 0) {
+        LOG_E(STORE) {
+            Serial.print("[Recorder] 无法打开记录文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+
+    _mapSize = WAVEFORM_HEADER_SIZE + (size_t)_capacity * sizeof(WaveformRecord);
+
+    // 预分配实际存储块，避免写满闪存时在映射写入处收到 SIGBUS
+    if (created || (size_t)st.st_size != _mapSize) {
+        if (ftruncate(_fd, 0) != 0 || ftruncate(_fd, (off_t)_mapSize) != 0) {
+            LOG_E(STORE) Serial.println("[Recorder] 设置文件大小失败");
+            return false;
+        }
+        int err = posix_fallocate(_fd, 0, (off_t)_mapSize);
+        if (err != 0 && err != EOPNOTSUPP && err != EINVAL) {
+            LOG_E(STORE) {
+                Serial.print("[Recorder] 预分配存储空间失败, errno=");
+                Serial.println(err);
+            }
+            return false;
+        }
+        created = true;
+    }
+
+    void* addr = mmap(nullptr, _mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG_E(STORE) Serial.println("[Recorder] mmap 失败");
+        return false;
+    }
+    _map = static_cast<uint8_t*>(addr);
+    _header = reinterpret_cast<WaveformFileHeader*>(_map);
+    _records = reinterpret_cast<WaveformRecord*>(_map + WAVEFORM_HEADER_SIZE);
+    return true;
+}
+
+bool WaveformRecorder::headerMatches() const {
+    return memcmp(_header->magic, WAVEFORM_MAGIC, sizeof(WAVEFORM_MAGIC)) == 0 &&
+           _header->version == WAVEFORM_FILE_VERSION &&
+           _header->headerSize == WAVEFORM_HEADER_SIZE &&
+           _header->recordSize == sizeof(WaveformRecord) &&
+           _header->channelCount == CH_COUNT &&
+           _header->capacity == _capacity;
+}
+
+void WaveformRecorder::initHeader() {
+    memset(_map, 0, _mapSize);
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    memcpy(_header->magic, WAVEFORM_MAGIC, sizeof(WAVEFORM_MAGIC));
+    _header->version = WAVEFORM_FILE_VERSION;
+    _header->headerSize = WAVEFORM_HEADER_SIZE;
+    _header->recordSize = sizeof(WaveformRecord);
+    _header->channelCount = CH_COUNT;
+    _header->capacity = _capacity;
+    _header->createdUnixUs = (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+    _header->sessionCount = 0;
+    _header->writeSeq = 0;
+    _header->sessionStartSeq = 0;
+}
+
+// 头部中的 writeSeq 与记录页不保证同时落盘，需要按记录本身校验：
+// 先从头部位置向回找到最后一条完整记录，再向前追上头部未来得及记下的记录
+uint64_t WaveformRecorder::recoverWriteSeq() const {
+    uint64_t seq = _header->writeSeq;
+    uint64_t limit = _capacity;
+
+    auto valid = [this](uint64_t s) {
+        const WaveformRecord& rec = _records[(s - 1) % _capacity];
+        return rec.seq == s && rec.checksum == recordChecksum(rec);
+    };
+
+    while (seq > 0 && limit-- > 0 && !valid(seq)) {
+        seq--;
+    }
+    if (seq > 0 && !valid(seq)) {
+        seq = 0;
+    }
+
+    limit = _capacity;
+    while (limit-- > 0 && valid(seq + 1)) {
+        seq++;
+    }
+    return seq;
+}
+
+bool WaveformRecorder::begin() {
+    if (isOpen()) return true;
+
+    bool created = false;
+    if (!openFile(created)) {
+        end();
+        return false;
+    }
+
+    if (created || !headerMatches()) {
+        LOG_I(STORE) Serial.println("[Recorder] 创建新的波形记录文件");
+        initHeader();
+    }
+
+    uint64_t lastSeq = recoverWriteSeq();
+    if (lastSeq != _header->writeSeq) {
+        LOG_W(STORE) {
+            Serial.print("[Recorder] 恢复写位置: 头部 ");
+            Serial.print((unsigned long)_header->writeSeq);
+            Serial.print(" -> 实际 ");
+            Serial.println((unsigned long)lastSeq);
+        }
+    }
+
+    _header->sessionCount++;
+    _header->sessionStartSeq = lastSeq + 1;
+    __atomic_store_n(&_header->writeSeq, lastSeq, __ATOMIC_RELEASE);
+    _nextSeq = lastSeq + 1;
+    _syncedSeq = lastSeq;
+    msync(_map, WAVEFORM_HEADER_SIZE, MS_SYNC);
+
+    _stopSync = false;
+    _syncThread = std::thread(&WaveformRecorder::syncLoop, this);
+
+    LOG_I(STORE) {
+        Serial.print("[Recorder] 记录文件 ");
+        Serial.print(_path);
+        Serial.print(", 容量 ");
+        Serial.print((unsigned long)_capacity);
+        Serial.print(" 条, 起始序号 ");
+        Serial.println((unsigned long)_nextSeq);
+    }
+    return true;
+}
+
+void WaveformRecorder::end() {
+    if (_syncThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_syncMutex);
+            _stopSync = true;
+        }
+        _syncCond.notify_all();
+        _syncThread.join();
+    }
+
+    if (_map) {
+        if (_header) {
+            syncRange(_syncedSeq, __atomic_load_n(&_header->writeSeq, __ATOMIC_ACQUIRE));
+        }
+        munmap(_map, _mapSize);
+        _map = nullptr;
+    }
+    _header = nullptr;
+    _records = nullptr;
+
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool WaveformRecorder::append(const SampleFrame& frame) {
+    if (!_header) return false;
+
+    uint64_t seq = _nextSeq++;
+    WaveformRecord& rec = _records[(seq - 1) % _capacity];
+
+    // seqlock：先使槽位失效，再写数据，最后发布 seq
+    __atomic_store_n(&rec.seq, (uint64_t)0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    rec.timestampUs = frame.timestampUs;
+    for (int i = 0; i < CH_COUNT; i++) {
+        rec.values[i] = frame.values[i];
+    }
+    rec.breathState = frame.breathState;
+    rec.flags = frame.flags;
+    rec.reserved = 0;
+    rec.checksum = recordChecksum(rec);
+
+    __atomic_store_n(&rec.seq, seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&_header->writeSeq, seq, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint64_t WaveformRecorder::getSequence() const {
+    return _header ? __atomic_load_n(&_header->writeSeq, __ATOMIC_ACQUIRE) : 0;
+}
+
+// 将 (fromSeq, toSeq] 对应的记录页和头部页同步到存储
+void WaveformRecorder::syncRange(uint64_t fromSeq, uint64_t toSeq) {
+    if (!_map || toSeq <= fromSeq) return;
+
+    const size_t page = pageSize();
+    auto syncBytes = [this, page](size_t begin, size_t end) {
+        size_t alignedBegin = begin & ~(page - 1);
+        msync(_map + alignedBegin, end - alignedBegin, MS_SYNC);
+    };
+
+    uint64_t count = toSeq - fromSeq;
+    if (count >= _capacity) {
+        syncBytes(WAVEFORM_HEADER_SIZE, _mapSize);
+    } else {
+        size_t first = (size_t)(fromSeq % _capacity);   // 第一条未同步记录的槽位
+        size_t last = (size_t)((toSeq - 1) % _capacity);
+        size_t base = WAVEFORM_HEADER_SIZE;
+        if (first <= last) {
+            syncBytes(base + first * sizeof(WaveformRecord), base + (last + 1) * sizeof(WaveformRecord));
+        } else {
+            // 环形回绕，分两段同步
+            syncBytes(base + first * sizeof(WaveformRecord), _mapSize);
+            syncBytes(base, base + (last + 1) * sizeof(WaveformRecord));
+        }
+    }
+
+    // 记录落盘后再同步头部，保证头部不会领先于磁盘上的数据太多
+    msync(_map, WAVEFORM_HEADER_SIZE, MS_SYNC);
+    _syncedSeq = toSeq;
+    _syncCount++;
+}
+
+void WaveformRecorder::syncLoop() {
+    std::unique_lock<std::mutex> lock(_syncMutex);
+    while (!_stopSync) {
+        _syncCond.wait_for(lock, std::chrono::milliseconds(_syncIntervalMs));
+        if (_stopSync) break;
+
+        uint64_t seq = __atomic_load_n(&_header->writeSeq, __ATOMIC_ACQUIRE);
+        if (seq != _syncedSeq) {
+            lock.unlock();
+            syncRange(_syncedSeq, seq);
+            lock.lock();
+        }
+    }
+}
+
+// ===================== WaveformReader =====================
+
+WaveformReader::WaveformReader(const std::string& path)
+    : _path(path), _fd(-1), _map(nullptr), _mapSize(0), _header(nullptr), _records(nullptr), _capacity(0) {
+}
+
+WaveformReader::~WaveformReader() {
+    close();
+}
+
+bool WaveformReader::open() {
+    close();
+
+    _fd = ::open(_path.c_str(), O_RDONLY);
+    if (_fd < 0) {
+        LOG_E(STORE) {
+            Serial.print("[Recorder] 无法打开记录文件: ");
+            Serial.println(_path);
+        }
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(_fd, &st) != 0 || (size_t)st.st_size < WAVEFORM_HEADER_SIZE) {
+        LOG_E(STORE) Serial.println("[Recorder] 记录文件大小无效");
+        close();
+        return false;
+    }
+
+    _mapSize = (size_t)st.st_size;
+    void* addr = mmap(nullptr, _mapSize, PROT_READ, MAP_SHARED, _fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG_E(STORE) Serial.println("[Recorder] mmap 失败");
+        close();
+        return false;
+    }
+    _map = static_cast<uint8_t*>(addr);
+
+    const WaveformFileHeader* header = reinterpret_cast<const WaveformFileHeader*>(_map);
+    if (memcmp(header->magic, WAVEFORM_MAGIC, sizeof(WAVEFORM_MAGIC)) != 0 ||
+        header->version != WAVEFORM_FILE_VERSION ||
+        header->recordSize != sizeof(WaveformRecord) ||
+        header->channelCount != CH_COUNT ||
+        WAVEFORM_HEADER_SIZE + header->capacity * sizeof(WaveformRecord) > _mapSize) {
+        LOG_E(STORE) Serial.println("[Recorder] 记录文件格式不匹配");
+        close();
+        return false;
+    }
+
+    _header = header;
+    _records = reinterpret_cast<const WaveformRecord*>(_map + WAVEFORM_HEADER_SIZE);
+    _capacity = header->capacity;
+    return true;
+}
+
+void WaveformReader::close() {
+    if (_map) {
+        munmap(_map, _mapSize);
+        _map = nullptr;
+    }
+    _header = nullptr;
+    _records = nullptr;
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+uint64_t WaveformReader::latestSequence() const {
+    return _header ? __atomic_load_n(&_header->writeSeq, __ATOMIC_ACQUIRE) : 0;
+}
+
+uint64_t WaveformReader::oldestSequence() const {
+    uint64_t latest = latestSequence();
+    if (latest == 0) return 0;
+    return (latest > _capacity) ? latest - _capacity + 1 : 1;
+}
+
+uint64_t WaveformReader::getSessionStartSequence() const {
+    return _header ? __atomic_load_n(&_header->sessionStartSeq, __ATOMIC_ACQUIRE) : 0;
+}
+
+bool WaveformReader::readRecord(uint64_t seq, WaveformRecord& out) const {
+    if (!_header || seq == 0) return false;
+
+    const WaveformRecord& rec = _records[(seq - 1) % _capacity];
+    uint64_t before = __atomic_load_n(&rec.seq, __ATOMIC_ACQUIRE);
+    if (before != seq) return false;
+
+    memcpy(&out, &rec, sizeof(WaveformRecord));
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t after = __atomic_load_n(&rec.seq, __ATOMIC_RELAXED);
+    if (after != seq) return false;
+
+    out.seq = seq;
+    return out.checksum == recordChecksum(out);
+}
+
+size_t WaveformReader::readSince(uint64_t afterSeq, WaveformRecord* out, size_t maxCount) const {
+    uint64_t latest = latestSequence();
+    uint64_t oldest = oldestSequence();
+    if (latest == 0 || afterSeq >= latest) return 0;
+
+    uint64_t seq = (afterSeq + 1 < oldest) ? oldest : afterSeq + 1;
+    size_t count = 0;
+    while (seq <= latest && count < maxCount) {
+        if (readRecord(seq, out[count])) {
+            count++;
+        }
+        seq++;
+    }
+    return count;
+}
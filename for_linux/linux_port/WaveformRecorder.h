@@ -0,0 +1,134 @@
+#ifndef WaveformRecorder_h
+#define WaveformRecorder_h
+
+#include "LuckfoxArduino.h"
+#include "SampleFrame.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// 使用 ArduinoHAL 命名空间
+using namespace ArduinoHAL;
+
+// 波形记录文件格式（内存映射环形文件）
+//
+//   [0, WAVEFORM_HEADER_SIZE)        WaveformFileHeader，独占一页
+//   [WAVEFORM_HEADER_SIZE, ...)      capacity 个定长 WaveformRecord
+//
+// 记录写入顺序：seq 置 0 -> 写数据与校验和 -> 以 release 语义写入 seq。
+// 读者用 seqlock 方式读取（前后两次读 seq 一致才有效），因此可以在记录进行中
+// 并发打开文件。掉电后重新打开时，按 seq 与校验和找回最后一条完整记录。
+// 已有文件的格式（版本、通道数、容量）与当前不符时改名为 <路径>.v<旧版本> 保留，再新建。
+
+constexpr uint32_t WAVEFORM_FILE_VERSION = 3;   // 2: 增加 CH_VOLUME; 3: 时间戳改为 Unix 微秒
+constexpr size_t WAVEFORM_HEADER_SIZE = 4096;
+constexpr const char* WAVEFORM_DEFAULT_PATH = "/root/breath_waveform.rec";
+constexpr uint32_t WAVEFORM_DEFAULT_CAPACITY = 180000;    // 100Hz 下约 30 分钟
+constexpr unsigned long WAVEFORM_DEFAULT_SYNC_MS = 200;  // 后台 msync 周期
+
+struct WaveformFileHeader {
+    char magic[8];              // "BRWAVE\0\0"
+    uint32_t version;           // WAVEFORM_FILE_VERSION
+    uint32_t headerSize;        // WAVEFORM_HEADER_SIZE
+    uint32_t recordSize;        // sizeof(WaveformRecord)
+    uint32_t channelCount;      // CH_COUNT
+    uint64_t capacity;          // 环形记录条数
+    uint64_t createdUnixUs;     // 文件创建时间（墙上时钟）
+    uint64_t sessionCount;      // 打开（会话）次数，每次 begin() 加一
+    uint64_t writeSeq;          // 最后一条已提交记录的 seq（0 表示无记录）
+    uint64_t sessionStartSeq;   // 当前会话的第一条记录 seq
+};
+
+struct WaveformRecord {
+    uint64_t seq;               // 记录序号，从 1 开始；0 表示正在写入或空槽
+    uint64_t timestampUs;       // 采样时间 epochMicros()（Unix 微秒）
+    float values[CH_COUNT];     // 按 SampleChannel 索引
+    uint8_t breathState;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t checksum;          // timestampUs..reserved 的 FNV-1a
+    uint32_t padding;
+};
+
+class WaveformRecorder : public SampleSink {
+public:
+    WaveformRecorder(const std::string& path = WAVEFORM_DEFAULT_PATH,
+                     uint32_t capacity = WAVEFORM_DEFAULT_CAPACITY,
+                     unsigned long syncIntervalMs = WAVEFORM_DEFAULT_SYNC_MS);
+    ~WaveformRecorder();
+
+    // 打开/创建并预分配记录文件，恢复写位置，启动后台同步线程
+    bool begin();
+    // 最后一次同步并关闭文件
+    void end();
+
+    // 热路径：仅内存写入，不做任何系统调用
+    bool append(const SampleFrame& frame);
+    void onSample(const SampleFrame& frame) override { append(frame); }
+
+    bool isOpen() const { return _header != nullptr; }
+    uint64_t getSequence() const;
+    uint32_t getCapacity() const { return _capacity; }
+    const std::string& getPath() const { return _path; }
+    uint64_t getSyncCount() const { return _syncCount.load(); }
+
+private:
+    std::string _path;
+    uint32_t _capacity;
+    unsigned long _syncIntervalMs;
+
+    int _fd;
+    uint8_t* _map;
+    size_t _mapSize;
+    WaveformFileHeader* _header;
+    WaveformRecord* _records;
+    uint64_t _nextSeq;
+
+    // 后台同步线程
+    std::thread _syncThread;
+    std::mutex _syncMutex;
+    std::condition_variable _syncCond;
+    bool _stopSync;
+    uint64_t _syncedSeq;
+    std::atomic<uint64_t> _syncCount;
+
+    bool openFile(bool& created);
+    void initHeader();
+    bool headerMatches() const;
+    uint64_t recoverWriteSeq() const;
+    void syncLoop();
+    void syncRange(uint64_t fromSeq, uint64_t toSeq);
+};
+
+// 记录文件读取器：只读映射，可与正在写入的 WaveformRecorder 并发使用
+class WaveformReader {
+public:
+    WaveformReader(const std::string& path = WAVEFORM_DEFAULT_PATH);
+    ~WaveformReader();
+
+    bool open();
+    void close();
+    bool isOpen() const { return _header != nullptr; }
+
+    // 当前最新/最旧的可读记录序号（无记录时返回 0）
+    uint64_t latestSequence() const;
+    uint64_t oldestSequence() const;
+    uint64_t getCapacity() const { return _capacity; }
+    uint64_t getSessionStartSequence() const;
+
+    // 读取指定序号的记录；记录已被覆盖或正在写入时返回 false
+    bool readRecord(uint64_t seq, WaveformRecord& out) const;
+    // 读取 afterSeq 之后的记录，最多 maxCount 条，返回实际条数
+    size_t readSince(uint64_t afterSeq, WaveformRecord* out, size_t maxCount) const;
+
+private:
+    std::string _path;
+    int _fd;
+    uint8_t* _map;
+    size_t _mapSize;
+    const WaveformFileHeader* _header;
+    const WaveformRecord* _records;
+    uint64_t _capacity;
+};
+
+#endif
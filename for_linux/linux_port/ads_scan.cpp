@@ -0,0 +1,78 @@
+/*
+ * ADS1115 多输入扫描工具
+ *
+ * 用 ADS1115Scanner 轮询 ADS1115 的全部输入，每秒打印各输入最新电压与实际吞吐，
+ * 用于确认接线、量程以及流水化扫描的有效样本率。需停止 breath_controller 后运行。
+ *
+ * 用法: ads_scan [--rdy <gpio>] [--seconds <n>]
+ *   --rdy      ALERT/RDY 所接 GPIO 编号（默认不用，按转换周期计时）
+ *   --seconds  运行时长，0 为一直运行（默认 0）
+ */
+
+#include "LuckfoxArduino.h"
+#include "I2CMux.h"
+#include "ADS1115.h"
+#include "ADS1115Scanner.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ArduinoHAL;
+
+// 与 main.cpp 一致：ADS1115 地址 0x4A，位于 TCA9548 通道 4
+constexpr uint8_t SCAN_ADS_ADDRESS = 0x4A;
+constexpr uint8_t SCAN_MUX_CHANNEL = 4;
+
+int main(int argc, char* argv[]) {
+    int rdyPin = -1;
+    unsigned long seconds = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--rdy" && i + 1 < argc) {
+            rdyPin = atoi(argv[++i]);
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--rdy <gpio>] [--seconds <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Wire.begin();
+    I2CMux mux(TCA9548_BASE_ADDR);
+    mux.begin();
+    ADS1115 ads(SCAN_ADS_ADDRESS, &mux, SCAN_MUX_CHANNEL);
+    if (!ads.begin()) {
+        return 1;
+    }
+
+    // 输入表：按实际接线修改
+    ADS1115Scanner scanner(&ads);
+    scanner.addInput("O2_A",   ADS1115_MUX_AIN0_GND, ADS1115_PGA_2048V, ADS1115_DR_860SPS);
+    scanner.addInput("O2_B",   ADS1115_MUX_AIN1_GND, ADS1115_PGA_2048V, ADS1115_DR_860SPS);
+    scanner.addInput("FLOW",   ADS1115_MUX_AIN2_GND, ADS1115_PGA_4096V, ADS1115_DR_860SPS);
+    scanner.addInput("SUPPLY", ADS1115_MUX_AIN3_GND, ADS1115_PGA_6144V, ADS1115_DR_250SPS);
+    if (!scanner.start(rdyPin)) {
+        return 1;
+    }
+
+    unsigned long startMs = millis();
+    unsigned long lastPrintMs = startMs;
+    while (seconds == 0 || millis() - startMs < seconds * 1000UL) {
+        scanner.poll();
+
+        if (millis() - lastPrintMs >= 1000) {
+            lastPrintMs = millis();
+            for (uint8_t i = 0; i < scanner.getInputCount(); i++) {
+                const ADS1115ScanReading& r = scanner.getReading(i);
+                printf("%-6s %9.5f V  ", scanner.getInputName(i), r.valid ? r.voltage : 0.0f);
+            }
+            printf("| %6.1f / %6.1f SPS  错误 %u\n",
+                   scanner.getThroughput(), scanner.getConfiguredRate(), scanner.getErrorCount());
+            fflush(stdout);
+        }
+    }
+
+    scanner.stop();
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "gas_concentration.h"
+#include "LogModules.h"
 
 ACD1100::ACD1100(I2CMux* mux, uint8_t channel, ACD1100_COMM_MODE mode) 
     : _mux(mux), _channel(channel), _commMode(mode), _serialPort(nullptr) {
@@ -25,14 +26,16 @@ bool ACD1100::begin(I2C* wirePort, HardwareSerial* serialPort) {
     } else {
         // UART模式
         if (serialPort == nullptr) {
-            Serial.println("ACD1100: UART模式需要传入有效的serialPort指针");
+            LOG_E(GAS) Serial.println("ACD1100: UART模式需要传入有效的serialPort指针");
             return false;
         }
         _serialPort = serialPort;
         _serialPort->begin(ACD1100_UART_BAUD);
         delay(200); // 新增：初始化后等待
-        Serial.print("ACD1100: UART串口已初始化，波特率: ");
-        Serial.println(ACD1100_UART_BAUD);
+        LOG_I(GAS) {
+            Serial.print("ACD1100: UART串口已初始化，波特率: ");
+            Serial.println(ACD1100_UART_BAUD);
+        }
     }
     
     // 检查传感器是否连接
@@ -42,51 +45,57 @@ bool ACD1100::begin(I2C* wirePort, HardwareSerial* serialPort) {
 //检测ACD1100是否完成连接
 bool ACD1100::isConnected() {
     if (_commMode == COMM_UART) {
-        Serial.println("ACD1100 UART: 测试连接...");
+        LOG_D(GAS) Serial.println("ACD1100 UART: 测试连接...");
         if (_serialPort == nullptr) {
-            Serial.println("ACD1100 UART: 串口未初始化");
+            LOG_E(GAS) Serial.println("ACD1100 UART: 串口未初始化");
             return false;
         }
         // 尝试读取软件版本来判断是否连接
         std::string version = getSoftwareVersion();
         if (version != "Unknown") {
-            Serial.print("ACD1100 UART: 连接成功，版本: ");
-            Serial.println(version.c_str());
+            LOG_I(GAS) {
+                Serial.print("ACD1100 UART: 连接成功，版本: ");
+                Serial.println(version.c_str());
+            }
             return true;
         }
-        Serial.println("ACD1100 UART: 连接测试失败");
+        LOG_W(GAS) Serial.println("ACD1100 UART: 连接测试失败");
         return false;
     } else {
         // I2C模式：原有检测逻辑
         if (!selectSensorChannel()) {
-            Serial.println("ACD1100: 无法选择通道");
+            LOG_W(GAS) Serial.println("ACD1100: 无法选择通道");
             return false;
         }
         
-        Serial.print("ACD1100: 测试传感器地址0x");
-        Serial.println(ACD1100_I2C_ADDR, HEX);
+        LOG_D(GAS) {
+            Serial.print("ACD1100: 测试传感器地址0x");
+            Serial.println(ACD1100_I2C_ADDR, HEX);
+        }
         
         // 测试传感器地址
         _i2cPort->beginTransmission(ACD1100_I2C_ADDR);
         uint8_t result = _i2cPort->endTransmission();
         
-        Serial.print("ACD1100: 传感器地址测试结果: ");
-        Serial.println(result);
+        LOG_D(GAS) {
+            Serial.print("ACD1100: 传感器地址测试结果: ");
+            Serial.println(result);
+        }
         
         // 如果连接失败，尝试扫描I2C总线
         if (result != 0) {
-            Serial.println("ACD1100: 标准地址无响应，开始详细诊断...");
+            LOG_W(GAS) Serial.println("ACD1100: 标准地址无响应，开始详细诊断...");
             
             // 首先检查多路复用器状态
-            Serial.println("ACD1100: 检查多路复用器状态...");
+            LOG_I(GAS) Serial.println("ACD1100: 检查多路复用器状态...");
             checkMuxStatus();
             
             // 然后扫描I2C总线
-            Serial.println("ACD1100: 开始I2C扫描...");
+            LOG_I(GAS) Serial.println("ACD1100: 开始I2C扫描...");
             scanI2CAddresses();
             
             // 最后测试多路复用器通道
-            Serial.println("ACD1100: 测试多路复用器通道...");
+            LOG_I(GAS) Serial.println("ACD1100: 测试多路复用器通道...");
             testMuxChannels();
         }
         
@@ -97,8 +106,10 @@ bool ACD1100::isConnected() {
 // 设置通信模式
 void ACD1100::setCommunicationMode(ACD1100_COMM_MODE mode) {
     _commMode = mode;
-    Serial.print("ACD1100: 通信模式切换为: ");
-    Serial.println(mode == COMM_I2C ? "I2C" : "UART");
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 通信模式切换为: ");
+        Serial.println(mode == COMM_I2C ? "I2C" : "UART");
+    }
 }
 
 // 获取通信模式
@@ -123,12 +134,12 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
     }
     
     // 发送读取命令
-    Serial.println("ACD1100: 发送读取命令 0x03 0x00");
+    LOG_T(GAS) Serial.println("ACD1100: 发送读取命令 0x03 0x00");
     _i2cPort->beginTransmission(ACD1100_I2C_ADDR);
     _i2cPort->write(0x03);  // 命令高字节
     _i2cPort->write(0x00);  // 命令低字节
     if (_i2cPort->endTransmission() != 0) {
-        Serial.println("ACD1100: 命令发送失败");
+        LOG_W(GAS) Serial.println("ACD1100: 命令发送失败");
         _lastError = ERROR_I2C_COMMUNICATION;
         return false;
     }
@@ -144,17 +155,21 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
     uint8_t response[10]; // 地址 + 9字节数据
     
     // 读取传感器数据
-    Serial.println("ACD1100: 读取传感器数据");
+    LOG_T(GAS) Serial.println("ACD1100: 读取传感器数据");
     uint8_t bytesRead = _i2cPort->requestFrom(ACD1100_I2C_ADDR, 10);
-    Serial.print("ACD1100: 请求10字节，实际收到");
-    Serial.print(bytesRead);
-    Serial.println("字节");
+    LOG_T(GAS) {
+        Serial.print("ACD1100: 请求10字节，实际收到");
+        Serial.print(bytesRead);
+        Serial.println("字节");
+    }
     
     // 检查接收到的字节数（兼容9字节和10字节两种格式）
     if (bytesRead != 9 && bytesRead != 10) {
-        Serial.print("ACD1100: 数据长度错误，期望9或10字节，实际收到");
-        Serial.print(bytesRead);
-        Serial.println("字节");
+        LOG_W(GAS) {
+            Serial.print("ACD1100: 数据长度错误，期望9或10字节，实际收到");
+            Serial.print(bytesRead);
+            Serial.println("字节");
+        }
         _lastError = ERROR_SENSOR_NOT_RESPONDING;
         return false;
     }
@@ -165,14 +180,16 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
     }
     
     // 打印原始数据用于调试
-    Serial.print("ACD1100原始数据: ");
-    for (uint8_t i = 0; i < bytesRead; i++) {
-        Serial.print("0x");
-        if (response[i] < 16) Serial.print("0");
-        Serial.print(response[i], HEX);
-        Serial.print(" ");
+    LOG_T(GAS) {
+        Serial.print("ACD1100原始数据: ");
+        for (uint8_t i = 0; i < bytesRead; i++) {
+            Serial.print("0x");
+            if (response[i] < 16) Serial.print("0");
+            Serial.print(response[i], HEX);
+            Serial.print(" ");
+        }
+        Serial.println();
     }
-    Serial.println();
     
     // 确定数据起始位置
     uint8_t dataStart = 0;
@@ -182,8 +199,10 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
             dataStart = 1;
         }
         // 打印首字节并继续后续处理（不再 return）
-        Serial.print("ACD1100: 响应首字节(可能为地址): 0x");
-        Serial.println(response[0], HEX);
+        LOG_T(GAS) {
+            Serial.print("ACD1100: 响应首字节(可能为地址): 0x");
+            Serial.println(response[0], HEX);
+        }
     }
     // 如果bytesRead == 9，dataStart保持0
     
@@ -194,25 +213,29 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
     
     // 1. 校验 CO2 高2字节 (PPM3, PPM2)
     calculatedCRC = calculateCRC8(&response[dataStart + 0], 2);
-    Serial.print("ACD1100: CO2高位CRC - 计算值: 0x");
-    Serial.print(calculatedCRC, HEX);
-    Serial.print(", 实际值: 0x");
-    Serial.println(response[dataStart + 2], HEX);
+    LOG_T(GAS) {
+        Serial.print("ACD1100: CO2高位CRC - 计算值: 0x");
+        Serial.print(calculatedCRC, HEX);
+        Serial.print(", 实际值: 0x");
+        Serial.println(response[dataStart + 2], HEX);
+    }
     
     if (calculatedCRC != response[dataStart + 2]) {
-        Serial.println("ACD1100: CO2高位CRC校验失败");
+        LOG_W(GAS) Serial.println("ACD1100: CO2高位CRC校验失败");
         crcValid = false;
     }
 
     // 2. 校验 CO2 低2字节 (PPM1, PPM0)
     calculatedCRC = calculateCRC8(&response[dataStart + 3], 2);
-    Serial.print("ACD1100: CO2低位CRC - 计算值: 0x");
-    Serial.print(calculatedCRC, HEX);
-    Serial.print(", 实际值: 0x");
-    Serial.println(response[dataStart + 5], HEX);
+    LOG_T(GAS) {
+        Serial.print("ACD1100: CO2低位CRC - 计算值: 0x");
+        Serial.print(calculatedCRC, HEX);
+        Serial.print(", 实际值: 0x");
+        Serial.println(response[dataStart + 5], HEX);
+    }
     
     if (calculatedCRC != response[dataStart + 5]) {
-        Serial.println("ACD1100: CO2低位CRC校验失败");
+        LOG_W(GAS) Serial.println("ACD1100: CO2低位CRC校验失败");
         crcValid = false;
     }
     
@@ -231,7 +254,7 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
     }
     
     if (!crcValid) {
-        Serial.println("ACD1100: CRC校验失败，数据不可靠");
+        LOG_W(GAS) Serial.println("ACD1100: CRC校验失败，数据不可靠");
         _lastError = ERROR_CRC_MISMATCH;
         return false;
     }
@@ -249,9 +272,11 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
     // temperature = temp_raw / 100.0;
     temperature = 0.0; // 不使用温度值，设置为0
     
-    Serial.print("ACD1100: CO2=");
-    Serial.print(co2_ppm);
-    Serial.println("ppm");
+    LOG_D(GAS) {
+        Serial.print("ACD1100: CO2=");
+        Serial.print(co2_ppm);
+        Serial.println("ppm");
+    }
     
     _lastCO2 = co2_ppm;
     // _lastTemp = temperature;  // 不再使用温度值
@@ -536,8 +561,10 @@ bool ACD1100::selectSensorChannel() {
     }
     
     if (!_mux->selectChannel(_channel)) {
-        Serial.print("ACD1100: 无法选择通道 ");
-        Serial.println(_channel);
+        LOG_W(GAS) {
+            Serial.print("ACD1100: 无法选择通道 ");
+            Serial.println(_channel);
+        }
         return false;
     }
     
@@ -548,19 +575,21 @@ bool ACD1100::selectSensorChannel() {
 // 添加简化的测试读取函数
 bool ACD1100::testSimpleRead() {
     if (!selectSensorChannel()) {
-        Serial.println("ACD1100: 无法选择通道");
+        LOG_W(GAS) Serial.println("ACD1100: 无法选择通道");
         return false;
     }
     
-    Serial.println("ACD1100: 尝试简化读取测试");
+    LOG_I(GAS) Serial.println("ACD1100: 尝试简化读取测试");
     
     // 发送读取命令
     _i2cPort->beginTransmission(ACD1100_I2C_ADDR);
     _i2cPort->write(0x03);
     _i2cPort->write(0x00);
     uint8_t sendResult = _i2cPort->endTransmission();
-    Serial.print("ACD1100: 发送命令结果: ");
-    Serial.println(sendResult);
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 发送命令结果: ");
+        Serial.println(sendResult);
+    }
     
     if (sendResult != 0) {
         return false;
@@ -570,14 +599,18 @@ bool ACD1100::testSimpleRead() {
     
     // 尝试读取数据
     uint8_t testBytes = _i2cPort->requestFrom(ACD1100_I2C_ADDR, 1);
-    Serial.print("ACD1100: 测试读取1字节，收到");
-    Serial.print(testBytes);
-    Serial.println("字节");
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 测试读取1字节，收到");
+        Serial.print(testBytes);
+        Serial.println("字节");
+    }
     
     if (testBytes > 0) {
         uint8_t testData = _i2cPort->read();
-        Serial.print("ACD1100: 测试数据: 0x");
-        Serial.println(testData, HEX);
+        LOG_I(GAS) {
+            Serial.print("ACD1100: 测试数据: 0x");
+            Serial.println(testData, HEX);
+        }
         return true;
     }
     
@@ -586,7 +619,7 @@ bool ACD1100::testSimpleRead() {
 
 // I2C地址扫描函数
 void ACD1100::scanI2CAddresses() {
-    Serial.println("ACD1100: 开始I2C地址扫描...");
+    LOG_I(GAS) Serial.println("ACD1100: 开始I2C地址扫描...");
     int deviceCount = 0;
     
     for (uint8_t address = 1; address < 127; address++) {
@@ -594,126 +627,150 @@ void ACD1100::scanI2CAddresses() {
         uint8_t error = _i2cPort->endTransmission();
         
         if (error == 0) {
-            Serial.print("ACD1100: 找到设备，地址: 0x");
-            if (address < 16) Serial.print("0");
-            Serial.print(address, HEX);
-            Serial.print(" (");
-            Serial.print(address);
-            Serial.println(")");
+            LOG_I(GAS) {
+                Serial.print("ACD1100: 找到设备，地址: 0x");
+                if (address < 16) Serial.print("0");
+                Serial.print(address, HEX);
+                Serial.print(" (");
+                Serial.print(address);
+                Serial.println(")");
+            }
             deviceCount++;
         }
     }
     
     if (deviceCount == 0) {
-        Serial.println("ACD1100: 未找到任何I2C设备！");
-        Serial.println("ACD1100: 可能的问题:");
-        Serial.println("1. 传感器未连接");
-        Serial.println("2. 多路复用器通道错误");
-        Serial.println("3. 电源问题");
-        Serial.println("4. I2C接线问题");
+        LOG_W(GAS) {
+            Serial.println("ACD1100: 未找到任何I2C设备！");
+            Serial.println("ACD1100: 可能的问题:");
+            Serial.println("1. 传感器未连接");
+            Serial.println("2. 多路复用器通道错误");
+            Serial.println("3. 电源问题");
+            Serial.println("4. I2C接线问题");
+        }
     } else {
-        Serial.print("ACD1100: 总共找到 ");
-        Serial.print(deviceCount);
-        Serial.println(" 个I2C设备");
+        LOG_I(GAS) {
+            Serial.print("ACD1100: 总共找到 ");
+            Serial.print(deviceCount);
+            Serial.println(" 个I2C设备");
+        }
     }
 }
 
 // 测试多路复用器通道
 void ACD1100::testMuxChannels() {
     if (_mux == nullptr) {
-        Serial.println("ACD1100: 多路复用器未设置");
+        LOG_W(GAS) Serial.println("ACD1100: 多路复用器未设置");
         return;
     }
     
-    Serial.print("ACD1100: 当前配置通道: ");
-    Serial.println(_channel);
-    Serial.print("ACD1100: 多路复用器总通道数: ");
-    Serial.println(_mux->getChannelCount());
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 当前配置通道: ");
+        Serial.println(_channel);
+        Serial.print("ACD1100: 多路复用器总通道数: ");
+        Serial.println(_mux->getChannelCount());
+    }
     
     // 测试所有通道
     for (uint8_t i = 0; i < _mux->getChannelCount(); i++) {
-        Serial.print("ACD1100: 测试通道 ");
-        Serial.print(i);
-        Serial.print("...");
+        LOG_I(GAS) {
+            Serial.print("ACD1100: 测试通道 ");
+            Serial.print(i);
+            Serial.print("...");
+        }
         
         if (_mux->selectChannel(i)) {
-            Serial.print(" 选择成功");
+            LOG_I(GAS) Serial.print(" 选择成功");
             
             // 测试I2C通信
             _i2cPort->beginTransmission(ACD1100_I2C_ADDR);
             uint8_t testResult = _i2cPort->endTransmission();
             
             if (testResult == 0) {
-                Serial.println(" - 找到ACD1100！");
-                Serial.print("ACD1100: 建议将传感器配置到通道 ");
-                Serial.println(i);
+                LOG_I(GAS) {
+                    Serial.println(" - 找到ACD1100！");
+                    Serial.print("ACD1100: 建议将传感器配置到通道 ");
+                    Serial.println(i);
+                }
                 return;
             } else {
-                Serial.print(" - 无响应 (结果:");
-                Serial.print(testResult);
-                Serial.println(")");
+                LOG_I(GAS) {
+                    Serial.print(" - 无响应 (结果:");
+                    Serial.print(testResult);
+                    Serial.println(")");
+                }
             }
         } else {
-            Serial.println(" - 选择失败");
+            LOG_I(GAS) Serial.println(" - 选择失败");
         }
     }
     
-    Serial.println("ACD1100: 在所有通道上都未找到传感器");
+    LOG_I(GAS) Serial.println("ACD1100: 在所有通道上都未找到传感器");
 }
 
 // 检查多路复用器状态
 void ACD1100::checkMuxStatus() {
     if (_mux == nullptr) {
-        Serial.println("ACD1100: 多路复用器未设置！");
+        LOG_W(GAS) Serial.println("ACD1100: 多路复用器未设置！");
         return;
     }
     
-    Serial.print("ACD1100: 多路复用器地址: 0x");
-    Serial.println(0x70, HEX);  // TCA9548默认地址
-    Serial.print("ACD1100: 配置通道: ");
-    Serial.println(_channel);
-    Serial.print("ACD1100: 总通道数: ");
-    Serial.println(_mux->getChannelCount());
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 多路复用器地址: 0x");
+        Serial.println(0x70, HEX);  // TCA9548默认地址
+        Serial.print("ACD1100: 配置通道: ");
+        Serial.println(_channel);
+        Serial.print("ACD1100: 总通道数: ");
+        Serial.println(_mux->getChannelCount());
+    }
     
     // 检查多路复用器是否响应
-    Serial.println("ACD1100: 测试多路复用器I2C通信...");
+    LOG_I(GAS) Serial.println("ACD1100: 测试多路复用器I2C通信...");
     _i2cPort->beginTransmission(0x70);  // TCA9548地址
     uint8_t muxResult = _i2cPort->endTransmission();
-    Serial.print("ACD1100: 多路复用器通信结果: ");
-    Serial.println(muxResult);
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 多路复用器通信结果: ");
+        Serial.println(muxResult);
+    }
     
     if (muxResult != 0) {
-        Serial.println("ACD1100: 多路复用器无响应！");
+        LOG_W(GAS) Serial.println("ACD1100: 多路复用器无响应！");
         return;
     }
     
     // 检查当前通道是否启用
-    Serial.print("ACD1100: 检查通道 ");
-    Serial.print(_channel);
-    Serial.print(" 是否启用...");
+    LOG_I(GAS) {
+        Serial.print("ACD1100: 检查通道 ");
+        Serial.print(_channel);
+        Serial.print(" 是否启用...");
+    }
     
     // 尝试选择通道
     if (_mux->selectChannel(_channel)) {
-        Serial.println(" 成功");
+        LOG_I(GAS) Serial.println(" 成功");
         
         // 测试通道选择后的I2C通信
-        Serial.println("ACD1100: 测试通道选择后的I2C通信...");
+        LOG_I(GAS) Serial.println("ACD1100: 测试通道选择后的I2C通信...");
         _i2cPort->beginTransmission(ACD1100_I2C_ADDR);
         uint8_t testResult = _i2cPort->endTransmission();
         
-        Serial.print("ACD1100: 通道选择后测试结果: ");
-        Serial.println(testResult);
+        LOG_I(GAS) {
+            Serial.print("ACD1100: 通道选择后测试结果: ");
+            Serial.println(testResult);
+        }
         
     } else {
-        Serial.println(" 失败");
-        Serial.println("ACD1100: 无法选择配置的通道！");
+        LOG_W(GAS) {
+            Serial.println(" 失败");
+            Serial.println("ACD1100: 无法选择配置的通道！");
+        }
     }
 }
 
 // UART方式读取CO2
 bool ACD1100::readCO2UART(uint32_t &co2_ppm, float &temperature) {
     if (_serialPort == nullptr) {
-        Serial.println("ACD1100: UART端口未初始化");
+        LOG_E(GAS) Serial.println("ACD1100: UART端口未初始化");
         _lastError = ERROR_SENSOR_NOT_RESPONDING;
         return false;
     }
@@ -724,16 +781,20 @@ bool ACD1100::readCO2UART(uint32_t &co2_ppm, float &temperature) {
     delay(20); // 清空后延时，防止前驱残留
     // 组装读取命令
     uint8_t cmd[] = {0xFE, 0xA6, 0x00, 0x01, 0xA7};
-    Serial.print("ACD1100 UART发送: ");
+    LOG_T(GAS) {
+        Serial.print("ACD1100 UART发送: ");
+        for (uint8_t i = 0; i < 5; i++) {
+            Serial.print("0x");
+            if (cmd[i] < 0x10) Serial.print("0");
+            Serial.print(cmd[i], HEX);
+            Serial.print(" ");
+        }
+        Serial.println();
+    }
     for (uint8_t i = 0; i < 5; i++) {
-        Serial.print("0x");
-        if (cmd[i] < 0x10) Serial.print("0");
-        Serial.print(cmd[i], HEX);
-        Serial.print(" ");
         _serialPort->write(cmd[i]);
         delay(12); // 字节间更长延时
     }
-    Serial.println();
     _serialPort->flush();
     delay(800); // 发送完等待响应更久
     // 读取响应（超时方案）
@@ -746,40 +807,46 @@ bool ACD1100::readCO2UART(uint32_t &co2_ppm, float &temperature) {
         }
     }
     if (bytesRead > 0) {
-        Serial.print("ACD1100 UART收到: ");
-        for (uint8_t i = 0; i < bytesRead; i++) {
-            Serial.print("0x");
-            if (response[i] < 0x10) Serial.print("0");
-            Serial.print(response[i], HEX);
-            Serial.print(" ");
+        LOG_T(GAS) {
+            Serial.print("ACD1100 UART收到: ");
+            for (uint8_t i = 0; i < bytesRead; i++) {
+                Serial.print("0x");
+                if (response[i] < 0x10) Serial.print("0");
+                Serial.print(response[i], HEX);
+                Serial.print(" ");
+            }
+            Serial.println();
         }
-        Serial.println();
     }
     if (bytesRead == 10) {
         delay(20); // 收到完整数据后缓冲
     }
     if (bytesRead != 10) {
-        Serial.print("ACD1100 UART: 期望10字节，实际收到");
-        Serial.print(bytesRead);
-        Serial.println("字节");
+        LOG_W(GAS) {
+            Serial.print("ACD1100 UART: 期望10字节，实际收到");
+            Serial.print(bytesRead);
+            Serial.println("字节");
+        }
         if (bytesRead == 0) {
-            Serial.println("ACD1100 UART: 无响应，请检查:");
-            Serial.println("  1. TX接传感器RX，RX接传感器TX");
-            Serial.println("  2. GND连接");
-            Serial.println("  3. 传感器电源");
-            Serial.println("  4. SET引脚接GND（UART模式）");
+            LOG_W(GAS) {
+                Serial.println("ACD1100 UART: 无响应，请检查:");
+                Serial.println("  1. TX接传感器RX，RX接传感器TX");
+                Serial.println("  2. GND连接");
+                Serial.println("  3. 传感器电源");
+                Serial.println("  4. SET引脚接GND（UART模式）");
+            }
             delay(50); // 空数据情况下延时降低复位几率
         }
         _lastError = ERROR_SENSOR_NOT_RESPONDING;
         return false;
     }
     if (response[0] != 0xFE || response[1] != 0xA6) {
-        Serial.println("ACD1100 UART: 响应帧头错误");
+        LOG_W(GAS) Serial.println("ACD1100 UART: 响应帧头错误");
         _lastError = ERROR_INVALID_DATA;
         return false;
     }
     if (response[2] != 0x04 || response[3] != 0x01) {
-        Serial.println("ACD1100 UART: 响应长度或命令码错误");
+        LOG_W(GAS) Serial.println("ACD1100 UART: 响应长度或命令码错误");
         _lastError = ERROR_INVALID_DATA;
         return false;
     }
@@ -789,10 +856,12 @@ bool ACD1100::readCO2UART(uint32_t &co2_ppm, float &temperature) {
         calcCS += response[i];
     }
     if (calcCS != response[9]) {
-        Serial.print("ACD1100 UART: 校验和错误-计算:");
-        Serial.print(calcCS, HEX);
-        Serial.print(" 收到:");
-        Serial.println(response[9], HEX);
+        LOG_W(GAS) {
+            Serial.print("ACD1100 UART: 校验和错误-计算:");
+            Serial.print(calcCS, HEX);
+            Serial.print(" 收到:");
+            Serial.println(response[9], HEX);
+        }
         _lastError = ERROR_CRC_MISMATCH;
         return false;
     }
@@ -801,9 +870,11 @@ bool ACD1100::readCO2UART(uint32_t &co2_ppm, float &temperature) {
     // int16_t temp_raw = ((int16_t)response[6] << 8) | response[7];
     // temperature = temp_raw / 100.0;
     temperature = 0.0; // 不使用温度值，设置为0
-    Serial.print("ACD1100 UART: CO2=");
-    Serial.print(co2_ppm);
-    Serial.println("ppm");
+    LOG_D(GAS) {
+        Serial.print("ACD1100 UART: CO2=");
+        Serial.print(co2_ppm);
+        Serial.println("ppm");
+    }
     _lastCO2 = co2_ppm;
     // _lastTemp = temperature;  // 不再使用温度值
     _lastTemp = 0.0;
@@ -0,0 +1,140 @@
+/*
+ * 日志开销基准
+ *
+ * 用合成的 I2C 总线（总线钩子直接给出各传感器的响应，不访问 /dev/i2c-*）和虚拟时钟
+ * 全速运行 BreathController::update()，报告每个采集周期的平均耗时。
+ * make bench 以默认级别和 TRACE 级别各编译一份，对比关闭/打开调试输出时的控制周期开销；
+ * 日志写入标准输出，结果写入标准错误，可用 ./log_bench > /dev/null 只看结果。
+ *
+ * 用法: log_bench [--cycles <n>] [--period <us>]
+ *   --cycles  计时的 update() 次数（默认 20000）
+ *   --period  两次 update() 之间推进的虚拟时间（默认 2000 us）
+ */
+
+#include "LuckfoxArduino.h"
+#include "BreathController.h"
+#include "I2CMux.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ArduinoHAL;
+
+// 与 ACD1100 相同的 CRC-8（多项式 0x31，初值 0xFF）
+static uint8_t crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// 按 main.cpp 的通道分配应答：多路复用器与写事务一律 ACK，
+// 气压传感器状态寄存器报告采集完成，数据寄存器给出随虚拟时间变化的呼吸波形，
+// ACD1100 返回带正确 CRC 的 400 ppm 帧
+class SyntheticBus : public I2CBusHook {
+public:
+    bool replayWrite(uint8_t addr, const uint8_t* data, size_t len, uint8_t& status) override {
+        if (addr == SENSOR_ADDR && len > 0) {
+            _reg = data[0];
+        }
+        status = 0;
+        return true;
+    }
+
+    bool replayRead(uint8_t addr, uint8_t* data, size_t len, ssize_t& result) override {
+        for (size_t i = 0; i < len; i++) {
+            data[i] = 0;
+        }
+        if (addr == SENSOR_ADDR && len > 0) {
+            data[0] = pressureRegister(_reg);
+        } else if (addr == ACD1100_ADDR && len == 10) {
+            const uint8_t frame[10] = { 0x55, 0x00, 0x00, 0x00, 0x01, 0x90, 0x00, 0x00, 0x19, 0x00 };
+            for (size_t i = 0; i < len; i++) {
+                data[i] = frame[i];
+            }
+            data[3] = crc8(&data[1], 2);
+            data[6] = crc8(&data[4], 2);
+            data[9] = crc8(&data[7], 2);
+        }
+        result = (ssize_t)len;
+        return true;
+    }
+
+private:
+    uint8_t pressureRegister(uint8_t reg) {
+        // 约 101 kPa 基线上 ±2 kPa、3 秒一个周期的呼吸波形（量程 400 kPa 时 k = 16）
+        double phase = 2.0 * M_PI * (micros() % 3000000UL) / 3000000.0;
+        uint32_t adc = (uint32_t)(3100 + 400 * sin(phase));
+        switch (reg) {
+            case REG_STATUS:   return 0x01;
+            case REG_CMD:      return 0x00;
+            case REG_DATA_MSB: return (uint8_t)(adc >> 16);
+            case REG_DATA_CSB: return (uint8_t)(adc >> 8);
+            case REG_DATA_LSB: return (uint8_t)adc;
+            case REG_TEMP_MSB: return 0x0A;
+            default:           return 0x00;
+        }
+    }
+
+    uint8_t _reg = 0;
+};
+
+int main(int argc, char* argv[]) {
+    unsigned long cycles = 20000;
+    unsigned long periodUs = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cycles" && i + 1 < argc) {
+            cycles = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--period" && i + 1 < argc) {
+            periodUs = strtoul(argv[++i], nullptr, 10);
+        } else {
+            fprintf(stderr, "用法: %s [--cycles <n>] [--period <us>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SyntheticBus bus;
+    i2cBusHook() = &bus;
+    enableVirtualClock(1000000);
+
+    I2CMux mux(0x70);
+    BreathController controller(&mux);
+    mux.begin();
+    mux.addChannel(1, SENSOR_ADDR, "SENSOR");
+    mux.addChannel(2, 0x3C, "OLED Display");
+    mux.addChannel(3, SENSOR_ADDR, "备用气压传感器");
+    mux.addChannel(5, ACD1100_ADDR, "ACD1100气体传感器");
+    mux.enableChannel(1, true);
+    mux.enableChannel(2, true);
+    mux.enableChannel(3, true);
+    mux.enableChannel(5, true);
+    controller.begin();
+
+    // 预热：让基线、融合与呼吸检测进入稳态
+    for (int i = 0; i < 500; i++) {
+        controller.update();
+        advanceVirtualClock(periodUs);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < cycles; i++) {
+        controller.update();
+        advanceVirtualClock(periodUs);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double totalUs = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / 1000.0;
+
+    fprintf(stderr, "日志级别 %d: %lu 个周期, 平均 %.2f us/周期\n",
+            LOG_LEVEL_DEFAULT, cycles, cycles ? totalUs / cycles : 0.0);
+
+    i2cBusHook() = nullptr;
+    disableVirtualClock();
+    return 0;
+}
@@ -11,6 +11,11 @@
 #include "BreathController.h"
 #include "gas_concentration.h"
 #include "I2CMux.h"
+#include "WaveformRecorder.h"
+#include "ColumnarStore.h"
+#include "BusTrace.h"
+#include "TelemetryShm.h"
+#include "TelemetryServer.h"
 
 // 使用 ArduinoHAL 命名空间
 using namespace ArduinoHAL;
@@ -29,6 +34,47 @@ I2CMux i2cMux(0x70); // TCA9548地址为0x70
 // 创建呼吸控制器，传入多路复用器
 BreathController breathController(&i2cMux);
 
+// 波形记录器（内存映射环形文件，可用 --record <路径> / --no-record 修改）
+std::string recordPath = WAVEFORM_DEFAULT_PATH;
+bool recordEnabled = true;
+WaveformRecorder* waveformRecorder = nullptr;
+
+// 长期趋势存储（列式压缩文件，可用 --trend <路径> / --no-trend 修改）
+std::string trendPath = COLUMNAR_DEFAULT_PATH;
+bool trendEnabled = true;
+ColumnarWriter* trendWriter = nullptr;
+
+// 共享内存遥测（GUI/日志等查看者只读连接，可用 --shm <名称> / --no-shm 修改）
+std::string telemetryName = TELEMETRY_DEFAULT_NAME;
+bool telemetryNameGiven = false;
+bool telemetryEnabled = true;
+TelemetryPublisher* telemetryPublisher = nullptr;
+
+// 二进制遥测流（Unix 套接字，可用 --stream <路径> / --no-stream 修改）
+std::string streamPath = STREAM_DEFAULT_PATH;
+bool streamPathGiven = false;
+bool streamEnabled = true;
+TelemetryServer* telemetryServer = nullptr;
+
+// 压力闭环（--pressure-control <Hz> 启用，200~1000 Hz；默认按呼吸状态开环步进）
+unsigned long pressureControlHz = 0;
+unsigned long lastControlStatsMs = 0;
+
+// 差压流量零点标定（--flow-zero），启动时气路须无流量
+bool flowZeroRequested = false;
+
+// 气阀特性扫描（--characterize-valve flow|pressure），启动后先扫描建表再进入主循环
+std::string valveSweepSource;
+
+// I2C 事务录制/回放（--capture <路径> 录制；--replay <路径> 以虚拟时钟全速回放，
+// 气阀指令与呼吸状态变化输出到 --events <路径>，默认 replay_events.csv）
+std::string capturePath;
+std::string replayPath;
+std::string eventsPath = "replay_events.csv";
+I2CTraceRecorder* busRecorder = nullptr;
+I2CTraceReplayer* busReplayer = nullptr;
+ReplayEventLog* replayEvents = nullptr;
+
 // Arduino风格的setup函数
 void setup() {
     Serial.begin(115200);
@@ -136,6 +182,94 @@ void setup() {
     Serial.println("\n=== 初始化氧传感器 ===");
     breathController.initializeOxygenSensor();
     
+    // 启动压力闭环
+    if (pressureControlHz > 0) {
+        Serial.println("\n=== 启动压力闭环 ===");
+        breathController.enablePressureControl(pressureControlHz);
+    }
+    
+    // 启动波形记录
+    if (recordEnabled) {
+        Serial.println("\n=== 启动波形记录 ===");
+        waveformRecorder = new WaveformRecorder(recordPath);
+        if (waveformRecorder->begin()) {
+            breathController.addSampleSink(waveformRecorder);
+        } else {
+            Serial.println("波形记录启动失败，继续运行但不记录");
+            delete waveformRecorder;
+            waveformRecorder = nullptr;
+        }
+    }
+    
+    // 启动趋势存储
+    if (trendEnabled) {
+        Serial.println("\n=== 启动趋势存储 ===");
+        trendWriter = new ColumnarWriter(trendPath);
+        if (trendWriter->begin()) {
+            breathController.addSampleSink(trendWriter);
+        } else {
+            Serial.println("趋势存储启动失败，继续运行但不存储");
+            delete trendWriter;
+            trendWriter = nullptr;
+        }
+    }
+    
+    // 发布共享内存遥测
+    if (telemetryEnabled) {
+        Serial.println("\n=== 启动共享内存遥测 ===");
+        telemetryPublisher = new TelemetryPublisher(telemetryName);
+        if (telemetryPublisher->begin()) {
+            breathController.addSampleSink(telemetryPublisher);
+        } else {
+            Serial.println("共享内存遥测启动失败，GUI将无法连接");
+            delete telemetryPublisher;
+            telemetryPublisher = nullptr;
+        }
+    }
+    
+    // 启动遥测流服务
+    if (streamEnabled) {
+        Serial.println("\n=== 启动遥测流服务 ===");
+        telemetryServer = new TelemetryServer(streamPath);
+        if (telemetryServer->begin()) {
+            breathController.addSampleSink(telemetryServer);
+        } else {
+            Serial.println("遥测流服务启动失败，继续运行");
+            delete telemetryServer;
+            telemetryServer = nullptr;
+        }
+    }
+    
+    // 回放事件输出
+    if (busReplayer) {
+        replayEvents = new ReplayEventLog(eventsPath);
+        if (replayEvents->begin()) {
+            breathController.addSampleSink(replayEvents);
+        } else {
+            delete replayEvents;
+            replayEvents = nullptr;
+        }
+    }
+    
+    // 差压流量零点（在气阀扫描之前，扫描会用到流量）
+    if (flowZeroRequested) {
+        Serial.println("\n=== 差压流量零点标定 ===");
+        breathController.calibrateFlowZero();
+    }
+    
+    // 气阀特性扫描（须在压力闭环启动前）
+    if (!valveSweepSource.empty()) {
+        Serial.println("\n=== 气阀特性扫描 ===");
+        bool wasPressureControl = breathController.isPressureControlEnabled();
+        breathController.disablePressureControl();
+        if (!breathController.characterizeValve(valveSweepSource == "flow")) {
+            Serial.println("气阀特性扫描失败，沿用原有查找表");
+        }
+        if (wasPressureControl) {
+            breathController.enablePressureControl(pressureControlHz);
+        }
+    }
+    
     Serial.println("\n=== 系统初始化完成 ===");
     Serial.println("开始主循环...");
     Serial.println("ACD1100当前通信模式: I2C");
@@ -147,6 +281,26 @@ void loop() {
     // 更新气压、温度以及控制器状态（包含ACD1100）
     breathController.update();
     
+    // 压力闭环统计（每 10 秒）
+    if (breathController.isPressureControlEnabled() && millis() - lastControlStatsMs >= 10000) {
+        lastControlStatsMs = millis();
+        PressureControlStats stats = breathController.getPressureController().getStats();
+        Serial.print("[PressureCtl] 周期: ");
+        Serial.print((unsigned long)stats.loops);
+        Serial.print(", 超时周期: ");
+        Serial.print(stats.overruns);
+        Serial.print(", 抖动 平均/最大: ");
+        Serial.print(stats.jitterMeanUs, 0);
+        Serial.print("/");
+        Serial.print(stats.jitterMaxUs, 0);
+        Serial.print(" us, 误差 RMS/最大: ");
+        Serial.print(stats.errorRmsKpa, 3);
+        Serial.print("/");
+        Serial.print(stats.errorMaxKpa, 3);
+        Serial.print(" kPa, 测量超时: ");
+        Serial.println(stats.staleEvents);
+    }
+    
     // 适当延时，避免过快刷新
     delay(10);
 }
@@ -158,25 +312,121 @@ int main(int argc, char* argv[]) {
     std::cout << "编译时间: " << __DATE__ << " " << __TIME__ << std::endl;
     std::cout << std::endl;
 
+    // 解析命令行参数
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--no-record") {
+            recordEnabled = false;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--no-trend") {
+            trendEnabled = false;
+        } else if (arg == "--trend" && i + 1 < argc) {
+            trendPath = argv[++i];
+        } else if (arg == "--no-shm") {
+            telemetryEnabled = false;
+        } else if (arg == "--shm" && i + 1 < argc) {
+            telemetryName = argv[++i];
+            telemetryNameGiven = true;
+        } else if (arg == "--no-stream") {
+            streamEnabled = false;
+        } else if (arg == "--stream" && i + 1 < argc) {
+            streamPath = argv[++i];
+            streamPathGiven = true;
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--events" && i + 1 < argc) {
+            eventsPath = argv[++i];
+        } else if (arg == "--pressure-control" && i + 1 < argc) {
+            pressureControlHz = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--flow-zero") {
+            flowZeroRequested = true;
+        } else if (arg == "--characterize-valve" && i + 1 < argc) {
+            valveSweepSource = argv[++i];
+        }
+    }
+
+    // 回放模式：不访问真实设备，也不覆盖现场的波形/趋势文件；
+    // 共享内存与遥测流只在用 --shm / --stream 另指名称时发布，避免干扰正在运行的控制器
+    if (!replayPath.empty()) {
+        recordEnabled = false;
+        trendEnabled = false;
+        if (!telemetryNameGiven || telemetryName == TELEMETRY_DEFAULT_NAME) {
+            telemetryEnabled = false;
+        }
+        if (!streamPathGiven || streamPath == STREAM_DEFAULT_PATH) {
+            streamEnabled = false;
+        }
+        busReplayer = new I2CTraceReplayer(replayPath);
+        if (!busReplayer->begin()) {
+            return 1;
+        }
+    } else if (!capturePath.empty()) {
+        busRecorder = new I2CTraceRecorder(capturePath);
+        if (!busRecorder->begin()) {
+            delete busRecorder;
+            busRecorder = nullptr;
+        }
+    }
+    
+    // 回放耗时统计（虚拟时钟下 millis() 不反映真实时间）
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
     // 调用Arduino风格的setup函数（仅执行一次）
     try {
         setup();
     } catch (const std::exception& e) {
+        Serial.flush();
         std::cerr << "Setup failed with exception: " << e.what() << std::endl;
         return 1;
     }
 
     // 主循环：不断调用Arduino风格的loop函数
+    Serial.flush();
     std::cout << "\n进入主循环 (按Ctrl+C退出)...\n" << std::endl;
     
     try {
         while (true) {
             loop();
+            if (busReplayer && busReplayer->finished()) {
+                break;
+            }
         }
     } catch (const std::exception& e) {
+        Serial.flush();
         std::cerr << "Loop terminated with exception: " << e.what() << std::endl;
         return 1;
     }
 
+    // 回放结束：输出统计
+    if (busReplayer) {
+        double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        double virtualSec = (micros() - busReplayer->getStartUs()) / 1000000.0;
+        if (replayEvents) {
+            replayEvents->end();
+        }
+        
+        Serial.flush();
+        std::cout << "\n=== 回放完成 ===" << std::endl;
+        std::cout << "事务: " << busReplayer->getRecordCount()
+                  << ", 跳过: " << busReplayer->getSkippedCount()
+                  << ", 未匹配: " << busReplayer->getMissCount()
+                  << ", 写入不一致: " << busReplayer->getWriteMismatchCount() << std::endl;
+        if (replayEvents) {
+            std::cout << "控制周期: " << replayEvents->getCycleCount()
+                      << ", 气阀指令: " << replayEvents->getValveEventCount()
+                      << ", 状态变化: " << replayEvents->getStateEventCount()
+                      << " -> " << eventsPath << std::endl;
+        }
+        std::cout << "虚拟时长: " << virtualSec << " 秒, 实际耗时: " << wallSec << " 秒";
+        if (wallSec > 0) {
+            std::cout << " (" << virtualSec / wallSec << " 倍速)";
+        }
+        std::cout << std::endl;
+        busReplayer->end();
+    }
+
     return 0;
 }
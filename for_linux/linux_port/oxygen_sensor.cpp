@@ -1,9 +1,10 @@
 #include "oxygen_sensor.h"
+#include "LogModules.h"
 
 // 构造函数
-OxygenSensor::OxygenSensor(ADS1115* ads, uint8_t muxChannel)
-    : _ads(ads), _muxChannel(muxChannel), _a0(0), _a1(0), _isCalibrated(false),
-      _filterEnabled(true), _filterSize(5), _filterIndex(0) {
+OxygenSensor::OxygenSensor(ADS1115* ads, uint16_t muxChannel)
+    : _ads(ads), _muxChannel(muxChannel), _a0(0), _a1(0), _isCalibrated(false), _lastOxygenPercent(0.0f),
+      _calPoint(CAL_SHORT_CIRCUIT), _filterEnabled(true), _filterSize(5), _filterIndex(0) {
     
     // 初始化滤波缓冲区
     for (uint8_t i = 0; i < MAX_FILTER_SIZE; i++) {
@@ -14,15 +15,17 @@ OxygenSensor::OxygenSensor(ADS1115* ads, uint8_t muxChannel)
 // 初始化传感器
 void OxygenSensor::begin() {
     if (_ads == nullptr) {
-        Serial.println("氧传感器: ADS1115未初始化！");
+        LOG_E(O2) Serial.println("氧传感器: ADS1115未初始化！");
         return;
     }
     
-    Serial.println("氧传感器初始化");
-    Serial.println("使用ADS1115 16位ADC进行读取");
-    Serial.println("请确保:");
-    Serial.println("1. 传感器正极（Vsensor+）连接到ADS1115的AIN0");
-    Serial.println("2. 传感器负极（Vsensor-）连接到ADS1115的GND");
+    LOG_I(O2) {
+        Serial.println("氧传感器初始化");
+        Serial.println("使用ADS1115 16位ADC进行读取");
+        Serial.println("请确保:");
+        Serial.println("1. 传感器正极（Vsensor+）连接到ADS1115的AIN0");
+        Serial.println("2. 传感器负极（Vsensor-）连接到ADS1115的GND");
+    }
 }
 
 // 读取ADC原始值
@@ -44,12 +47,12 @@ float OxygenSensor::readVoltage() {
 // 读取氧气浓度
 float OxygenSensor::readOxygenConcentration() {
     if (!_isCalibrated) {
-        Serial.println("警告: 氧传感器未校准，返回0");
+        LOG_W(O2) Serial.println("警告: 氧传感器未校准，返回0");
         return 0.0;
     }
     
     if (_ads == nullptr) {
-        Serial.println("警告: ADS1115未初始化");
+        LOG_W(O2) Serial.println("警告: ADS1115未初始化");
         return 0.0;
     }
     
@@ -63,7 +66,7 @@ float OxygenSensor::readOxygenConcentration() {
     
     // 应用计算公式: 氧气浓度 = (Ax − A0) × 20.9/(A1 − A0)
     if (_a1 == _a0) {
-        Serial.println("警告: 校准参数异常，A1 == A0");
+        LOG_W(O2) Serial.println("警告: 校准参数异常，A1 == A0");
         return 0.0;
     }
     
@@ -71,83 +74,140 @@ float OxygenSensor::readOxygenConcentration() {
     
     // 限制输出范围在合理范围内（0-30%）
     oxygenPercent = constrain(oxygenPercent, 0.0, 30.0);
+    _lastOxygenPercent = oxygenPercent;
     
     return oxygenPercent;
 }
 
-// 校准：测量短接时的ADC值
-int16_t OxygenSensor::calibrateShortCircuit() {
+// 短接：信号几乎立即稳定
+static const CalibrationConfig SHORT_CIRCUIT_CALIBRATION_CONFIG = {
+    500,        // settleMs
+    15000,      // timeoutMs
+    20,         // window（约 2 秒）
+    3.0f,       // maxStdDev (LSB)
+    5           // maxReadFailures
+};
+
+// 空气：电化学传感器需要更长的稳定时间
+static const CalibrationConfig AIR_CALIBRATION_CONFIG = {
+    2000,       // settleMs
+    60000,      // timeoutMs
+    20,         // window
+    8.0f,       // maxStdDev (LSB)
+    5           // maxReadFailures
+};
+
+bool OxygenSensor::startCalibration(CalibrationPoint point) {
     if (_ads == nullptr) {
-        Serial.println("错误: ADS1115未初始化");
-        return 0;
+        LOG_E(O2) Serial.println("错误: ADS1115未初始化");
+        return false;
+    }
+    if (_calSampler.isRunning()) {
+        return false;
+    }
+    _calPoint = point;
+    _calSampler.start(point == CAL_SHORT_CIRCUIT ? SHORT_CIRCUIT_CALIBRATION_CONFIG : AIR_CALIBRATION_CONFIG);
+    return true;
+}
+
+CalibrationSampler::Status OxygenSensor::stepCalibration() {
+    if (!_calSampler.isRunning()) {
+        return _calSampler.getStatus();
     }
     
-    Serial.println("\n=== 开始短接校准（A0） ===");
-    Serial.println("请将传感器的正负极（Vsensor+与Vsensor-）短接");
-    Serial.println("等待5秒后开始测量...");
-    
-    delay(5000);
-    
-    // 读取多次并取平均值
-    const int samples = 20;
-    long sum = 0;
+    // 校准使用未滤波的原始值，平滑由采样窗口完成
+    CalibrationSampler::Status status = _calSampler.addSample(readRawADC());
+    if (status != CalibrationSampler::STABLE) {
+        if (!_calSampler.isRunning()) {
+            LOG_W(O2) {
+                Serial.print("校准未完成: ");
+                Serial.print(CalibrationSampler::statusName(status));
+                Serial.print(", 标准差 ");
+                Serial.println(_calSampler.getStdDev(), 2);
+            }
+        }
+        return status;
+    }
     
-    for (int i = 0; i < samples; i++) {
-        int16_t value = readRawADC();
-        sum += value;
+    int16_t value = (int16_t)lround(_calSampler.getMean());
+    if (_calPoint == CAL_SHORT_CIRCUIT) {
+        _a0 = value;
+        LOG_I(O2) {
+            Serial.print("短接校准完成！A0 = ");
+            Serial.println(_a0);
+        }
+    } else {
+        _a1 = value;
+        LOG_I(O2) {
+            Serial.print("空气环境校准完成！A1 = ");
+            Serial.println(_a1);
+        }
+        
+        // 检查校准参数是否合理
+        if (abs(_a1 - _a0) < 100) {
+            LOG_W(O2) Serial.println("警告: A1和A0差值过小，可能校准有问题");
+        }
+        _isCalibrated = true;
+    }
+    LOG_I(O2) {
+        Serial.print("窗口标准差: ");
+        Serial.print(_calSampler.getStdDev(), 2);
+        Serial.print(" LSB, 用时 ");
+        Serial.print(_calSampler.getElapsedMs());
+        Serial.println(" ms");
+    }
+    return status;
+}
+
+bool OxygenSensor::runCalibration(CalibrationPoint point) {
+    if (!startCalibration(point)) {
+        return false;
+    }
+    while (true) {
+        CalibrationSampler::Status status = stepCalibration();
+        if (!_calSampler.isRunning()) {
+            return status == CalibrationSampler::STABLE;
+        }
         delay(100); // ADS1115需要更多时间
     }
+}
+
+// 校准：测量短接时的ADC值
+int16_t OxygenSensor::calibrateShortCircuit() {
+    LOG_I(O2) {
+        Serial.println("\n=== 开始短接校准（A0） ===");
+        Serial.println("请将传感器的正负极（Vsensor+与Vsensor-）短接");
+        Serial.println("等待信号稳定...");
+    }
     
-    _a0 = sum / samples;
-    
-    Serial.print("短接校准完成！A0 = ");
-    Serial.println(_a0);
-    Serial.print("对应电压: ");
-    Serial.print(_ads->readVoltage(_muxChannel), 4);
-    Serial.println(" V");
-    Serial.println("=== 短接校准完成 ===\n");
+    if (runCalibration(CAL_SHORT_CIRCUIT)) {
+        LOG_I(O2) {
+            Serial.print("对应电压: ");
+            Serial.print(_ads->readVoltage(_muxChannel), 4);
+            Serial.println(" V");
+        }
+    }
+    LOG_I(O2) Serial.println("=== 短接校准完成 ===\n");
     
     return _a0;
 }
 
 // 校准：测量空气中（21%氧气）的ADC值
 int16_t OxygenSensor::calibrateAirEnvironment() {
-    if (_ads == nullptr) {
-        Serial.println("错误: ADS1115未初始化");
-        return 0;
-    }
-    
-    Serial.println("\n=== 开始空气环境校准（A1） ===");
-    Serial.println("请将传感器置于空气中（21%氧气环境）");
-    Serial.println("等待10秒让传感器稳定...");
-    
-    delay(10000);
-    
-    // 读取多次并取平均值
-    const int samples = 20;
-    long sum = 0;
-    
-    for (int i = 0; i < samples; i++) {
-        int16_t value = readRawADC();
-        sum += value;
-        delay(100); // ADS1115需要更多时间
+    LOG_I(O2) {
+        Serial.println("\n=== 开始空气环境校准（A1） ===");
+        Serial.println("请将传感器置于空气中（21%氧气环境）");
+        Serial.println("等待信号稳定（最长 60 秒）...");
     }
     
-    _a1 = sum / samples;
-    
-    Serial.print("空气环境校准完成！A1 = ");
-    Serial.println(_a1);
-    Serial.print("对应电压: ");
-    Serial.print(_ads->readVoltage(_muxChannel), 4);
-    Serial.println(" V");
-    
-    // 检查校准参数是否合理
-    if (abs(_a1 - _a0) < 100) {
-        Serial.println("警告: A1和A0差值过小，可能校准有问题");
+    if (runCalibration(CAL_AIR)) {
+        LOG_I(O2) {
+            Serial.print("对应电压: ");
+            Serial.print(_ads->readVoltage(_muxChannel), 4);
+            Serial.println(" V");
+        }
     }
-    
-    _isCalibrated = true;
-    Serial.println("=== 空气环境校准完成 ===\n");
+    LOG_I(O2) Serial.println("=== 空气环境校准完成 ===\n");
     
     return _a1;
 }
@@ -158,10 +218,12 @@ void OxygenSensor::setCalibrationParams(int16_t a0, int16_t a1) {
     _a1 = a1;
     _isCalibrated = true;
     
-    Serial.print("校准参数已设置: A0 = ");
-    Serial.print(_a0);
-    Serial.print(", A1 = ");
-    Serial.println(_a1);
+    LOG_I(O2) {
+        Serial.print("校准参数已设置: A0 = ");
+        Serial.print(_a0);
+        Serial.print(", A1 = ");
+        Serial.println(_a1);
+    }
 }
 
 // 获取校准参数
@@ -3,6 +3,7 @@
 
 #include "LuckfoxArduino.h"
 #include "ADS1115.h"
+#include "CalibrationSampler.h"
 
 // 使用 ArduinoHAL 命名空间
 using namespace ArduinoHAL;
@@ -13,7 +14,7 @@ public:
     // 构造函数（使用ADS1115）
     // ads: ADS1115指针
     // muxChannel: 用于校准的MUX通道设置（默认ADS1115_MUX_AIN0_GND）
-    OxygenSensor(ADS1115* ads, uint8_t muxChannel = ADS1115_MUX_AIN0_GND);
+    OxygenSensor(ADS1115* ads, uint16_t muxChannel = ADS1115_MUX_AIN0_GND);
     
     // 初始化传感器
     void begin();
@@ -28,13 +29,25 @@ public:
     // 返回氧气浓度百分比
     float readOxygenConcentration();
     
-    // 校准函数
+    // 最近一次 readOxygenConcentration() 的结果（不触发I2C读取）
+    float getOxygenPercentage() const { return _lastOxygenPercent; }
+    
+    // 校准函数（阻塞，信号稳定后立即返回）
     // 测量短接时的ADC值作为A0
     int16_t calibrateShortCircuit();
     
     // 测量空气中（21%氧气）的ADC值作为A1
     int16_t calibrateAirEnvironment();
     
+    // 非阻塞校准：startCalibration() 后由调用方周期性调用 stepCalibration()（约 100ms 一次），
+    // 直到返回的状态不再是进行中；STABLE 表示对应的 A0/A1 已更新
+    enum CalibrationPoint { CAL_SHORT_CIRCUIT = 0, CAL_AIR };
+    bool startCalibration(CalibrationPoint point);
+    CalibrationSampler::Status stepCalibration();
+    void cancelCalibration() { _calSampler.cancel(); }
+    bool isCalibrating() const { return _calSampler.isRunning(); }
+    const CalibrationSampler& getCalibrationSampler() const { return _calSampler; }
+    
     // 手动设置校准参数
     void setCalibrationParams(int16_t a0, int16_t a1);
     
@@ -52,10 +65,18 @@ public:
 
 private:
     ADS1115* _ads;          // ADS1115 ADC模块
-    uint8_t _muxChannel;     // MUX通道设置
+    uint16_t _muxChannel;    // MUX通道设置
     int16_t _a0;             // 短接时的ADC值
     int16_t _a1;             // 空气中（21%氧气）的ADC值
     bool _isCalibrated;      // 是否已校准
+    float _lastOxygenPercent; // 最近一次读数
+    
+    // 非阻塞校准状态
+    CalibrationSampler _calSampler;
+    CalibrationPoint _calPoint;
+    
+    // 阻塞式校准的公共循环
+    bool runCalibration(CalibrationPoint point);
     
     // 滤波相关
     bool _filterEnabled;
@@ -33,12 +33,40 @@ FILES=(
     "BreathController.cpp"
     "ADS1115.h"
     "ADS1115.cpp"
+    "ADS1115Scanner.h"
+    "ADS1115Scanner.cpp"
     "gas_concentration.h"
     "gas_concentration.cpp"
     "oxygen_sensor.h"
     "oxygen_sensor.cpp"
     "OLEDDisplay.h"
     "OLEDDisplay.cpp"
+    "SampleFrame.h"
+    "WaveformRecorder.h"
+    "WaveformRecorder.cpp"
+    "ColumnarStore.h"
+    "ColumnarStore.cpp"
+    "BusTrace.h"
+    "BusTrace.cpp"
+    "TelemetryShm.h"
+    "TelemetryShm.cpp"
+    "TelemetryServer.h"
+    "TelemetryServer.cpp"
+    "CalibrationSampler.h"
+    "PgaAutoRange.h"
+    "PressureController.h"
+    "PressureController.cpp"
+    "ValveLinearizer.h"
+    "ValveLinearizer.cpp"
+    "PressureFusion.h"
+    "PressureFusion.cpp"
+    "FlowEstimator.h"
+    "FlowEstimator.cpp"
+    "CAFS3000.h"
+    "CAFS3000.cpp"
+    "VolumeIntegrator.h"
+    "VolumeIntegrator.cpp"
+    "LogModules.h"
     "Makefile"
 )
 
@@ -69,9 +97,23 @@ CPP_FILES=(
     "I2CMux.cpp"
     "BreathController.cpp"
     "ADS1115.cpp"
+    "ADS1115Scanner.cpp"
     "gas_concentration.cpp"
     "oxygen_sensor.cpp"
     "OLEDDisplay.cpp"
+    "WaveformRecorder.cpp"
+    "ColumnarStore.cpp"
+    "BusTrace.cpp"
+    "TelemetryShm.cpp"
+    "TelemetryServer.cpp"
+    "PressureController.cpp"
+    "ValveLinearizer.cpp"
+    "PressureFusion.cpp"
+    "FlowEstimator.cpp"
+    "CAFS3000.cpp"
+    "VolumeIntegrator.cpp"
+    "CalibrationSampler.h"
+    "PgaAutoRange.h"
 )
 
 ERRORS=0
@@ -0,0 +1,121 @@
+/*
+ * 遥测流客户端示例
+ *
+ * 连接 breath_controller 的 Unix 套接字遥测流，按订阅接收二进制批数据并输出 CSV。
+ * 也可作为床旁记录器、测试台等下游程序解析协议的参考（协议见 TelemetryServer.h）。
+ *
+ * 用法: telemetry_client [-c 通道列表] [-d 抽取倍数] [-b 每批样本数] [套接字路径]
+ *   -c 0,2   只订阅压力与流量（默认全部通道）
+ *   -d 10    每 10 个样本取 1 个
+ *   -b 50    每批 50 个样本
+ */
+
+#include "LuckfoxArduino.h"
+#include "TelemetryServer.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ArduinoHAL;
+
+static bool readFully(int fd, void* buf, size_t len) {
+    uint8_t* p = static_cast<uint8_t*>(buf);
+    while (len > 0) {
+        ssize_t n = ::read(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = STREAM_DEFAULT_PATH;
+    StreamSubscribe sub;
+    sub.channelMask = (1u << CH_COUNT) - 1;
+    sub.decimation = 1;
+    sub.batchSize = 10;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-c" && i + 1 < argc) {
+            sub.channelMask = 0;
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start < list.size()) {
+                size_t comma = list.find(',', start);
+                if (comma == std::string::npos) comma = list.size();
+                int ch = atoi(list.substr(start, comma - start).c_str());
+                if (ch >= 0 && ch < CH_COUNT) sub.channelMask |= 1u << ch;
+                start = comma + 1;
+            }
+        } else if (arg == "-d" && i + 1 < argc) {
+            sub.decimation = (uint16_t)atoi(argv[++i]);
+        } else if (arg == "-b" && i + 1 < argc) {
+            sub.batchSize = (uint16_t)atoi(argv[++i]);
+        } else {
+            path = arg;
+        }
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "无法连接 %s\n", path.c_str());
+        return 1;
+    }
+
+    // 发送订阅
+    uint8_t request[sizeof(uint32_t) + 1 + sizeof(StreamSubscribe)];
+    uint32_t length = 1 + sizeof(StreamSubscribe);
+    memcpy(request, &length, sizeof(length));
+    request[sizeof(length)] = STREAM_MSG_SUBSCRIBE;
+    memcpy(&request[sizeof(length) + 1], &sub, sizeof(sub));
+    if (::write(fd, request, sizeof(request)) != (ssize_t)sizeof(request)) {
+        return 1;
+    }
+
+    printf("timestamp_us,state,flags");
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        if (sub.channelMask & (1u << ch)) printf(",ch%d", ch);
+    }
+    printf("\n");
+
+    std::vector<uint8_t> message;
+    uint64_t totalDropped = 0;
+    while (readFully(fd, &length, sizeof(length))) {
+        message.resize(length);
+        if (length == 0 || !readFully(fd, message.data(), length)) break;
+        if (message[0] != STREAM_MSG_BATCH || length < 1 + sizeof(StreamBatchHeader)) continue;
+
+        StreamBatchHeader header;
+        memcpy(&header, &message[1], sizeof(header));
+        if (header.dropped > 0) {
+            totalDropped += header.dropped;
+            fprintf(stderr, "丢弃 %u 个样本（累计 %llu）\n", header.dropped, (unsigned long long)totalDropped);
+        }
+
+        const uint8_t* p = &message[1 + sizeof(header)];
+        for (uint16_t i = 0; i < header.count; i++, p += header.sampleSize) {
+            uint64_t ts;
+            memcpy(&ts, p, sizeof(ts));
+            printf("%llu,%u,0x%02x", (unsigned long long)ts, p[8], p[9]);
+            const uint8_t* v = p + 10;
+            for (int ch = 0; ch < CH_COUNT; ch++) {
+                if (!(header.channelMask & (1u << ch))) continue;
+                float value;
+                memcpy(&value, v, sizeof(value));
+                v += sizeof(value);
+                printf(",%.4f", value);
+            }
+            printf("\n");
+        }
+        fflush(stdout);
+    }
+    ::close(fd);
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * 共享内存遥测查看工具
+ *
+ * 以只读方式连接 breath_controller 发布的遥测共享内存，可与 GUI 等其他查看者同时运行。
+ *
+ * 用法: telemetry_view [--csv] [共享内存名称]
+ *   默认       每 200ms 刷新显示一次最新快照
+ *   --csv     按帧输出环形缓冲区中的全部新数据（适合记录到文件），Ctrl+C 退出
+ */
+
+#include "LuckfoxArduino.h"
+#include "TelemetryShm.h"
+#include <cstdio>
+
+using namespace ArduinoHAL;
+
+static const char* STATE_NAMES[] = { "INHALE", "EXHALE", "PEAK", "TROUGH" };
+
+int main(int argc, char* argv[]) {
+    std::string name = TELEMETRY_DEFAULT_NAME;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--csv") {
+            csv = true;
+        } else {
+            name = arg;
+        }
+    }
+
+    TelemetryReader reader(name);
+
+    if (csv) {
+        printf("timestamp_us,pressure_kpa,pressure_backup_kpa,flow_ml_min,co2_ppm,o2_percent,temperature_c,valve,volume_ml,state,flags\n");
+    }
+
+    uint64_t cursor = 0;
+    std::vector<SampleFrame> batch(256);
+    while (true) {
+        // 首次连接，或写者重启后重新连接
+        if (!reader.isAttached() || reader.publisherRestarted()) {
+            if (!reader.attach()) {
+                fprintf(stderr, "等待 breath_controller 发布 %s ...\n", name.c_str());
+                delay(1000);
+                continue;
+            }
+            cursor = reader.latestIndex();
+        }
+
+        if (csv) {
+            uint64_t last = cursor;
+            size_t n = reader.readSince(cursor, batch.data(), batch.size(), &last);
+            for (size_t i = 0; i < n; i++) {
+                const SampleFrame& f = batch[i];
+                printf("%llu", (unsigned long long)f.timestampUs);
+                for (int ch = 0; ch < CH_COUNT; ch++) {
+                    printf(",%.4f", f.values[ch]);
+                }
+                printf(",%u,0x%02x\n", f.breathState, f.flags);
+            }
+            cursor = last;
+            if (n == batch.size()) continue;
+            fflush(stdout);
+            delay(50);
+        } else {
+            SampleFrame f;
+            if (reader.readSnapshot(f)) {
+                printf("\r[%s] #%llu 压力 %7.2f kPa  流量 %7.0f ml/min  容积 %5.0f ml  CO2 %6.0f ppm  O2 %5.2f%%  气阀 %5.1f  %-6s   ",
+                       reader.isPublisherAlive() ? "在线" : "停止",
+                       (unsigned long long)reader.latestIndex(),
+                       f.values[CH_PRESSURE], f.values[CH_FLOW], f.values[CH_VOLUME], f.values[CH_CO2], f.values[CH_O2],
+                       f.values[CH_VALVE], f.breathState < 4 ? STATE_NAMES[f.breathState] : "?");
+                fflush(stdout);
+            }
+            delay(200);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * 趋势存储查询工具
+ *
+ * 读取 breath_controller 的列式趋势文件，按时间范围和列输出 CSV，
+ * 或只依据块摘要输出统计信息。可在写入进行中运行（只读取已完整写出的块）。
+ *
+ * 用法: trend_query [选项] [趋势文件路径]
+ *   --from US         起始时间戳(Unix 微秒，默认 0)
+ *   --to US           结束时间戳(Unix 微秒，默认不限)
+ *   --columns LIST    要输出的通道序号，逗号分隔（默认全部）
+ *   --filter CH:MIN:MAX  只扫描该通道数值范围与 [MIN,MAX] 相交的块
+ *   --summary         只输出各通道 min/max/mean，不解码数据
+ *   --info            输出块索引
+ */
+
+#include "LuckfoxArduino.h"
+#include "ColumnarStore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cfloat>
+
+using namespace ArduinoHAL;
+
+static const char* CHANNEL_NAMES[CH_COUNT] = {
+    "pressure_kpa", "pressure_backup_kpa", "flow_ml_min", "co2_ppm", "o2_percent", "temperature_c", "valve", "volume_ml"
+};
+
+static uint32_t parseColumns(const std::string& list) {
+    uint32_t mask = 0;
+    size_t start = 0;
+    while (start < list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        int ch = atoi(list.substr(start, comma - start).c_str());
+        if (ch >= 0 && ch < CH_COUNT) mask |= COLUMN_MASK_CHANNEL(ch);
+        start = comma + 1;
+    }
+    return mask | COLUMN_MASK_STATE | COLUMN_MASK_FLAGS;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = COLUMNAR_DEFAULT_PATH;
+    uint64_t fromUs = 0;
+    uint64_t toUs = UINT64_MAX;
+    uint32_t mask = COLUMN_MASK_ALL;
+    bool summaryOnly = false;
+    bool infoOnly = false;
+    ColumnarValueFilter filter;
+    bool useFilter = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--from" && i + 1 < argc) {
+            fromUs = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--to" && i + 1 < argc) {
+            toUs = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--columns" && i + 1 < argc) {
+            mask = parseColumns(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d:%f:%f", &filter.channel, &filter.minValue, &filter.maxValue) == 3) {
+                useFilter = true;
+            }
+        } else if (arg == "--summary") {
+            summaryOnly = true;
+        } else if (arg == "--info") {
+            infoOnly = true;
+        } else {
+            path = arg;
+        }
+    }
+
+    ColumnarReader reader(path);
+    if (!reader.open()) {
+        return 1;
+    }
+
+    if (infoOnly) {
+        printf("chunk,rows,first_us,last_us,payload_bytes\n");
+        for (size_t i = 0; i < reader.getChunkCount(); i++) {
+            const ColumnarChunkHeader& h = reader.getChunk(i);
+            printf("%zu,%u,%llu,%llu,%u\n", i, h.rowCount,
+                   (unsigned long long)h.firstTimestampUs, (unsigned long long)h.lastTimestampUs,
+                   h.payloadSize);
+        }
+        return 0;
+    }
+
+    if (summaryOnly) {
+        printf("channel,min,max,mean\n");
+        for (int ch = 0; ch < CH_COUNT; ch++) {
+            ColumnSummary s;
+            if (reader.summarize(fromUs, toUs, ch, s)) {
+                printf("%s,%.4f,%.4f,%.4f\n", CHANNEL_NAMES[ch], s.minValue, s.maxValue, s.meanValue);
+            }
+        }
+        return 0;
+    }
+
+    ColumnarQueryResult result;
+    if (!reader.read(fromUs, toUs, mask, result, useFilter ? &filter : nullptr)) {
+        return 1;
+    }
+
+    printf("timestamp_us");
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        if (mask & COLUMN_MASK_CHANNEL(ch)) printf(",%s", CHANNEL_NAMES[ch]);
+    }
+    printf(",state,flags\n");
+
+    for (size_t row = 0; row < result.size(); row++) {
+        printf("%llu", (unsigned long long)result.timestamps[row]);
+        for (int ch = 0; ch < CH_COUNT; ch++) {
+            if (mask & COLUMN_MASK_CHANNEL(ch)) printf(",%.4f", result.values[ch][row]);
+        }
+        printf(",%u,0x%02x\n", result.states[row], result.flags[row]);
+    }
+
+    fprintf(stderr, "扫描 %u 块, 跳过 %u 块, 共 %zu 行\n",
+            result.chunksScanned, result.chunksSkipped, result.size());
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * 波形记录查看工具
+ *
+ * 以只读方式打开 breath_controller 的波形记录文件并输出 CSV，
+ * 可在记录进行中并发运行。
+ *
+ * 用法: waveform_dump [-n 条数] [-f] [记录文件路径]
+ *   -n N   只输出最近 N 条记录（默认输出全部）
+ *   -f     持续跟随新记录（类似 tail -f），Ctrl+C 退出
+ */
+
+#include "LuckfoxArduino.h"
+#include "WaveformRecorder.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ArduinoHAL;
+
+static const char* CHANNEL_NAMES[CH_COUNT] = {
+    "pressure_kpa", "pressure_backup_kpa", "flow_ml_min", "co2_ppm", "o2_percent", "temperature_c", "valve", "volume_ml"
+};
+
+static void printRecord(const WaveformRecord& rec) {
+    printf("%llu,%llu", (unsigned long long)rec.seq, (unsigned long long)rec.timestampUs);
+    for (int i = 0; i < CH_COUNT; i++) {
+        printf(",%.4f", rec.values[i]);
+    }
+    printf(",%u,0x%02x\n", rec.breathState, rec.flags);
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = WAVEFORM_DEFAULT_PATH;
+    uint64_t lastCount = 0;
+    bool follow = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            lastCount = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "-f") {
+            follow = true;
+        } else {
+            path = arg;
+        }
+    }
+
+    WaveformReader reader(path);
+    if (!reader.open()) {
+        return 1;
+    }
+
+    printf("seq,timestamp_us");
+    for (int i = 0; i < CH_COUNT; i++) {
+        printf(",%s", CHANNEL_NAMES[i]);
+    }
+    printf(",state,flags\n");
+
+    uint64_t cursor = 0;
+    uint64_t latest = reader.latestSequence();
+    if (lastCount > 0 && latest > lastCount) {
+        cursor = latest - lastCount;
+    }
+
+    const size_t BATCH = 256;
+    std::vector<WaveformRecord> batch(BATCH);
+    while (true) {
+        size_t n = reader.readSince(cursor, batch.data(), BATCH);
+        for (size_t i = 0; i < n; i++) {
+            printRecord(batch[i]);
+            cursor = batch[i].seq;
+        }
+        if (n == BATCH) continue;
+
+        if (!follow) break;
+        fflush(stdout);
+        delay(50);
+    }
+    return 0;
+}
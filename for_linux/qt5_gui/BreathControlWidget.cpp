@@ -13,14 +13,16 @@
 #include <QLabel>
 #include <QMessageBox>
 
-using namespace ArduinoHAL;
+// Chart window: 60 s of waveform at the respective sample rates
+static const int LOCAL_WINDOW_SAMPLES = 600;         // ~10 Hz, local BreathController loop
+static const int TELEMETRY_WINDOW_SAMPLES = 6000;    // ~100 Hz, breath_controller via shared memory
 
 BreathControlWidget::BreathControlWidget(QWidget *parent)
     : QWidget(parent)
     , ui(nullptr)
-    , controller(nullptr)
+    , workerThread(new QThread(this))
+    , worker(new BreathControllerWorker())
     , isRunning(false)
-    , updateTimer(new QTimer(this))
 {
     setupUI();
     setupConnections();
@@ -29,10 +31,9 @@ BreathControlWidget::BreathControlWidget(QWidget *parent)
 
 BreathControlWidget::~BreathControlWidget()
 {
-    if (isRunning) {
-        onStopClicked();
-    }
-    delete controller;
+    // Let the current poll finish; the worker is deleted on its own thread
+    workerThread->quit();
+    workerThread->wait();
     delete ui;
 }
 
@@ -45,6 +46,8 @@ void BreathControlWidget::setupUI()
     startButton = new QPushButton("Start Monitoring", this);
     stopButton = new QPushButton("Stop", this);
     resetButton = new QPushButton("Reset", this);
+    viewButton = new QPushButton("Trend View", this);
+    viewButton->setCheckable(true);
     
     startButton->setStyleSheet("QPushButton { background-color: green; font-size: 14px; padding: 10px; }");
     stopButton->setStyleSheet("QPushButton { background-color: red; font-size: 14px; padding: 10px; }");
@@ -53,6 +56,7 @@ void BreathControlWidget::setupUI()
     buttonLayout->addWidget(startButton);
     buttonLayout->addWidget(stopButton);
     buttonLayout->addWidget(resetButton);
+    buttonLayout->addWidget(viewButton);
     mainLayout->addLayout(buttonLayout);
     
     // Sensor readings group
@@ -91,18 +95,38 @@ void BreathControlWidget::setupUI()
     sensorLayout->addWidget(o2Label, 1, 2);
     sensorLayout->addWidget(o2LCD, 1, 3);
     
+    // Volume (integrated by the controller's VolumeIntegrator)
+    QLabel *volumeLabel = new QLabel("Volume (ml):", this);
+    volumeLCD = new QLCDNumber(this);
+    volumeLCD->setDigitCount(6);
+    volumeLCD->setSegmentStyle(QLCDNumber::Flat);
+    sensorLayout->addWidget(volumeLabel, 2, 0);
+    sensorLayout->addWidget(volumeLCD, 2, 1);
+    
     mainLayout->addWidget(sensorGroup);
     
-    // Charts
-    QHBoxLayout *chartLayout = new QHBoxLayout();
+    // Sweep waveforms: only the freshly written strip is repainted each frame
+    plotStack = new QStackedWidget(this);
+    
+    sweepView = new SweepWaveformWidget(this);
+    sweepView->addTrace("Pressure", Qt::yellow, -1.0, 5.0);
+    sweepView->addTrace("Flow", Qt::green, -60.0, 60.0);     // L/min
+    sweepView->addTrace("Volume", Qt::cyan, 0.0, 500.0);
+    plotStack->addWidget(sweepView);
+    
+    // Trend charts
+    QWidget *chartPage = new QWidget(this);
+    QHBoxLayout *chartLayout = new QHBoxLayout(chartPage);
+    chartLayout->setContentsMargins(0, 0, 0, 0);
     
     pressurePlot = new SensorDataPlot("Pressure (cmH2O)", this);
     flowPlot = new SensorDataPlot("Flow (L/min)", this);
     
     chartLayout->addWidget(pressurePlot);
     chartLayout->addWidget(flowPlot);
+    plotStack->addWidget(chartPage);
     
-    mainLayout->addLayout(chartLayout);
+    mainLayout->addWidget(plotStack, 1);
 }
 
 void BreathControlWidget::setupConnections()
@@ -110,37 +134,54 @@ void BreathControlWidget::setupConnections()
     connect(startButton, &QPushButton::clicked, this, &BreathControlWidget::onStartClicked);
     connect(stopButton, &QPushButton::clicked, this, &BreathControlWidget::onStopClicked);
     connect(resetButton, &QPushButton::clicked, this, &BreathControlWidget::onResetClicked);
-    connect(updateTimer, &QTimer::timeout, this, &BreathControlWidget::updateSensorData);
+    connect(viewButton, &QPushButton::toggled, this, &BreathControlWidget::onViewToggled);
+    
+    // Worker -> GUI: queued, so every slot below runs on the GUI thread
+    connect(worker, &BreathControllerWorker::initialized,
+            this, &BreathControlWidget::onSensorInitialized, Qt::QueuedConnection);
+    connect(worker, &BreathControllerWorker::samplesReady,
+            this, &BreathControlWidget::onSamplesReady, Qt::QueuedConnection);
+    connect(worker, &BreathControllerWorker::connectionChanged,
+            this, &BreathControlWidget::i2cStatusChanged, Qt::QueuedConnection);
 }
 
 void BreathControlWidget::initializeController()
 {
-    // Initialize I2C
-    Wire.begin();
-    
-    // Create breath controller
-    controller = new BreathController();
+    // Sensor bring-up (mux switching, ACD1100 warm-up) can take seconds,
+    // so it runs on the worker thread as well
+    worker->moveToThread(workerThread);
+    connect(workerThread, &QThread::started, worker, &BreathControllerWorker::initialize);
+    connect(workerThread, &QThread::finished, worker, &QObject::deleteLater);
     
-    // Initialize (begin() returns void)
-    controller->begin();
-    
-    // Assume success for now - could add error detection later
-    onSensorInitialized(true);
+    startButton->setEnabled(false);
+    workerThread->start();
 }
 
-void BreathControlWidget::onSensorInitialized(bool success)
+void BreathControlWidget::onSensorInitialized(bool success, bool attachMode)
 {
-    emit i2cStatusChanged(success);
-    
     if (!success) {
         QMessageBox::critical(this, "Initialization Error",
             "Failed to initialize sensors!\n\n"
             "Please check:\n"
             "1. I2C connections\n"
             "2. Device permissions (/dev/i2c-0)\n"
-            "3. Hardware power supply");
+            "3. Hardware power supply\n"
+            "4. I2C multiplexer (TCA9548 at 0x70)\n\n"
+            "No running breath_controller was found to attach to.");
         startButton->setEnabled(false);
+        return;
     }
+    
+    // Thousands of points per trace: draw a min/max envelope instead
+    const int window = attachMode ? TELEMETRY_WINDOW_SAMPLES : LOCAL_WINDOW_SAMPLES;
+    pressurePlot->setMaxDataPoints(window);
+    flowPlot->setMaxDataPoints(window);
+    pressurePlot->setEnvelopeMode(true);
+    flowPlot->setEnvelopeMode(true);
+    
+    startButton->setEnabled(!isRunning);
+    startButton->setToolTip(attachMode ? "Attached to running breath_controller"
+                                       : "Reading sensors locally");
 }
 
 void BreathControlWidget::onStartClicked()
@@ -149,8 +190,7 @@ void BreathControlWidget::onStartClicked()
     startButton->setEnabled(false);
     stopButton->setEnabled(true);
     
-    // Start update timer (update every 100ms)
-    updateTimer->start(100);
+    QMetaObject::invokeMethod(worker, "start", Qt::QueuedConnection);
 }
 
 void BreathControlWidget::onStopClicked()
@@ -159,42 +199,52 @@ void BreathControlWidget::onStopClicked()
     startButton->setEnabled(true);
     stopButton->setEnabled(false);
     
-    updateTimer->stop();
+    QMetaObject::invokeMethod(worker, "stop", Qt::QueuedConnection);
 }
 
 void BreathControlWidget::onResetClicked()
 {
+    QMetaObject::invokeMethod(worker, "reset", Qt::QueuedConnection);
+    
     pressurePlot->clearData();
     flowPlot->clearData();
+    sweepView->clear();
     
     pressureLCD->display(0.0);
     flowLCD->display(0.0);
     co2LCD->display(0.0);
     o2LCD->display(0.0);
+    volumeLCD->display(0.0);
 }
 
-void BreathControlWidget::updateSensorData()
+void BreathControlWidget::onSamplesReady(const SampleBatch &samples)
 {
-    if (!controller || !isRunning) {
+    // A batch can still arrive after Stop was clicked
+    if (!isRunning || samples.isEmpty()) {
         return;
     }
     
-    // Update controller (reads all sensors)
-    controller->update();
-    
-    // Get sensor data
-    float pressure = controller->getPressure();
-    float flow = controller->getFlow();
-    float co2 = controller->getCO2Percentage();
-    float o2 = controller->getO2Percentage();
-    
-    // Update LCD displays
-    pressureLCD->display(pressure);
-    flowLCD->display(flow);
-    co2LCD->display(co2);
-    o2LCD->display(o2);
-    
-    // Update charts
-    pressurePlot->addDataPoint(pressure);
-    flowPlot->addDataPoint(flow);
+    // LCDs show the newest sample of the batch
+    const SampleFrame &latest = samples.last();
+    pressureLCD->display(latest.values[CH_PRESSURE]);
+    flowLCD->display(latest.values[CH_FLOW] / 1000.0);     // ml/min -> L/min
+    co2LCD->display(latest.values[CH_CO2] / 10000.0);   // ppm -> %
+    o2LCD->display(latest.values[CH_O2]);
+    volumeLCD->display(latest.values[CH_VOLUME]);
+    
+    // Every sample goes to the plots; they coalesce redraws themselves
+    for (const SampleFrame &frame : samples) {
+        const double flowLMin = frame.values[CH_FLOW] / 1000.0;
+        const double traces[3] = { frame.values[CH_PRESSURE], flowLMin, frame.values[CH_VOLUME] };
+        sweepView->addSample(frame.timestampUs, traces);
+        
+        pressurePlot->addDataPoint(frame.values[CH_PRESSURE]);
+        flowPlot->addDataPoint(flowLMin);
+    }
+}
+
+void BreathControlWidget::onViewToggled(bool trendView)
+{
+    plotStack->setCurrentIndex(trendView ? 1 : 0);
+    viewButton->setText(trendView ? "Sweep View" : "Trend View");
 }
@@ -9,14 +9,15 @@
 #define BREATHCONTROLWIDGET_H
 
 #include <QWidget>
-#include <QTimer>
+#include <QThread>
+#include <QStackedWidget>
 #include <QLabel>
 #include <QPushButton>
 #include <QGroupBox>
 #include <QLCDNumber>
-#include "/home/wang/code/breath_contr/LuckfoxArduino.h"
-#include "/home/wang/code/breath_contr/BreathController.h"
+#include "BreathControllerWorker.h"
 #include "SensorDataPlot.h"
+#include "SweepWaveformWidget.h"
 
 namespace Ui {
 class BreathControlWidget;
@@ -37,38 +38,40 @@ private slots:
     void onStartClicked();
     void onStopClicked();
     void onResetClicked();
-    void updateSensorData();
-    void onSensorInitialized(bool success);
+    void onViewToggled(bool trendView);
+    void onSamplesReady(const SampleBatch &samples);
+    void onSensorInitialized(bool success, bool attachMode);
 
 private:
     Ui::BreathControlWidget *ui;
     
-    // Backend controller
-    BreathController *controller;
+    // Acquisition runs in workerThread; the GUI only talks to it via queued calls
+    QThread *workerThread;
+    BreathControllerWorker *worker;
     bool isRunning;
     
     // UI elements
     QPushButton *startButton;
     QPushButton *stopButton;
     QPushButton *resetButton;
+    QPushButton *viewButton;
     
     // LCD displays
     QLCDNumber *pressureLCD;
     QLCDNumber *flowLCD;
     QLCDNumber *co2LCD;
     QLCDNumber *o2LCD;
+    QLCDNumber *volumeLCD;
     
-    // Charts
+    // Waveforms: sweep display (default) or trend charts
+    QStackedWidget *plotStack;
+    SweepWaveformWidget *sweepView;
     SensorDataPlot *pressurePlot;
     SensorDataPlot *flowPlot;
     
-    // Timer for data updates
-    QTimer *updateTimer;
-    
     void setupUI();
     void setupConnections();
     void initializeController();
-    void updateDisplays();
 };
 
 #endif // BREATHCONTROLWIDGET_H
@@ -0,0 +1,209 @@
+/*
+ * ===================================================================
+ * BreathControllerWorker.cpp
+ * Sensor acquisition worker implementation
+ * ===================================================================
+ */
+
+#include "BreathControllerWorker.h"
+
+using namespace ArduinoHAL;
+
+// Local mode: BreathController::update() already paces itself (~100 ms per call)
+static const int LOCAL_POLL_INTERVAL_MS = 100;
+// Attach mode: drain the shared ring often enough to keep the plots smooth
+static const int TELEMETRY_POLL_INTERVAL_MS = 50;
+
+BreathControllerWorker::BreathControllerWorker(QObject *parent)
+    : QObject(parent)
+    , mux(nullptr)
+    , controller(nullptr)
+    , telemetry(new TelemetryReader())
+    , attachMode(false)
+    , telemetryCursor(0)
+    , pollTimer(nullptr)
+    , connected(false)
+{
+    qRegisterMetaType<SampleBatch>("SampleBatch");
+}
+
+BreathControllerWorker::~BreathControllerWorker()
+{
+    if (controller) {
+        controller->removeSampleSink(this);
+    }
+    delete controller;
+    delete mux;
+    delete telemetry;
+}
+
+void BreathControllerWorker::initialize()
+{
+    // Created here so the timer belongs to the worker thread
+    pollTimer = new QTimer(this);
+    pollTimer->setTimerType(Qt::PreciseTimer);
+    connect(pollTimer, &QTimer::timeout, this, &BreathControllerWorker::poll);
+    
+    // Prefer attaching to a running breath_controller: the control loop then
+    // keeps running in its own process and a UI stall cannot stall ventilation.
+    if (attachTelemetry()) {
+        setConnected(true);
+        emit initialized(true, true);
+        return;
+    }
+    
+    // No publisher found - fall back to driving the sensors locally
+    if (!setupLocalSensors()) {
+        setConnected(false);
+        emit initialized(false, false);
+        return;
+    }
+    controller->addSampleSink(this);
+    
+    setConnected(true);
+    emit initialized(true, false);
+}
+
+bool BreathControllerWorker::setupLocalSensors()
+{
+    Wire.begin();
+    
+    // BreathController::update() reads nothing without the multiplexer, so make
+    // sure it answers before building the controller (writing 0 disables all channels)
+    Wire.beginTransmission(TCA9548_BASE_ADDR);
+    Wire.write(0x00);
+    if (Wire.endTransmission() != 0) {
+        return false;
+    }
+    
+    // Same channel layout as breath_controller (linux_port/main.cpp). The oxygen
+    // sensor is left to the calibration tab, which runs its own AO08 worker.
+    mux = new I2CMux(TCA9548_BASE_ADDR);
+    controller = new BreathController(mux);
+    
+    mux->addChannel(0, 0x50, "Flow sensor");
+    mux->addChannel(1, 0x6D, "SENSOR");
+    mux->addChannel(2, 0x3C, "OLED Display");
+    mux->addChannel(3, 0x6D, "Backup pressure sensor");
+    mux->addChannel(4, 0x4A, "ADS1115 ADC");
+    mux->addChannel(5, 0x2A, "ACD1100 gas sensor");
+    
+    mux->enableChannel(0, false);
+    mux->enableChannel(1, true);
+    mux->enableChannel(2, true);
+    mux->enableChannel(3, true);
+    mux->enableChannel(4, false);
+    mux->enableChannel(5, true);
+    
+    controller->begin();
+    return true;
+}
+
+void BreathControllerWorker::start()
+{
+    if (!pollTimer || pollTimer->isActive()) {
+        return;
+    }
+    if (attachMode) {
+        // Only show data published from now on
+        telemetryCursor = telemetry->latestIndex();
+    }
+    pollTimer->start(attachMode ? TELEMETRY_POLL_INTERVAL_MS : LOCAL_POLL_INTERVAL_MS);
+}
+
+void BreathControllerWorker::stop()
+{
+    if (pollTimer) {
+        pollTimer->stop();
+    }
+    pending.clear();
+}
+
+void BreathControllerWorker::reset()
+{
+    pending.clear();
+    if (attachMode) {
+        telemetryCursor = telemetry->latestIndex();
+    }
+}
+
+void BreathControllerWorker::onSample(const SampleFrame &frame)
+{
+    pending.append(frame);
+}
+
+void BreathControllerWorker::poll()
+{
+    if (attachMode) {
+        pollTelemetry();
+    } else if (controller) {
+        // Blocking I2C work - fine here, this is not the GUI thread
+        controller->update();
+    }
+    flush();
+}
+
+bool BreathControllerWorker::attachTelemetry()
+{
+    if (!telemetry->attach() || !telemetry->isPublisherAlive()) {
+        telemetry->detach();
+        return false;
+    }
+    
+    attachMode = true;
+    telemetryCursor = telemetry->latestIndex();
+    return true;
+}
+
+void BreathControllerWorker::pollTelemetry()
+{
+    // Re-attach after breath_controller restarts
+    if (!telemetry->isAttached() || telemetry->publisherRestarted()) {
+        if (!telemetry->attach()) {
+            setConnected(false);
+            return;
+        }
+        telemetryCursor = telemetry->latestIndex();
+    }
+    setConnected(telemetry->isPublisherAlive());
+    
+    // Read each new frame in place from its ring slot; the only copy is the
+    // append into the batch handed to the GUI thread. A slot the publisher
+    // overwrote while we were reading it fails the seqlock check and is dropped.
+    const uint64_t latest = telemetry->latestIndex();
+    if (latest <= telemetryCursor) {
+        return;
+    }
+    const uint64_t first = qMax(telemetryCursor + 1, telemetry->oldestIndex());
+    pending.reserve(pending.size() + int(latest - first + 1));
+    for (uint64_t index = first; index <= latest; ++index) {
+        const SampleFrame *frame = telemetry->frameAt(index);
+        if (!frame) {
+            continue;
+        }
+        pending.append(*frame);
+        if (!telemetry->isStillValid(index)) {
+            pending.removeLast();
+        }
+    }
+    telemetryCursor = latest;
+}
+
+void BreathControllerWorker::setConnected(bool state)
+{
+    if (state != connected) {
+        connected = state;
+        emit connectionChanged(state);
+    }
+}
+
+void BreathControllerWorker::flush()
+{
+    if (pending.isEmpty()) {
+        return;
+    }
+    // One queued signal per poll, however many samples it produced
+    SampleBatch batch;
+    batch.swap(pending);
+    emit samplesReady(batch);
+}
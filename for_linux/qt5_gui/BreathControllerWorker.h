@@ -0,0 +1,77 @@
+/*
+ * ===================================================================
+ * BreathControllerWorker.h
+ * Sensor acquisition worker running in its own QThread
+ * ===================================================================
+ */
+
+#ifndef BREATHCONTROLLERWORKER_H
+#define BREATHCONTROLLERWORKER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QMetaType>
+#include "/home/wang/code/breath_contr/LuckfoxArduino.h"
+#include "/home/wang/code/breath_contr/BreathController.h"
+#include "/home/wang/code/breath_contr/TelemetryShm.h"
+
+// Batch of timestamped samples delivered to the GUI through a queued connection
+typedef QVector<SampleFrame> SampleBatch;
+Q_DECLARE_METATYPE(SampleBatch)
+
+/*
+ * Owns everything that touches I2C or the telemetry shared memory.
+ * The object is moved to a dedicated QThread; all public slots are meant
+ * to be invoked through queued connections (QMetaObject::invokeMethod),
+ * so the GUI thread never blocks on sensor I/O.
+ */
+class BreathControllerWorker : public QObject, public SampleSink
+{
+    Q_OBJECT
+
+public:
+    explicit BreathControllerWorker(QObject *parent = nullptr);
+    ~BreathControllerWorker();
+    
+    // Called by BreathController::update() on the worker thread
+    void onSample(const SampleFrame &frame) override;
+
+public slots:
+    // Attach to a running breath_controller, or bring up the local sensors
+    void initialize();
+    void start();
+    void stop();
+    // Drop queued samples and resynchronise with the telemetry ring
+    void reset();
+
+signals:
+    void initialized(bool success, bool attachMode);
+    void samplesReady(const SampleBatch &samples);
+    void connectionChanged(bool connected);
+
+private slots:
+    void poll();
+
+private:
+    // Backend controller and its I2C multiplexer (local mode only)
+    I2CMux *mux;
+    BreathController *controller;
+    
+    // Shared-memory telemetry from a running breath_controller (attach mode)
+    TelemetryReader *telemetry;
+    bool attachMode;
+    uint64_t telemetryCursor;
+    
+    QTimer *pollTimer;
+    SampleBatch pending;
+    bool connected;
+    
+    bool attachTelemetry();
+    bool setupLocalSensors();
+    void pollTelemetry();
+    void setConnected(bool state);
+    void flush();
+};
+
+#endif // BREATHCONTROLLERWORKER_H
@@ -12,18 +12,12 @@
 #include <QGroupBox>
 #include <QMessageBox>
 
-using namespace ArduinoHAL;
-
 OxygenCalibrationWidget::OxygenCalibrationWidget(QWidget *parent)
     : QWidget(parent)
     , ui(nullptr)
-    , mux(nullptr)
-    , oxygenSensor(nullptr)
-    , calibrationStorage(nullptr)
+    , workerThread(new QThread(this))
+    , worker(new OxygenSensorWorker())
     , isCalibrating(false)
-    , calibrationStep(0)
-    , readingTimer(new QTimer(this))
-    , calibrationTimer(new QTimer(this))
 {
     setupUI();
     setupConnections();
@@ -32,9 +26,9 @@ OxygenCalibrationWidget::OxygenCalibrationWidget(QWidget *parent)
 
 OxygenCalibrationWidget::~OxygenCalibrationWidget()
 {
-    delete oxygenSensor;
-    delete calibrationStorage;
-    delete mux;
+    // A running calibration is abandoned; stored parameters stay untouched
+    workerThread->quit();
+    workerThread->wait();
     delete ui;
 }
 
@@ -48,16 +42,20 @@ void OxygenCalibrationWidget::setupUI()
     
     calibrateZeroButton = new QPushButton("Zero Point\n(Short Circuit)", this);
     calibrateAirButton = new QPushButton("Air Point\n(20.95% O2)", this);
+    cancelCalibrationButton = new QPushButton("Cancel\nCalibration", this);
     testVoltageButton = new QPushButton("Test Voltage", this);
     clearCalibrationButton = new QPushButton("Clear Calibration", this);
     
     calibrateZeroButton->setStyleSheet("QPushButton { font-size: 12px; padding: 15px; }");
     calibrateAirButton->setStyleSheet("QPushButton { font-size: 12px; padding: 15px; }");
+    cancelCalibrationButton->setStyleSheet("QPushButton { font-size: 12px; padding: 15px; }");
+    cancelCalibrationButton->setVisible(false);
     testVoltageButton->setStyleSheet("QPushButton { font-size: 12px; padding: 10px; }");
     clearCalibrationButton->setStyleSheet("QPushButton { background-color: darkred; font-size: 12px; padding: 10px; }");
     
     calibrationLayout->addWidget(calibrateZeroButton);
     calibrationLayout->addWidget(calibrateAirButton);
+    calibrationLayout->addWidget(cancelCalibrationButton);
     calibrationLayout->addWidget(testVoltageButton);
     calibrationLayout->addWidget(clearCalibrationButton);
     
@@ -95,12 +93,17 @@ void OxygenCalibrationWidget::setupUI()
     airVoltageLabel = new QLabel("Air Voltage: N/A", this);
     
     calibrationProgress = new QProgressBar(this);
+    calibrationProgress->setRange(0, 100);
     calibrationProgress->setVisible(false);
     
+    stabilityLabel = new QLabel(this);
+    stabilityLabel->setVisible(false);
+    
     infoLayout->addWidget(calibrationStatusLabel);
     infoLayout->addWidget(zeroVoltageLabel);
     infoLayout->addWidget(airVoltageLabel);
     infoLayout->addWidget(calibrationProgress);
+    infoLayout->addWidget(stabilityLabel);
     
     mainLayout->addWidget(infoGroup);
     
@@ -112,13 +115,12 @@ void OxygenCalibrationWidget::setupUI()
         "<b>Zero Point Calibration:</b><br>"
         "1. Short circuit Vsensor+ and Vsensor- pins<br>"
         "2. Click 'Zero Point' button<br>"
-        "3. Wait for calibration to complete<br><br>"
+        "3. Wait until the signal is stable<br><br>"
         "<b>Air Point Calibration:</b><br>"
         "1. Remove short circuit<br>"
         "2. Expose sensor to fresh air<br>"
-        "3. Wait 1-2 minutes for stabilization<br>"
-        "4. Click 'Air Point' button<br>"
-        "5. Wait for calibration to complete",
+        "3. Click 'Air Point' button<br>"
+        "4. Calibration finishes as soon as the reading is stable (up to 60 s)",
         this
     );
     instructions->setWordWrap(true);
@@ -133,69 +135,75 @@ void OxygenCalibrationWidget::setupConnections()
             this, &OxygenCalibrationWidget::onCalibrateZeroClicked);
     connect(calibrateAirButton, &QPushButton::clicked, 
             this, &OxygenCalibrationWidget::onCalibrateAirClicked);
+    connect(cancelCalibrationButton, &QPushButton::clicked, 
+            this, &OxygenCalibrationWidget::onCancelCalibrationClicked);
     connect(testVoltageButton, &QPushButton::clicked, 
             this, &OxygenCalibrationWidget::onTestVoltageClicked);
     connect(clearCalibrationButton, &QPushButton::clicked, 
             this, &OxygenCalibrationWidget::onClearCalibrationClicked);
     
-    connect(readingTimer, &QTimer::timeout, 
-            this, &OxygenCalibrationWidget::updateReading);
-    connect(calibrationTimer, &QTimer::timeout, 
-            this, &OxygenCalibrationWidget::performZeroCalibration);
+    // Worker -> GUI (queued: the worker lives in workerThread)
+    connect(worker, &OxygenSensorWorker::initialized,
+            this, &OxygenCalibrationWidget::onSensorInitialized);
+    connect(worker, &OxygenSensorWorker::readingReady,
+            this, &OxygenCalibrationWidget::onReadingReady);
+    connect(worker, &OxygenSensorWorker::calibrationInfo,
+            this, &OxygenCalibrationWidget::onCalibrationInfo);
+    connect(worker, &OxygenSensorWorker::calibrationProgress,
+            this, &OxygenCalibrationWidget::onCalibrationProgress);
+    connect(worker, &OxygenSensorWorker::calibrationFinished,
+            this, &OxygenCalibrationWidget::onCalibrationFinished);
+    connect(worker, &OxygenSensorWorker::voltageTested,
+            this, &OxygenCalibrationWidget::onVoltageTested);
+    connect(worker, &OxygenSensorWorker::calibrationCleared,
+            this, &OxygenCalibrationWidget::onCalibrationCleared);
 }
 
 void OxygenCalibrationWidget::initializeSensor()
 {
-    Wire.begin();
-    
-    // Initialize I2C Mux
-    mux = new I2CMux(0x70);
-    mux->begin();
-    mux->addChannel(6, 0x4A, "ADS1115");
-    
-    // Initialize oxygen sensor
-    oxygenSensor = new AO08_Sensor(mux, 6, 0x4A);
-    calibrationStorage = new AO08_CalibrationStorage();
+    worker->moveToThread(workerThread);
+    connect(workerThread, &QThread::started, worker, &OxygenSensorWorker::initialize);
+    connect(workerThread, &QThread::finished, worker, &QObject::deleteLater);
+    
+    calibrateZeroButton->setEnabled(false);
+    calibrateAirButton->setEnabled(false);
+    testVoltageButton->setEnabled(false);
+    workerThread->start();
+}
+
+void OxygenCalibrationWidget::onSensorInitialized(bool sensorOk, bool storageOk)
+{
+    emit i2cStatusChanged(sensorOk);
     
-    if (!calibrationStorage->begin()) {
+    if (!storageOk) {
         QMessageBox::warning(this, "Warning",
             "Calibration storage initialization failed.\n"
             "Calibration data will not be persistent.");
     }
     
-    bool success = oxygenSensor->begin();
-    emit i2cStatusChanged(success);
-    
-    if (!success) {
+    if (!sensorOk) {
         QMessageBox::critical(this, "Initialization Error",
             "Failed to initialize oxygen sensor!\n\n"
             "Please check:\n"
             "1. ADS1115 connection (I2C address 0x4A)\n"
             "2. I2C Mux channel 6 configuration\n"
             "3. Device permissions");
-        
-        calibrateZeroButton->setEnabled(false);
-        calibrateAirButton->setEnabled(false);
         return;
     }
     
-    updateCalibrationInfo();
-    
-    // Start reading timer (update every 500ms)
-    readingTimer->start(500);
+    calibrateZeroButton->setEnabled(true);
+    calibrateAirButton->setEnabled(true);
+    testVoltageButton->setEnabled(true);
 }
 
-void OxygenCalibrationWidget::updateCalibrationInfo()
+void OxygenCalibrationWidget::onCalibrationInfo(bool calibrated, double voltageZero, double voltageAir)
 {
-    if (oxygenSensor->isCalibrated()) {
-        float vZero, vAir;
-        oxygenSensor->getCalibrationParams(vZero, vAir);
-        
+    if (calibrated) {
         calibrationStatusLabel->setText("Status: Calibrated");
         calibrationStatusLabel->setStyleSheet("QLabel { color: green; font-weight: bold; }");
         
-        zeroVoltageLabel->setText(QString("Zero Voltage: %1 mV").arg(vZero, 0, 'f', 4));
-        airVoltageLabel->setText(QString("Air Voltage: %1 mV").arg(vAir, 0, 'f', 4));
+        zeroVoltageLabel->setText(QString("Zero Voltage: %1 mV").arg(voltageZero, 0, 'f', 4));
+        airVoltageLabel->setText(QString("Air Voltage: %1 mV").arg(voltageAir, 0, 'f', 4));
     } else {
         calibrationStatusLabel->setText("Status: Not Calibrated");
         calibrationStatusLabel->setStyleSheet("QLabel { color: orange; font-weight: bold; }");
@@ -205,6 +213,30 @@ void OxygenCalibrationWidget::updateCalibrationInfo()
     }
 }
 
+void OxygenCalibrationWidget::setCalibrating(bool calibrating)
+{
+    isCalibrating = calibrating;
+    calibrateZeroButton->setEnabled(!calibrating);
+    calibrateAirButton->setEnabled(!calibrating);
+    testVoltageButton->setEnabled(!calibrating);
+    clearCalibrationButton->setEnabled(!calibrating);
+    cancelCalibrationButton->setVisible(calibrating);
+    calibrationProgress->setVisible(calibrating);
+    stabilityLabel->setVisible(calibrating);
+    
+    if (calibrating) {
+        calibrationProgress->setValue(0);
+        stabilityLabel->setText("Waiting for signal...");
+    }
+}
+
+void OxygenCalibrationWidget::beginCalibration(AO08_Sensor::CalibrationPoint point)
+{
+    setCalibrating(true);
+    QMetaObject::invokeMethod(worker, "startCalibration", Qt::QueuedConnection,
+                              Q_ARG(int, point));
+}
+
 void OxygenCalibrationWidget::onCalibrateZeroClicked()
 {
     int ret = QMessageBox::question(this, "Zero Point Calibration",
@@ -213,83 +245,70 @@ void OxygenCalibrationWidget::onCalibrateZeroClicked()
         QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        isCalibrating = true;
-        calibrateZeroButton->setEnabled(false);
-        calibrateAirButton->setEnabled(false);
-        calibrationProgress->setVisible(true);
-        calibrationProgress->setRange(0, 100);
-        calibrationProgress->setValue(0);
-        
-        // Start calibration after 2 second delay
-        QTimer::singleShot(2000, this, &OxygenCalibrationWidget::performZeroCalibration);
-    }
-}
-
-void OxygenCalibrationWidget::performZeroCalibration()
-{
-    bool success = oxygenSensor->calibrateZero(true);
-    
-    isCalibrating = false;
-    calibrateZeroButton->setEnabled(true);
-    calibrateAirButton->setEnabled(true);
-    calibrationProgress->setVisible(false);
-    
-    if (success) {
-        QMessageBox::information(this, "Success",
-            "Zero point calibration completed successfully!");
-        updateCalibrationInfo();
-    } else {
-        QMessageBox::critical(this, "Error",
-            "Zero point calibration failed!\n\n"
-            "Please check sensor connection and try again.");
+        beginCalibration(AO08_Sensor::CAL_ZERO);
     }
 }
 
 void OxygenCalibrationWidget::onCalibrateAirClicked()
 {
     int ret = QMessageBox::question(this, "Air Point Calibration",
-        "Is the sensor exposed to fresh air?\n"
-        "Has it stabilized for at least 1-2 minutes?\n\n"
+        "Is the sensor exposed to fresh air?\n\n"
+        "Calibration completes as soon as the reading is stable.\n"
         "Click 'Yes' to proceed with calibration.",
         QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        isCalibrating = true;
-        calibrateZeroButton->setEnabled(false);
-        calibrateAirButton->setEnabled(false);
-        calibrationProgress->setVisible(true);
-        calibrationProgress->setRange(0, 100);
-        calibrationProgress->setValue(0);
-        
-        QTimer::singleShot(2000, this, &OxygenCalibrationWidget::performAirCalibration);
+        beginCalibration(AO08_Sensor::CAL_AIR);
     }
 }
 
-void OxygenCalibrationWidget::performAirCalibration()
+void OxygenCalibrationWidget::onCancelCalibrationClicked()
 {
-    bool success = oxygenSensor->calibrateAir(true);
-    
-    isCalibrating = false;
-    calibrateZeroButton->setEnabled(true);
-    calibrateAirButton->setEnabled(true);
-    calibrationProgress->setVisible(false);
+    cancelCalibrationButton->setEnabled(false);
+    QMetaObject::invokeMethod(worker, "cancelCalibration", Qt::QueuedConnection);
+}
+
+void OxygenCalibrationWidget::onCalibrationProgress(double progress, double stability, double mean,
+                                                    double stdDev, int samples, const QString &state)
+{
+    calibrationProgress->setValue(qRound(progress * 100.0));
+    
+    // Stability: 100% once the window standard deviation is below the threshold
+    const int stablePercent = qRound(stability * 100.0);
+    stabilityLabel->setText(QString("%1 - mean %2 mV, σ %3 mV (%4 samples), stability %5%")
+                                .arg(state)
+                                .arg(mean, 0, 'f', 4)
+                                .arg(stdDev, 0, 'f', 4)
+                                .arg(samples)
+                                .arg(stablePercent));
+    stabilityLabel->setStyleSheet(stablePercent >= 100 ? "QLabel { color: green; }"
+                                                       : "QLabel { color: orange; }");
+    voltageLCD->display(mean);
+}
+
+void OxygenCalibrationWidget::onCalibrationFinished(int point, int status, const QString &message)
+{
+    setCalibrating(false);
+    cancelCalibrationButton->setEnabled(true);
     
-    if (success) {
+    const QString name = (point == AO08_Sensor::CAL_ZERO) ? "Zero point" : "Air point";
+    if (status == CalibrationSampler::STABLE) {
         QMessageBox::information(this, "Success",
-            "Air point calibration completed successfully!\n\n"
-            "Calibration data has been saved.");
-        updateCalibrationInfo();
-    } else {
+            QString("%1 calibration completed successfully!\n\n%2").arg(name, message));
+    } else if (status != CalibrationSampler::CANCELLED) {
         QMessageBox::critical(this, "Error",
-            "Air point calibration failed!\n\n"
-            "Please ensure zero point calibration was completed first.");
+            QString("%1 calibration failed!\n\n%2").arg(name, message));
     }
 }
 
 void OxygenCalibrationWidget::onTestVoltageClicked()
 {
-    float voltage;
-    if (oxygenSensor->readVoltage(voltage)) {
+    QMetaObject::invokeMethod(worker, "testVoltage", Qt::QueuedConnection);
+}
+
+void OxygenCalibrationWidget::onVoltageTested(bool ok, double voltage)
+{
+    if (ok) {
         QMessageBox::information(this, "Voltage Test",
             QString("Current sensor voltage: %1 mV\n\n"
                     "Sensor connection: OK").arg(voltage, 0, 'f', 4));
@@ -308,34 +327,25 @@ void OxygenCalibrationWidget::onClearCalibrationClicked()
         QMessageBox::Yes | QMessageBox::No);
     
     if (ret == QMessageBox::Yes) {
-        if (calibrationStorage->clearCalibration()) {
-            QMessageBox::information(this, "Success",
-                "Calibration data cleared.\n\n"
-                "Please recalibrate the sensor.");
-            updateCalibrationInfo();
-        }
+        QMetaObject::invokeMethod(worker, "clearCalibration", Qt::QueuedConnection);
     }
 }
 
-void OxygenCalibrationWidget::updateReading()
+void OxygenCalibrationWidget::onCalibrationCleared(bool ok)
+{
+    if (ok) {
+        QMessageBox::information(this, "Success",
+            "Calibration data cleared.\n\n"
+            "Please recalibrate the sensor.");
+    }
+}
+
+void OxygenCalibrationWidget::onReadingReady(bool voltageOk, double voltage, bool oxygenOk, double oxygen)
 {
     if (isCalibrating) {
         return;
     }
     
-    // Read voltage
-    float voltage;
-    if (oxygenSensor->readVoltage(voltage)) {
-        voltageLCD->display(voltage);
-    } else {
-        voltageLCD->display(0.0);
-    }
-    
-    // Read oxygen percentage
-    float oxygenPercent;
-    if (oxygenSensor->readOxygenPercentage(oxygenPercent)) {
-        oxygenLCD->display(oxygenPercent);
-    } else {
-        oxygenLCD->display(0.0);
-    }
+    voltageLCD->display(voltageOk ? voltage : 0.0);
+    oxygenLCD->display(oxygenOk ? oxygen : 0.0);
 }
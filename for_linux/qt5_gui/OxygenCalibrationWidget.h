@@ -9,14 +9,12 @@
 #define OXYGENCALIBRATIONWIDGET_H
 
 #include <QWidget>
+#include <QThread>
 #include <QPushButton>
 #include <QLabel>
 #include <QLCDNumber>
-#include <QTimer>
 #include <QProgressBar>
-#include "/home/wang/code/AO08/AO08_Sensor.h"
-#include "/home/wang/code/AO08/AO08_CalibrationStorage.h"
-#include "/home/wang/code/breath_contr/I2CMux.h"
+#include "OxygenSensorWorker.h"
 
 namespace Ui {
 class OxygenCalibrationWidget;
@@ -36,23 +34,31 @@ signals:
 private slots:
     void onCalibrateZeroClicked();
     void onCalibrateAirClicked();
+    void onCancelCalibrationClicked();
     void onTestVoltageClicked();
     void onClearCalibrationClicked();
-    void updateReading();
-    void performZeroCalibration();
-    void performAirCalibration();
+    
+    // Results from the worker thread
+    void onSensorInitialized(bool sensorOk, bool storageOk);
+    void onReadingReady(bool voltageOk, double voltage, bool oxygenOk, double oxygen);
+    void onCalibrationInfo(bool calibrated, double voltageZero, double voltageAir);
+    void onCalibrationProgress(double progress, double stability, double mean, double stdDev,
+                               int samples, const QString &state);
+    void onCalibrationFinished(int point, int status, const QString &message);
+    void onVoltageTested(bool ok, double voltage);
+    void onCalibrationCleared(bool ok);
 
 private:
     Ui::OxygenCalibrationWidget *ui;
     
-    // Backend objects
-    I2CMux *mux;
-    AO08_Sensor *oxygenSensor;
-    AO08_CalibrationStorage *calibrationStorage;
+    // Sensor I/O and calibration run in workerThread
+    QThread *workerThread;
+    OxygenSensorWorker *worker;
     
     // UI elements
     QPushButton *calibrateZeroButton;
     QPushButton *calibrateAirButton;
+    QPushButton *cancelCalibrationButton;
     QPushButton *testVoltageButton;
     QPushButton *clearCalibrationButton;
     
@@ -62,18 +68,16 @@ private:
     QLabel *calibrationStatusLabel;
     QLabel *zeroVoltageLabel;
     QLabel *airVoltageLabel;
+    QLabel *stabilityLabel;
     QProgressBar *calibrationProgress;
     
-    QTimer *readingTimer;
-    QTimer *calibrationTimer;
-    
     bool isCalibrating;
-    int calibrationStep;
     
     void setupUI();
     void setupConnections();
     void initializeSensor();
-    void updateCalibrationInfo();
+    void beginCalibration(AO08_Sensor::CalibrationPoint point);
+    void setCalibrating(bool calibrating);
 };
 
 #endif // OXYGENCALIBRATIONWIDGET_H
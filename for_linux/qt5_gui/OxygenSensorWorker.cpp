@@ -0,0 +1,180 @@
+/*
+ * ===================================================================
+ * OxygenSensorWorker.cpp
+ * AO08 oxygen sensor worker implementation
+ * ===================================================================
+ */
+
+#include "OxygenSensorWorker.h"
+
+using namespace ArduinoHAL;
+
+static const int READING_INTERVAL_MS = 500;
+// One ADC conversion per step; the sampler decides when the signal is stable
+static const int CALIBRATION_STEP_MS = 100;
+
+OxygenSensorWorker::OxygenSensorWorker(QObject *parent)
+    : QObject(parent)
+    , mux(nullptr)
+    , oxygenSensor(nullptr)
+    , calibrationStorage(nullptr)
+    , readingTimer(nullptr)
+    , calibrationTimer(nullptr)
+{
+}
+
+OxygenSensorWorker::~OxygenSensorWorker()
+{
+    delete oxygenSensor;
+    delete calibrationStorage;
+    delete mux;
+}
+
+void OxygenSensorWorker::initialize()
+{
+    // Created here so the timers belong to the worker thread
+    readingTimer = new QTimer(this);
+    calibrationTimer = new QTimer(this);
+    connect(readingTimer, &QTimer::timeout, this, &OxygenSensorWorker::updateReading);
+    connect(calibrationTimer, &QTimer::timeout, this, &OxygenSensorWorker::stepCalibration);
+    
+    Wire.begin();
+    
+    // Initialize I2C Mux
+    mux = new I2CMux(0x70);
+    mux->begin();
+    mux->addChannel(6, 0x4A, "ADS1115");
+    
+    // Initialize oxygen sensor
+    oxygenSensor = new AO08_Sensor(mux, 6, 0x4A);
+    calibrationStorage = new AO08_CalibrationStorage();
+    
+    bool storageOk = calibrationStorage->begin();
+    bool sensorOk = oxygenSensor->begin();
+    emit initialized(sensorOk, storageOk);
+    
+    if (!sensorOk) {
+        return;
+    }
+    
+    // 860 SPS oversampling decimated to 10 Hz in the sensor's own thread;
+    // readings and calibration steps below just pick up the latest output.
+    // On failure the sensor keeps doing single-shot conversions.
+    oxygenSensor->startAcquisition();
+    
+    reportCalibrationInfo();
+    readingTimer->start(READING_INTERVAL_MS);
+}
+
+void OxygenSensorWorker::reportCalibrationInfo()
+{
+    float vZero = 0.0f;
+    float vAir = 0.0f;
+    oxygenSensor->getCalibrationParams(vZero, vAir);
+    emit calibrationInfo(oxygenSensor->isCalibrated(), vZero, vAir);
+}
+
+void OxygenSensorWorker::updateReading()
+{
+    float voltage = 0.0f;
+    bool voltageOk = oxygenSensor->readVoltage(voltage);
+    
+    float oxygenPercent = 0.0f;
+    bool oxygenOk = oxygenSensor->readOxygenPercentage(oxygenPercent);
+    
+    emit readingReady(voltageOk, voltage, oxygenOk, oxygenPercent);
+}
+
+void OxygenSensorWorker::startCalibration(int point)
+{
+    if (!oxygenSensor) {
+        emit calibrationFinished(point, CalibrationSampler::READ_FAILED, "Sensor not initialized.");
+        return;
+    }
+    if (!oxygenSensor->startCalibration(static_cast<AO08_Sensor::CalibrationPoint>(point), true)) {
+        emit calibrationFinished(point, CalibrationSampler::REJECTED, "A calibration is already running.");
+        return;
+    }
+    
+    // Readings would interleave conversions with the calibration samples
+    readingTimer->stop();
+    calibrationTimer->start(CALIBRATION_STEP_MS);
+}
+
+void OxygenSensorWorker::cancelCalibration()
+{
+    if (oxygenSensor && oxygenSensor->isCalibrating()) {
+        oxygenSensor->cancelCalibration();
+        // Let the next step report the cancellation like any other outcome
+        if (!calibrationTimer->isActive()) {
+            stepCalibration();
+        }
+    }
+}
+
+void OxygenSensorWorker::stepCalibration()
+{
+    const CalibrationSampler::Status status = oxygenSensor->stepCalibration();
+    const CalibrationSampler &sampler = oxygenSensor->getCalibrationSampler();
+    
+    emit calibrationProgress(sampler.getProgress(), sampler.getStability(),
+                             sampler.getCount() ? sampler.getMean() : sampler.getLastValue(),
+                             sampler.getStdDev(), sampler.getCount(),
+                             QString::fromUtf8(CalibrationSampler::statusName(status)));
+    
+    if (oxygenSensor->isCalibrating()) {
+        return;
+    }
+    
+    calibrationTimer->stop();
+    const int point = oxygenSensor->getCalibrationPoint();
+    const double seconds = sampler.getElapsedMs() / 1000.0;
+    
+    QString message;
+    switch (status) {
+    case CalibrationSampler::STABLE:
+        message = QString("Signal stable after %1 s: %2 mV (σ %3 mV).")
+                      .arg(seconds, 0, 'f', 1)
+                      .arg(sampler.getMean(), 0, 'f', 4)
+                      .arg(sampler.getStdDev(), 0, 'f', 4);
+        break;
+    case CalibrationSampler::TIMEOUT:
+        message = QString("Signal did not stabilise within %1 s (σ %2 mV).\n"
+                          "Check the sensor and try again.")
+                      .arg(seconds, 0, 'f', 0)
+                      .arg(sampler.getStdDev(), 0, 'f', 4);
+        break;
+    case CalibrationSampler::READ_FAILED:
+        message = "Failed to read the ADC.\nPlease check the sensor connection.";
+        break;
+    case CalibrationSampler::REJECTED:
+        message = "Air voltage must be higher than the zero voltage.\n"
+                  "Please ensure zero point calibration was completed first.";
+        break;
+    case CalibrationSampler::CANCELLED:
+        message = "Calibration cancelled.";
+        break;
+    default:
+        break;
+    }
+    
+    emit calibrationFinished(point, status, message);
+    reportCalibrationInfo();
+    readingTimer->start(READING_INTERVAL_MS);
+}
+
+void OxygenSensorWorker::testVoltage()
+{
+    float voltage = 0.0f;
+    bool ok = oxygenSensor && !oxygenSensor->isCalibrating() && oxygenSensor->readVoltage(voltage);
+    emit voltageTested(ok, voltage);
+}
+
+void OxygenSensorWorker::clearCalibration()
+{
+    bool ok = calibrationStorage && calibrationStorage->clearCalibration();
+    emit calibrationCleared(ok);
+    if (oxygenSensor) {
+        reportCalibrationInfo();
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * ===================================================================
+ * OxygenSensorWorker.h
+ * AO08 oxygen sensor worker running in its own QThread
+ * ===================================================================
+ */
+
+#ifndef OXYGENSENSORWORKER_H
+#define OXYGENSENSORWORKER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QString>
+#include "/home/wang/code/AO08/AO08_Sensor.h"
+#include "/home/wang/code/AO08/AO08_CalibrationStorage.h"
+#include "/home/wang/code/breath_contr/I2CMux.h"
+
+/*
+ * Owns the mux, the AO08 sensor and its calibration storage. Periodic
+ * readings and the calibration state machine both run on the worker
+ * thread; the widget drives it through queued invocations only.
+ */
+class OxygenSensorWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OxygenSensorWorker(QObject *parent = nullptr);
+    ~OxygenSensorWorker();
+
+public slots:
+    void initialize();
+    // point: AO08_Sensor::CalibrationPoint
+    void startCalibration(int point);
+    void cancelCalibration();
+    void testVoltage();
+    void clearCalibration();
+
+signals:
+    void initialized(bool sensorOk, bool storageOk);
+    void readingReady(bool voltageOk, double voltage, bool oxygenOk, double oxygen);
+    void calibrationInfo(bool calibrated, double voltageZero, double voltageAir);
+    // progress/stability in 0..1, mean/stdDev in mV
+    void calibrationProgress(double progress, double stability, double mean, double stdDev,
+                             int samples, const QString &state);
+    // status: CalibrationSampler::Status (STABLE on success)
+    void calibrationFinished(int point, int status, const QString &message);
+    void voltageTested(bool ok, double voltage);
+    void calibrationCleared(bool ok);
+
+private slots:
+    void updateReading();
+    void stepCalibration();
+
+private:
+    I2CMux *mux;
+    AO08_Sensor *oxygenSensor;
+    AO08_CalibrationStorage *calibrationStorage;
+    
+    QTimer *readingTimer;
+    QTimer *calibrationTimer;
+    
+    void reportCalibrationInfo();
+};
+
+#endif // OXYGENSENSORWORKER_H
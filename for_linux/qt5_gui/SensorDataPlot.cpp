@@ -7,13 +7,31 @@
 
 #include "SensorDataPlot.h"
 #include <QVBoxLayout>
+#include <algorithm>
+#ifndef QT_NO_OPENGL
+#include <QOpenGLContext>
+#endif
 
 SensorDataPlot::SensorDataPlot(const QString &title, QWidget *parent)
     : QWidget(parent)
+    , ringHead(0)
+    , ringCount(0)
     , maxDataPoints(100)
     , currentIndex(0)
+    , envelopeMode(false)
+    , envelopeColumns(0)
+    , envelopeHead(0)
+    , envelopeCount(0)
+    , autoScale(true)
+    , refreshTimer(new QTimer(this))
 {
     setupChart(title);
+    resetBuffers();
+    
+    // Samples only mark the chart dirty; the timer redraws at most once per frame
+    refreshTimer->setSingleShot(true);
+    refreshTimer->setInterval(1000 / 60);
+    connect(refreshTimer, &QTimer::timeout, this, &SensorDataPlot::refreshChart);
     
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->addWidget(chartView);
@@ -57,52 +75,233 @@ void SensorDataPlot::setupChart(const QString &title)
     // Create chart view
     chartView = new QChartView(chart, this);
     chartView->setRenderHint(QPainter::Antialiasing);
+}
+
+bool SensorDataPlot::openGLAvailable()
+{
+#ifndef QT_NO_OPENGL
+    // QtCharts silently draws nothing if GL series are used without a working context
+    static int available = -1;
+    if (available < 0) {
+        QOpenGLContext context;
+        available = context.create() ? 1 : 0;
+    }
+    return available == 1;
+#else
+    return false;
+#endif
+}
+
+void SensorDataPlot::setEnvelopeMode(bool enabled)
+{
+    if (enabled == envelopeMode) {
+        return;
+    }
+    envelopeMode = enabled;
+    envelopeColumns = 0;
+    
+    // The GL path and the envelope both aim at long windows; antialiasing a
+    // few thousand segments per frame is what the Luckfox cannot afford
+    series->setUseOpenGL(enabled && openGLAvailable());
+    QPen pen = series->pen();
+    pen.setWidth(enabled ? 1 : 2);
+    series->setPen(pen);
+    chartView->setRenderHint(QPainter::Antialiasing, !enabled);
+    
+    if (!refreshTimer->isActive()) {
+        refreshTimer->start();
+    }
+}
+
+void SensorDataPlot::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
     
-    // Initialize data buffer
-    dataBuffer.reserve(maxDataPoints);
+    // Column geometry depends on the plot area width; rebuild on next refresh
+    if (envelopeMode) {
+        envelopeColumns = 0;
+        if (!refreshTimer->isActive()) {
+            refreshTimer->start();
+        }
+    }
+}
+
+void SensorDataPlot::resetBuffers()
+{
+    ring.fill(QPointF(), maxDataPoints);
+    renderBuffer.clear();
+    renderBuffer.reserve(maxDataPoints);
+    ringHead = 0;
+    ringCount = 0;
+    currentIndex = 0;
+    minDeque.clear();
+    maxDeque.clear();
+    envelopeColumns = 0;
+    envelopeHead = 0;
+    envelopeCount = 0;
 }
 
 void SensorDataPlot::addDataPoint(double value)
 {
-    dataBuffer.append(value);
+    const QPointF point(currentIndex, value);
+    
+    // Overwrite the oldest slot - no allocation, no shifting
+    ring[ringHead] = point;
+    ringHead = (ringHead + 1) % maxDataPoints;
+    if (ringCount < maxDataPoints) {
+        ringCount++;
+    }
+    
+    // Window extrema: drop dominated values from the back, expired ones from the front
+    while (!minDeque.empty() && minDeque.back().y() >= value) {
+        minDeque.pop_back();
+    }
+    minDeque.push_back(point);
+    while (!maxDeque.empty() && maxDeque.back().y() <= value) {
+        maxDeque.pop_back();
+    }
+    maxDeque.push_back(point);
+    
+    const qint64 oldest = currentIndex - maxDataPoints + 1;
+    while (minDeque.front().x() < oldest) {
+        minDeque.pop_front();
+    }
+    while (maxDeque.front().x() < oldest) {
+        maxDeque.pop_front();
+    }
     
-    // Keep buffer size limited
-    if (dataBuffer.size() > maxDataPoints) {
-        dataBuffer.removeFirst();
+    if (envelopeMode && envelopeColumns > 0) {
+        addEnvelopeSample(currentIndex, value);
     }
     
     currentIndex++;
-    updateChart();
+    
+    if (!refreshTimer->isActive()) {
+        refreshTimer->start();
+    }
+}
+
+void SensorDataPlot::rebuildEnvelope(int columns)
+{
+    // One slot per pixel column plus one for the partially expired column at the left edge
+    envelopeColumns = columns;
+    envelope.resize(columns + 1);
+    envelopeHead = 0;
+    envelopeCount = 0;
+    
+    const int start = (ringHead - ringCount + maxDataPoints) % maxDataPoints;
+    for (int i = 0; i < ringCount; ++i) {
+        const QPointF &p = ring[(start + i) % maxDataPoints];
+        addEnvelopeSample(qint64(p.x()), p.y());
+    }
+}
+
+void SensorDataPlot::addEnvelopeSample(qint64 index, double value)
+{
+    // Integer column mapping keeps every column exactly maxDataPoints / columns samples wide
+    const qint64 column = index * envelopeColumns / maxDataPoints;
+    
+    if (envelopeCount > 0) {
+        const int last = (envelopeHead - 1 + envelope.size()) % envelope.size();
+        EnvelopeColumn &col = envelope[last];
+        if (col.column == column) {
+            col.min = qMin(col.min, value);
+            col.max = qMax(col.max, value);
+            return;
+        }
+    }
+    
+    EnvelopeColumn &col = envelope[envelopeHead];
+    col.column = column;
+    col.min = value;
+    col.max = value;
+    envelopeHead = (envelopeHead + 1) % envelope.size();
+    if (envelopeCount < envelope.size()) {
+        envelopeCount++;
+    }
 }
 
 void SensorDataPlot::clearData()
 {
-    dataBuffer.clear();
-    currentIndex = 0;
+    refreshTimer->stop();
+    resetBuffers();
     series->clear();
+    axisX->setRange(0, maxDataPoints);
 }
 
 void SensorDataPlot::setYAxisRange(double min, double max)
 {
+    autoScale = false;
     axisY->setRange(min, max);
 }
 
-void SensorDataPlot::updateChart()
+void SensorDataPlot::setMaxDataPoints(int points)
 {
-    series->clear();
+    if (points < 2 || points == maxDataPoints) {
+        return;
+    }
+    maxDataPoints = points;
+    clearData();
+}
+
+void SensorDataPlot::setRefreshRate(int fps)
+{
+    if (fps > 0) {
+        refreshTimer->setInterval(qMax(1, 1000 / fps));
+    }
+}
+
+void SensorDataPlot::fillPoints()
+{
+    // Unroll the ring oldest-first
+    renderBuffer.resize(ringCount);
+    const int start = (ringHead - ringCount + maxDataPoints) % maxDataPoints;
+    const int firstPart = qMin(ringCount, maxDataPoints - start);
+    std::copy(ring.constBegin() + start, ring.constBegin() + start + firstPart, renderBuffer.begin());
+    std::copy(ring.constBegin(), ring.constBegin() + (ringCount - firstPart), renderBuffer.begin() + firstPart);
+}
+
+void SensorDataPlot::fillEnvelope()
+{
+    const int columns = qMax(1, int(chart->plotArea().width()));
+    if (columns != envelopeColumns) {
+        rebuildEnvelope(columns);
+    }
     
-    int startIndex = qMax(0, currentIndex - maxDataPoints);
+    // Two vertices per column, so the series size follows the widget width
+    // rather than the number of samples in the window
+    renderBuffer.resize(envelopeCount * 2);
+    const int start = (envelopeHead - envelopeCount + envelope.size()) % envelope.size();
+    for (int i = 0; i < envelopeCount; ++i) {
+        const EnvelopeColumn &col = envelope[(start + i) % envelope.size()];
+        const double x = double(col.column) * maxDataPoints / envelopeColumns;
+        renderBuffer[2 * i] = QPointF(x, col.min);
+        renderBuffer[2 * i + 1] = QPointF(x, col.max);
+    }
+}
+
+void SensorDataPlot::refreshChart()
+{
+    if (ringCount == 0) {
+        return;
+    }
     
-    for (int i = 0; i < dataBuffer.size(); ++i) {
-        series->append(startIndex + i, dataBuffer[i]);
+    // Hand the whole window over in one call
+    if (envelopeMode) {
+        fillEnvelope();
+    } else {
+        fillPoints();
     }
+    series->replace(renderBuffer);
     
-    // Auto-scale Y axis based on current data
-    if (!dataBuffer.isEmpty()) {
-        double minVal = *std::min_element(dataBuffer.begin(), dataBuffer.end());
-        double maxVal = *std::max_element(dataBuffer.begin(), dataBuffer.end());
-        
+    // Auto-scale Y axis from the tracked window extrema
+    if (autoScale) {
+        double minVal = minDeque.front().y();
+        double maxVal = maxDeque.front().y();
         double margin = (maxVal - minVal) * 0.1;
+        if (margin <= 0.0) {
+            margin = qMax(1.0, qAbs(maxVal) * 0.1);
+        }
         axisY->setRange(minVal - margin, maxVal + margin);
     }
     
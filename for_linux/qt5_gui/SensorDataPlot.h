@@ -9,10 +9,13 @@
 #define SENSORDATAPLOT_H
 
 #include <QWidget>
+#include <QTimer>
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QVector>
+#include <QPointF>
+#include <deque>
 
 QT_CHARTS_USE_NAMESPACE
 
@@ -27,20 +30,69 @@ public:
     void addDataPoint(double value);
     void clearData();
     void setYAxisRange(double min, double max);
+    
+    // Window length in samples (reallocates the ring, drops current data)
+    void setMaxDataPoints(int points);
+    // Upper bound on chart refreshes per second, independent of sample rate
+    void setRefreshRate(int fps);
+    
+    // Long-window mode: draw a per-pixel-column min/max envelope instead of
+    // every sample, rendered through OpenGL when the platform provides it
+    void setEnvelopeMode(bool enabled);
+    bool isEnvelopeMode() const { return envelopeMode; }
+    bool isOpenGLActive() const { return series->useOpenGL(); }
+
+protected:
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void refreshChart();
 
 private:
+    // Min/max of all samples falling into one pixel column
+    struct EnvelopeColumn {
+        qint64 column;
+        double min;
+        double max;
+    };
+    
     QChartView *chartView;
     QChart *chart;
     QLineSeries *series;
     QValueAxis *axisX;
     QValueAxis *axisY;
     
-    QVector<double> dataBuffer;
+    // Preallocated point ring: ringHead is the slot for the next sample
+    QVector<QPointF> ring;
+    int ringHead;
+    int ringCount;
     int maxDataPoints;
-    int currentIndex;
+    qint64 currentIndex;
+    
+    // Ordered copy handed to QLineSeries::replace(), reused between refreshes
+    QVector<QPointF> renderBuffer;
+    
+    // Monotonic deques (sample index, value) for O(1) amortised window min/max
+    std::deque<QPointF> minDeque;
+    std::deque<QPointF> maxDeque;
+    
+    // Column ring for envelope mode, updated as samples arrive
+    bool envelopeMode;
+    int envelopeColumns;        // plot width in pixels the envelope was built for (0 = stale)
+    QVector<EnvelopeColumn> envelope;
+    int envelopeHead;
+    int envelopeCount;
+    
+    bool autoScale;
+    QTimer *refreshTimer;
     
     void setupChart(const QString &title);
-    void updateChart();
+    void resetBuffers();
+    void rebuildEnvelope(int columns);
+    void addEnvelopeSample(qint64 index, double value);
+    void fillPoints();
+    void fillEnvelope();
+    static bool openGLAvailable();
 };
 
 #endif // SENSORDATAPLOT_H
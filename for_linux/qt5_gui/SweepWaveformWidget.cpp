@@ -0,0 +1,332 @@
+/*
+ * ===================================================================
+ * SweepWaveformWidget.cpp
+ * Monitor-style sweeping waveform implementation
+ * ===================================================================
+ */
+
+#include "SweepWaveformWidget.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <cmath>
+
+static const QColor SWEEP_BACKGROUND(0, 0, 0);
+static const QColor SWEEP_GRID(40, 40, 40);
+
+SweepWaveformWidget::SweepWaveformWidget(QWidget *parent)
+    : QWidget(parent)
+    , pendingCount(0)
+    , frameTimer(new QTimer(this))
+    , sweepSeconds(6.0)
+    , started(false)
+    , originUs(0)
+    , lastPos(0.0)
+{
+    // Every pixel is owned by the backing pixmap; skip Qt's background fill
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumHeight(120);
+    
+    frameTimer->setSingleShot(true);
+    frameTimer->setInterval(1000 / 60);
+    connect(frameTimer, &QTimer::timeout, this, &SweepWaveformWidget::renderPending);
+}
+
+SweepWaveformWidget::~SweepWaveformWidget()
+{
+}
+
+int SweepWaveformWidget::addTrace(const QString &name, const QColor &color, double min, double max)
+{
+    Trace trace;
+    trace.name = name;
+    trace.color = color;
+    trace.min = min;
+    trace.max = max;
+    trace.autoScale = true;
+    trace.sweepMin = 0.0;
+    trace.sweepMax = 0.0;
+    trace.lastValue = 0.0;
+    traces.append(trace);
+    
+    // Lane layout changed - start over
+    clear();
+    return traces.size() - 1;
+}
+
+void SweepWaveformWidget::setTraceRange(int trace, double min, double max)
+{
+    if (trace < 0 || trace >= traces.size() || max <= min) {
+        return;
+    }
+    traces[trace].min = min;
+    traces[trace].max = max;
+    traces[trace].autoScale = false;
+    if (!backing.isNull()) {
+        QPainter painter(&backing);
+        drawLabels(painter);
+    }
+    update(0, 0, LABEL_WIDTH, height());
+}
+
+void SweepWaveformWidget::setAutoScale(int trace, bool enabled)
+{
+    if (trace >= 0 && trace < traces.size()) {
+        traces[trace].autoScale = enabled;
+    }
+}
+
+void SweepWaveformWidget::setSweepDuration(double seconds)
+{
+    if (seconds > 0.0) {
+        sweepSeconds = seconds;
+        clear();
+    }
+}
+
+void SweepWaveformWidget::setFrameRate(int fps)
+{
+    if (fps > 0) {
+        frameTimer->setInterval(qMax(1, 1000 / fps));
+    }
+}
+
+void SweepWaveformWidget::clear()
+{
+    frameTimer->stop();
+    pending.clear();
+    pendingCount = 0;
+    started = false;
+    resetBacking();
+    update();
+}
+
+void SweepWaveformWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    
+    // Pixel positions depend on the width, so the current sweep cannot be kept
+    started = false;
+    resetBacking();
+}
+
+QRect SweepWaveformWidget::laneRect(int trace) const
+{
+    const int lanes = qMax(1, traces.size());
+    const int top = height() * trace / lanes;
+    const int bottom = height() * (trace + 1) / lanes;
+    return QRect(LABEL_WIDTH, top, sweepWidth(), bottom - top);
+}
+
+int SweepWaveformWidget::valueToY(const Trace &trace, int lane, double value) const
+{
+    const QRect rect = laneRect(lane).adjusted(0, 4, 0, -4);
+    double ratio = (value - trace.min) / (trace.max - trace.min);
+    ratio = qBound(0.0, ratio, 1.0);
+    return rect.bottom() - int(ratio * (rect.height() - 1));
+}
+
+void SweepWaveformWidget::resetBacking()
+{
+    if (width() <= 0 || height() <= 0) {
+        return;
+    }
+    backing = QPixmap(size());
+    backing.fill(SWEEP_BACKGROUND);
+    
+    QPainter painter(&backing);
+    painter.setPen(SWEEP_GRID);
+    for (int i = 1; i < traces.size(); ++i) {
+        const int y = laneRect(i).top();
+        painter.drawLine(0, y, width() - 1, y);
+    }
+    drawLabels(painter);
+    dirty = QRegion(rect());
+}
+
+void SweepWaveformWidget::drawLabels(QPainter &painter)
+{
+    QFont font = painter.font();
+    font.setPointSize(8);
+    painter.setFont(font);
+    
+    for (int i = 0; i < traces.size(); ++i) {
+        const Trace &trace = traces[i];
+        const QRect lane = laneRect(i);
+        const QRect label(0, lane.top(), LABEL_WIDTH - 4, lane.height());
+        painter.fillRect(label, SWEEP_BACKGROUND);
+        painter.setPen(trace.color);
+        painter.drawText(label.adjusted(2, 2, 0, 0), Qt::AlignLeft | Qt::AlignTop, trace.name);
+        painter.drawText(label.adjusted(2, 16, 0, 0), Qt::AlignLeft | Qt::AlignTop,
+                         QString::number(trace.max, 'g', 3));
+        painter.drawText(label.adjusted(2, 0, 0, -2), Qt::AlignLeft | Qt::AlignBottom,
+                         QString::number(trace.min, 'g', 3));
+    }
+    dirty += QRect(0, 0, LABEL_WIDTH, height());
+}
+
+void SweepWaveformWidget::addSample(quint64 timestampUs, const double *values)
+{
+    if (traces.isEmpty()) {
+        return;
+    }
+    
+    // Just queue it - drawing happens once per frame, however fast samples arrive
+    pending.append(double(timestampUs));
+    for (int i = 0; i < traces.size(); ++i) {
+        pending.append(values[i]);
+    }
+    pendingCount++;
+    
+    if (!frameTimer->isActive()) {
+        frameTimer->start();
+    }
+}
+
+void SweepWaveformWidget::eraseColumns(QPainter &painter, int from, int to)
+{
+    // [from, to) in unwrapped sweep coordinates
+    const int w = sweepWidth();
+    const int count = qMin(to - from, w);
+    if (count <= 0) {
+        return;
+    }
+    const int start = ((from % w) + w) % w;
+    const int first = qMin(count, w - start);
+    
+    QRect r(LABEL_WIDTH + start, 0, first, height());
+    painter.fillRect(r, SWEEP_BACKGROUND);
+    dirty += r;
+    if (count > first) {
+        r = QRect(LABEL_WIDTH, 0, count - first, height());
+        painter.fillRect(r, SWEEP_BACKGROUND);
+        dirty += r;
+    }
+}
+
+void SweepWaveformWidget::wrapSweep(QPainter &painter)
+{
+    // Monitor behaviour: the scale changes only at the start of a sweep, so the
+    // screen never shows two scales inside one trace segment
+    bool rescaled = false;
+    for (int i = 0; i < traces.size(); ++i) {
+        Trace &trace = traces[i];
+        if (trace.autoScale && trace.sweepMax > trace.sweepMin) {
+            const double margin = (trace.sweepMax - trace.sweepMin) * 0.1;
+            trace.min = trace.sweepMin - margin;
+            trace.max = trace.sweepMax + margin;
+            rescaled = true;
+        }
+        trace.sweepMin = trace.lastValue;
+        trace.sweepMax = trace.lastValue;
+    }
+    if (rescaled) {
+        drawLabels(painter);
+    }
+}
+
+void SweepWaveformWidget::renderPending()
+{
+    if (backing.isNull() || pendingCount == 0) {
+        pending.clear();
+        pendingCount = 0;
+        return;
+    }
+    
+    const int w = sweepWidth();
+    const double pxPerUs = w / (sweepSeconds * 1e6);
+    const int stride = traces.size() + 1;
+    
+    QPainter painter(&backing);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    
+    for (int s = 0; s < pendingCount; ++s) {
+        const double *sample = pending.constData() + s * stride;
+        const quint64 t = quint64(sample[0]);
+        
+        if (!started) {
+            originUs = t;
+            lastPos = 0.0;
+            started = true;
+            for (int i = 0; i < traces.size(); ++i) {
+                traces[i].lastValue = sample[i + 1];
+                traces[i].sweepMin = traces[i].sweepMax = sample[i + 1];
+            }
+            eraseColumns(painter, 0, ERASE_WIDTH + 1);
+            continue;
+        }
+        
+        const double pos = t >= originUs ? (t - originUs) * pxPerUs : -1.0;
+        if (pos < lastPos || pos - lastPos >= w) {
+            // Gap longer than a full sweep (paused stream) or time running backwards
+            // (clock stepped, publisher restarted) - restart from the left
+            started = false;
+            painter.end();
+            resetBacking();
+            painter.begin(&backing);
+            s--;
+            continue;
+        }
+        
+        const int x0 = int(lastPos);
+        const int x1 = int(pos);
+        if (x1 / w != x0 / w) {
+            wrapSweep(painter);
+        }
+        
+        // Erase bar ahead of the new point, then the segments behind it
+        if (x1 > x0) {
+            eraseColumns(painter, x0 + 1 + ERASE_WIDTH, x1 + 1 + ERASE_WIDTH);
+        }
+        
+        const int sx0 = x0 % w;
+        const int sx1 = sx0 + (x1 - x0);
+        for (int i = 0; i < traces.size(); ++i) {
+            Trace &trace = traces[i];
+            const double value = sample[i + 1];
+            const int y0 = valueToY(trace, i, trace.lastValue);
+            const int y1 = valueToY(trace, i, value);
+            const QRect lane = laneRect(i);
+            
+            painter.setPen(QPen(trace.color, 1));
+            painter.setClipRect(lane);
+            painter.drawLine(LABEL_WIDTH + sx0, y0, LABEL_WIDTH + sx1, y1);
+            if (sx1 >= w) {
+                // Segment crosses the right edge: draw its continuation at the left
+                painter.drawLine(LABEL_WIDTH + sx0 - w, y0, LABEL_WIDTH + sx1 - w, y1);
+            }
+            painter.setClipping(false);
+            
+            trace.lastValue = value;
+            trace.sweepMin = qMin(trace.sweepMin, value);
+            trace.sweepMax = qMax(trace.sweepMax, value);
+        }
+        
+        if (sx1 < w) {
+            dirty += QRect(LABEL_WIDTH + sx0, 0, sx1 - sx0 + 1, height());
+        } else {
+            dirty += QRect(LABEL_WIDTH + sx0, 0, w - sx0, height());
+            dirty += QRect(LABEL_WIDTH, 0, sx1 - w + 1, height());
+        }
+        lastPos = pos;
+    }
+    painter.end();
+    
+    pending.clear();
+    pendingCount = 0;
+    
+    // Only the columns written this frame reach the screen
+    update(dirty);
+    dirty = QRegion();
+}
+
+void SweepWaveformWidget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    if (backing.isNull()) {
+        painter.fillRect(event->rect(), SWEEP_BACKGROUND);
+        return;
+    }
+    for (const QRect &r : event->region()) {
+        painter.drawPixmap(r, backing, r);
+    }
+}
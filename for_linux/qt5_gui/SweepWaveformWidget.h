@@ -0,0 +1,95 @@
+/*
+ * ===================================================================
+ * SweepWaveformWidget.h
+ * Monitor-style sweeping waveform display
+ * ===================================================================
+ */
+
+#ifndef SWEEPWAVEFORMWIDGET_H
+#define SWEEPWAVEFORMWIDGET_H
+
+#include <QWidget>
+#include <QTimer>
+#include <QPixmap>
+#include <QRegion>
+#include <QColor>
+#include <QVector>
+
+class QPainter;
+
+/*
+ * Traces are drawn left to right into a persistent backing pixmap and wrap
+ * around, with an erase bar running just ahead of the write position.
+ * Each frame only the columns written since the previous frame are painted
+ * into the pixmap and pushed to the screen; axes, labels and older trace
+ * segments are never redrawn. All traces share one time base.
+ */
+class SweepWaveformWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SweepWaveformWidget(QWidget *parent = nullptr);
+    ~SweepWaveformWidget();
+    
+    // Traces are stacked top to bottom in the order they are added
+    int addTrace(const QString &name, const QColor &color, double min, double max);
+    // Fixed scale; by default each trace rescales to the previous sweep's range at wrap-around
+    void setTraceRange(int trace, double min, double max);
+    void setAutoScale(int trace, bool enabled);
+    
+    // Seconds per full sweep across the widget
+    void setSweepDuration(double seconds);
+    void setFrameRate(int fps);
+    
+    // values[i] belongs to trace i; a timestamp earlier than the previous one restarts the sweep
+    void addSample(quint64 timestampUs, const double *values);
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void renderPending();
+
+private:
+    struct Trace {
+        QString name;
+        QColor color;
+        double min;
+        double max;
+        bool autoScale;
+        double sweepMin;        // range seen during the current sweep
+        double sweepMax;
+        double lastValue;
+    };
+    
+    QVector<Trace> traces;
+    
+    // Samples received since the last frame: timestamp followed by one value per trace
+    QVector<double> pending;
+    int pendingCount;
+    
+    QPixmap backing;
+    QRegion dirty;
+    QTimer *frameTimer;
+    
+    double sweepSeconds;
+    bool started;               // a previous point exists to draw from
+    quint64 originUs;           // timestamp at x = 0 of the first sweep
+    double lastPos;             // unwrapped x of the previous point, in pixels
+    
+    static const int LABEL_WIDTH = 64;
+    static const int ERASE_WIDTH = 12;
+    
+    int sweepWidth() const { return qMax(1, width() - LABEL_WIDTH); }
+    QRect laneRect(int trace) const;
+    int valueToY(const Trace &trace, int lane, double value) const;
+    void resetBacking();
+    void drawLabels(QPainter &painter);
+    void eraseColumns(QPainter &painter, int from, int to);
+    void wrapSweep(QPainter &painter);
+};
+
+#endif // SWEEPWAVEFORMWIDGET_H
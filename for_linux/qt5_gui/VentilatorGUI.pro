@@ -34,14 +34,24 @@ SOURCES += \
     main.cpp \
     MainWindow.cpp \
     BreathControlWidget.cpp \
+    BreathControllerWorker.cpp \
     OxygenCalibrationWidget.cpp \
+    OxygenSensorWorker.cpp \
     SensorDataPlot.cpp \
+    SweepWaveformWidget.cpp \
     /home/wang/code/breath_contr/BreathController.cpp \
     /home/wang/code/breath_contr/ADS1115.cpp \
     /home/wang/code/breath_contr/gas_concentration.cpp \
     /home/wang/code/breath_contr/oxygen_sensor.cpp \
     /home/wang/code/breath_contr/I2CMux.cpp \
     /home/wang/code/breath_contr/OLEDDisplay.cpp \
+    /home/wang/code/breath_contr/TelemetryShm.cpp \
+    /home/wang/code/breath_contr/PressureController.cpp \
+    /home/wang/code/breath_contr/ValveLinearizer.cpp \
+    /home/wang/code/breath_contr/PressureFusion.cpp \
+    /home/wang/code/breath_contr/FlowEstimator.cpp \
+    /home/wang/code/breath_contr/CAFS3000.cpp \
+    /home/wang/code/breath_contr/VolumeIntegrator.cpp \
     /home/wang/code/AO08/AO08_Sensor.cpp \
     /home/wang/code/AO08/AO08_CalibrationStorage.cpp
 
@@ -49,8 +59,11 @@ SOURCES += \
 HEADERS += \
     MainWindow.h \
     BreathControlWidget.h \
+    BreathControllerWorker.h \
     OxygenCalibrationWidget.h \
+    OxygenSensorWorker.h \
     SensorDataPlot.h \
+    SweepWaveformWidget.h \
     /home/wang/code/breath_contr/LuckfoxArduino.h \
     /home/wang/code/breath_contr/BreathController.h \
     /home/wang/code/breath_contr/ADS1115.h \
@@ -58,15 +71,26 @@ HEADERS += \
     /home/wang/code/breath_contr/oxygen_sensor.h \
     /home/wang/code/breath_contr/I2CMux.h \
     /home/wang/code/breath_contr/OLEDDisplay.h \
+    /home/wang/code/breath_contr/SampleFrame.h \
+    /home/wang/code/breath_contr/TelemetryShm.h \
+    /home/wang/code/breath_contr/PressureController.h \
+    /home/wang/code/breath_contr/ValveLinearizer.h \
+    /home/wang/code/breath_contr/PressureFusion.h \
+    /home/wang/code/breath_contr/FlowEstimator.h \
+    /home/wang/code/breath_contr/CAFS3000.h \
+    /home/wang/code/breath_contr/VolumeIntegrator.h \
     /home/wang/code/AO08/AO08_Sensor.h \
-    /home/wang/code/AO08/AO08_CalibrationStorage.h
+    /home/wang/code/AO08/AO08_CalibrationStorage.h \
+    /home/wang/code/AO08/CalibrationSampler.h \
+    /home/wang/code/AO08/DecimationFilter.h \
+    /home/wang/code/AO08/PgaAutoRange.h
 
 # Resources
 RESOURCES += \
     resources.qrc
 
 # Libraries
-LIBS += -lpthread -lm
+LIBS += -lpthread -lm -lrt
 
 # Installation
 target.path = /root